@@ -43,7 +43,14 @@ uint32_t a8051_instruction_get_address(struct instruction *instr);
 unsigned int a8051_instruction_get_width(struct instruction *instr);
 unsigned int a8051_instruction_get_num_operands(struct instruction *instr);
 unsigned int a8051_instruction_get_opcodes(struct instruction *instr, uint8_t *dest);
+int a8051_instruction_get_operand_kind(struct instruction *instr, int index);
+int32_t a8051_instruction_get_operand_value(struct instruction *instr, int index);
+int a8051_instruction_get_branch_target(struct instruction *instr, uint32_t *dest);
+int a8051_instruction_get_flow(struct instruction *instr);
+int a8051_instruction_get_isa_index(struct instruction *instr);
+int a8051_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest);
 int a8051_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags);
+int a8051_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest);
 int a8051_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags);
 int a8051_instruction_get_str_opcodes(struct instruction *instr, char *dest, int size, int flags);
 int a8051_instruction_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
@@ -53,6 +60,8 @@ void a8051_instruction_free(struct instruction *instr);
 
 /* 8051 Directive Accessor Functions */
 unsigned int a8051_directive_get_num_operands(struct instruction *instr);
+int a8051_directive_get_operand_kind(struct instruction *instr, int index);
+int32_t a8051_directive_get_operand_value(struct instruction *instr, int index);
 int a8051_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
 int a8051_directive_get_str_operand(struct instruction *instr, char *dest, int size, int index, int flags);
 void a8051_directive_free(struct instruction *instr);
@@ -86,11 +95,161 @@ unsigned int a8051_instruction_get_opcodes(struct instruction *instr, uint8_t *d
     return instructionDisasm->instructionInfo->width;
 }
 
+int a8051_instruction_get_operand_kind(struct instruction *instr, int index) {
+    struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return OPERAND_KIND_NONE;
+
+    /* Raw data byte */
+    if (instructionDisasm->instructionInfo == &A8051_Instruction_Set[A8051_ISET_INDEX_BYTE])
+        return OPERAND_KIND_RAW;
+
+    switch (instructionDisasm->instructionInfo->operandTypes[index]) {
+        case OPERAND_R:
+            return OPERAND_KIND_REGISTER;
+        case OPERAND_A:
+        case OPERAND_AB:
+        case OPERAND_C:
+        case OPERAND_DPTR:
+            return OPERAND_KIND_IMPLICIT;
+        case OPERAND_IND_R:
+        case OPERAND_IND_DPTR:
+        case OPERAND_IND_A_DPTR:
+        case OPERAND_IND_A_PC:
+            return OPERAND_KIND_INDIRECT;
+        case OPERAND_IMMED:
+        case OPERAND_IMMED_16:
+            return OPERAND_KIND_DATA;
+        case OPERAND_ADDR_DIRECT:
+        case OPERAND_ADDR_DIRECT_SRC:
+        case OPERAND_ADDR_DIRECT_DST:
+            return OPERAND_KIND_DATA_ADDRESS;
+        case OPERAND_ADDR_BIT:
+        case OPERAND_ADDR_NOT_BIT:
+            return OPERAND_KIND_BIT_ADDRESS;
+        case OPERAND_ADDR_11:
+        case OPERAND_ADDR_16:
+            return OPERAND_KIND_PROG_ADDRESS;
+        case OPERAND_ADDR_RELATIVE:
+            return OPERAND_KIND_RELATIVE_ADDRESS;
+        default:
+            break;
+    }
+
+    return OPERAND_KIND_NONE;
+}
+
+int32_t a8051_instruction_get_operand_value(struct instruction *instr, int index) {
+    struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return 0;
+
+    /* An 11-bit address replaces the low bits of the next instruction's
+     * address */
+    if (instructionDisasm->instructionInfo->operandTypes[index] == OPERAND_ADDR_11)
+        return ((instructionDisasm->address + instructionDisasm->instructionInfo->width) & 0xF800) | instructionDisasm->operandDisasms[index];
+
+    return instructionDisasm->operandDisasms[index];
+}
+
+int a8051_instruction_get_branch_target(struct instruction *instr, uint32_t *dest) {
+    struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
+    int i;
+
+    for (i = 0; i < instructionDisasm->instructionInfo->numOperands; i++) {
+        switch (a8051_instruction_get_operand_kind(instr, i)) {
+            case OPERAND_KIND_RELATIVE_ADDRESS:
+                *dest = instructionDisasm->operandDisasms[i] + instructionDisasm->address + instructionDisasm->instructionInfo->width;
+                return 1;
+            case OPERAND_KIND_PROG_ADDRESS:
+                *dest = a8051_instruction_get_operand_value(instr, i);
+                return 1;
+            default:
+                break;
+        }
+    }
+
+    return 0;
+}
+
+/* Instructions that change the control flow */
+static const struct {
+    const char *mnemonic;
+    int flow;
+} A8051_Flow_Table[] = {
+    {"ajmp", FLOW_JUMP}, {"ljmp", FLOW_JUMP}, {"sjmp", FLOW_JUMP},
+    {"jmp", FLOW_INDIRECT_JUMP},
+    {"acall", FLOW_CALL}, {"lcall", FLOW_CALL},
+    {"ret", FLOW_RETURN}, {"reti", FLOW_RETURN},
+    {"jc", FLOW_BRANCH}, {"jnc", FLOW_BRANCH}, {"jb", FLOW_BRANCH}, {"jnb", FLOW_BRANCH},
+    {"jbc", FLOW_BRANCH}, {"jz", FLOW_BRANCH}, {"jnz", FLOW_BRANCH}, {"cjne", FLOW_BRANCH},
+    {"djnz", FLOW_BRANCH},
+    {"resrvd", FLOW_INVALID},
+};
+
+int a8051_instruction_get_flow(struct instruction *instr) {
+    struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
+    int i;
+
+    /* Raw data byte */
+    if (instructionDisasm->instructionInfo == &A8051_Instruction_Set[A8051_ISET_INDEX_BYTE])
+        return FLOW_INVALID;
+
+    for (i = 0; i < sizeof(A8051_Flow_Table)/sizeof(A8051_Flow_Table[0]); i++) {
+        if (strcmp(instructionDisasm->instructionInfo->mnemonic, A8051_Flow_Table[i].mnemonic) == 0)
+            return A8051_Flow_Table[i].flow;
+    }
+
+    return FLOW_NEXT;
+}
+
+int a8051_instruction_get_isa_index(struct instruction *instr) {
+    struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
+    return instructionDisasm->instructionInfo - A8051_Instruction_Set;
+}
+
+/* Conditional jumps take the same machine cycles, taken or not */
+int a8051_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest) {
+    struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
+
+    if (variant != CYCLES_VARIANT_DEFAULT || instructionDisasm->instructionInfo->cycles == 0)
+        return 0;
+
+    dest->next = dest->taken = instructionDisasm->instructionInfo->cycles;
+
+    return 1;
+}
+
 int a8051_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags) {
     struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
     return snprintf(dest, size, A8051_FORMAT_ADDRESS_LABEL("%0*x"), A8051_ADDRESS_WIDTH, instructionDisasm->address);
 }
 
+/* Address of the label that get_str_operand() prints for operand index in
+ * assembly, kept in step with its cases */
+int a8051_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest) {
+    struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return 0;
+
+    switch (instructionDisasm->instructionInfo->operandTypes[index]) {
+        case OPERAND_ADDR_11:
+        case OPERAND_ADDR_16:
+            *dest = instructionDisasm->operandDisasms[index];
+            return 1;
+        case OPERAND_ADDR_RELATIVE:
+            *dest = instructionDisasm->operandDisasms[index] + instructionDisasm->address + instructionDisasm->instructionInfo->width;
+            return 1;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
 int a8051_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags) {
     struct a8051InstructionDisasm *instructionDisasm = (struct a8051InstructionDisasm *)instr->data;
     return snprintf(dest, size, A8051_FORMAT_ADDRESS("%*x"), A8051_ADDRESS_WIDTH, instructionDisasm->address);
@@ -248,6 +407,20 @@ unsigned int a8051_directive_get_num_operands(struct instruction *instr) {
     return 0;
 }
 
+int a8051_directive_get_operand_kind(struct instruction *instr, int index) {
+    struct a8051Directive *directive = (struct a8051Directive *)instr->data;
+    if (strcmp(directive->name, A8051_DIRECTIVE_NAME_ORIGIN) == 0 && index == 0)
+        return OPERAND_KIND_PROG_ADDRESS;
+    return OPERAND_KIND_NONE;
+}
+
+int32_t a8051_directive_get_operand_value(struct instruction *instr, int index) {
+    struct a8051Directive *directive = (struct a8051Directive *)instr->data;
+    if (strcmp(directive->name, A8051_DIRECTIVE_NAME_ORIGIN) == 0 && index == 0)
+        return directive->value;
+    return 0;
+}
+
 int a8051_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags) {
     struct a8051Directive *directive = (struct a8051Directive *)instr->data;
     return snprintf(dest, size, "%s", directive->name);
@@ -267,3 +440,13 @@ void a8051_directive_free(struct instruction *instr) {
     instr->data = NULL;
 }
 
+/******************************************************************************/
+/* 8051 Instruction Set Table */
+/******************************************************************************/
+
+const char *a8051_isa_mnemonic(unsigned int index) {
+    if (index >= A8051_TOTAL_INSTRUCTIONS)
+        return NULL;
+    return A8051_Instruction_Set[index].mnemonic;
+}
+
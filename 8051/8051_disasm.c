@@ -18,7 +18,14 @@ extern uint32_t a8051_instruction_get_address(struct instruction *instr);
 extern unsigned int a8051_instruction_get_width(struct instruction *instr);
 extern unsigned int a8051_instruction_get_num_operands(struct instruction *instr);
 extern unsigned int a8051_instruction_get_opcodes(struct instruction *instr, uint8_t *dest);
+extern int a8051_instruction_get_operand_kind(struct instruction *instr, int index);
+extern int32_t a8051_instruction_get_operand_value(struct instruction *instr, int index);
+extern int a8051_instruction_get_branch_target(struct instruction *instr, uint32_t *dest);
+extern int a8051_instruction_get_flow(struct instruction *instr);
+extern int a8051_instruction_get_isa_index(struct instruction *instr);
+extern int a8051_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest);
 extern int a8051_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags);
+extern int a8051_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest);
 extern int a8051_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags);
 extern int a8051_instruction_get_str_opcodes(struct instruction *instr, char *dest, int size, int flags);
 extern int a8051_instruction_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
@@ -27,6 +34,8 @@ extern int a8051_instruction_get_str_comment(struct instruction *instr, char *de
 extern void a8051_instruction_free(struct instruction *instr);
 
 extern unsigned int a8051_directive_get_num_operands(struct instruction *instr);
+extern int a8051_directive_get_operand_kind(struct instruction *instr, int index);
+extern int32_t a8051_directive_get_operand_value(struct instruction *instr, int index);
 extern int a8051_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
 extern int a8051_directive_get_str_operand(struct instruction *instr, char *dest, int size, int index, int flags);
 extern void a8051_directive_free(struct instruction *instr);
@@ -88,11 +97,11 @@ int disasmstream_8051_close(struct DisasmStream *self) {
 /******************************************************************************/
 
 static int util_disasm_directive(struct instruction *instr, char *name, uint32_t value);
-static int util_disasm_instruction(struct instruction *instr, struct a8051InstructionInfo *instructionInfo, struct disasmstream_8051_state *state);
+static int util_disasm_instruction(struct instruction *instr, const struct a8051InstructionInfo *instructionInfo, struct disasmstream_8051_state *state);
 static void util_disasm_operands(struct a8051InstructionDisasm *instructionDisasm);
 static void util_opbuffer_shift(struct disasmstream_8051_state *state, int n);
 static int util_opbuffer_len_consecutive(struct disasmstream_8051_state *state);
-static struct a8051InstructionInfo *util_iset_lookup_by_opcode(uint8_t opcode);
+static const struct a8051InstructionInfo *util_iset_lookup_by_opcode(uint8_t opcode);
 
 int disasmstream_8051_read(struct DisasmStream *self, struct instruction *instr) {
     struct disasmstream_8051_state *state = (struct disasmstream_8051_state *)self->state;
@@ -137,7 +146,7 @@ int disasmstream_8051_read(struct DisasmStream *self, struct instruction *instr)
         }
 
         if (lenConsecutive > 0) {
-            struct a8051InstructionInfo *instructionInfo;
+            const struct a8051InstructionInfo *instructionInfo;
 
             if ((instructionInfo = util_iset_lookup_by_opcode(state->data[0])) == NULL) {
                 /* This should never happen because the 8051 instruction set
@@ -230,6 +239,8 @@ static int util_disasm_directive(struct instruction *instr, char *name, uint32_t
     instr->data = directive;
     instr->type = DISASM_TYPE_DIRECTIVE;
     instr->get_num_operands = a8051_directive_get_num_operands;
+    instr->get_operand_kind = a8051_directive_get_operand_kind;
+    instr->get_operand_value = a8051_directive_get_operand_value;
     instr->get_str_mnemonic = a8051_directive_get_str_mnemonic;
     instr->get_str_operand = a8051_directive_get_str_operand;
     instr->free = a8051_directive_free;
@@ -237,7 +248,7 @@ static int util_disasm_directive(struct instruction *instr, char *name, uint32_t
     return 0;
 }
 
-static int util_disasm_instruction(struct instruction *instr, struct a8051InstructionInfo *instructionInfo, struct disasmstream_8051_state *state) {
+static int util_disasm_instruction(struct instruction *instr, const struct a8051InstructionInfo *instructionInfo, struct disasmstream_8051_state *state) {
     struct a8051InstructionDisasm *instructionDisasm;
     int i;
 
@@ -264,7 +275,14 @@ static int util_disasm_instruction(struct instruction *instr, struct a8051Instru
     instr->get_width = a8051_instruction_get_width;
     instr->get_num_operands = a8051_instruction_get_num_operands;
     instr->get_opcodes = a8051_instruction_get_opcodes;
+    instr->get_operand_kind = a8051_instruction_get_operand_kind;
+    instr->get_operand_value = a8051_instruction_get_operand_value;
+    instr->get_branch_target = a8051_instruction_get_branch_target;
+    instr->get_flow = a8051_instruction_get_flow;
+    instr->get_isa_index = a8051_instruction_get_isa_index;
+    instr->get_cycles = a8051_instruction_get_cycles;
     instr->get_str_address_label = a8051_instruction_get_str_address_label;
+    instr->get_label_target = a8051_instruction_get_label_target;
     instr->get_str_address = a8051_instruction_get_str_address;
     instr->get_str_opcodes = a8051_instruction_get_str_opcodes;
     instr->get_str_mnemonic = a8051_instruction_get_str_mnemonic;
@@ -279,7 +297,7 @@ static int util_disasm_instruction(struct instruction *instr, struct a8051Instru
 }
 
 static void util_disasm_operands(struct a8051InstructionDisasm *instructionDisasm) {
-    struct a8051InstructionInfo *instructionInfo = instructionDisasm->instructionInfo;
+    const struct a8051InstructionInfo *instructionInfo = instructionDisasm->instructionInfo;
     int i, encodedIndex;
 
     /* Index of encoded operands into opcode array */
@@ -383,7 +401,39 @@ static int util_opbuffer_len_consecutive(struct disasmstream_8051_state *state)
     return lenConsecutive;
 }
 
-static struct a8051InstructionInfo *util_iset_lookup_by_opcode(uint8_t opcode) {
+static const struct a8051InstructionInfo *util_iset_lookup_by_opcode(uint8_t opcode) {
     return &A8051_Instruction_Set[opcode];
 }
 
+/******************************************************************************/
+/* 8051 Instruction Set Table Support */
+/******************************************************************************/
+
+unsigned int a8051_isa_width(uint8_t opcode) {
+    return util_iset_lookup_by_opcode(opcode)->width;
+}
+
+/******************************************************************************/
+/* 8051 Raw Data Support */
+/******************************************************************************/
+
+int a8051_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address) {
+    struct disasmstream_8051_state state;
+
+    /* Load a byte into an opcode buffer */
+    memset(&state, 0, sizeof(state));
+    state.data[0] = data[0];
+    state.address[0] = address;
+    state.len = 1;
+
+    memset(instr, 0, sizeof(struct instruction));
+    if (util_disasm_instruction(instr, &A8051_Instruction_Set[A8051_ISET_INDEX_BYTE], &state) < 0)
+        return -1;
+
+    return 1;
+}
+
+int a8051_disasm_origin(struct instruction *instr, uint32_t address) {
+    memset(instr, 0, sizeof(struct instruction));
+    return util_disasm_directive(instr, A8051_DIRECTIVE_NAME_ORIGIN, address);
+}
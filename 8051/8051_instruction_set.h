@@ -31,13 +31,15 @@ struct a8051InstructionInfo {
     unsigned int width;
     int numOperands;
     int operandTypes[3];
+    /* Machine cycles of twelve clocks on the standard core, 0 if unknown */
+    unsigned int cycles;
 };
 
 /* Structure for a disassembled instruction */
 struct a8051InstructionDisasm {
     uint32_t address;
     uint8_t opcode[3];
-    struct a8051InstructionInfo *instructionInfo;
+    const struct a8051InstructionInfo *instructionInfo;
     int32_t operandDisasms[3];
 };
 
@@ -47,8 +49,8 @@ struct a8051Directive {
     uint32_t value;
 };
 
-extern struct a8051InstructionInfo A8051_Instruction_Set[];
-extern int A8051_TOTAL_INSTRUCTIONS;
+extern const struct a8051InstructionInfo A8051_Instruction_Set[];
+extern const int A8051_TOTAL_INSTRUCTIONS;
 
 #endif
 
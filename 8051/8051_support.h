@@ -1,6 +1,7 @@
 #ifndef A8051_SUPPORT_H
 #define A8051_SUPPORT_H
 
+#include <stdint.h>
 #include <disasmstream.h>
 #include <instruction.h>
 
@@ -9,5 +10,17 @@ int disasmstream_8051_init(struct DisasmStream *self);
 int disasmstream_8051_close(struct DisasmStream *self);
 int disasmstream_8051_read(struct DisasmStream *self, struct instruction *instr);
 
+/* 8051 Instruction Set Table Support */
+const char *a8051_isa_mnemonic(unsigned int index);
+/* Width in bytes of the instruction with the opcode byte opcode */
+unsigned int a8051_isa_width(uint8_t opcode);
+
+/* 8051 Raw Data Support, for streams that decode bytes out of input order */
+/* Raw .db byte "instruction" of the first of len bytes at data, loaded at
+ * address. Returns the number of bytes used, or -1 on allocation failure. */
+int a8051_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address);
+/* Origin directive for address, returns 0, or -1 on allocation failure */
+int a8051_disasm_origin(struct instruction *instr, uint32_t address);
+
 #endif
 
@@ -166,7 +166,7 @@ static int test_disasm_8051_unit_test_run(char *name, uint8_t *test_data, uint32
     return -1;
 }
 
-static struct a8051InstructionInfo *util_iset_lookup_by_mnemonic(char *mnemonic) {
+static const struct a8051InstructionInfo *util_iset_lookup_by_mnemonic(char *mnemonic) {
     int i;
 
     for (i = 0; i < A8051_TOTAL_INSTRUCTIONS; i++) {
@@ -180,7 +180,7 @@ static struct a8051InstructionInfo *util_iset_lookup_by_mnemonic(char *mnemonic)
     return &A8051_Instruction_Set[A8051_ISET_INDEX_BYTE];
 }
 
-static struct a8051InstructionInfo *util_iset_lookup_by_opcode(uint8_t opcode) {
+static const struct a8051InstructionInfo *util_iset_lookup_by_opcode(uint8_t opcode) {
     return &A8051_Instruction_Set[opcode];
 }
 
@@ -192,8 +192,8 @@ static struct a8051InstructionInfo *util_iset_lookup_by_opcode(uint8_t opcode) {
 int test_disasm_8051_unit_tests(void) {
     int numTests = 0, passedTests = 0;
     int i;
-    struct a8051InstructionInfo *(*lookup)(char *) = util_iset_lookup_by_mnemonic;
-    struct a8051InstructionInfo *(*lookup_opcode)(uint8_t) = util_iset_lookup_by_opcode;
+    const struct a8051InstructionInfo *(*lookup)(char *) = util_iset_lookup_by_mnemonic;
+    const struct a8051InstructionInfo *(*lookup_opcode)(uint8_t) = util_iset_lookup_by_opcode;
 
     /* Check Sample Program */
     /* org 000h; nop; inc A; dec 023h; inc @R0; dec @R1; inc R5; label1: add A,
@@ -32,7 +32,14 @@ uint32_t avr_instruction_get_address(struct instruction *instr);
 unsigned int avr_instruction_get_width(struct instruction *instr);
 unsigned int avr_instruction_get_num_operands(struct instruction *instr);
 unsigned int avr_instruction_get_opcodes(struct instruction *instr, uint8_t *dest);
+int avr_instruction_get_operand_kind(struct instruction *instr, int index);
+int32_t avr_instruction_get_operand_value(struct instruction *instr, int index);
+int avr_instruction_get_branch_target(struct instruction *instr, uint32_t *dest);
+int avr_instruction_get_flow(struct instruction *instr);
+int avr_instruction_get_isa_index(struct instruction *instr);
+int avr_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest);
 int avr_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags);
+int avr_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest);
 int avr_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags);
 int avr_instruction_get_str_opcodes(struct instruction *instr, char *dest, int size, int flags);
 int avr_instruction_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
@@ -42,6 +49,8 @@ void avr_instruction_free(struct instruction *instr);
 
 /* AVR Directive Accessor Functions */
 unsigned int avr_directive_get_num_operands(struct instruction *instr);
+int avr_directive_get_operand_kind(struct instruction *instr, int index);
+int32_t avr_directive_get_operand_value(struct instruction *instr, int index);
 int avr_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
 int avr_directive_get_str_operand(struct instruction *instr, char *dest, int size, int index, int flags);
 void avr_directive_free(struct instruction *instr);
@@ -75,11 +84,169 @@ unsigned int avr_instruction_get_opcodes(struct instruction *instr, uint8_t *des
     return instructionDisasm->instructionInfo->width;
 }
 
+int avr_instruction_get_operand_kind(struct instruction *instr, int index) {
+    struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return OPERAND_KIND_NONE;
+
+    switch (instructionDisasm->instructionInfo->operandTypes[index]) {
+        case OPERAND_REGISTER:
+        case OPERAND_REGISTER_STARTR16:
+        case OPERAND_REGISTER_EVEN_PAIR:
+        case OPERAND_REGISTER_EVEN_PAIR_STARTR24:
+            return OPERAND_KIND_REGISTER;
+        case OPERAND_IO_REGISTER:
+            return OPERAND_KIND_IO_REGISTER;
+        case OPERAND_DATA:
+        case OPERAND_DES_ROUND:
+            return OPERAND_KIND_DATA;
+        case OPERAND_BIT:
+            return OPERAND_KIND_BIT;
+        case OPERAND_X: case OPERAND_XP: case OPERAND_MX:
+        case OPERAND_Y: case OPERAND_YP: case OPERAND_MY: case OPERAND_YPQ:
+        case OPERAND_Z: case OPERAND_ZP: case OPERAND_MZ: case OPERAND_ZPQ:
+            return OPERAND_KIND_INDIRECT;
+        case OPERAND_LONG_ABSOLUTE_ADDRESS:
+            /* lds / sts address data memory, call / jmp program memory */
+            if (instructionDisasm->instructionInfo->numOperands == 2)
+                return OPERAND_KIND_DATA_ADDRESS;
+            return OPERAND_KIND_PROG_ADDRESS;
+        case OPERAND_BRANCH_ADDRESS:
+        case OPERAND_RELATIVE_ADDRESS:
+            return OPERAND_KIND_RELATIVE_ADDRESS;
+        case OPERAND_RAW_WORD:
+        case OPERAND_RAW_BYTE:
+            return OPERAND_KIND_RAW;
+        default:
+            break;
+    }
+
+    return OPERAND_KIND_NONE;
+}
+
+int32_t avr_instruction_get_operand_value(struct instruction *instr, int index) {
+    struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return 0;
+
+    /* Undo the byte address scaling for lds / sts data addresses */
+    if (avr_instruction_get_operand_kind(instr, index) == OPERAND_KIND_DATA_ADDRESS)
+        return instructionDisasm->operandDisasms[index] / 2;
+
+    return instructionDisasm->operandDisasms[index];
+}
+
+int avr_instruction_get_branch_target(struct instruction *instr, uint32_t *dest) {
+    struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
+    int i;
+
+    for (i = 0; i < instructionDisasm->instructionInfo->numOperands; i++) {
+        switch (avr_instruction_get_operand_kind(instr, i)) {
+            case OPERAND_KIND_RELATIVE_ADDRESS:
+                *dest = instructionDisasm->operandDisasms[i] + instructionDisasm->address + 2;
+                return 1;
+            case OPERAND_KIND_PROG_ADDRESS:
+                *dest = instructionDisasm->operandDisasms[i];
+                return 1;
+            default:
+                break;
+        }
+    }
+
+    return 0;
+}
+
+/* Instructions that change the control flow, other than the conditional
+ * branches, which all take a branch address operand */
+static const struct {
+    const char *mnemonic;
+    int flow;
+} AVR_Flow_Table[] = {
+    {"rjmp", FLOW_JUMP}, {"jmp", FLOW_JUMP},
+    {"rcall", FLOW_CALL}, {"call", FLOW_CALL},
+    {"ijmp", FLOW_INDIRECT_JUMP}, {"eijmp", FLOW_INDIRECT_JUMP},
+    {"icall", FLOW_INDIRECT_CALL}, {"eicall", FLOW_INDIRECT_CALL},
+    {"ret", FLOW_RETURN}, {"reti", FLOW_RETURN},
+    {"cpse", FLOW_SKIP}, {"sbrc", FLOW_SKIP}, {"sbrs", FLOW_SKIP}, {"sbic", FLOW_SKIP}, {"sbis", FLOW_SKIP},
+};
+
+int avr_instruction_get_flow(struct instruction *instr) {
+    struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
+    const struct avrInstructionInfo *instructionInfo = instructionDisasm->instructionInfo;
+    int i;
+
+    for (i = 0; i < instructionInfo->numOperands; i++) {
+        switch (instructionInfo->operandTypes[i]) {
+            case OPERAND_RAW_WORD:
+            case OPERAND_RAW_BYTE:
+                return FLOW_INVALID;
+            case OPERAND_BRANCH_ADDRESS:
+                return FLOW_BRANCH;
+            default:
+                break;
+        }
+    }
+
+    for (i = 0; i < sizeof(AVR_Flow_Table)/sizeof(AVR_Flow_Table[0]); i++) {
+        if (strcmp(instructionInfo->mnemonic, AVR_Flow_Table[i].mnemonic) == 0)
+            return AVR_Flow_Table[i].flow;
+    }
+
+    return FLOW_NEXT;
+}
+
+int avr_instruction_get_isa_index(struct instruction *instr) {
+    struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
+    return instructionDisasm->instructionInfo - AVR_Instruction_Set;
+}
+
+int avr_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest) {
+    struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
+    int flow;
+
+    if (variant < 0 || variant >= AVR_TOTAL_CORES || instructionDisasm->instructionInfo->cycles[variant] == 0)
+        return 0;
+
+    dest->next = dest->taken = instructionDisasm->instructionInfo->cycles[variant];
+
+    /* A taken branch or a skip costs one more cycle */
+    flow = avr_instruction_get_flow(instr);
+    if (flow == FLOW_BRANCH || flow == FLOW_SKIP)
+        dest->taken++;
+
+    return 1;
+}
+
 int avr_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags) {
     struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
     return snprintf(dest, size, AVR_FORMAT_ADDRESS_LABEL("%0*x"), AVR_ADDRESS_WIDTH, instructionDisasm->address);
 }
 
+/* Address of the label that get_str_operand() prints for operand index in
+ * assembly, kept in step with its cases */
+int avr_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest) {
+    struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return 0;
+
+    switch (instructionDisasm->instructionInfo->operandTypes[index]) {
+        case OPERAND_LONG_ABSOLUTE_ADDRESS:
+            *dest = instructionDisasm->operandDisasms[index];
+            return 1;
+        case OPERAND_BRANCH_ADDRESS:
+        case OPERAND_RELATIVE_ADDRESS:
+            *dest = instructionDisasm->operandDisasms[index] + instructionDisasm->address + 2;
+            return 1;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
 int avr_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags) {
     struct avrInstructionDisasm *instructionDisasm = (struct avrInstructionDisasm *)instr->data;
     return snprintf(dest, size, AVR_FORMAT_ADDRESS("%*x"), AVR_ADDRESS_WIDTH, instructionDisasm->address);
@@ -231,6 +398,20 @@ unsigned int avr_directive_get_num_operands(struct instruction *instr) {
     return 0;
 }
 
+int avr_directive_get_operand_kind(struct instruction *instr, int index) {
+    struct avrDirective *directive = (struct avrDirective *)instr->data;
+    if (strcmp(directive->name, AVR_DIRECTIVE_NAME_ORIGIN) == 0 && index == 0)
+        return OPERAND_KIND_PROG_ADDRESS;
+    return OPERAND_KIND_NONE;
+}
+
+int32_t avr_directive_get_operand_value(struct instruction *instr, int index) {
+    struct avrDirective *directive = (struct avrDirective *)instr->data;
+    if (strcmp(directive->name, AVR_DIRECTIVE_NAME_ORIGIN) == 0 && index == 0)
+        return directive->value;
+    return 0;
+}
+
 int avr_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags) {
     struct avrDirective *directive = (struct avrDirective *)instr->data;
     return snprintf(dest, size, "%s", directive->name);
@@ -250,3 +431,13 @@ void avr_directive_free(struct instruction *instr) {
     instr->data = NULL;
 }
 
+/******************************************************************************/
+/* AVR Instruction Set Table */
+/******************************************************************************/
+
+const char *avr_isa_mnemonic(unsigned int index) {
+    if (index >= AVR_TOTAL_INSTRUCTIONS)
+        return NULL;
+    return AVR_Instruction_Set[index].mnemonic;
+}
+
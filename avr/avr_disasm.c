@@ -18,7 +18,14 @@ extern uint32_t avr_instruction_get_address(struct instruction *instr);
 extern unsigned int avr_instruction_get_width(struct instruction *instr);
 extern unsigned int avr_instruction_get_num_operands(struct instruction *instr);
 extern unsigned int avr_instruction_get_opcodes(struct instruction *instr, uint8_t *dest);
+extern int avr_instruction_get_operand_kind(struct instruction *instr, int index);
+extern int32_t avr_instruction_get_operand_value(struct instruction *instr, int index);
+extern int avr_instruction_get_branch_target(struct instruction *instr, uint32_t *dest);
+extern int avr_instruction_get_flow(struct instruction *instr);
+extern int avr_instruction_get_isa_index(struct instruction *instr);
+extern int avr_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest);
 extern int avr_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags);
+extern int avr_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest);
 extern int avr_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags);
 extern int avr_instruction_get_str_opcodes(struct instruction *instr, char *dest, int size, int flags);
 extern int avr_instruction_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
@@ -27,6 +34,8 @@ extern int avr_instruction_get_str_comment(struct instruction *instr, char *dest
 extern void avr_instruction_free(struct instruction *instr);
 
 extern unsigned int avr_directive_get_num_operands(struct instruction *instr);
+extern int avr_directive_get_operand_kind(struct instruction *instr, int index);
+extern int32_t avr_directive_get_operand_value(struct instruction *instr, int index);
 extern int avr_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
 extern int avr_directive_get_str_operand(struct instruction *instr, char *dest, int size, int index, int flags);
 extern void avr_directive_free(struct instruction *instr);
@@ -87,12 +96,12 @@ int disasmstream_avr_close(struct DisasmStream *self) {
 /******************************************************************************/
 
 static int util_disasm_directive(struct instruction *instr, char *name, uint32_t value);
-static int util_disasm_instruction(struct instruction *instr, struct avrInstructionInfo *instructionInfo, struct disasmstream_avr_state *state);
+static int util_disasm_instruction(struct instruction *instr, const struct avrInstructionInfo *instructionInfo, struct disasmstream_avr_state *state);
 static void util_disasm_operands(struct avrInstructionDisasm *instructionDisasm);
-static int32_t util_disasm_operand(struct avrInstructionInfo *instructionInfo, uint32_t operand, int index);
+static int32_t util_disasm_operand(const struct avrInstructionInfo *instructionInfo, uint32_t operand, int index);
 static void util_opbuffer_shift(struct disasmstream_avr_state *state, int n);
 static int util_opbuffer_len_consecutive(struct disasmstream_avr_state *state);
-static struct avrInstructionInfo *util_iset_lookup_by_opcode(uint16_t opcode);
+static const struct avrInstructionInfo *util_iset_lookup_by_opcode(uint16_t opcode);
 static int util_bits_data_from_mask(uint16_t data, uint16_t mask);
 
 int disasmstream_avr_read(struct DisasmStream *self, struct instruction *instr) {
@@ -137,7 +146,7 @@ int disasmstream_avr_read(struct DisasmStream *self, struct instruction *instr)
 
         /* Two or more consecutive bytes */
         if (lenConsecutive >= 2) {
-            struct avrInstructionInfo *instructionInfo;
+            const struct avrInstructionInfo *instructionInfo;
             uint16_t opcode;
 
             /* Assemble the 16-bit opcode from little-endian input */
@@ -239,6 +248,8 @@ static int util_disasm_directive(struct instruction *instr, char *name, uint32_t
     instr->data = directive;
     instr->type = DISASM_TYPE_DIRECTIVE;
     instr->get_num_operands = avr_directive_get_num_operands;
+    instr->get_operand_kind = avr_directive_get_operand_kind;
+    instr->get_operand_value = avr_directive_get_operand_value;
     instr->get_str_mnemonic = avr_directive_get_str_mnemonic;
     instr->get_str_operand = avr_directive_get_str_operand;
     instr->free = avr_directive_free;
@@ -246,7 +257,7 @@ static int util_disasm_directive(struct instruction *instr, char *name, uint32_t
     return 0;
 }
 
-static int util_disasm_instruction(struct instruction *instr, struct avrInstructionInfo *instructionInfo, struct disasmstream_avr_state *state) {
+static int util_disasm_instruction(struct instruction *instr, const struct avrInstructionInfo *instructionInfo, struct disasmstream_avr_state *state) {
     struct avrInstructionDisasm *instructionDisasm;
     int i;
 
@@ -273,7 +284,14 @@ static int util_disasm_instruction(struct instruction *instr, struct avrInstruct
     instr->get_width = avr_instruction_get_width;
     instr->get_num_operands = avr_instruction_get_num_operands;
     instr->get_opcodes = avr_instruction_get_opcodes;
+    instr->get_operand_kind = avr_instruction_get_operand_kind;
+    instr->get_operand_value = avr_instruction_get_operand_value;
+    instr->get_branch_target = avr_instruction_get_branch_target;
+    instr->get_flow = avr_instruction_get_flow;
+    instr->get_isa_index = avr_instruction_get_isa_index;
+    instr->get_cycles = avr_instruction_get_cycles;
     instr->get_str_address_label = avr_instruction_get_str_address_label;
+    instr->get_label_target = avr_instruction_get_label_target;
     instr->get_str_address = avr_instruction_get_str_address;
     instr->get_str_opcodes = avr_instruction_get_str_opcodes;
     instr->get_str_mnemonic = avr_instruction_get_str_mnemonic;
@@ -288,7 +306,7 @@ static int util_disasm_instruction(struct instruction *instr, struct avrInstruct
 }
 
 static void util_disasm_operands(struct avrInstructionDisasm *instructionDisasm) {
-    struct avrInstructionInfo *instructionInfo = instructionDisasm->instructionInfo;
+    const struct avrInstructionInfo *instructionInfo = instructionDisasm->instructionInfo;
     int i;
     uint16_t opcode;
     uint32_t operand;
@@ -309,7 +327,7 @@ static void util_disasm_operands(struct avrInstructionDisasm *instructionDisasm)
     }
 }
 
-static int32_t util_disasm_operand(struct avrInstructionInfo *instructionInfo, uint32_t operand, int index) {
+static int32_t util_disasm_operand(const struct avrInstructionInfo *instructionInfo, uint32_t operand, int index) {
     int32_t operandDisasm;
 
     switch (instructionInfo->operandTypes[index]) {
@@ -399,7 +417,7 @@ static int util_opbuffer_len_consecutive(struct disasmstream_avr_state *state) {
     return lenConsecutive;
 }
 
-static struct avrInstructionInfo *util_iset_lookup_by_opcode(uint16_t opcode) {
+static const struct avrInstructionInfo *util_iset_lookup_by_opcode(uint16_t opcode) {
     int i, j;
 
     uint16_t instructionBits;
@@ -439,3 +457,41 @@ static int util_bits_data_from_mask(uint16_t data, uint16_t mask) {
     return result;
 }
 
+/******************************************************************************/
+/* AVR Instruction Set Table Support */
+/******************************************************************************/
+
+unsigned int avr_isa_width(uint16_t opcode) {
+    const struct avrInstructionInfo *instructionInfo;
+
+    instructionInfo = util_iset_lookup_by_opcode(opcode);
+    return (instructionInfo != NULL) ? instructionInfo->width : 2;
+}
+
+/******************************************************************************/
+/* AVR Raw Data Support */
+/******************************************************************************/
+
+int avr_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address) {
+    struct disasmstream_avr_state state;
+    unsigned int i;
+
+    /* Load a word, or a lone byte, into an opcode buffer */
+    memset(&state, 0, sizeof(state));
+    state.len = (len >= 2) ? 2 : 1;
+    for (i = 0; i < state.len; i++) {
+        state.data[i] = data[i];
+        state.address[i] = address + i;
+    }
+
+    memset(instr, 0, sizeof(struct instruction));
+    if (util_disasm_instruction(instr, &AVR_Instruction_Set[(len >= 2) ? AVR_ISET_INDEX_WORD : AVR_ISET_INDEX_BYTE], &state) < 0)
+        return -1;
+
+    return (len >= 2) ? 2 : 1;
+}
+
+int avr_disasm_origin(struct instruction *instr, uint32_t address) {
+    memset(instr, 0, sizeof(struct instruction));
+    return util_disasm_directive(instr, AVR_DIRECTIVE_NAME_ORIGIN, address);
+}
@@ -15,155 +15,155 @@
  *      This one is indistinguishable from andi.
  */
 
-struct avrInstructionInfo AVR_Instruction_Set[] = {
-    {"break", 2, 0x9598, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"clc", 2, 0x9488, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"clh", 2, 0x94d8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"cli", 2, 0x94f8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"cln", 2, 0x94a8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"cls", 2, 0x94c8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"clt", 2, 0x94e8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"clv", 2, 0x94b8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"clz", 2, 0x9498, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"eicall", 2, 0x9519, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"eijmp", 2, 0x9419, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"elpm", 2, 0x95d8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"icall", 2, 0x9509, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"ijmp", 2, 0x9409, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"lpm", 2, 0x95c8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"nop", 2, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"ret", 2, 0x9508, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"reti", 2, 0x9518, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"sec", 2, 0x9408, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"seh", 2, 0x9458, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"sei", 2, 0x9478, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"sen", 2, 0x9428, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"ses", 2, 0x9448, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"set", 2, 0x9468, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"sev", 2, 0x9438, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"sez", 2, 0x9418, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"sleep", 2, 0x9588, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"spm", 2, 0x95e8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"wdr", 2, 0x95a8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}},
-    {"spm", 2, 0x95f8, 1, {0}, {OPERAND_ZP, OPERAND_NONE}},
-    {"des", 2, 0x940b, 1, {0x00f0}, {OPERAND_DES_ROUND, OPERAND_NONE}},
-    {"asr", 2, 0x9405, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"bclr", 2, 0x9488, 1, {0x0070}, {OPERAND_BIT, OPERAND_NONE}},
-    {"brcc", 2, 0xf400, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brcs", 2, 0xf000, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"breq", 2, 0xf001, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brge", 2, 0xf404, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brhc", 2, 0xf405, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brhs", 2, 0xf005, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brid", 2, 0xf407, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brie", 2, 0xf007, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brlo", 2, 0xf000, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brlt", 2, 0xf004, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brmi", 2, 0xf002, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brne", 2, 0xf401, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brpl", 2, 0xf402, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brsh", 2, 0xf400, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brtc", 2, 0xf406, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brts", 2, 0xf006, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brvc", 2, 0xf403, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"brvs", 2, 0xf003, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}},
-    {"bset", 2, 0x9408, 1, {0x0070}, {OPERAND_BIT, OPERAND_NONE}},
-    {"call", 4, 0x940e, 1, {0x01f1}, {OPERAND_LONG_ABSOLUTE_ADDRESS, OPERAND_NONE}},
+const struct avrInstructionInfo AVR_Instruction_Set[] = {
+    {"break", 2, 0x9598, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"clc", 2, 0x9488, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"clh", 2, 0x94d8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"cli", 2, 0x94f8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"cln", 2, 0x94a8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"cls", 2, 0x94c8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"clt", 2, 0x94e8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"clv", 2, 0x94b8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"clz", 2, 0x9498, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"eicall", 2, 0x9519, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {4, 3, 3, 0}},
+    {"eijmp", 2, 0x9419, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {2, 2, 2, 0}},
+    {"elpm", 2, 0x95d8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {3, 3, 3, 0}},
+    {"icall", 2, 0x9509, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {3, 2, 2, 3}},
+    {"ijmp", 2, 0x9409, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {2, 2, 2, 2}},
+    {"lpm", 2, 0x95c8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {3, 3, 3, 0}},
+    {"nop", 2, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"ret", 2, 0x9508, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {4, 4, 4, 6}},
+    {"reti", 2, 0x9518, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {4, 4, 4, 6}},
+    {"sec", 2, 0x9408, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"seh", 2, 0x9458, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"sei", 2, 0x9478, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"sen", 2, 0x9428, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"ses", 2, 0x9448, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"set", 2, 0x9468, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"sev", 2, 0x9438, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"sez", 2, 0x9418, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"sleep", 2, 0x9588, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"spm", 2, 0x95e8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {0, 0, 0, 0}},
+    {"wdr", 2, 0x95a8, 0, {0}, {OPERAND_NONE, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"spm", 2, 0x95f8, 1, {0}, {OPERAND_ZP, OPERAND_NONE}, {0, 0, 0, 0}},
+    {"des", 2, 0x940b, 1, {0x00f0}, {OPERAND_DES_ROUND, OPERAND_NONE}, {0, 1, 0, 0}},
+    {"asr", 2, 0x9405, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"bclr", 2, 0x9488, 1, {0x0070}, {OPERAND_BIT, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brcc", 2, 0xf400, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brcs", 2, 0xf000, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"breq", 2, 0xf001, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brge", 2, 0xf404, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brhc", 2, 0xf405, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brhs", 2, 0xf005, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brid", 2, 0xf407, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brie", 2, 0xf007, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brlo", 2, 0xf000, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brlt", 2, 0xf004, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brmi", 2, 0xf002, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brne", 2, 0xf401, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brpl", 2, 0xf402, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brsh", 2, 0xf400, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brtc", 2, 0xf406, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brts", 2, 0xf006, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brvc", 2, 0xf403, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"brvs", 2, 0xf003, 1, {0x03f8}, {OPERAND_BRANCH_ADDRESS, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"bset", 2, 0x9408, 1, {0x0070}, {OPERAND_BIT, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"call", 4, 0x940e, 1, {0x01f1}, {OPERAND_LONG_ABSOLUTE_ADDRESS, OPERAND_NONE}, {4, 3, 3, 0}},
 //    {"clr", 2, 0x2400, 1, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER_GHOST}},
-    {"com", 2, 0x9400, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"dec", 2, 0x940a, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"inc", 2, 0x9403, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"jmp", 4, 0x940c, 1, {0x01f1}, {OPERAND_LONG_ABSOLUTE_ADDRESS, OPERAND_NONE}},
-    {"lpm", 2, 0x9004, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_Z}},
-    {"lpm", 2, 0x9005, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_ZP}},
+    {"com", 2, 0x9400, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"dec", 2, 0x940a, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"inc", 2, 0x9403, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"jmp", 4, 0x940c, 1, {0x01f1}, {OPERAND_LONG_ABSOLUTE_ADDRESS, OPERAND_NONE}, {3, 3, 3, 0}},
+    {"lpm", 2, 0x9004, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_Z}, {3, 3, 3, 0}},
+    {"lpm", 2, 0x9005, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_ZP}, {3, 3, 3, 0}},
 //    {"lsl", 2, 0x0c00, 1, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER_GHOST}},
-    {"lsr", 2, 0x9406, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"neg", 2, 0x9401, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"pop", 2, 0x900f, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"xch", 2, 0x9204, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}},
-    {"las", 2, 0x9205, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}},
-    {"lac", 2, 0x9206, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}},
-    {"lat", 2, 0x9207, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}},
-    {"push", 2, 0x920f, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"rcall", 2, 0xd000, 1, {0x0fff}, {OPERAND_RELATIVE_ADDRESS, OPERAND_NONE}},
-    {"rjmp", 2, 0xc000, 1, {0x0fff}, {OPERAND_RELATIVE_ADDRESS, OPERAND_NONE}},
+    {"lsr", 2, 0x9406, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"neg", 2, 0x9401, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"pop", 2, 0x900f, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {2, 2, 2, 3}},
+    {"xch", 2, 0x9204, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}, {0, 2, 0, 0}},
+    {"las", 2, 0x9205, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}, {0, 2, 0, 0}},
+    {"lac", 2, 0x9206, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}, {0, 2, 0, 0}},
+    {"lat", 2, 0x9207, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}, {0, 2, 0, 0}},
+    {"push", 2, 0x920f, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {2, 1, 1, 1}},
+    {"rcall", 2, 0xd000, 1, {0x0fff}, {OPERAND_RELATIVE_ADDRESS, OPERAND_NONE}, {3, 2, 2, 3}},
+    {"rjmp", 2, 0xc000, 1, {0x0fff}, {OPERAND_RELATIVE_ADDRESS, OPERAND_NONE}, {2, 2, 2, 2}},
 //    {"rol", 2, 0x1c00, 1, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER_GHOST}},
-    {"ror", 2, 0x9407, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
-    {"ser", 2, 0xef0f, 1, {0x00f0}, {OPERAND_REGISTER_STARTR16, OPERAND_NONE}},
-    {"swap", 2, 0x9402, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}},
+    {"ror", 2, 0x9407, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"ser", 2, 0xef0f, 1, {0x00f0}, {OPERAND_REGISTER_STARTR16, OPERAND_NONE}, {1, 1, 1, 1}},
+    {"swap", 2, 0x9402, 1, {0x01f0}, {OPERAND_REGISTER, OPERAND_NONE}, {1, 1, 1, 1}},
 //    {"tst", 2, 0x2000, 1, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER_GHOST}},
-    {"adc", 2, 0x1c00, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"add", 2, 0x0c00, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"adiw", 2, 0x9600, 2, {0x0030, 0x00cf}, {OPERAND_REGISTER_EVEN_PAIR_STARTR24, OPERAND_DATA}},
-    {"and", 2, 0x2000, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"andi", 2, 0x7000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {"bld", 2, 0xf800, 2, {0x01f0, 0x0007}, {OPERAND_REGISTER, OPERAND_BIT}},
-    {"brbc", 2, 0xf400, 2, {0x0007, 0x03f8}, {OPERAND_BIT, OPERAND_BRANCH_ADDRESS}},
-    {"brbs", 2, 0xf000, 2, {0x0007, 0x03f8}, {OPERAND_BIT, OPERAND_BRANCH_ADDRESS}},
-    {"bst", 2, 0xfa00, 2, {0x01f0, 0x0007}, {OPERAND_REGISTER, OPERAND_BIT}},
-    {"cbi", 2, 0x9800, 2, {0x00f8, 0x0007}, {OPERAND_IO_REGISTER, OPERAND_BIT}},
+    {"adc", 2, 0x1c00, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"add", 2, 0x0c00, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"adiw", 2, 0x9600, 2, {0x0030, 0x00cf}, {OPERAND_REGISTER_EVEN_PAIR_STARTR24, OPERAND_DATA}, {2, 2, 2, 0}},
+    {"and", 2, 0x2000, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"andi", 2, 0x7000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {1, 1, 1, 1}},
+    {"bld", 2, 0xf800, 2, {0x01f0, 0x0007}, {OPERAND_REGISTER, OPERAND_BIT}, {1, 1, 1, 1}},
+    {"brbc", 2, 0xf400, 2, {0x0007, 0x03f8}, {OPERAND_BIT, OPERAND_BRANCH_ADDRESS}, {1, 1, 1, 1}},
+    {"brbs", 2, 0xf000, 2, {0x0007, 0x03f8}, {OPERAND_BIT, OPERAND_BRANCH_ADDRESS}, {1, 1, 1, 1}},
+    {"bst", 2, 0xfa00, 2, {0x01f0, 0x0007}, {OPERAND_REGISTER, OPERAND_BIT}, {1, 1, 1, 1}},
+    {"cbi", 2, 0x9800, 2, {0x00f8, 0x0007}, {OPERAND_IO_REGISTER, OPERAND_BIT}, {2, 1, 1, 1}},
 //    {"cbr", 2, 0x7000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_COMPLEMENTED_DATA}},
-    {"cp", 2, 0x1400, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"cpc", 2, 0x0400, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"cpi", 2, 0x3000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {"cpse", 2, 0x1000, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"elpm", 2, 0x9006, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_Z}},
-    {"elpm", 2, 0x9007, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_ZP}},
-    {"eor", 2, 0x2400, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"fmul", 2, 0x0308, 2, {0x0070, 0x0007}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}},
-    {"fmuls", 2, 0x0380, 2, {0x0070, 0x0007}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}},
-    {"fmulsu", 2, 0x0388, 2, {0x0070, 0x0007}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}},
-    {"in", 2, 0xb000, 2, {0x01f0, 0x060f}, {OPERAND_REGISTER, OPERAND_DATA}},
-    {"ld", 2, 0x900c, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_X}},
-    {"ld", 2, 0x900d, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_XP}},
-    {"ld", 2, 0x900e, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_MX}},
-    {"ld", 2, 0x8008, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_Y}},
-    {"ld", 2, 0x9009, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_YP}},
-    {"ld", 2, 0x900a, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_MY}},
-    {"ld", 2, 0x8000, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_Z}},
-    {"ld", 2, 0x9001, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_ZP}},
-    {"ld", 2, 0x9002, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_MZ}},
-    {"ldd", 2, 0x8008, 2, {0x01f0, 0x2c07}, {OPERAND_REGISTER, OPERAND_YPQ}},
-    {"ldd", 2, 0x8000, 2, {0x01f0, 0x2c07}, {OPERAND_REGISTER, OPERAND_ZPQ}},
-    {"ldi", 2, 0xe000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {"lds", 4, 0x9000, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_LONG_ABSOLUTE_ADDRESS}},
-    {"lds", 2, 0xA000, 2, {0x00f0, 0x070f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {"mov", 2, 0x2c00, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"movw", 2, 0x0100, 2, {0x00f0, 0x000f}, {OPERAND_REGISTER_EVEN_PAIR, OPERAND_REGISTER_EVEN_PAIR}},
-    {"mul", 2, 0x9c00, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"muls", 2, 0x0200, 2, {0x00f0, 0x000f}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}},
-    {"mulsu", 2, 0x0300, 2, {0x0070, 0x0007}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}},
-    {"or", 2, 0x2800, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"ori", 2, 0x6000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {"out", 2, 0xb800, 2, {0x060f, 0x01f0}, {OPERAND_IO_REGISTER, OPERAND_REGISTER}},
-    {"sbc", 2, 0x0800, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"sbci", 2, 0x4000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {"sbi", 2, 0x9a00, 2, {0x00f8, 0x0007}, {OPERAND_IO_REGISTER, OPERAND_BIT}},
-    {"sbic", 2, 0x9900, 2, {0x00f8, 0x0007}, {OPERAND_IO_REGISTER, OPERAND_BIT}},
-    {"sbis", 2, 0x9b00, 2, {0x00f8, 0x0007}, {OPERAND_IO_REGISTER, OPERAND_BIT}},
-    {"sbiw", 2, 0x9700, 2, {0x0030, 0x00cf}, {OPERAND_REGISTER_EVEN_PAIR_STARTR24, OPERAND_DATA}},
-    {"sbr", 2, 0x6000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {"sbrc", 2, 0xfc00, 2, {0x01f0, 0x0007}, {OPERAND_REGISTER, OPERAND_BIT}},
-    {"sbrs", 2, 0xfe00, 2, {0x01f0, 0x0007}, {OPERAND_REGISTER, OPERAND_BIT}},
-    {"st", 2, 0x920c, 2, {0, 0x01f0}, {OPERAND_X, OPERAND_REGISTER}},
-    {"st", 2, 0x920d, 2, {0, 0x01f0}, {OPERAND_XP, OPERAND_REGISTER}},
-    {"st", 2, 0x920e, 2, {0, 0x01f0}, {OPERAND_MX, OPERAND_REGISTER}},
-    {"st", 2, 0x8208, 2, {0, 0x01f0}, {OPERAND_Y, OPERAND_REGISTER}},
-    {"st", 2, 0x9209, 2, {0, 0x01f0}, {OPERAND_YP, OPERAND_REGISTER}},
-    {"st", 2, 0x920a, 2, {0, 0x01f0}, {OPERAND_MY, OPERAND_REGISTER}},
-    {"st", 2, 0x8200, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}},
-    {"st", 2, 0x9201, 2, {0, 0x01f0}, {OPERAND_ZP, OPERAND_REGISTER}},
-    {"st", 2, 0x9202, 2, {0, 0x01f0}, {OPERAND_MZ, OPERAND_REGISTER}},
-    {"std", 2, 0x8208, 2, {0x2c07, 0x01f0}, {OPERAND_YPQ, OPERAND_REGISTER}},
-    {"std", 2, 0x8200, 2, {0x2c07, 0x01f0}, {OPERAND_ZPQ, OPERAND_REGISTER}},
-    {"sts", 4, 0x9200, 2, {0, 0x01f0}, {OPERAND_LONG_ABSOLUTE_ADDRESS, OPERAND_REGISTER}},
-    {"sts", 2, 0xA800, 2, {0x00f0, 0x070f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {"sub", 2, 0x1800, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}},
-    {"subi", 2, 0x5000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}},
-    {".dw", 2, 0, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE}},
-    {".db", 1, 0, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE}},
+    {"cp", 2, 0x1400, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"cpc", 2, 0x0400, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"cpi", 2, 0x3000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {1, 1, 1, 1}},
+    {"cpse", 2, 0x1000, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"elpm", 2, 0x9006, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_Z}, {3, 3, 3, 0}},
+    {"elpm", 2, 0x9007, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_ZP}, {3, 3, 3, 0}},
+    {"eor", 2, 0x2400, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"fmul", 2, 0x0308, 2, {0x0070, 0x0007}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}, {2, 2, 2, 0}},
+    {"fmuls", 2, 0x0380, 2, {0x0070, 0x0007}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}, {2, 2, 2, 0}},
+    {"fmulsu", 2, 0x0388, 2, {0x0070, 0x0007}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}, {2, 2, 2, 0}},
+    {"in", 2, 0xb000, 2, {0x01f0, 0x060f}, {OPERAND_REGISTER, OPERAND_DATA}, {1, 1, 1, 1}},
+    {"ld", 2, 0x900c, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_X}, {2, 1, 2, 1}},
+    {"ld", 2, 0x900d, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_XP}, {2, 1, 2, 1}},
+    {"ld", 2, 0x900e, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_MX}, {2, 2, 2, 2}},
+    {"ld", 2, 0x8008, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_Y}, {2, 1, 2, 1}},
+    {"ld", 2, 0x9009, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_YP}, {2, 1, 2, 1}},
+    {"ld", 2, 0x900a, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_MY}, {2, 2, 2, 2}},
+    {"ld", 2, 0x8000, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_Z}, {2, 1, 2, 1}},
+    {"ld", 2, 0x9001, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_ZP}, {2, 1, 2, 1}},
+    {"ld", 2, 0x9002, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_MZ}, {2, 2, 2, 2}},
+    {"ldd", 2, 0x8008, 2, {0x01f0, 0x2c07}, {OPERAND_REGISTER, OPERAND_YPQ}, {2, 2, 2, 0}},
+    {"ldd", 2, 0x8000, 2, {0x01f0, 0x2c07}, {OPERAND_REGISTER, OPERAND_ZPQ}, {2, 2, 2, 0}},
+    {"ldi", 2, 0xe000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {1, 1, 1, 1}},
+    {"lds", 4, 0x9000, 2, {0x01f0}, {OPERAND_REGISTER, OPERAND_LONG_ABSOLUTE_ADDRESS}, {2, 2, 3, 0}},
+    {"lds", 2, 0xA000, 2, {0x00f0, 0x070f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {0, 0, 0, 2}},
+    {"mov", 2, 0x2c00, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"movw", 2, 0x0100, 2, {0x00f0, 0x000f}, {OPERAND_REGISTER_EVEN_PAIR, OPERAND_REGISTER_EVEN_PAIR}, {1, 1, 1, 0}},
+    {"mul", 2, 0x9c00, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {2, 2, 2, 0}},
+    {"muls", 2, 0x0200, 2, {0x00f0, 0x000f}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}, {2, 2, 2, 0}},
+    {"mulsu", 2, 0x0300, 2, {0x0070, 0x0007}, {OPERAND_REGISTER_STARTR16, OPERAND_REGISTER_STARTR16}, {2, 2, 2, 0}},
+    {"or", 2, 0x2800, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"ori", 2, 0x6000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {1, 1, 1, 1}},
+    {"out", 2, 0xb800, 2, {0x060f, 0x01f0}, {OPERAND_IO_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"sbc", 2, 0x0800, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"sbci", 2, 0x4000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {1, 1, 1, 1}},
+    {"sbi", 2, 0x9a00, 2, {0x00f8, 0x0007}, {OPERAND_IO_REGISTER, OPERAND_BIT}, {2, 1, 1, 1}},
+    {"sbic", 2, 0x9900, 2, {0x00f8, 0x0007}, {OPERAND_IO_REGISTER, OPERAND_BIT}, {1, 2, 1, 1}},
+    {"sbis", 2, 0x9b00, 2, {0x00f8, 0x0007}, {OPERAND_IO_REGISTER, OPERAND_BIT}, {1, 2, 1, 1}},
+    {"sbiw", 2, 0x9700, 2, {0x0030, 0x00cf}, {OPERAND_REGISTER_EVEN_PAIR_STARTR24, OPERAND_DATA}, {2, 2, 2, 0}},
+    {"sbr", 2, 0x6000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {1, 1, 1, 1}},
+    {"sbrc", 2, 0xfc00, 2, {0x01f0, 0x0007}, {OPERAND_REGISTER, OPERAND_BIT}, {1, 1, 1, 1}},
+    {"sbrs", 2, 0xfe00, 2, {0x01f0, 0x0007}, {OPERAND_REGISTER, OPERAND_BIT}, {1, 1, 1, 1}},
+    {"st", 2, 0x920c, 2, {0, 0x01f0}, {OPERAND_X, OPERAND_REGISTER}, {2, 1, 1, 1}},
+    {"st", 2, 0x920d, 2, {0, 0x01f0}, {OPERAND_XP, OPERAND_REGISTER}, {2, 1, 1, 1}},
+    {"st", 2, 0x920e, 2, {0, 0x01f0}, {OPERAND_MX, OPERAND_REGISTER}, {2, 2, 1, 2}},
+    {"st", 2, 0x8208, 2, {0, 0x01f0}, {OPERAND_Y, OPERAND_REGISTER}, {2, 1, 1, 1}},
+    {"st", 2, 0x9209, 2, {0, 0x01f0}, {OPERAND_YP, OPERAND_REGISTER}, {2, 1, 1, 1}},
+    {"st", 2, 0x920a, 2, {0, 0x01f0}, {OPERAND_MY, OPERAND_REGISTER}, {2, 2, 1, 2}},
+    {"st", 2, 0x8200, 2, {0, 0x01f0}, {OPERAND_Z, OPERAND_REGISTER}, {2, 1, 1, 1}},
+    {"st", 2, 0x9201, 2, {0, 0x01f0}, {OPERAND_ZP, OPERAND_REGISTER}, {2, 1, 1, 1}},
+    {"st", 2, 0x9202, 2, {0, 0x01f0}, {OPERAND_MZ, OPERAND_REGISTER}, {2, 2, 1, 2}},
+    {"std", 2, 0x8208, 2, {0x2c07, 0x01f0}, {OPERAND_YPQ, OPERAND_REGISTER}, {2, 2, 1, 0}},
+    {"std", 2, 0x8200, 2, {0x2c07, 0x01f0}, {OPERAND_ZPQ, OPERAND_REGISTER}, {2, 2, 1, 0}},
+    {"sts", 4, 0x9200, 2, {0, 0x01f0}, {OPERAND_LONG_ABSOLUTE_ADDRESS, OPERAND_REGISTER}, {2, 2, 2, 0}},
+    {"sts", 2, 0xA800, 2, {0x00f0, 0x070f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {0, 0, 0, 1}},
+    {"sub", 2, 0x1800, 2, {0x01f0, 0x020f}, {OPERAND_REGISTER, OPERAND_REGISTER}, {1, 1, 1, 1}},
+    {"subi", 2, 0x5000, 2, {0x00f0, 0x0f0f}, {OPERAND_REGISTER_STARTR16, OPERAND_DATA}, {1, 1, 1, 1}},
+    {".dw", 2, 0, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE}, {0, 0, 0, 0}},
+    {".db", 1, 0, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE}, {0, 0, 0, 0}},
 };
 
 /* Total number of AVR instructions */
-int AVR_TOTAL_INSTRUCTIONS = (sizeof(AVR_Instruction_Set)/sizeof(AVR_Instruction_Set[0]));
+const int AVR_TOTAL_INSTRUCTIONS = (sizeof(AVR_Instruction_Set)/sizeof(AVR_Instruction_Set[0]));
 
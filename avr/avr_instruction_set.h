@@ -23,6 +23,16 @@ enum {
     OPERAND_RAW_WORD, OPERAND_RAW_BYTE,
 };
 
+/* Enumeration for AVR cores with their own instruction timing, in the order
+ * of the CYCLES_VARIANT_* core variants */
+enum {
+    AVR_CORE_AVRE,      /* Classic megaAVR and tinyAVR */
+    AVR_CORE_AVRXM,     /* XMEGA */
+    AVR_CORE_AVRXT,     /* tinyAVR 0/1/2-series, megaAVR 0-series, AVR Dx */
+    AVR_CORE_AVRRC,     /* Reduced core tinyAVR, e.g. ATtiny10 */
+    AVR_TOTAL_CORES,
+};
+
 /* Structure for each entry in the instruction set */
 struct avrInstructionInfo {
     char mnemonic[7];
@@ -31,13 +41,15 @@ struct avrInstructionInfo {
     int numOperands;
     uint16_t operandMasks[2];
     int operandTypes[2];
+    /* Clock cycles by core with a 16-bit PC, 0 if unavailable or variable */
+    uint8_t cycles[AVR_TOTAL_CORES];
 };
 
 /* Structure for a disassembled instruction */
 struct avrInstructionDisasm {
     uint32_t address;
     uint8_t opcode[4];
-    struct avrInstructionInfo *instructionInfo;
+    const struct avrInstructionInfo *instructionInfo;
     int32_t operandDisasms[2];
 };
 
@@ -47,8 +59,8 @@ struct avrDirective {
     uint32_t value;
 };
 
-extern struct avrInstructionInfo AVR_Instruction_Set[];
-extern int AVR_TOTAL_INSTRUCTIONS;
+extern const struct avrInstructionInfo AVR_Instruction_Set[];
+extern const int AVR_TOTAL_INSTRUCTIONS;
 
 #endif
 
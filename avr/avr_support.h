@@ -1,6 +1,7 @@
 #ifndef AVR_SUPPORT_H
 #define AVR_SUPPORT_H
 
+#include <stdint.h>
 #include <disasmstream.h>
 #include <instruction.h>
 
@@ -9,5 +10,18 @@ int disasmstream_avr_init(struct DisasmStream *self);
 int disasmstream_avr_close(struct DisasmStream *self);
 int disasmstream_avr_read(struct DisasmStream *self, struct instruction *instr);
 
+/* AVR Instruction Set Table Support */
+const char *avr_isa_mnemonic(unsigned int index);
+/* Width in bytes of the instruction with the first opcode word opcode */
+unsigned int avr_isa_width(uint16_t opcode);
+
+/* AVR Raw Data Support, for streams that decode bytes out of input order */
+/* Raw .dw word "instruction" of the first two of len bytes at data, loaded
+ * at address, or .db byte if len is 1. Returns the number of bytes used, or
+ * -1 on allocation failure. */
+int avr_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address);
+/* Origin directive for address, returns 0, or -1 on allocation failure */
+int avr_disasm_origin(struct instruction *instr, uint32_t address);
+
 #endif
 
@@ -166,7 +166,7 @@ static int test_disasm_avr_unit_test_run(char *name, uint8_t *test_data, uint32_
     return -1;
 }
 
-static struct avrInstructionInfo *util_iset_lookup_by_mnemonic(char *mnemonic) {
+static const struct avrInstructionInfo *util_iset_lookup_by_mnemonic(char *mnemonic) {
     int i;
 
     for (i = 0; i < AVR_TOTAL_INSTRUCTIONS; i++) {
@@ -187,7 +187,7 @@ static struct avrInstructionInfo *util_iset_lookup_by_mnemonic(char *mnemonic) {
 int test_disasm_avr_unit_tests(void) {
     int numTests = 0, passedTests = 0;
     int i;
-    struct avrInstructionInfo *(*lookup)(char *) = util_iset_lookup_by_mnemonic;
+    const struct avrInstructionInfo *(*lookup)(char *) = util_iset_lookup_by_mnemonic;
 
     /* Check Sample Program */
     /* rjmp .0; ser R16; out $17, R16; out $18, R16; dec R16; rjmp .-6 */
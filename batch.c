@@ -0,0 +1,203 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <batch.h>
+
+/******************************************************************************/
+/* Work-stealing Worker Pool */
+/******************************************************************************/
+
+/* Deque of job indices owned by one worker */
+struct batch_deque {
+    pthread_mutex_t lock;
+    unsigned int *items;
+    unsigned int head, tail;
+};
+
+struct batch_pool {
+    struct batch_job *jobs;
+    struct batch_deque *deques;
+    unsigned int num_workers;
+    void (*process)(struct batch_job *job, void *arg);
+    void *arg;
+};
+
+struct batch_worker {
+    struct batch_pool *pool;
+    unsigned int id;
+    pthread_t thread;
+};
+
+/* Take a job from the front of our own deque */
+static int util_deque_pop(struct batch_deque *deque, unsigned int *item) {
+    int ret = 0;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail != deque->head) {
+        *item = deque->items[deque->head++];
+        ret = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return ret;
+}
+
+/* Steal a job from the back of another worker's deque */
+static int util_deque_steal(struct batch_deque *deque, unsigned int *item) {
+    int ret = 0;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail != deque->head) {
+        *item = deque->items[--deque->tail];
+        ret = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return ret;
+}
+
+static void *batch_worker_thread(void *arg) {
+    struct batch_worker *worker = (struct batch_worker *)arg;
+    struct batch_pool *pool = worker->pool;
+    unsigned int item, i;
+
+    while (1) {
+        if (!util_deque_pop(&pool->deques[worker->id], &item)) {
+            /* Own deque empty, look for a victim. No jobs are added once the
+             * batch is running, so all deques empty means we are done. */
+            for (i = 1; i < pool->num_workers; i++) {
+                if (util_deque_steal(&pool->deques[(worker->id + i) % pool->num_workers], &item))
+                    break;
+            }
+            if (i >= pool->num_workers)
+                break;
+        }
+
+        pool->process(&pool->jobs[item], pool->arg);
+    }
+
+    return NULL;
+}
+
+int batch_run(struct batch_job *jobs, unsigned int num_jobs, unsigned int num_workers, void (*process)(struct batch_job *job, void *arg), void *arg) {
+    struct batch_pool pool;
+    struct batch_worker *workers;
+    unsigned int i, started;
+    int ret = 0;
+
+    if (num_workers == 0)
+        num_workers = 1;
+    if (num_workers > num_jobs)
+        num_workers = (num_jobs > 0) ? num_jobs : 1;
+
+    pool.jobs = jobs;
+    pool.num_workers = num_workers;
+    pool.process = process;
+    pool.arg = arg;
+
+    pool.deques = calloc(num_workers, sizeof(struct batch_deque));
+    workers = calloc(num_workers, sizeof(struct batch_worker));
+    if (pool.deques == NULL || workers == NULL) {
+        free(pool.deques);
+        free(workers);
+        return -1;
+    }
+
+    /* Deal jobs round-robin onto the worker deques */
+    for (i = 0; i < num_workers; i++) {
+        pthread_mutex_init(&pool.deques[i].lock, NULL);
+        pool.deques[i].items = malloc(((num_jobs / num_workers) + 1) * sizeof(unsigned int));
+        if (pool.deques[i].items == NULL)
+            ret = -1;
+    }
+    for (i = 0; ret == 0 && i < num_jobs; i++) {
+        struct batch_deque *deque = &pool.deques[i % num_workers];
+        deque->items[deque->tail++] = i;
+    }
+
+    /* Start the workers, the calling thread runs worker 0 */
+    for (started = 1; ret == 0 && started < num_workers; started++) {
+        workers[started].pool = &pool;
+        workers[started].id = started;
+        if (pthread_create(&workers[started].thread, NULL, batch_worker_thread, &workers[started]) != 0)
+            break;
+    }
+    if (ret == 0) {
+        workers[0].pool = &pool;
+        workers[0].id = 0;
+        batch_worker_thread(&workers[0]);
+    }
+    for (i = 1; ret == 0 && i < started; i++)
+        pthread_join(workers[i].thread, NULL);
+
+    for (i = 0; i < num_workers; i++) {
+        pthread_mutex_destroy(&pool.deques[i].lock);
+        free(pool.deques[i].items);
+    }
+    free(pool.deques);
+    free(workers);
+
+    return ret;
+}
+
+/******************************************************************************/
+/* Output Path Templates */
+/******************************************************************************/
+
+static int util_append(char *dest, unsigned int size, unsigned int *len, const char *str, unsigned int n) {
+    if (*len + n >= size)
+        return -1;
+    memcpy(dest + *len, str, n);
+    *len += n;
+    dest[*len] = '\0';
+    return 0;
+}
+
+int batch_format_path(char *dest, unsigned int size, const char *template, const char *path, unsigned int index) {
+    const char *name, *dot, *end;
+    char number[16];
+    unsigned int len = 0;
+    int ret = 0;
+
+    /* Split the input path into directory, name and extension */
+    name = strrchr(path, '/');
+    name = (name != NULL) ? name + 1 : path;
+    dot = strrchr(name, '.');
+    if (dot == NULL || dot == name)
+        dot = name + strlen(name);
+
+    if (size == 0)
+        return -1;
+    dest[0] = '\0';
+
+    for (; *template != '\0' && ret == 0; template = end + 1) {
+        if (*template != '{') {
+            end = template;
+            ret = util_append(dest, size, &len, template, 1);
+            continue;
+        }
+
+        if ((end = strchr(template, '}')) == NULL)
+            return -1;
+
+        if (strncmp(template, "{path}", 6) == 0)
+            ret = util_append(dest, size, &len, path, strlen(path));
+        else if (strncmp(template, "{dir}", 5) == 0)
+            ret = (name == path) ? util_append(dest, size, &len, ".", 1) : util_append(dest, size, &len, path, name - path - 1);
+        else if (strncmp(template, "{name}", 6) == 0)
+            ret = util_append(dest, size, &len, name, strlen(name));
+        else if (strncmp(template, "{stem}", 6) == 0)
+            ret = util_append(dest, size, &len, name, dot - name);
+        else if (strncmp(template, "{index}", 7) == 0) {
+            snprintf(number, sizeof(number), "%u", index);
+            ret = util_append(dest, size, &len, number, strlen(number));
+        } else
+            return -1;
+    }
+
+    return ret;
+}
+
@@ -0,0 +1,36 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+/* Batch Support
+ *
+ * Runs a processing function over many input files on a pool of worker
+ * threads. Jobs are dealt round-robin onto per-worker deques; a worker takes
+ * jobs from the front of its own deque and, once that is empty, steals from
+ * the back of the other workers' deques, so that a few large images do not
+ * leave the other workers idle. Jobs thus mostly start in input order, which
+ * keeps them within the window of a file prefetcher.
+ */
+
+struct batch_job {
+    /* Input file path, and its index in the batch */
+    const char *path;
+    unsigned int index;
+    /* Output file path */
+    char out_path[4096];
+
+    /* Result, filled in by the processing function */
+    int status;
+    const char *error;
+};
+
+/* Process all jobs with num_workers threads, returns 0 once all are done */
+int batch_run(struct batch_job *jobs, unsigned int num_jobs, unsigned int num_workers, void (*process)(struct batch_job *job, void *arg), void *arg);
+
+/* Expand an output path template for an input path. Substitutes {path} (the
+ * input path), {dir} (its directory), {name} (its file name), {stem} (its
+ * file name without extension) and {index}. Returns -1 on a bad template or
+ * overflow. */
+int batch_format_path(char *dest, unsigned int size, const char *template, const char *path, unsigned int index);
+
+#endif
+
@@ -0,0 +1,57 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include <budget.h>
+
+/******************************************************************************/
+/* Memory Budget Support */
+/******************************************************************************/
+
+static atomic_size_t budget_limit = BUDGET_UNLIMITED;
+static atomic_size_t budget_used;
+static atomic_size_t budget_max_used;
+static atomic_int budget_refused;
+
+void budget_set_limit(size_t limit) {
+    atomic_store(&budget_limit, limit);
+}
+
+size_t budget_get_limit(void) {
+    return atomic_load(&budget_limit);
+}
+
+int budget_charge(size_t size) {
+    size_t used, limit, peak;
+
+    limit = atomic_load(&budget_limit);
+    used = atomic_load(&budget_used);
+
+    /* Charge only if the total stays within the limit */
+    do {
+        if (size > limit || used > limit - size) {
+            atomic_store(&budget_refused, 1);
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak(&budget_used, &used, used + size));
+
+    /* Track the high water mark */
+    peak = atomic_load(&budget_max_used);
+    while (used + size > peak && !atomic_compare_exchange_weak(&budget_max_used, &peak, used + size))
+        ;
+
+    return 0;
+}
+
+void budget_release(size_t size) {
+    atomic_fetch_sub(&budget_used, size);
+}
+
+size_t budget_peak(void) {
+    return atomic_load(&budget_max_used);
+}
+
+int budget_exceeded(void) {
+    return atomic_load(&budget_refused);
+}
+
@@ -0,0 +1,73 @@
+#ifndef BUDGET_H
+#define BUDGET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Memory Budget Support
+ *
+ * Plain disassembly streams its input: every Byte, Disasm, and Print Stream
+ * holds at most one record, instruction, or line of state, and the pipeline
+ * and fan-out streams a fixed number of them, so it runs in memory bounded
+ * by a constant independent of the size of the program file, for all file
+ * types and for standard input.
+ *
+ * Buffers whose size depends on the options or the input are charged to a
+ * process-wide budget, which --max-memory limits. A charge that would exceed
+ * the limit fails, and the stage either spills to a temporary file or fails
+ * with STREAM_ERROR_ALLOC rather than grow. The charged buffers are:
+ *
+ *   - the pipeline rings (ring.h), and the prefetch buffers of --batch and
+ *     similarity index
+ *   - the ELF image of an input that cannot seek, at most 1 MiB of it held
+ *     in memory before the rest spills to a temporary file (file/elf.c)
+ *   - the xref index of the assembly label pre-pass (xref.h), whose input
+ *     spills to a temporary file if it cannot seek
+ *   - the program images of --discover, --previous, and --diff (image.h),
+ *     and the discovery state (discover.h)
+ *   - the instruction tokens and diagonal vectors of --diff (diff.h)
+ *   - the records, leaders, and blocks of -O cfg and -O dot (cfg.h), and the
+ *     functions, call sites, and walk state of -O stack (callgraph.h)
+ *   - the automaton of --search (search.h) and the counters of -O stats
+ *   - the band tables of similarity index, and the index and candidates of
+ *     similarity query (similarity.h)
+ *   - the cached program files, uploads, and buffered replies of --serve,
+ *     which evicts unused cache entries before it refuses a charge (serve.h),
+ *     and the upload of --connect
+ *
+ * The exceptions, which are not charged:
+ *
+ *   - --previous-listing is read a line at a time, into a line buffer as
+ *     long as its longest line (incremental.h)
+ *   - the one signature per program file of similarity index, the file
+ *     lists of --batch and merge, and their job tables, which grow with the
+ *     command line rather than the program files; the similarity and merge
+ *     subcommands take no --max-memory
+ *   - the fixed size state of each stream, the -f template, and the --tee
+ *     outputs, covered by BUDGET_BASELINE
+ */
+
+/* Memory set aside for the program itself, stdio buffers, thread stacks,
+ * and the fixed size state of the streams, which --max-memory must cover */
+#define BUDGET_BASELINE     (16*1024*1024)
+
+/* No limit, the default */
+#define BUDGET_UNLIMITED    SIZE_MAX
+
+/* Limit the charged buffers to limit bytes */
+void budget_set_limit(size_t limit);
+size_t budget_get_limit(void);
+
+/* Charge size bytes to the budget, returns 0, or -1 without charging if the
+ * limit would be exceeded */
+int budget_charge(size_t size);
+/* Return size bytes charged earlier */
+void budget_release(size_t size);
+
+/* Largest total charged so far */
+size_t budget_peak(void);
+/* Nonzero if a charge has failed */
+int budget_exceeded(void);
+
+#endif
+
@@ -0,0 +1,728 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <printstream.h>
+#include <instruction.h>
+#include <budget.h>
+#include <ucdisasm.h>
+#include <cfg.h>
+#include <callgraph.h>
+
+/* Initial number of call sites */
+#define CALLGRAPH_SITES_LEN     256
+/* Most interrupt vectors */
+#define CALLGRAPH_MAX_VECTORS   256
+
+/* Depth first search states */
+enum {
+    CALLGRAPH_UNSEARCHED,
+    CALLGRAPH_SEARCHING,
+    CALLGRAPH_SEARCHED,
+};
+
+/* Notes that make the depth a lower bound */
+#define CALLGRAPH_FLAGS_LOWER_BOUND (CALLGRAPH_FLAG_RECURSIVE | CALLGRAPH_FLAG_INDIRECT | CALLGRAPH_FLAG_OUTSIDE | CALLGRAPH_FLAG_UNBOUNDED)
+
+static const uint32_t PIC18_Vectors[] = {0x00, 0x08, 0x18};
+static const uint32_t PIC_Midrange_Vectors[] = {0x00, 0x08};
+static const uint32_t PIC_Baseline_Vectors[] = {0x00};
+static const uint32_t a8051_Vectors[] = {0x00, 0x03, 0x0b, 0x13, 0x1b, 0x23, 0x2b};
+
+/* Interrupt vector slot where code starts */
+struct callgraph_vector {
+    uint32_t address;
+    /* Slot number, the slot's address over the vector size */
+    int number;
+};
+
+/* Push depth at the entry of a block, in the walk of a function */
+struct callgraph_visit {
+    int32_t depth;
+    /* Function index + 1 of the walk that set depth */
+    uint32_t stamp;
+    /* Function index + 1 of the function entering at the block, or 0 */
+    uint32_t function;
+    uint8_t queued;
+};
+
+/* Blocks of the walk of a function */
+struct callgraph_walk {
+    struct callgraph_visit *visits;
+    /* Blocks to walk again, and blocks reached */
+    size_t *worklist, *reached;
+};
+
+/* Function of the depth first search, with its next call site */
+struct callgraph_frame {
+    size_t function, site;
+};
+
+/******************************************************************************/
+/* Call Graph */
+/******************************************************************************/
+
+static int util_is_pic(int arch) {
+    return arch == UCDISASM_ARCH_PIC_BASELINE || arch == UCDISASM_ARCH_PIC_MIDRANGE || arch == UCDISASM_ARCH_PIC_MIDRANGE_ENHANCED || arch == UCDISASM_ARCH_PIC_PIC18;
+}
+
+int callgraph_init(struct callgraph *cg, int arch, isa_mnemonic_func isa_mnemonic) {
+    unsigned int i, num_entries;
+
+    memset(cg, 0, sizeof(struct callgraph));
+    cg->arch = arch;
+    cfg_init(&cg->cfg, CYCLES_VARIANT_DEFAULT);
+
+    /* Stack effect of each instruction set table entry */
+    for (num_entries = 0; isa_mnemonic(num_entries) != NULL; num_entries++)
+        ;
+    if (budget_charge(num_entries) < 0)
+        return -1;
+    if ((cg->stack_effects = calloc(num_entries + 1, 1)) == NULL) {
+        budget_release(num_entries);
+        return -1;
+    }
+    cg->charged = num_entries;
+
+    for (i = 0; i < num_entries; i++) {
+        if (strcasecmp(isa_mnemonic(i), "push") == 0)
+            cg->stack_effects[i] = 1;
+        else if (strcasecmp(isa_mnemonic(i), "pop") == 0)
+            cg->stack_effects[i] = -1;
+    }
+    cg->cfg.stack_effects = cg->stack_effects;
+    cg->cfg.num_effects = num_entries;
+
+    return 0;
+}
+
+void callgraph_free(struct callgraph *cg) {
+    cfg_free(&cg->cfg);
+    free(cg->stack_effects);
+    free(cg->functions);
+    free(cg->sites);
+    budget_release(cg->charged);
+    memset(cg, 0, sizeof(struct callgraph));
+}
+
+int callgraph_add(struct callgraph *cg, struct instruction *instr) {
+    return cfg_add(&cg->cfg, instr);
+}
+
+/* Interrupt vector slots where code starts, returns their number */
+static unsigned int util_vectors(const struct callgraph *cg, struct callgraph_vector *vectors) {
+    const struct cfg_record *records = cg->cfg.records;
+    const uint32_t *table;
+    unsigned int i, n = 0, len;
+
+    switch (cg->arch) {
+        case UCDISASM_ARCH_AVR8:
+            /* The run of jumps and returns of a vector table at 0, or the
+             * reset alone */
+            if (cg->cfg.num_records == 0 || records[0].address != 0)
+                return 0;
+            vectors[n].address = 0;
+            vectors[n++].number = 0;
+            if (records[0].flow != FLOW_JUMP)
+                return n;
+            for (i = 1; i < cg->cfg.num_records && n < CALLGRAPH_MAX_VECTORS; i++) {
+                if (records[i].address != records[i-1].address + records[i-1].width || records[i].width != records[0].width)
+                    break;
+                if (records[i].flow != FLOW_JUMP && records[i].flow != FLOW_RETURN)
+                    break;
+                /* Entries are as wide as the jump at the reset */
+                vectors[n].address = records[i].address;
+                vectors[n++].number = records[i].address / records[0].width;
+            }
+            return n;
+        case UCDISASM_ARCH_PIC_PIC18:
+            table = PIC18_Vectors;
+            len = sizeof(PIC18_Vectors)/sizeof(PIC18_Vectors[0]);
+            break;
+        case UCDISASM_ARCH_PIC_MIDRANGE:
+        case UCDISASM_ARCH_PIC_MIDRANGE_ENHANCED:
+            table = PIC_Midrange_Vectors;
+            len = sizeof(PIC_Midrange_Vectors)/sizeof(PIC_Midrange_Vectors[0]);
+            break;
+        case UCDISASM_ARCH_8051:
+            table = a8051_Vectors;
+            len = sizeof(a8051_Vectors)/sizeof(a8051_Vectors[0]);
+            break;
+        default:
+            table = PIC_Baseline_Vectors;
+            len = sizeof(PIC_Baseline_Vectors)/sizeof(PIC_Baseline_Vectors[0]);
+            break;
+    }
+
+    /* Slots without code keep their numbers */
+    for (i = 0; i < len; i++) {
+        if (cfg_block_find(&cg->cfg, table[i]) >= 0) {
+            vectors[n].address = table[i];
+            vectors[n++].number = i;
+        }
+    }
+
+    return n;
+}
+
+/* Functions by entry, a vector before a call target at the same entry */
+static int util_function_compare(const void *a, const void *b) {
+    const struct callgraph_function *fa = a, *fb = b;
+    if (fa->entry != fb->entry)
+        return (fa->entry > fb->entry) - (fa->entry < fb->entry);
+    return (fa->vector < fb->vector) - (fa->vector > fb->vector);
+}
+
+static long util_function_find(const struct callgraph *cg, uint32_t entry) {
+    size_t lo = 0, hi = cg->num_functions, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo)/2;
+        if (cg->functions[mid].entry < entry)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < cg->num_functions && cg->functions[lo].entry == entry)
+        return lo;
+    return -1;
+}
+
+/* Collect the functions, at the vectors and call targets */
+static int util_functions(struct callgraph *cg) {
+    const struct cfg_record *record;
+    struct callgraph_vector vectors[CALLGRAPH_MAX_VECTORS];
+    unsigned int num_vectors;
+    size_t i, j, count;
+
+    num_vectors = util_vectors(cg, vectors);
+
+    for (i = 0, count = num_vectors; i < cg->cfg.num_records; i++)
+        count += (cg->cfg.records[i].flow == FLOW_CALL && cg->cfg.records[i].has_target);
+
+    if (budget_charge(count * sizeof(struct callgraph_function)) < 0)
+        return -1;
+    if ((cg->functions = calloc(count + 1, sizeof(struct callgraph_function))) == NULL) {
+        budget_release(count * sizeof(struct callgraph_function));
+        return -1;
+    }
+    cg->charged += count * sizeof(struct callgraph_function);
+
+    for (i = 0; i < num_vectors; i++) {
+        cg->functions[i].entry = vectors[i].address;
+        cg->functions[i].vector = vectors[i].number;
+    }
+    for (j = 0; j < cg->cfg.num_records; j++) {
+        record = &cg->cfg.records[j];
+        /* An rcall .+0 only reserves stack */
+        if (record->flow != FLOW_CALL || !record->has_target || record->target == record->address + record->width)
+            continue;
+        cg->functions[i].entry = record->target;
+        cg->functions[i++].vector = -1;
+    }
+    qsort(cg->functions, i, sizeof(struct callgraph_function), util_function_compare);
+
+    /* Drop duplicates */
+    for (j = 0, count = i, i = 0; j < count; j++) {
+        if (i == 0 || cg->functions[i-1].entry != cg->functions[j].entry)
+            cg->functions[i++] = cg->functions[j];
+    }
+    cg->num_functions = i;
+
+    return 0;
+}
+
+static int util_site_add(struct callgraph *cg, long callee, int depth) {
+    struct callgraph_site *sites;
+    size_t capacity;
+
+    if (cg->num_sites == cg->sites_capacity) {
+        capacity = (cg->sites_capacity == 0) ? CALLGRAPH_SITES_LEN : cg->sites_capacity*2;
+        if (budget_charge((capacity - cg->sites_capacity) * sizeof(struct callgraph_site)) < 0)
+            return -1;
+        if ((sites = realloc(cg->sites, capacity * sizeof(struct callgraph_site))) == NULL) {
+            budget_release((capacity - cg->sites_capacity) * sizeof(struct callgraph_site));
+            return -1;
+        }
+        cg->charged += (capacity - cg->sites_capacity) * sizeof(struct callgraph_site);
+        cg->sites = sites;
+        cg->sites_capacity = capacity;
+    }
+
+    cg->sites[cg->num_sites].callee = callee;
+    cg->sites[cg->num_sites++].depth = depth;
+
+    return 0;
+}
+
+/* Walk the blocks of a function from its entry, following all but call
+ * edges and stopping at the entries of other functions, for the push depth
+ * at the entry of each block it reaches */
+static void util_walk_depths(struct callgraph *cg, size_t index, long entry, struct callgraph_walk *walk, size_t *num_reached) {
+    struct callgraph_function *function = &cg->functions[index];
+    struct callgraph_visit *visits = walk->visits;
+    const struct cfg *cfg = &cg->cfg;
+    const struct cfg_block *block;
+    const struct cfg_record *record;
+    uint32_t stamp = index + 1;
+    size_t i, n = 0;
+    int depth;
+    unsigned int e;
+    long b, s;
+
+    visits[entry].stamp = stamp;
+    visits[entry].depth = 0;
+    visits[entry].queued = 1;
+    walk->worklist[n++] = entry;
+    walk->reached[(*num_reached)++] = entry;
+
+    while (n > 0) {
+        b = walk->worklist[--n];
+        visits[b].queued = 0;
+        depth = visits[b].depth;
+        block = &cfg->blocks[b];
+
+        for (i = block->first; i < block->first + block->count; i++) {
+            record = &cfg->records[i];
+            /* An rcall .+0 pushes the return address and continues */
+            if (record->flow == FLOW_CALL && record->has_target && record->target == record->address + record->width)
+                depth += cg->return_size;
+            depth += record->stack;
+        }
+
+        for (e = 0; e < block->num_edges; e++) {
+            if (block->edges[e].kind == CFG_EDGE_CALL)
+                continue;
+            if ((s = cfg_block_find(cfg, block->edges[e].address)) < 0)
+                continue;
+            /* Another function's blocks are walked from its own entry */
+            if (visits[s].function != 0 && visits[s].function != stamp)
+                continue;
+
+            if (visits[s].stamp != stamp) {
+                visits[s].stamp = stamp;
+                visits[s].depth = depth;
+                walk->reached[(*num_reached)++] = s;
+            } else if (depth > visits[s].depth) {
+                /* Reached again deeper, e.g. by a push in a loop */
+                if (depth > CALLGRAPH_MAX_DEPTH) {
+                    function->flags |= CALLGRAPH_FLAG_UNBOUNDED;
+                    continue;
+                }
+                visits[s].depth = depth;
+            } else {
+                continue;
+            }
+            if (!visits[s].queued) {
+                visits[s].queued = 1;
+                walk->worklist[n++] = s;
+            }
+        }
+    }
+}
+
+/* Walk the blocks of a function, then take its frame and call sites from
+ * the push depths of the blocks it reached, each once */
+static int util_walk_function(struct callgraph *cg, size_t index, long reset, struct callgraph_walk *walk) {
+    struct callgraph_function *function = &cg->functions[index];
+    const struct callgraph_visit *visits = walk->visits;
+    const struct cfg *cfg = &cg->cfg;
+    const struct cfg_block *block;
+    const struct cfg_record *record;
+    uint32_t stamp = index + 1;
+    size_t i, k, num_reached = 0;
+    int depth, frame = 0;
+    unsigned int e;
+    long b, s, callee;
+
+    function->first_site = cg->num_sites;
+
+    if ((b = cfg_block_find(cfg, function->entry)) < 0) {
+        function->flags |= CALLGRAPH_FLAG_OUTSIDE;
+        return 0;
+    }
+    util_walk_depths(cg, index, b, walk, &num_reached);
+
+    for (k = 0; k < num_reached; k++) {
+        b = walk->reached[k];
+        depth = visits[b].depth;
+        block = &cfg->blocks[b];
+
+        for (i = block->first; i < block->first + block->count; i++) {
+            record = &cfg->records[i];
+            if (record->flow == FLOW_CALL && record->has_target && record->target == record->address + record->width) {
+                depth += cg->return_size;
+            } else if (record->flow == FLOW_CALL || record->flow == FLOW_INDIRECT_CALL) {
+                callee = (record->flow == FLOW_CALL && record->has_target) ? util_function_find(cg, record->target) : -1;
+                if (callee < 0)
+                    function->flags |= CALLGRAPH_FLAG_INDIRECT;
+                if (util_site_add(cg, callee, depth + cg->return_size) < 0)
+                    return -1;
+            } else if (record->flow == FLOW_INDIRECT_JUMP) {
+                function->flags |= CALLGRAPH_FLAG_INDIRECT;
+            }
+
+            depth += record->stack;
+            if (depth > frame)
+                frame = depth;
+        }
+
+        for (e = 0; e < block->num_edges; e++) {
+            if (block->edges[e].kind == CFG_EDGE_CALL)
+                continue;
+            if ((s = cfg_block_find(cfg, block->edges[e].address)) < 0) {
+                function->flags |= CALLGRAPH_FLAG_OUTSIDE;
+                continue;
+            }
+            if (visits[s].function == 0 || visits[s].function == stamp)
+                continue;
+
+            /* A jump back to the reset starts over */
+            if (s == reset) {
+                function->flags |= CALLGRAPH_FLAG_RESET;
+                continue;
+            }
+            /* A jump or fall through into another function is a tail call */
+            if (util_site_add(cg, visits[s].function - 1, depth) < 0)
+                return -1;
+        }
+    }
+
+    function->frame = frame;
+    function->num_sites = cg->num_sites - function->first_site;
+
+    return 0;
+}
+
+/* Memoized depth first search of the depth of a function, with an explicit
+ * stack of at most one frame per function */
+static void util_search(struct callgraph *cg, size_t index, struct callgraph_frame *stack) {
+    struct callgraph_function *function, *callee;
+    const struct callgraph_site *site;
+    struct callgraph_frame *top;
+    size_t n = 0;
+    long depth;
+
+    if (cg->functions[index].state != CALLGRAPH_UNSEARCHED)
+        return;
+
+    function = &cg->functions[index];
+    function->state = CALLGRAPH_SEARCHING;
+    function->depth = function->frame;
+    function->all_flags |= function->flags;
+    stack[n].function = index;
+    stack[n++].site = function->first_site;
+
+    while (n > 0) {
+        top = &stack[n-1];
+        function = &cg->functions[top->function];
+
+        if (top->site == function->first_site + function->num_sites) {
+            function->state = CALLGRAPH_SEARCHED;
+            n--;
+            continue;
+        }
+
+        site = &cg->sites[top->site];
+        if (site->callee < 0) {
+            top->site++;
+            continue;
+        }
+
+        callee = &cg->functions[site->callee];
+        if (callee->state == CALLGRAPH_UNSEARCHED) {
+            /* Search the callee, then come back to this site */
+            callee->state = CALLGRAPH_SEARCHING;
+            callee->depth = callee->frame;
+            callee->all_flags |= callee->flags;
+            stack[n].function = site->callee;
+            stack[n++].site = callee->first_site;
+            continue;
+        }
+
+        if (callee->state == CALLGRAPH_SEARCHING) {
+            /* A cycle back to a function still being searched */
+            callee->flags |= CALLGRAPH_FLAG_RECURSIVE;
+            callee->all_flags |= CALLGRAPH_FLAG_RECURSIVE;
+            function->all_flags |= CALLGRAPH_FLAG_RECURSIVE;
+        } else {
+            depth = site->depth + (long)callee->depth;
+            if (depth > (long)function->depth)
+                function->depth = depth;
+            function->all_flags |= callee->all_flags & ~CALLGRAPH_FLAG_RESET;
+        }
+        top->site++;
+    }
+}
+
+int callgraph_build(struct callgraph *cg) {
+    struct callgraph_walk walk;
+    struct callgraph_frame *stack;
+    size_t charged, i;
+    long reset, b;
+
+    if (cfg_build(&cg->cfg) < 0)
+        return -1;
+
+    /* Return address size */
+    if (util_is_pic(cg->arch))
+        cg->return_size = 1;
+    else if (cg->arch == UCDISASM_ARCH_AVR8 && cg->cfg.num_records > 0 && cg->cfg.records[cg->cfg.num_records-1].address >= 0x20000)
+        cg->return_size = 3;
+    else
+        cg->return_size = 2;
+
+    if (util_functions(cg) < 0)
+        return -1;
+    reset = (cg->num_functions > 0 && cg->functions[0].vector == 0) ? cfg_block_find(&cg->cfg, cg->functions[0].entry) : -1;
+
+    /* Walk each function */
+    charged = cg->cfg.num_blocks * (sizeof(struct callgraph_visit) + 2*sizeof(size_t));
+    if (budget_charge(charged) < 0)
+        return -1;
+    walk.visits = calloc(cg->cfg.num_blocks + 1, sizeof(struct callgraph_visit));
+    walk.worklist = malloc((cg->cfg.num_blocks + 1) * sizeof(size_t));
+    walk.reached = malloc((cg->cfg.num_blocks + 1) * sizeof(size_t));
+    if (walk.visits == NULL || walk.worklist == NULL || walk.reached == NULL)
+        goto cleanup_failure;
+
+    /* Mark the entry block of each function */
+    for (i = 0; i < cg->num_functions; i++) {
+        if ((b = cfg_block_find(&cg->cfg, cg->functions[i].entry)) >= 0)
+            walk.visits[b].function = i + 1;
+    }
+
+    for (i = 0; i < cg->num_functions; i++) {
+        if (util_walk_function(cg, i, reset, &walk) < 0)
+            goto cleanup_failure;
+    }
+
+    free(walk.visits);
+    free(walk.worklist);
+    free(walk.reached);
+    budget_release(charged);
+
+    /* Search the depths */
+    charged = cg->num_functions * sizeof(struct callgraph_frame);
+    if (budget_charge(charged) < 0)
+        return -1;
+    if ((stack = malloc(charged + 1)) == NULL) {
+        budget_release(charged);
+        return -1;
+    }
+    for (i = 0; i < cg->num_functions; i++)
+        util_search(cg, i, stack);
+    free(stack);
+    budget_release(charged);
+
+    return 0;
+
+    cleanup_failure:
+    free(walk.visits);
+    free(walk.worklist);
+    free(walk.reached);
+    budget_release(charged);
+    return -1;
+}
+
+static void util_write_depth(char *dest, size_t size, unsigned long depth, unsigned int flags) {
+    snprintf(dest, size, "%lu%s", depth, (flags & CALLGRAPH_FLAGS_LOWER_BOUND) ? "+" : "");
+}
+
+void callgraph_write(const struct callgraph *cg, FILE *out) {
+    const struct callgraph_function *function, *reset = NULL, *worst = NULL;
+    const char *unit = util_is_pic(cg->arch) ? "level" : "byte";
+    char address[16], vector[16], depth[24], notes[64];
+    unsigned long total;
+    size_t i;
+
+    fprintf(out, "%-8s  %6s  %5s  %6s  %5s  notes\n", "function", "vector", "frame", "depth", "calls");
+    for (i = 0; i < cg->num_functions; i++) {
+        function = &cg->functions[i];
+        snprintf(address, sizeof(address), "0x%04x", function->entry);
+        if (function->vector >= 0)
+            snprintf(vector, sizeof(vector), "%d", function->vector);
+        else
+            strcpy(vector, "-");
+        util_write_depth(depth, sizeof(depth), function->depth, function->all_flags);
+        snprintf(notes, sizeof(notes), "%s%s%s%s%s",
+            (function->flags & CALLGRAPH_FLAG_RECURSIVE) ? ", recursive" : "",
+            (function->flags & CALLGRAPH_FLAG_INDIRECT) ? ", indirect" : "",
+            (function->flags & CALLGRAPH_FLAG_OUTSIDE) ? ", outside" : "",
+            (function->flags & CALLGRAPH_FLAG_UNBOUNDED) ? ", unbounded" : "",
+            (function->flags & CALLGRAPH_FLAG_RESET) ? ", resets" : "");
+        fprintf(out, "%-8s  %6s  %5u  %6s  %5u%s%s\n", address, vector, function->frame, depth, function->num_sites,
+            (notes[0] != '\0') ? "  " : "", (notes[0] != '\0') ? notes + 2 : "");
+    }
+
+    /* Depth from each vector, with the return address of an interrupt */
+    for (i = 0; i < cg->num_functions; i++) {
+        function = &cg->functions[i];
+        if (function->vector < 0)
+            continue;
+        if (function->vector > 0 && (function->flags & CALLGRAPH_FLAG_RESET)) {
+            fprintf(out, "vector %d at 0x%04x: resets\n", function->vector, function->entry);
+            continue;
+        }
+
+        total = function->depth + ((function->vector > 0) ? cg->return_size : 0);
+        util_write_depth(depth, sizeof(depth), total, function->all_flags);
+        fprintf(out, "vector %d at 0x%04x: %s %s%s\n", function->vector, function->entry, depth, unit, (total == 1) ? "" : "s");
+
+        if (function->vector == 0)
+            reset = function;
+        else if (worst == NULL || function->depth > worst->depth)
+            worst = function;
+    }
+
+    /* Worst case of the reset and the deepest interrupt */
+    if (reset == NULL && worst == NULL)
+        return;
+    total = ((reset != NULL) ? reset->depth : 0) + ((worst != NULL) ? worst->depth + cg->return_size : 0);
+    util_write_depth(depth, sizeof(depth), total, ((reset != NULL) ? reset->all_flags : 0) | ((worst != NULL) ? worst->all_flags : 0));
+    fprintf(out, "worst case: %s %s%s, ", depth, unit, (total == 1) ? "" : "s");
+    if (reset != NULL && worst != NULL)
+        fprintf(out, "vector 0 and vector %d\n", worst->vector);
+    else
+        fprintf(out, "vector %d\n", (reset != NULL) ? reset->vector : worst->vector);
+}
+
+/******************************************************************************/
+/* Stack Print Stream Support */
+/******************************************************************************/
+
+/* Print Stream State */
+struct printstream_stack_state {
+    /* Print Option Bit Flags */
+    unsigned int flags;
+
+    int arch;
+    isa_mnemonic_func isa_mnemonic;
+    struct callgraph cg;
+
+    /* Summary written */
+    int written;
+};
+
+int printstream_stack_setup(struct PrintStream *self, const char *arch_name, isa_mnemonic_func isa_mnemonic) {
+    struct printstream_stack_state *state;
+
+    /* Allocate stream state, which carries the architecture until init */
+    state = self->state = calloc(1, sizeof(struct printstream_stack_state));
+    if (state == NULL) {
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    if ((state->arch = ucdisasm_arch_lookup(arch_name)) < 0) {
+        free(self->state);
+        self->error = "Unknown architecture for stack depth!";
+        return STREAM_ERROR_FAILURE;
+    }
+    state->isa_mnemonic = isa_mnemonic;
+
+    self->error = NULL;
+    self->stream_init = printstream_stack_init;
+    self->stream_close = printstream_stack_close;
+    self->stream_read = printstream_stack_read;
+
+    return 0;
+}
+
+int printstream_stack_init(struct PrintStream *self, int flags) {
+    struct printstream_stack_state *state = (struct printstream_stack_state *)self->state;
+
+    state->flags = flags;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    if (callgraph_init(&state->cg, state->arch, state->isa_mnemonic) < 0) {
+        self->error = "Error allocating stack effects!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    /* Initialize the input stream */
+    if (self->in->stream_init(self->in) < 0) {
+        self->error = "Error in input stream initialization!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int printstream_stack_close(struct PrintStream *self) {
+    struct printstream_stack_state *state = (struct printstream_stack_state *)self->state;
+
+    /* Free stream state memory */
+    callgraph_free(&state->cg);
+    free(self->state);
+
+    /* Close input stream */
+    if (self->in->stream_close(self->in) < 0) {
+        self->error = "Error in input stream close!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+/* Write the summary */
+static int util_write_summary(struct PrintStream *self, FILE *out) {
+    struct printstream_stack_state *state = (struct printstream_stack_state *)self->state;
+
+    if (callgraph_build(&state->cg) < 0) {
+        self->error = "Error allocating call graph!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    callgraph_write(&state->cg, out);
+
+    if (ferror(out)) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+
+    state->written = 1;
+
+    return 0;
+}
+
+int printstream_stack_read(struct PrintStream *self, FILE *out) {
+    struct printstream_stack_state *state = (struct printstream_stack_state *)self->state;
+    struct instruction instr;
+    int ret;
+
+    if (state->written)
+        return STREAM_EOF;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, &instr);
+    switch (ret) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            /* Write the summary at the end of the stream */
+            if ((ret = util_write_summary(self, out)) < 0)
+                return ret;
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    /* Keep the record of an instruction */
+    ret = callgraph_add(&state->cg, &instr);
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    if (ret < 0) {
+        self->error = "Error allocating instruction records!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#ifndef CALLGRAPH_H
+#define CALLGRAPH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <instruction.h>
+#include <printstream.h>
+#include <cfg.h>
+
+/* Call Graph and Stack Depth Support
+ *
+ * Finds the worst case stack depth of each function and from each interrupt
+ * vector, over the control flow graph of cfg.h, whose records carry the
+ * stack effect of each push and pop from a table built once per
+ * instruction set.
+ *
+ * A function starts at an interrupt vector or a call target. The vectors
+ * are the jumps and returns that fill an AVR vector table from address 0,
+ * 0x00, 0x08 and 0x18 on PIC18, 0x00 and 0x08 on the midrange PICs, the
+ * 0x00, 0x03, 0x0b, ... slots on the 8051, and 0x00 on the baseline PICs,
+ * where code starts there. A vector's number is its slot's, the slot
+ * address over the vector size, whether or not the slots before it hold
+ * code, so vector 0, and only it, is the reset.
+ *
+ * Each function's blocks are walked from its entry, following all but call
+ * edges, for the push depth at the entry of each block. A block reached
+ * again deeper is walked again, up to CALLGRAPH_MAX_DEPTH. The walk stops at
+ * the entry of another function: a jump or fall through into it is a tail
+ * call, and a jump back to the reset starts over. Then each block reached is
+ * taken once, for the function's frame, its most pushed, and its call sites,
+ * each kept once in a call site table with the depth at the callee's entry.
+ * An AVR rcall .+0, which only reserves stack, pushes the return address.
+ *
+ * A memoized depth first search over the call site table, with a stack of
+ * its own rather than recursion, then gives the depth of each function: the
+ * larger of its frame and, at each call site, the site's depth and the
+ * callee's depth. A callee still being searched is a cycle, and marks the
+ * function recursive.
+ *
+ * The depth is in bytes, with two byte return addresses, or three on AVRs
+ * with code past 128 KiB, and in hardware stack levels on the PICs. It is
+ * a lower bound for a function that is recursive, makes an indirect call or
+ * jump, leaves the decoded code, or pushes in a loop; the table notes
+ * these, and writes the depth with a "+". Stack frames allocated by moving
+ * the stack pointer are not seen.
+ *
+ * The stack print stream writes the table of functions at the end of the
+ * stream, then the depth from each vector, with the return address of an
+ * interrupt, and the worst case of the reset and the deepest interrupt,
+ * without nesting. A vector that jumps back to the reset is not counted as
+ * an interrupt, and any other function that does is noted.
+ *
+ *   function  vector  frame   depth  calls  notes
+ *   0x0000         0      0       7      1
+ *   0x0002         1      1       5      1
+ *   0x000a         -      1       5      1
+ *   0x0012         -      2       2      0
+ *   vector 0 at 0x0000: 7 bytes
+ *   vector 1 at 0x0002: 7 bytes
+ *   worst case: 14 bytes, vector 0 and vector 1
+ */
+
+/* Deepest push depth followed in a function */
+#define CALLGRAPH_MAX_DEPTH     4096
+
+/* Notes on a function's depth */
+enum {
+    CALLGRAPH_FLAG_RECURSIVE    = (1<<0),
+    CALLGRAPH_FLAG_INDIRECT     = (1<<1),
+    CALLGRAPH_FLAG_OUTSIDE      = (1<<2),
+    CALLGRAPH_FLAG_UNBOUNDED    = (1<<3),
+    /* Vector that jumps back to the reset */
+    CALLGRAPH_FLAG_RESET        = (1<<4),
+};
+
+struct callgraph_function {
+    uint32_t entry;
+    /* Vector number, or -1 */
+    int vector;
+    /* Most pushed by the function, and with its callees */
+    unsigned int frame, depth;
+    /* Call sites [first_site, first_site + num_sites) */
+    size_t first_site;
+    unsigned int num_sites;
+    /* Notes of the function, and with its callees */
+    unsigned int flags, all_flags;
+    /* Depth first search state */
+    int state;
+};
+
+struct callgraph_site {
+    /* Called function, or -1 for an indirect call */
+    long callee;
+    /* Push depth at the callee's entry: at the call with the return
+     * address, or at a tail call */
+    int depth;
+};
+
+struct callgraph {
+    int arch;
+    struct cfg cfg;
+    int8_t *stack_effects;
+
+    struct callgraph_function *functions;
+    size_t num_functions;
+    struct callgraph_site *sites;
+    size_t num_sites, sites_capacity;
+
+    /* Bytes of return address, or stack levels of a call */
+    unsigned int return_size;
+
+    /* Bytes charged to the memory budget */
+    size_t charged;
+};
+
+/* Start an empty call graph for an architecture (UCDISASM_ARCH_*), with
+ * the stack effects of its instruction set, returns 0, or -1 on allocation
+ * failure */
+int callgraph_init(struct callgraph *cg, int arch, isa_mnemonic_func isa_mnemonic);
+void callgraph_free(struct callgraph *cg);
+
+/* Add the record of an instruction, returns 0, or -1 on allocation failure */
+int callgraph_add(struct callgraph *cg, struct instruction *instr);
+
+/* Build the call graph and the depths, returns 0, or -1 on allocation
+ * failure */
+int callgraph_build(struct callgraph *cg);
+
+/* Write the summary table of a built call graph */
+void callgraph_write(const struct callgraph *cg, FILE *out);
+
+/* Setup self to write the stack depth summary of the stream */
+int printstream_stack_setup(struct PrintStream *self, const char *arch_name, isa_mnemonic_func isa_mnemonic);
+
+/* Stack Print Stream Support */
+int printstream_stack_init(struct PrintStream *self, int flags);
+int printstream_stack_close(struct PrintStream *self);
+int printstream_stack_read(struct PrintStream *self, FILE *out);
+
+#endif
+
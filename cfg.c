@@ -0,0 +1,492 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <printstream.h>
+#include <instruction.h>
+#include <printstream_file.h>
+#include <budget.h>
+#include <cfg.h>
+
+/* Initial number of instruction records */
+#define CFG_RECORDS_LEN     1024
+
+static const char *const CFG_Edge_Names[] = {
+    [CFG_EDGE_NEXT] = "next",
+    [CFG_EDGE_BRANCH] = "branch",
+    [CFG_EDGE_SKIP] = "skip",
+    [CFG_EDGE_JUMP] = "jump",
+    [CFG_EDGE_CALL] = "call",
+};
+
+/******************************************************************************/
+/* Control Flow Graph */
+/******************************************************************************/
+
+void cfg_init(struct cfg *cfg, int variant) {
+    memset(cfg, 0, sizeof(struct cfg));
+    cfg->variant = variant;
+}
+
+void cfg_free(struct cfg *cfg) {
+    free(cfg->records);
+    free(cfg->blocks);
+    budget_release(cfg->charged);
+
+    cfg->records = NULL;
+    cfg->num_records = cfg->capacity = 0;
+    cfg->blocks = NULL;
+    cfg->num_blocks = 0;
+    cfg->charged = 0;
+}
+
+const char *cfg_edge_name(int kind) {
+    return CFG_Edge_Names[kind];
+}
+
+int cfg_add(struct cfg *cfg, struct instruction *instr) {
+    struct cfg_record *records, *record;
+    struct instruction_cycles cycles;
+    size_t capacity;
+    int index;
+
+    if (instr->type != DISASM_TYPE_INSTRUCTION)
+        return 0;
+
+    if (cfg->num_records == cfg->capacity) {
+        capacity = (cfg->capacity == 0) ? CFG_RECORDS_LEN : cfg->capacity*2;
+        if (budget_charge((capacity - cfg->capacity) * sizeof(struct cfg_record)) < 0)
+            return -1;
+        if ((records = realloc(cfg->records, capacity * sizeof(struct cfg_record))) == NULL) {
+            budget_release((capacity - cfg->capacity) * sizeof(struct cfg_record));
+            return -1;
+        }
+        cfg->charged += (capacity - cfg->capacity) * sizeof(struct cfg_record);
+        cfg->records = records;
+        cfg->capacity = capacity;
+    }
+
+    record = &cfg->records[cfg->num_records++];
+    memset(record, 0, sizeof(struct cfg_record));
+    record->address = instr->get_address(instr);
+    record->width = instr->get_width(instr);
+    record->flow = instr->get_flow(instr);
+    record->has_target = instr->get_branch_target(instr, &record->target);
+    if (instr->get_cycles(instr, cfg->variant, &cycles)) {
+        record->has_cycles = 1;
+        record->next = cycles.next;
+        record->taken = cycles.taken;
+    }
+    if (cfg->stack_effects != NULL && (index = instr->get_isa_index(instr)) >= 0 && (unsigned int)index < cfg->num_effects)
+        record->stack = cfg->stack_effects[index];
+
+    return 0;
+}
+
+static int util_record_compare(const void *a, const void *b) {
+    const struct cfg_record *ra = a, *rb = b;
+    return (ra->address > rb->address) - (ra->address < rb->address);
+}
+
+static int util_address_compare(const void *a, const void *b) {
+    uint32_t aa = *(const uint32_t *)a, ab = *(const uint32_t *)b;
+    return (aa > ab) - (aa < ab);
+}
+
+/* Record i + 1, if it follows record i without a gap */
+static const struct cfg_record *util_following(const struct cfg *cfg, size_t i) {
+    if (i + 1 < cfg->num_records && cfg->records[i+1].address == cfg->records[i].address + cfg->records[i].width)
+        return &cfg->records[i+1];
+    return NULL;
+}
+
+/* Sorted unique addresses that start a block, other than those after raw
+ * data or a gap, which the block walk sees. Returns the number of leaders,
+ * or -1 on allocation failure. */
+static long util_leaders(const struct cfg *cfg, uint32_t **leaders, size_t *charged) {
+    const struct cfg_record *record, *following;
+    size_t i, j, n = 0, count = 0;
+
+    for (i = 0; i < cfg->num_records; i++) {
+        record = &cfg->records[i];
+        count += record->has_target + (record->flow != FLOW_NEXT && record->flow != FLOW_INVALID) + (record->flow == FLOW_SKIP);
+    }
+
+    *charged = count * sizeof(uint32_t);
+    if (budget_charge(*charged) < 0)
+        return -1;
+    if ((*leaders = malloc(*charged + 1)) == NULL) {
+        budget_release(*charged);
+        return -1;
+    }
+
+    for (i = 0; i < cfg->num_records; i++) {
+        record = &cfg->records[i];
+        if (record->has_target)
+            (*leaders)[n++] = record->target;
+        if (record->flow == FLOW_NEXT || record->flow == FLOW_INVALID)
+            continue;
+        /* After a control flow instruction */
+        (*leaders)[n++] = record->address + record->width;
+        /* After the skipped instruction, one or two words long */
+        if (record->flow == FLOW_SKIP && (following = util_following(cfg, i)) != NULL)
+            (*leaders)[n++] = following->address + following->width;
+    }
+    qsort(*leaders, n, sizeof(uint32_t), util_address_compare);
+
+    /* Drop duplicates */
+    for (i = 0, j = 0; i < n; i++) {
+        if (j == 0 || (*leaders)[j-1] != (*leaders)[i])
+            (*leaders)[j++] = (*leaders)[i];
+    }
+
+    return j;
+}
+
+/* Set the edges of a block, by the flow of its last instruction */
+static void util_block_edges(const struct cfg *cfg, struct cfg_block *block) {
+    size_t i = block->first + block->count - 1;
+    const struct cfg_record *last = &cfg->records[i], *following;
+
+    block->num_edges = 0;
+    switch (last->flow) {
+        case FLOW_BRANCH:
+        case FLOW_JUMP:
+        case FLOW_CALL:
+            if (last->has_target) {
+                block->edges[block->num_edges].kind = (last->flow == FLOW_BRANCH) ? CFG_EDGE_BRANCH : (last->flow == FLOW_JUMP) ? CFG_EDGE_JUMP : CFG_EDGE_CALL;
+                block->edges[block->num_edges++].address = last->target;
+            }
+            if (last->flow == FLOW_JUMP)
+                break;
+            /* Fall through */
+        case FLOW_NEXT:
+        case FLOW_INDIRECT_CALL:
+            block->edges[block->num_edges].kind = CFG_EDGE_NEXT;
+            block->edges[block->num_edges++].address = block->end;
+            break;
+        case FLOW_SKIP:
+            if ((following = util_following(cfg, i)) != NULL) {
+                block->edges[block->num_edges].kind = CFG_EDGE_SKIP;
+                block->edges[block->num_edges++].address = following->address + following->width;
+            }
+            block->edges[block->num_edges].kind = CFG_EDGE_NEXT;
+            block->edges[block->num_edges++].address = block->end;
+            break;
+        default:
+            /* Computed jumps and returns */
+            break;
+    }
+}
+
+/* Walk the records into blocks, counting them, and filling in blocks if it
+ * is not NULL */
+static size_t util_walk(struct cfg *cfg, const uint32_t *leaders, size_t num_leaders, struct cfg_block *blocks) {
+    const struct cfg_record *records = cfg->records;
+    size_t i, start, l = 0, n = 0;
+
+    for (start = 0; start < cfg->num_records; start = i) {
+        /* Raw data is not part of a block */
+        if (records[start].flow == FLOW_INVALID) {
+            i = start + 1;
+            continue;
+        }
+
+        for (i = start; i < cfg->num_records; i++) {
+            /* A leader other than the first instruction starts the next block */
+            while (l < num_leaders && leaders[l] < records[i].address)
+                l++;
+            if (i > start && l < num_leaders && leaders[l] == records[i].address)
+                break;
+            /* So does an address gap or raw data */
+            if (i > start && (records[i].address != records[i-1].address + records[i-1].width || records[i].flow == FLOW_INVALID))
+                break;
+            /* A control flow instruction ends the block */
+            if (records[i].flow != FLOW_NEXT) {
+                i++;
+                break;
+            }
+        }
+
+        if (blocks != NULL) {
+            blocks[n].first = start;
+            blocks[n].count = i - start;
+            blocks[n].start = records[start].address;
+            blocks[n].end = records[i-1].address + records[i-1].width;
+            util_block_edges(cfg, &blocks[n]);
+        }
+        n++;
+    }
+
+    return n;
+}
+
+int cfg_build(struct cfg *cfg) {
+    uint32_t *leaders;
+    size_t charged, num_blocks;
+    long num_leaders;
+
+    /* Records in address order, for the streams that read out of order */
+    qsort(cfg->records, cfg->num_records, sizeof(struct cfg_record), util_record_compare);
+
+    if ((num_leaders = util_leaders(cfg, &leaders, &charged)) < 0)
+        return -1;
+
+    num_blocks = util_walk(cfg, leaders, num_leaders, NULL);
+    if (budget_charge(num_blocks * sizeof(struct cfg_block)) < 0)
+        goto cleanup_failure;
+    if ((cfg->blocks = malloc(num_blocks * sizeof(struct cfg_block) + 1)) == NULL) {
+        budget_release(num_blocks * sizeof(struct cfg_block));
+        goto cleanup_failure;
+    }
+    cfg->charged += num_blocks * sizeof(struct cfg_block);
+    cfg->num_blocks = util_walk(cfg, leaders, num_leaders, cfg->blocks);
+
+    free(leaders);
+    budget_release(charged);
+
+    return 0;
+
+    cleanup_failure:
+    free(leaders);
+    budget_release(charged);
+    return -1;
+}
+
+long cfg_block_find(const struct cfg *cfg, uint32_t address) {
+    size_t lo = 0, hi = cfg->num_blocks, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo)/2;
+        if (cfg->blocks[mid].start < address)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < cfg->num_blocks && cfg->blocks[lo].start == address)
+        return lo;
+    return -1;
+}
+
+int cfg_block_cycles(const struct cfg *cfg, const struct cfg_block *block, unsigned long long *min, unsigned long long *max) {
+    const struct cfg_record *record, *following;
+    unsigned int taken;
+    size_t i;
+
+    *min = *max = 0;
+    for (i = block->first; i < block->first + block->count; i++) {
+        record = &cfg->records[i];
+        if (!record->has_cycles)
+            return 0;
+
+        if (record->flow == FLOW_BRANCH || record->flow == FLOW_SKIP) {
+            taken = record->taken;
+            /* Skipping a two word instruction */
+            if (record->flow == FLOW_SKIP && (following = util_following(cfg, i)) != NULL && following->width > 2)
+                taken++;
+            *min += (record->next < taken) ? record->next : taken;
+            *max += (record->next > taken) ? record->next : taken;
+        } else {
+            *min += record->next;
+            *max += record->next;
+        }
+    }
+
+    return 1;
+}
+
+/******************************************************************************/
+/* CFG Print Stream Support */
+/******************************************************************************/
+
+/* Print Stream State */
+struct printstream_cfg_state {
+    /* Print Option Bit Flags */
+    unsigned int flags;
+
+    int format;
+    const char *arch_name;
+    struct cfg cfg;
+
+    /* Graph written */
+    int written;
+};
+
+int printstream_cfg_setup(struct PrintStream *self, int format, const char *arch_name) {
+    struct printstream_cfg_state *state;
+
+    /* Allocate stream state, which carries the format until init */
+    state = self->state = calloc(1, sizeof(struct printstream_cfg_state));
+    if (state == NULL) {
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->format = format;
+    state->arch_name = arch_name;
+
+    self->error = NULL;
+    self->stream_init = printstream_cfg_init;
+    self->stream_close = printstream_cfg_close;
+    self->stream_read = printstream_cfg_read;
+
+    return 0;
+}
+
+int printstream_cfg_init(struct PrintStream *self, int flags) {
+    struct printstream_cfg_state *state = (struct printstream_cfg_state *)self->state;
+
+    state->flags = flags;
+    cfg_init(&state->cfg, PRINT_CYCLES_VARIANT(flags));
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the input stream */
+    if (self->in->stream_init(self->in) < 0) {
+        self->error = "Error in input stream initialization!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int printstream_cfg_close(struct PrintStream *self) {
+    struct printstream_cfg_state *state = (struct printstream_cfg_state *)self->state;
+
+    /* Free stream state memory */
+    cfg_free(&state->cfg);
+    free(self->state);
+
+    /* Close input stream */
+    if (self->in->stream_close(self->in) < 0) {
+        self->error = "Error in input stream close!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+static void util_write_dot(const struct cfg *cfg, FILE *out) {
+    const struct cfg_block *block;
+    unsigned long long min, max;
+    unsigned int e;
+    size_t i;
+    long to;
+
+    fputs("digraph cfg {\n", out);
+    fputs("    node [shape=box, fontname=\"monospace\"];\n", out);
+
+    for (i = 0; i < cfg->num_blocks; i++) {
+        block = &cfg->blocks[i];
+        fprintf(out, "    b%zu [label=\"0x%04x-0x%04x\\n%u instruction%s\\n", i, block->start, block->end, block->count, (block->count == 1) ? "" : "s");
+        if (!cfg_block_cycles(cfg, block, &min, &max))
+            fputs("unknown cycles\"];\n", out);
+        else if (min == max)
+            fprintf(out, "%llu cycle%s\"];\n", min, (min == 1) ? "" : "s");
+        else
+            fprintf(out, "%llu-%llu cycles\"];\n", min, max);
+    }
+
+    /* Edges to addresses that start no block are left out */
+    for (i = 0; i < cfg->num_blocks; i++) {
+        block = &cfg->blocks[i];
+        for (e = 0; e < block->num_edges; e++) {
+            if ((to = cfg_block_find(cfg, block->edges[e].address)) < 0)
+                continue;
+            fprintf(out, "    b%zu -> b%ld [label=\"%s\"%s];\n", i, to, cfg_edge_name(block->edges[e].kind),
+                (block->edges[e].kind == CFG_EDGE_CALL) ? ", style=dashed" : "");
+        }
+    }
+
+    fputs("}\n", out);
+}
+
+static void util_write_json(const struct cfg *cfg, const char *arch_name, FILE *out) {
+    const struct cfg_block *block;
+    unsigned long long min, max;
+    unsigned int e;
+    size_t i;
+
+    fprintf(out, "{\"architecture\":\"%s\",\"blocks\":[", arch_name);
+
+    for (i = 0; i < cfg->num_blocks; i++) {
+        block = &cfg->blocks[i];
+        fprintf(out, "%s{\"start\":%u,\"end\":%u,\"instructions\":%u,\"cycles\":", (i > 0) ? "," : "", block->start, block->end, block->count);
+        if (cfg_block_cycles(cfg, block, &min, &max))
+            fprintf(out, "{\"min\":%llu,\"max\":%llu}", min, max);
+        else
+            fputs("null", out);
+
+        fputs(",\"edges\":[", out);
+        for (e = 0; e < block->num_edges; e++) {
+            fprintf(out, "%s{\"kind\":\"%s\",\"to\":%u,\"block\":%ld}", (e > 0) ? "," : "", cfg_edge_name(block->edges[e].kind),
+                block->edges[e].address, cfg_block_find(cfg, block->edges[e].address));
+        }
+        fputs("]}", out);
+    }
+
+    fputs("]}\n", out);
+}
+
+/* Write the graph */
+static int util_write_graph(struct PrintStream *self, FILE *out) {
+    struct printstream_cfg_state *state = (struct printstream_cfg_state *)self->state;
+
+    if (cfg_build(&state->cfg) < 0) {
+        self->error = "Error allocating control flow graph!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    if (state->format == CFG_FORMAT_DOT)
+        util_write_dot(&state->cfg, out);
+    else
+        util_write_json(&state->cfg, state->arch_name, out);
+
+    if (ferror(out)) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+
+    state->written = 1;
+
+    return 0;
+}
+
+int printstream_cfg_read(struct PrintStream *self, FILE *out) {
+    struct printstream_cfg_state *state = (struct printstream_cfg_state *)self->state;
+    struct instruction instr;
+    int ret;
+
+    if (state->written)
+        return STREAM_EOF;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, &instr);
+    switch (ret) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            /* Write the graph at the end of the stream */
+            if ((ret = util_write_graph(self, out)) < 0)
+                return ret;
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    /* Keep the record of an instruction */
+    ret = cfg_add(&state->cfg, &instr);
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    if (ret < 0) {
+        self->error = "Error allocating instruction records!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    return 0;
+}
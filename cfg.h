@@ -0,0 +1,146 @@
+#ifndef CFG_H
+#define CFG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <instruction.h>
+#include <printstream.h>
+
+/* Control Flow Graph Support
+ *
+ * Splits the decoded instructions into basic blocks and links them by their
+ * control flow. Each instruction added is kept as a compact record of its
+ * address, width, flow, branch target, and cycles, in one array charged to
+ * the memory budget; no instruction is held.
+ *
+ * Building sorts the records by address and collects the addresses that
+ * start a block into a sorted leader array: the branch, jump, and call
+ * targets, the instructions after a branch, skip, jump, call, or return,
+ * and the instructions after a skipped one, which is one or two words long.
+ * One pass over the records then cuts them into the block table at the
+ * leaders, at gaps in the addresses, and around raw data, which is in no
+ * block. Each block has at most two edges, found by the flow of its last
+ * instruction:
+ *
+ *   next       to the instruction after the block (fall through, or the
+ *              return of a call)
+ *   branch     to the target of a taken conditional branch
+ *   skip       to the instruction after the skipped one
+ *   jump       to the target of a jump
+ *   call       to the called function
+ *
+ * Computed jumps and returns have no edges. An edge may lead to an address
+ * that starts no block, e.g. outside the decoded code.
+ *
+ * The CFG print stream writes the graph of the whole stream at its end, as
+ * Graphviz DOT or as one JSON object:
+ *
+ *   {"architecture":"avr","blocks":[{"start":0,"end":4,"instructions":2,
+ *    "cycles":{"min":2,"max":3},"edges":[{"kind":"branch","to":0,
+ *    "block":0},{"kind":"next","to":4,"block":1}]},...]}
+ *
+ * where "block" is the index of the block an edge leads to, or -1, and
+ * "cycles" is null if an instruction's timing is unknown.
+ */
+
+/* Most edges out of a block */
+#define CFG_MAX_EDGES       2
+
+/* Kinds of edges */
+enum {
+    CFG_EDGE_NEXT,
+    CFG_EDGE_BRANCH,
+    CFG_EDGE_SKIP,
+    CFG_EDGE_JUMP,
+    CFG_EDGE_CALL,
+};
+
+/* Graph output formats */
+enum {
+    CFG_FORMAT_DOT,
+    CFG_FORMAT_JSON,
+};
+
+/* Compact record of an instruction */
+struct cfg_record {
+    uint32_t address;
+    uint32_t target;
+    /* Cycles, if has_cycles */
+    uint16_t next, taken;
+    uint8_t width;
+    uint8_t flow;
+    uint8_t has_target;
+    uint8_t has_cycles;
+    /* Stack effect, from the stack effects table */
+    int8_t stack;
+};
+
+struct cfg_edge {
+    uint32_t address;
+    int kind;
+};
+
+struct cfg_block {
+    /* Addresses [start, end) */
+    uint32_t start, end;
+    /* Records [first, first + count) */
+    size_t first;
+    unsigned int count;
+    struct cfg_edge edges[CFG_MAX_EDGES];
+    unsigned int num_edges;
+};
+
+struct cfg {
+    /* Core variant of the cycles (CYCLES_VARIANT_*) */
+    int variant;
+    /* Optional stack effect of each instruction set table entry, e.g. 1 for
+     * push and -1 for pop */
+    const int8_t *stack_effects;
+    unsigned int num_effects;
+
+    struct cfg_record *records;
+    size_t num_records, capacity;
+    struct cfg_block *blocks;
+    size_t num_blocks;
+
+    /* Bytes charged to the memory budget */
+    size_t charged;
+};
+
+/* Start an empty graph, taking the cycles of the core variant */
+void cfg_init(struct cfg *cfg, int variant);
+/* Free the records and blocks, keeping the variant and stack effects */
+void cfg_free(struct cfg *cfg);
+
+/* Add the record of an instruction, returns 0, or -1 on allocation
+ * failure. Directives are ignored. */
+int cfg_add(struct cfg *cfg, struct instruction *instr);
+
+/* Build the block table from the records added, returns 0, or -1 on
+ * allocation failure */
+int cfg_build(struct cfg *cfg);
+
+/* Index of the block that starts at address, or -1 */
+long cfg_block_find(const struct cfg *cfg, uint32_t address);
+
+/* Shortest and longest cycles through a block, with the shorter and longer
+ * of the next and taken cycles of its last instruction. Returns 1, or 0 if
+ * an instruction's timing is unknown. */
+int cfg_block_cycles(const struct cfg *cfg, const struct cfg_block *block, unsigned long long *min, unsigned long long *max);
+
+/* Name of an edge kind */
+const char *cfg_edge_name(int kind);
+
+/* Setup self to write the control flow graph of the stream in format
+ * (CFG_FORMAT_*), with the cycles of the core variant in the flags'
+ * PRINT_CYCLES_VARIANT() */
+int printstream_cfg_setup(struct PrintStream *self, int format, const char *arch_name);
+
+/* CFG Print Stream Support */
+int printstream_cfg_init(struct PrintStream *self, int flags);
+int printstream_cfg_close(struct PrintStream *self);
+int printstream_cfg_read(struct PrintStream *self, FILE *out);
+
+#endif
+
@@ -0,0 +1,429 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <printstream_file.h>
+#include <ucdisasm.h>
+#include <budget.h>
+#include <image.h>
+#include <hash.h>
+#include <diff.h>
+
+/* Initial token capacity */
+#define DIFF_TOKENS_LEN     4096
+/* Fewest edit steps searched for a middle snake before settling for the
+ * furthest reaching path */
+#define DIFF_MIN_COST       256
+
+/* Address-normalized instruction */
+struct diff_token {
+    uint64_t hash;
+    uint32_t address;
+    uint32_t width;
+};
+
+struct diff_side {
+    struct program_image image;
+    struct diff_token *tokens;
+    size_t count, capacity;
+};
+
+struct diff_state {
+    struct diff_side old, new;
+    int arch, flags;
+    unsigned int max_width;
+    FILE *out;
+    struct diff_stats *stats;
+
+    /* Forward and backward furthest reaching x of each diagonal, centered */
+    long *vf, *vb;
+    size_t v_len;
+    /* Edit steps searched for a middle snake */
+    long cost;
+
+    /* Deletions and insertions of the hunk being gathered */
+    size_t del_start, del_end, ins_start, ins_end;
+
+    const char *error;
+};
+
+/******************************************************************************/
+/* Tokens */
+/******************************************************************************/
+
+uint64_t diff_token_hash(struct instruction *instr) {
+    unsigned int i, num_operands;
+    uint64_t hash = HASH_FNV_OFFSET_BASIS;
+    int kind;
+
+    hash = hash_fnv1a(hash, instr->get_isa_index(instr), 4);
+    num_operands = instr->get_num_operands(instr);
+    for (i = 0; i < num_operands; i++) {
+        kind = instr->get_operand_kind(instr, i);
+        hash = hash_fnv1a(hash, kind, 4);
+        if (kind != OPERAND_KIND_PROG_ADDRESS && kind != OPERAND_KIND_RELATIVE_ADDRESS)
+            hash = hash_fnv1a(hash, instr->get_operand_value(instr, i), 4);
+    }
+
+    return hash;
+}
+
+static int util_token_add(struct diff_side *side, struct instruction *instr) {
+    struct diff_token *tokens;
+    size_t capacity;
+
+    if (side->count == side->capacity) {
+        capacity = (side->capacity == 0) ? DIFF_TOKENS_LEN : side->capacity*2;
+        if (budget_charge((capacity - side->capacity) * sizeof(struct diff_token)) < 0)
+            return -1;
+        if ((tokens = realloc(side->tokens, capacity * sizeof(struct diff_token))) == NULL) {
+            budget_release((capacity - side->capacity) * sizeof(struct diff_token));
+            return -1;
+        }
+        side->tokens = tokens;
+        side->capacity = capacity;
+    }
+
+    side->tokens[side->count].hash = diff_token_hash(instr);
+    side->tokens[side->count].address = instr->get_address(instr);
+    side->tokens[side->count].width = instr->get_width(instr);
+    side->count++;
+
+    return 0;
+}
+
+/* Read a program image and decode it into tokens */
+static int util_side_read(struct diff_state *state, struct diff_side *side, struct ByteStream *source) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct instruction instr;
+    int ret;
+
+    if (source->stream_init(source) < 0) {
+        state->error = (source->error != NULL) ? source->error : "Error in byte stream initialization!";
+        return -1;
+    }
+    ret = image_read(&side->image, source);
+    if (source->stream_close(source) < 0 && ret == 0)
+        ret = STREAM_ERROR_INPUT;
+    if (ret < 0) {
+        state->error = (ret == STREAM_ERROR_ALLOC) ? "Error allocating program image!" : (source->error != NULL) ? source->error : "Error reading program file!";
+        return -1;
+    }
+
+    if (image_bytestream_setup(&bs, &side->image, side->image.base, (uint64_t)side->image.base + side->image.size) < 0) {
+        state->error = bs.error;
+        return -1;
+    }
+    ds.in = &bs;
+    ds.error = NULL;
+    ucdisasm_disasmstream_setup(&ds, state->arch);
+    if (ds.stream_init(&ds) < 0) {
+        state->error = (ds.error != NULL) ? ds.error : "Error in disasm stream initialization!";
+        bs.stream_close(&bs);
+        return -1;
+    }
+
+    while ((ret = ds.stream_read(&ds, &instr)) == 0) {
+        if (instr.type == DISASM_TYPE_INSTRUCTION && util_token_add(side, &instr) < 0) {
+            state->error = "Error allocating instruction tokens!";
+            ret = STREAM_ERROR_ALLOC;
+        }
+        instr.free(&instr);
+        if (ret < 0)
+            break;
+    }
+    if (ret != STREAM_EOF && state->error == NULL)
+        state->error = (ds.error != NULL) ? ds.error : "Error in disasm stream read!";
+    ds.stream_close(&ds);
+
+    return (ret == STREAM_EOF) ? 0 : -1;
+}
+
+static void util_side_free(struct diff_side *side) {
+    budget_release(side->capacity * sizeof(struct diff_token));
+    free(side->tokens);
+    image_free(&side->image);
+}
+
+/******************************************************************************/
+/* Output */
+/******************************************************************************/
+
+struct util_format_arg {
+    int flags;
+    char *line;
+    int size, len;
+};
+
+static int util_format_callback(struct instruction *instr, void *arg) {
+    struct util_format_arg *format = (struct util_format_arg *)arg;
+
+    if (instr->type != DISASM_TYPE_INSTRUCTION)
+        return 0;
+    format->len = printstream_file_format(instr, format->line, format->size, format->flags);
+    return 1;
+}
+
+/* Write the instruction of a token, decoded again from its image */
+static int util_write_token(struct diff_state *state, struct diff_side *side, size_t index, char prefix) {
+    char line[PRINTSTREAM_FILE_LINE_LEN];
+    struct util_format_arg format = {state->flags, line, sizeof(line), 0};
+    const struct diff_token *token = &side->tokens[index];
+    uint64_t len;
+
+    len = image_present_len(&side->image, token->address, token->width);
+    if (ucdisasm_disassemble(state->arch, side->image.data + (token->address - side->image.base), len, token->address, util_format_callback, &format) < 0 || format.len <= 0) {
+        state->error = "Error formatting instruction!";
+        return -1;
+    }
+    if (fputc(prefix, state->out) == EOF || fputs(line, state->out) < 0) {
+        state->error = "Error writing to output file!";
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Address of a position in a token sequence, the end of the last token past
+ * the end */
+static uint32_t util_position_address(const struct diff_side *side, size_t index) {
+    if (index < side->count)
+        return side->tokens[index].address;
+    if (side->count > 0)
+        return side->tokens[side->count - 1].address + side->tokens[side->count - 1].width;
+    return 0;
+}
+
+/* Write the hunk gathered so far, if any */
+static int util_hunk_flush(struct diff_state *state) {
+    size_t deleted = state->del_end - state->del_start, inserted = state->ins_end - state->ins_start, i;
+
+    if (deleted == 0 && inserted == 0)
+        return 0;
+
+    if (fprintf(state->out, "@@ -0x%04x,%zu +0x%04x,%zu @@\n", util_position_address(&state->old, state->del_start), deleted, util_position_address(&state->new, state->ins_start), inserted) < 0) {
+        state->error = "Error writing to output file!";
+        return -1;
+    }
+    for (i = state->del_start; i < state->del_end; i++) {
+        if (util_write_token(state, &state->old, i, '-') < 0)
+            return -1;
+    }
+    for (i = state->ins_start; i < state->ins_end; i++) {
+        if (util_write_token(state, &state->new, i, '+') < 0)
+            return -1;
+    }
+
+    state->stats->hunks++;
+    state->stats->modified += (deleted < inserted) ? deleted : inserted;
+    state->stats->deleted += (deleted > inserted) ? deleted - inserted : 0;
+    state->stats->inserted += (inserted > deleted) ? inserted - deleted : 0;
+
+    return 0;
+}
+
+/* Old tokens [a0, a1) and new tokens [b0, b1) differ, and come after the
+ * hunk gathered so far */
+static int util_emit_change(struct diff_state *state, size_t a0, size_t a1, size_t b0, size_t b1) {
+    if (state->del_end != a0 || state->ins_end != b0) {
+        if (util_hunk_flush(state) < 0)
+            return -1;
+        state->del_start = a0;
+        state->ins_start = b0;
+    }
+    state->del_end = a1;
+    state->ins_end = b1;
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Myers Diff */
+/******************************************************************************/
+
+/* Find the middle snake of the shortest edit script of old tokens [a0, a1)
+ * and new tokens [b0, b1), both nonempty, from (x, y) to (u, v) relative to
+ * (a0, b0). Past state->cost edit steps, as GNU diff's TOO_EXPENSIVE, split
+ * instead at the end of the furthest reaching forward or backward path,
+ * with an empty snake, so the script is no longer minimal but the search
+ * takes O((N+M) cost). */
+static void util_middle_snake(struct diff_state *state, size_t a0, size_t a1, size_t b0, size_t b1, long *x_out, long *y_out, long *u_out, long *v_out) {
+    const struct diff_token *a = state->old.tokens + a0, *b = state->new.tokens + b0;
+    long n = a1 - a0, m = b1 - b0, delta = n - m, max = (n + m + 1)/2;
+    long offset = state->v_len/2, *vf = state->vf + offset, *vb = state->vb + offset;
+    long d, k, x, y, x0, y0, best;
+    int odd = delta & 1;
+
+    vf[1] = 0;
+    vb[1] = 0;
+    for (d = 0; d <= max; d++) {
+        /* Forward paths from (0, 0) */
+        for (k = -d; k <= d; k += 2) {
+            if (k == -d || (k != d && vf[k-1] < vf[k+1]))
+                x = vf[k+1];
+            else
+                x = vf[k-1] + 1;
+            y = x - k;
+            x0 = x;
+            y0 = y;
+            while (x < n && y < m && a[x].hash == b[y].hash) {
+                x++;
+                y++;
+            }
+            vf[k] = x;
+            /* Overlaps a backward path of d-1 */
+            if (odd && delta - k >= -(d-1) && delta - k <= d-1 && vf[k] + vb[delta - k] >= n) {
+                *x_out = x0;
+                *y_out = y0;
+                *u_out = x;
+                *v_out = y;
+                return;
+            }
+        }
+
+        /* Backward paths from (n, m), x and y counted from the end */
+        for (k = -d; k <= d; k += 2) {
+            if (k == -d || (k != d && vb[k-1] < vb[k+1]))
+                x = vb[k+1];
+            else
+                x = vb[k-1] + 1;
+            y = x - k;
+            x0 = x;
+            y0 = y;
+            while (x < n && y < m && a[n-1-x].hash == b[m-1-y].hash) {
+                x++;
+                y++;
+            }
+            vb[k] = x;
+            /* Overlaps a forward path of d */
+            if (!odd && delta - k >= -d && delta - k <= d && vb[k] + vf[delta - k] >= n) {
+                *x_out = n - x;
+                *y_out = m - y;
+                *u_out = n - x0;
+                *v_out = m - y0;
+                return;
+            }
+        }
+
+        if (d < state->cost)
+            continue;
+
+        /* Too expensive: the furthest reaching path within the grid */
+        best = -1;
+        for (k = -d; k <= d; k += 2) {
+            x = vf[k];
+            y = x - k;
+            if (x <= n && y >= 0 && y <= m && x + y > best) {
+                best = x + y;
+                *x_out = *u_out = x;
+                *y_out = *v_out = y;
+            }
+        }
+        for (k = -d; k <= d; k += 2) {
+            x = vb[k];
+            y = x - k;
+            if (x <= n && y >= 0 && y <= m && x + y > best) {
+                best = x + y;
+                *x_out = *u_out = n - x;
+                *y_out = *v_out = m - y;
+            }
+        }
+        return;
+    }
+}
+
+static int util_diff(struct diff_state *state, size_t a0, size_t a1, size_t b0, size_t b1) {
+    long x, y, u, v;
+
+    for (;;) {
+        /* Common prefix and suffix */
+        while (a0 < a1 && b0 < b1 && state->old.tokens[a0].hash == state->new.tokens[b0].hash) {
+            a0++;
+            b0++;
+        }
+        while (a0 < a1 && b0 < b1 && state->old.tokens[a1-1].hash == state->new.tokens[b1-1].hash) {
+            a1--;
+            b1--;
+        }
+
+        if (a0 == a1 || b0 == b1) {
+            if (a0 == a1 && b0 == b1)
+                return 0;
+            return util_emit_change(state, a0, a1, b0, b1);
+        }
+
+        util_middle_snake(state, a0, a1, b0, b1, &x, &y, &u, &v);
+        /* A split that leaves the whole problem on one side, which only a
+         * cut-off search can give, is taken as one change */
+        if ((x == 0 && y == 0 && u == 0 && v == 0) || (x == (long)(a1 - a0) && y == (long)(b1 - b0)))
+            return util_emit_change(state, a0, a1, b0, b1);
+        if (util_diff(state, a0, a0 + x, b0, b0 + y) < 0)
+            return -1;
+
+        /* The rest in place of a tail call, so a long run of cut-off
+         * searches does not nest */
+        a0 += u;
+        b0 += v;
+    }
+}
+
+int diff_render(struct ByteStream *old_bs, struct ByteStream *new_bs, int arch, int flags, FILE *out, struct diff_stats *stats, const char **error) {
+    struct diff_state state;
+    unsigned int align;
+    size_t i;
+    int ret = -1;
+
+    memset(&state, 0, sizeof(state));
+    memset(stats, 0, sizeof(struct diff_stats));
+    image_init(&state.old.image);
+    image_init(&state.new.image);
+    state.arch = arch;
+    state.flags = flags;
+    state.out = out;
+    state.stats = stats;
+
+    if (ucdisasm_arch_widths(arch, &align, &state.max_width) < 0) {
+        *error = "Unknown architecture!";
+        return -1;
+    }
+
+    if (util_side_read(&state, &state.old, old_bs) == 0 && util_side_read(&state, &state.new, new_bs) == 0) {
+        stats->old_count = state.old.count;
+        stats->new_count = state.new.count;
+
+        /* Diagonals -(n+m) to n+m, with a guard at each end */
+        state.v_len = 2*(state.old.count + state.new.count) + 4;
+
+        /* Cost cut-off about the square root of n+m, as GNU diff */
+        for (state.cost = 1, i = state.old.count + state.new.count + 3; i != 0; i >>= 2)
+            state.cost <<= 1;
+        if (state.cost < DIFF_MIN_COST)
+            state.cost = DIFF_MIN_COST;
+        if (budget_charge(2 * state.v_len * sizeof(long)) < 0) {
+            state.error = "Error allocating diff vectors!";
+        } else {
+            state.vf = malloc(state.v_len * sizeof(long));
+            state.vb = malloc(state.v_len * sizeof(long));
+            if (state.vf == NULL || state.vb == NULL)
+                state.error = "Error allocating diff vectors!";
+            else if (util_diff(&state, 0, state.old.count, 0, state.new.count) == 0 && util_hunk_flush(&state) == 0)
+                ret = 0;
+            free(state.vf);
+            free(state.vb);
+            budget_release(2 * state.v_len * sizeof(long));
+        }
+    }
+
+    util_side_free(&state.old);
+    util_side_free(&state.new);
+
+    *error = state.error;
+
+    return ret;
+}
+
@@ -0,0 +1,63 @@
+#ifndef DIFF_H
+#define DIFF_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <bytestream.h>
+#include <instruction.h>
+
+/* Instruction Diff Support
+ *
+ * Compares the disassembly of two builds of a program instruction by
+ * instruction, rather than line by line, so code that only moved is not
+ * reported as changed.
+ *
+ * Each image is read into memory and decoded in address order into compact
+ * tokens: a hash of the instruction set entry and the operands, with the
+ * values of program address operands (jump, call, and branch targets) left
+ * out, since they shift with every insertion before their targets. The token
+ * sequences are aligned with Myers' O(ND) diff in linear space, which finds
+ * the middle snake of each subproblem from both ends and needs only two
+ * vectors of O(N+M) positions besides the tokens. As in GNU diff, the search
+ * for a middle snake gives up after about sqrt(N+M) edit steps, and at least
+ * 256, and splits at the furthest reaching path instead: unrelated images
+ * take O((N+M) sqrt(N+M)) time rather than O((N+M) D), and the script may
+ * not be minimal where they differ most.
+ *
+ * The output lists each run of deleted and inserted instructions as a hunk,
+ * in unified diff style:
+ *
+ *      @@ -0x0100,2 +0x0104,3 @@
+ *      -   100:	...
+ *      +   104:	...
+ *
+ * A deleted and an inserted instruction in the same hunk count as one
+ * modified instruction. As diff(1), --diff exits with DIFF_EXIT_SAME if there
+ * are no hunks, DIFF_EXIT_DIFFERENT if there are, and DIFF_EXIT_TROUBLE on
+ * error.
+ */
+
+/* Exit statuses of --diff */
+#define DIFF_EXIT_SAME          0
+#define DIFF_EXIT_DIFFERENT     1
+#define DIFF_EXIT_TROUBLE       2
+
+struct diff_stats {
+    /* Instructions of each image */
+    uint64_t old_count, new_count;
+    /* Instructions deleted, inserted, and modified */
+    uint64_t deleted, inserted, modified;
+    unsigned int hunks;
+};
+
+/* Token of an instruction: a hash of its instruction set entry and operands,
+ * leaving out the values of program address operands */
+uint64_t diff_token_hash(struct instruction *instr);
+
+/* Write the differences between the programs read by old_bs and new_bs to
+ * out, formatting instructions with the text print flags. The byte streams
+ * are initialized and closed. Returns 0, or -1 with an error string. */
+int diff_render(struct ByteStream *old_bs, struct ByteStream *new_bs, int arch, int flags, FILE *out, struct diff_stats *stats, const char **error);
+
+#endif
+
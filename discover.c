@@ -0,0 +1,518 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <ucdisasm.h>
+#include <budget.h>
+#include <image.h>
+#include <discover.h>
+
+/* File ByteStream Support (ELF symbols) */
+#include "file/file_support.h"
+
+/* Initial worklist capacity */
+#define DISCOVER_WORKLIST_LEN       256
+/* Most AVR interrupt vectors scanned */
+#define DISCOVER_AVR_MAX_VECTORS    128
+
+/* Decoding with the source stream */
+enum {
+    DECODE_NONE,
+    /* A run of reachable code, dropping the source's directives */
+    DECODE_CODE,
+    /* No bytes, passing through the directives that close the listing */
+    DECODE_END,
+};
+
+struct discover_disasmstream_state {
+    struct DisasmStream *source;
+    /* Source's byte stream, which the memory byte stream stands in for
+     * while decoding */
+    struct ByteStream *input;
+    struct ByteStream bs_image;
+    struct discover_spec spec;
+    unsigned int align, max_width;
+
+    /* Program image, with bitmaps of its bytes decoded as code and starting
+     * an instruction */
+    struct program_image image;
+    uint8_t *code, *start;
+    /* Bytes of the bitmaps and worklist charged to the memory budget */
+    size_t charged;
+
+    /* Entry points left to follow */
+    uint32_t *worklist;
+    size_t worklist_len, worklist_capacity;
+
+    /* Next byte of the image to return */
+    uint64_t position;
+    /* Origin directive due, decoding mode, closing directives returned */
+    int origin, decoding, done;
+};
+
+int discover_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, const struct discover_spec *spec) {
+    struct discover_disasmstream_state *state;
+
+    /* Allocate stream state */
+    state = self->state = calloc(1, sizeof(struct discover_disasmstream_state));
+    if (state == NULL) {
+        self->error = "Error allocating discover stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    if (ucdisasm_arch_widths(spec->arch, &state->align, &state->max_width) < 0) {
+        free(state);
+        self->error = "Unknown discover architecture!";
+        return STREAM_ERROR_FAILURE;
+    }
+    state->source = source;
+    state->spec = *spec;
+    image_init(&state->image);
+    if (state->spec.num_entries > DISCOVER_MAX_ENTRIES)
+        state->spec.num_entries = DISCOVER_MAX_ENTRIES;
+
+    self->in = source->in;
+    self->error = NULL;
+    self->stream_init = discover_disasmstream_init;
+    self->stream_close = discover_disasmstream_close;
+    self->stream_read = discover_disasmstream_read;
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Program Image */
+/******************************************************************************/
+
+static int util_bit_test(const uint8_t *bitmap, uint64_t index) {
+    return (bitmap[index >> 3] >> (index & 7)) & 1;
+}
+
+static void util_bit_set(uint8_t *bitmap, uint64_t index) {
+    bitmap[index >> 3] |= 1 << (index & 7);
+}
+
+/* Charge the budget for a change in buffer size, returns 0, or -1 if the
+ * limit would be exceeded */
+static int util_charge(struct discover_disasmstream_state *state, size_t old_size, size_t new_size) {
+    if (new_size > old_size && budget_charge(new_size - old_size) < 0)
+        return -1;
+    if (new_size < old_size)
+        budget_release(old_size - new_size);
+    state->charged = state->charged - old_size + new_size;
+    return 0;
+}
+
+/* Allocate the code and instruction start bitmaps over the image */
+static int util_bitmaps_alloc(struct discover_disasmstream_state *state) {
+    if (state->image.size == 0)
+        return 0;
+    if (util_charge(state, 0, 2*(state->image.size/8)) < 0)
+        return -1;
+    state->code = calloc(state->image.size/8, 1);
+    state->start = calloc(state->image.size/8, 1);
+    if (state->code == NULL || state->start == NULL)
+        return -1;
+
+    return 0;
+}
+
+/* Width of the instruction at address, or 0 if its first bytes are absent */
+static unsigned int util_width_at(struct discover_disasmstream_state *state, uint32_t address) {
+    if (image_present_len(&state->image, address, state->align) < state->align)
+        return 0;
+    return ucdisasm_instruction_width(state->spec.arch, state->image.data + (address - state->image.base));
+}
+
+static int util_flow_callback(struct instruction *instr, void *arg) {
+    if (instr->type != DISASM_TYPE_INSTRUCTION)
+        return 0;
+    *(int *)arg = instr->get_flow(instr);
+    return 1;
+}
+
+/* Control flow of the instruction at address, or FLOW_INVALID */
+static int util_flow_at(struct discover_disasmstream_state *state, uint32_t address) {
+    unsigned int len;
+    int flow = FLOW_INVALID;
+
+    if ((len = image_present_len(&state->image, address, state->max_width)) == 0)
+        return FLOW_INVALID;
+    if (ucdisasm_disassemble(state->spec.arch, state->image.data + (address - state->image.base), len, address, util_flow_callback, &flow) < 0)
+        return FLOW_INVALID;
+
+    return flow;
+}
+
+/******************************************************************************/
+/* Worklist */
+/******************************************************************************/
+
+/* Add an entry point, if it is on the instruction alignment and starts
+ * undecoded bytes of the image. Returns 0, or -1 on allocation failure. */
+static int util_worklist_push(struct discover_disasmstream_state *state, uint32_t address) {
+    uint32_t *worklist;
+    size_t capacity;
+
+    if (address % state->align != 0 || image_present_len(&state->image, address, 1) == 0)
+        return 0;
+    if (util_bit_test(state->code, address - state->image.base))
+        return 0;
+
+    if (state->worklist_len == state->worklist_capacity) {
+        capacity = (state->worklist_capacity == 0) ? DISCOVER_WORKLIST_LEN : state->worklist_capacity*2;
+        if (util_charge(state, state->worklist_capacity * sizeof(uint32_t), capacity * sizeof(uint32_t)) < 0)
+            return -1;
+        if ((worklist = realloc(state->worklist, capacity * sizeof(uint32_t))) == NULL) {
+            util_charge(state, capacity * sizeof(uint32_t), state->worklist_capacity * sizeof(uint32_t));
+            return -1;
+        }
+        state->worklist = worklist;
+        state->worklist_capacity = capacity;
+    }
+    state->worklist[state->worklist_len++] = address;
+
+    return 0;
+}
+
+/* Add the entry points of the spec, the ELF file, and the architecture's
+ * reset and interrupt vectors */
+static int util_worklist_seed(struct discover_disasmstream_state *state) {
+    uint32_t *entries;
+    uint32_t vector;
+    unsigned int i, slot;
+    uint64_t offset;
+    int n, flow;
+
+    for (i = 0; i < state->spec.num_entries; i++) {
+        if (util_worklist_push(state, state->spec.entries[i]) < 0)
+            return -1;
+    }
+
+    /* ELF entry point and function symbols */
+    if (state->input->stream_read == bytestream_elf_read) {
+        if ((entries = malloc(DISCOVER_MAX_ELF_ENTRIES * sizeof(uint32_t))) == NULL)
+            return -1;
+        n = bytestream_elf_entries(state->input, entries, DISCOVER_MAX_ELF_ENTRIES);
+        for (i = 0; n > 0 && i < (unsigned int)n; i++) {
+            if (util_worklist_push(state, entries[i]) < 0) {
+                free(entries);
+                return -1;
+            }
+        }
+        free(entries);
+    }
+
+    /* Reset vector */
+    if (util_worklist_push(state, 0) < 0)
+        return -1;
+
+    switch (state->spec.arch) {
+        case UCDISASM_ARCH_AVR8:
+            /* Interrupt vectors follow reset in slots of its jump's width,
+             * each a jump, or a reti for an unused one */
+            slot = util_width_at(state, 0);
+            for (i = 1; slot > 0 && i < DISCOVER_AVR_MAX_VECTORS; i++) {
+                flow = util_flow_at(state, i*slot);
+                if (flow != FLOW_JUMP && flow != FLOW_RETURN)
+                    break;
+                if (util_worklist_push(state, i*slot) < 0)
+                    return -1;
+            }
+            break;
+        case UCDISASM_ARCH_8051:
+            /* Interrupt vectors every 8 bytes from 0x03, used ones jumping
+             * to their handlers */
+            for (vector = 0x03; vector <= 0x2b; vector += 8) {
+                flow = util_flow_at(state, vector);
+                if ((flow == FLOW_JUMP || flow == FLOW_RETURN) && util_worklist_push(state, vector) < 0)
+                    return -1;
+            }
+            break;
+        case UCDISASM_ARCH_PIC_MIDRANGE:
+        case UCDISASM_ARCH_PIC_MIDRANGE_ENHANCED:
+            /* Interrupt vector at word 0x4 */
+            if (util_worklist_push(state, 0x8) < 0)
+                return -1;
+            break;
+        case UCDISASM_ARCH_PIC_PIC18:
+            /* High and low priority interrupt vectors at 0x8 and 0x18 */
+            if (util_worklist_push(state, 0x8) < 0 || util_worklist_push(state, 0x18) < 0)
+                return -1;
+            break;
+        default:
+            break;
+    }
+
+    /* Otherwise start at the lowest address */
+    if (state->worklist_len == 0) {
+        for (offset = 0; offset < state->image.size; offset++) {
+            if (util_bit_test(state->image.present, offset))
+                return util_worklist_push(state, state->image.base + offset);
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Traversal */
+/******************************************************************************/
+
+/* Start decoding len bytes of the image at offset with the source stream */
+static int util_decode_start(struct DisasmStream *self, struct discover_disasmstream_state *state, uint64_t offset, uint64_t len, int mode) {
+    if (len > UINT32_MAX)
+        len = UINT32_MAX;
+    if (bytestream_memory_setup(&state->bs_image, state->image.data + offset, len, state->image.base + offset) < 0) {
+        self->error = state->bs_image.error;
+        return STREAM_ERROR_ALLOC;
+    }
+    state->source->in = &state->bs_image;
+    if (state->source->stream_init(state->source) < 0) {
+        self->error = state->source->error;
+        return STREAM_ERROR_INPUT;
+    }
+    state->decoding = mode;
+
+    return 0;
+}
+
+/* Stop decoding with the source stream, which closes the memory byte stream */
+static int util_decode_stop(struct DisasmStream *self, struct discover_disasmstream_state *state) {
+    int ret = 0;
+
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+    state->source->in = state->input;
+    state->decoding = DECODE_NONE;
+
+    return ret;
+}
+
+/* Whether any of width bytes at offset were decoded before */
+static int util_code_overlaps(struct discover_disasmstream_state *state, uint64_t offset, unsigned int width) {
+    unsigned int i;
+
+    for (i = 0; i < width; i++) {
+        if (util_bit_test(state->code, offset + i))
+            return 1;
+    }
+
+    return 0;
+}
+
+/* Decode the instructions reachable in a straight line from entry */
+static int util_traverse(struct DisasmStream *self, struct discover_disasmstream_state *state, uint32_t entry) {
+    struct instruction instr;
+    uint32_t address, target;
+    uint64_t offset;
+    unsigned int width, i;
+    int flow, ret, stop = 0;
+
+    offset = entry - state->image.base;
+    if ((ret = util_decode_start(self, state, offset, state->image.size - offset, DECODE_CODE)) < 0)
+        return ret;
+
+    while (!stop && (ret = state->source->stream_read(state->source, &instr)) == 0) {
+        if (instr.type == DISASM_TYPE_INSTRUCTION) {
+            address = instr.get_address(&instr);
+            width = instr.get_width(&instr);
+            flow = instr.get_flow(&instr);
+            offset = address - state->image.base;
+
+            /* Stop at data, absent bytes, or code decoded before */
+            if (flow == FLOW_INVALID || image_present_len(&state->image, address, width) < width || util_code_overlaps(state, offset, width)) {
+                stop = 1;
+            } else {
+                for (i = 0; i < width; i++)
+                    util_bit_set(state->code, offset + i);
+                util_bit_set(state->start, offset);
+
+                /* Follow the branch, jump, or call target, and the
+                 * instruction after the one a skip may skip */
+                if (instr.get_branch_target(&instr, &target) && util_worklist_push(state, target) < 0)
+                    ret = STREAM_ERROR_ALLOC;
+                if (flow == FLOW_SKIP && (i = util_width_at(state, address + width)) > 0 && util_worklist_push(state, address + width + i) < 0)
+                    ret = STREAM_ERROR_ALLOC;
+
+                if (flow == FLOW_JUMP || flow == FLOW_INDIRECT_JUMP || flow == FLOW_RETURN)
+                    stop = 1;
+            }
+        }
+        instr.free(&instr);
+        if (ret < 0)
+            break;
+    }
+
+    if (ret == STREAM_ERROR_ALLOC)
+        self->error = "Error allocating discover worklist!";
+    else if (ret < 0 && ret != STREAM_EOF)
+        self->error = state->source->error;
+    if (util_decode_stop(self, state) < 0 && (ret == 0 || ret == STREAM_EOF))
+        ret = STREAM_ERROR_INPUT;
+
+    return (ret == STREAM_EOF) ? 0 : ret;
+}
+
+/******************************************************************************/
+/* Discover Disasm Stream Support */
+/******************************************************************************/
+
+int discover_disasmstream_init(struct DisasmStream *self) {
+    struct discover_disasmstream_state *state = (struct discover_disasmstream_state *)self->state;
+    uint32_t entry;
+    int ret;
+
+    state->position = 0;
+    state->origin = 1;
+    state->decoding = DECODE_NONE;
+    state->done = 0;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the source's byte stream and read the program image */
+    state->input = state->source->in;
+    if (state->input->stream_init(state->input) < 0) {
+        self->error = state->input->error;
+        return STREAM_ERROR_INPUT;
+    }
+    if ((ret = image_read(&state->image, state->input)) < 0) {
+        self->error = (ret == STREAM_ERROR_ALLOC) ? "Error allocating program image!" : state->input->error;
+        return ret;
+    }
+    if (util_bitmaps_alloc(state) < 0) {
+        self->error = "Error allocating program image!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    /* Follow the control flow from the entry points */
+    if (util_worklist_seed(state) < 0) {
+        self->error = "Error allocating discover worklist!";
+        return STREAM_ERROR_ALLOC;
+    }
+    while (state->worklist_len > 0) {
+        entry = state->worklist[--state->worklist_len];
+        if (util_bit_test(state->code, entry - state->image.base))
+            continue;
+        if ((ret = util_traverse(self, state, entry)) < 0)
+            return ret;
+    }
+
+    /* The worklist is no longer needed */
+    util_charge(state, state->worklist_capacity * sizeof(uint32_t), 0);
+    free(state->worklist);
+    state->worklist = NULL;
+    state->worklist_capacity = 0;
+
+    return 0;
+}
+
+int discover_disasmstream_close(struct DisasmStream *self) {
+    struct discover_disasmstream_state *state = (struct discover_disasmstream_state *)self->state;
+    int ret = 0;
+
+    if (state->decoding != DECODE_NONE && util_decode_stop(self, state) < 0)
+        ret = STREAM_ERROR_INPUT;
+
+    /* Close the source's byte stream */
+    if (state->input->stream_close(state->input) < 0) {
+        self->error = state->input->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free the image and stream state memory */
+    budget_release(state->charged);
+    image_free(&state->image);
+    free(state->code);
+    free(state->start);
+    free(state->worklist);
+    free(state);
+
+    return ret;
+}
+
+int discover_disasmstream_read(struct DisasmStream *self, struct instruction *instr) {
+    struct discover_disasmstream_state *state = (struct discover_disasmstream_state *)self->state;
+    uint64_t end;
+    unsigned int len;
+    int ret;
+
+    while (1) {
+        if (state->decoding != DECODE_NONE) {
+            ret = state->source->stream_read(state->source, instr);
+            if (ret == 0) {
+                if (instr->type == DISASM_TYPE_INSTRUCTION)
+                    state->position = instr->get_address(instr) + instr->get_width(instr) - state->image.base;
+                else if (state->decoding == DECODE_CODE) {
+                    /* Origin and end directives of the run */
+                    instr->free(instr);
+                    continue;
+                }
+                return 0;
+            } else if (ret != STREAM_EOF) {
+                self->error = state->source->error;
+                return ret;
+            }
+            if ((ret = util_decode_stop(self, state)) < 0)
+                return ret;
+            continue;
+        }
+
+        if (state->done)
+            return STREAM_EOF;
+
+        /* Skip the addresses absent from the input */
+        while (state->position < state->image.size && !util_bit_test(state->image.present, state->position)) {
+            if ((state->position & 7) == 0 && state->image.present[state->position >> 3] == 0)
+                state->position += 8;
+            else
+                state->position++;
+            state->origin = 1;
+        }
+
+        /* Let the source close the listing, e.g. with an end directive */
+        if (state->position >= state->image.size) {
+            state->done = 1;
+            if ((ret = util_decode_start(self, state, state->image.size, 0, DECODE_END)) < 0)
+                return ret;
+            continue;
+        }
+
+        if (state->origin) {
+            state->origin = 0;
+            if (ucdisasm_origin_directive(state->spec.arch, state->image.base + state->position, instr) < 0) {
+                self->error = "Error allocating memory for directive!";
+                return STREAM_ERROR_FAILURE;
+            }
+            return 0;
+        }
+
+        /* Decode a run of reachable code again */
+        if (util_bit_test(state->start, state->position)) {
+            for (end = state->position; end < state->image.size && util_bit_test(state->code, end); end++)
+                ;
+            if ((ret = util_decode_start(self, state, state->position, end - state->position, DECODE_CODE)) < 0)
+                return ret;
+            continue;
+        }
+
+        /* Data, up to a word of present bytes that are not code */
+        for (len = 0; len < state->align && state->position + len < state->image.size; len++) {
+            if (!util_bit_test(state->image.present, state->position + len) || util_bit_test(state->code, state->position + len))
+                break;
+        }
+        if ((ret = ucdisasm_raw_instruction(state->spec.arch, state->image.data + state->position, len, state->image.base + state->position, instr)) < 0) {
+            self->error = "Error allocating memory for disassembled instruction!";
+            return ret;
+        }
+        state->position += ret;
+        return 0;
+    }
+}
+
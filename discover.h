@@ -0,0 +1,55 @@
+#ifndef DISCOVER_H
+#define DISCOVER_H
+
+#include <stdint.h>
+#include <bytestream.h>
+#include <disasmstream.h>
+
+/* Recursive Descent Support
+ *
+ * Disassembles only the code reachable from the program's entry points,
+ * rather than sweeping linearly through every byte, so data tables and
+ * strings in program memory are listed as data instead of as instructions.
+ *
+ * At init, the discover disasm stream reads the whole program image from the
+ * source's byte stream into memory and follows its control flow from a
+ * worklist of entry points: the reset and interrupt vectors of the
+ * architecture, the entry point and function symbols of an ELF file, and the
+ * entries of the spec. From each entry, the source Disasm Stream decodes the
+ * image through a memory byte stream, one instruction after another, until an
+ * instruction that does not continue to the next (a jump, return, or
+ * computed jump), an invalid instruction, or bytes already decoded. Branch,
+ * jump, and call targets, and the instruction after one that may be skipped,
+ * are added to the worklist. A bitmap over the image marks the decoded bytes,
+ * so each byte is decoded at most once.
+ *
+ * Reads then return the image in address order: the reachable instructions,
+ * decoded again by the source, and all other bytes as raw .dw / .db data,
+ * with origin directives at the start and after gaps in the addresses. The
+ * image and its bitmaps are charged to the memory budget.
+ */
+
+/* Most entry points in a spec */
+#define DISCOVER_MAX_ENTRIES        64
+/* Most ELF entry point and function symbols followed */
+#define DISCOVER_MAX_ELF_ENTRIES    4096
+
+struct discover_spec {
+    /* Architecture (UCDISASM_ARCH_*) */
+    int arch;
+    /* Entry points in addition to the vectors */
+    uint32_t entries[DISCOVER_MAX_ENTRIES];
+    unsigned int num_entries;
+};
+
+/* Setup self to disassemble the code reachable in the image read by the
+ * source stream's byte stream, decoding it with the source stream */
+int discover_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, const struct discover_spec *spec);
+
+/* Discover Disasm Stream Support */
+int discover_disasmstream_init(struct DisasmStream *self);
+int discover_disasmstream_close(struct DisasmStream *self);
+int discover_disasmstream_read(struct DisasmStream *self, struct instruction *instr);
+
+#endif
+
@@ -0,0 +1,161 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <fanout.h>
+
+/******************************************************************************/
+/* Fan-out Disasm Stream Support */
+/******************************************************************************/
+
+struct fanout_state;
+
+/* Per-branch state */
+struct fanout_branch_state {
+    struct fanout_state *fanout;
+    /* Number of instructions this branch has consumed */
+    unsigned long consumed;
+};
+
+/* Shared state */
+struct fanout_state {
+    struct DisasmStream *source;
+
+    /* Branches, and the number initialized and still open */
+    struct fanout_branch_state *branches;
+    unsigned int num_branches;
+    unsigned int num_initialized;
+    unsigned int num_open;
+
+    /* Instruction currently handed out to the branches */
+    struct instruction current;
+    int have_current;
+    /* Number of instructions read from the source */
+    unsigned long fetched;
+
+    /* Final return code and error once the source has finished */
+    int done;
+    char *error;
+};
+
+int fanout_disasmstream_setup(struct DisasmStream *branches, unsigned int num_branches, struct DisasmStream *source) {
+    struct fanout_state *state;
+    unsigned int i;
+
+    /* Allocate shared state, with the branch states trailing it */
+    state = calloc(1, sizeof(struct fanout_state) + num_branches * sizeof(struct fanout_branch_state));
+    if (state == NULL) {
+        branches[0].error = "Error allocating fan-out stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->source = source;
+    state->branches = (struct fanout_branch_state *)(state + 1);
+    state->num_branches = num_branches;
+
+    for (i = 0; i < num_branches; i++) {
+        state->branches[i].fanout = state;
+        branches[i].in = source->in;
+        branches[i].state = &state->branches[i];
+        branches[i].error = NULL;
+        branches[i].stream_init = fanout_disasmstream_init;
+        branches[i].stream_close = fanout_disasmstream_close;
+        branches[i].stream_read = fanout_disasmstream_read;
+    }
+
+    return 0;
+}
+
+/* Branches receive a borrowed instruction, the fan-out frees the original */
+static void fanout_instruction_free(struct instruction *instr) {
+    instr->data = NULL;
+}
+
+int fanout_disasmstream_init(struct DisasmStream *self) {
+    struct fanout_state *state = ((struct fanout_branch_state *)self->state)->fanout;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the source stream with the first branch */
+    if (state->num_initialized++ == 0) {
+        if (state->source->stream_init(state->source) < 0) {
+            self->error = state->source->error;
+            return STREAM_ERROR_INPUT;
+        }
+    }
+    state->num_open++;
+
+    return 0;
+}
+
+int fanout_disasmstream_close(struct DisasmStream *self) {
+    struct fanout_state *state = ((struct fanout_branch_state *)self->state)->fanout;
+    int ret = 0;
+
+    if (--state->num_open > 0)
+        return 0;
+
+    /* Last branch closed, free the outstanding instruction */
+    if (state->have_current)
+        state->current.free(&state->current);
+
+    /* Close the source stream */
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free shared state memory */
+    free(state);
+
+    return ret;
+}
+
+int fanout_disasmstream_read(struct DisasmStream *self, struct instruction *instr) {
+    struct fanout_branch_state *branch = (struct fanout_branch_state *)self->state;
+    struct fanout_state *state = branch->fanout;
+    unsigned int i;
+    int ret;
+
+    /* If this branch has caught up, fetch the next instruction */
+    if (branch->consumed == state->fetched) {
+        if (state->done) {
+            self->error = state->error;
+            return state->done;
+        }
+
+        /* Every branch must be done with the current instruction */
+        for (i = 0; i < state->num_branches; i++) {
+            if (state->branches[i].consumed != state->fetched) {
+                self->error = "Fan-out branches read out of step!";
+                return STREAM_ERROR_FAILURE;
+            }
+        }
+
+        if (state->have_current) {
+            state->current.free(&state->current);
+            state->have_current = 0;
+        }
+
+        ret = state->source->stream_read(state->source, &state->current);
+        if (ret != 0) {
+            state->done = ret;
+            state->error = state->source->error;
+            self->error = state->error;
+            return ret;
+        }
+        state->have_current = 1;
+        state->fetched++;
+    }
+
+    /* Lend out the current instruction */
+    *instr = state->current;
+    instr->free = fanout_instruction_free;
+    branch->consumed++;
+
+    return 0;
+}
+
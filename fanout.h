@@ -0,0 +1,26 @@
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <disasmstream.h>
+
+/* Fan-out Stream Support
+ *
+ * A fan-out splits one source DisasmStream into several branch DisasmStreams,
+ * so that multiple PrintStreams can render the same decoded instructions in a
+ * single pass over the input. Each instruction is decoded once and handed to
+ * every branch; the fan-out keeps ownership and frees it once all branches
+ * have moved past it, so the branches must be read in lockstep, one
+ * instruction each per round. The first branch initialized initializes the
+ * source, and the last branch closed closes it.
+ */
+
+/* Setup num_branches branch streams fed from the source stream */
+int fanout_disasmstream_setup(struct DisasmStream *branches, unsigned int num_branches, struct DisasmStream *source);
+
+/* Fan-out Branch Disasm Stream Support */
+int fanout_disasmstream_init(struct DisasmStream *self);
+int fanout_disasmstream_close(struct DisasmStream *self);
+int fanout_disasmstream_read(struct DisasmStream *self, struct instruction *instr);
+
+#endif
+
@@ -3,52 +3,137 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
-#include <sys/mman.h>
 
 #include <bytestream.h>
+#include <budget.h>
+
+/* Largest copy of an input that cannot seek held in memory, larger inputs
+ * are copied to a temporary file */
+#define ELF_MAX_IMAGE   (1024*1024)
 
 struct bytestream_elf_state {
-    /* Memory mapped ELF file */
-    Elf64_Ehdr *elf;
-    /* Pointer to .text data in memory map */
-    uint8_t *text;
-    /* Instruction address */
+    /* Copy of an input that cannot seek, in memory or in a temporary file,
+     * or NULL */
+    FILE *spill;
+    uint8_t *image;
+    size_t image_size;
+    /* ELF file, positioned in the .text section */
+    FILE *fp;
+    /* Instruction address, within the .text section */
     uint64_t address_current;
-    uint64_t address_end;
+    uint64_t address_start, address_end;
     /* Size of ELF file */
     long size;
 };
 
-/* Finds the section header by name, or NULL if not found. */
-Elf64_Shdr *find_sh(Elf64_Ehdr *elf, char *name) {
-    Elf64_Shdr *shtab;
-    char *strtab;
+/* Reads len bytes at offset, returns 0 on success */
+static int read_at(FILE *fp, long offset, void *dest, size_t len) {
+    if (fseek(fp, offset, SEEK_SET) < 0)
+        return -1;
+    if (fread(dest, 1, len, fp) != len)
+        return -1;
+    return 0;
+}
+
+/* Finds the section header by name, returns 0 and fills in sh on success.
+ * Headers are read one at a time and bounds checked against the file size,
+ * so a malformed file is rejected rather than read out of bounds. */
+static int find_sh(FILE *fp, long size, const char *name, Elf64_Shdr *sh) {
+    Elf64_Ehdr elf;
+    Elf64_Shdr strtab;
+    char sh_name[16];
+    size_t name_len = strlen(name) + 1;
     int i;
 
-    shtab = (void *)elf + elf->e_shoff;
-    strtab = (void *)elf + shtab[elf->e_shstrndx].sh_offset;
+    if (name_len > sizeof(sh_name))
+        return -1;
+    if (read_at(fp, 0, &elf, sizeof(elf)) < 0)
+        return -1;
+    if (memcmp(elf.e_ident, ELFMAG, SELFMAG) != 0 || elf.e_ident[EI_CLASS] != ELFCLASS64)
+        return -1;
+    if (elf.e_shentsize != sizeof(Elf64_Shdr) || elf.e_shstrndx >= elf.e_shnum)
+        return -1;
+    if (elf.e_shoff > (uint64_t)size || (uint64_t)elf.e_shnum * sizeof(Elf64_Shdr) > (uint64_t)size - elf.e_shoff)
+        return -1;
+
+    if (read_at(fp, elf.e_shoff + elf.e_shstrndx * sizeof(Elf64_Shdr), &strtab, sizeof(strtab)) < 0)
+        return -1;
+    if (strtab.sh_offset > (uint64_t)size || strtab.sh_size > (uint64_t)size - strtab.sh_offset)
+        return -1;
 
-    for (i = 0; i < elf->e_shnum; i++) {
-        Elf64_Shdr *sh = &(shtab[i]);
-        char *found = strtab + sh->sh_name;
-        if (strcmp(found, name) == 0)
-            return sh;
+    for (i = 0; i < elf.e_shnum; i++) {
+        if (read_at(fp, elf.e_shoff + i * sizeof(Elf64_Shdr), sh, sizeof(Elf64_Shdr)) < 0)
+            return -1;
+        /* Compare the name, terminator included, within the string table */
+        if (sh->sh_name >= strtab.sh_size || name_len > strtab.sh_size - sh->sh_name)
+            continue;
+        if (read_at(fp, strtab.sh_offset + sh->sh_name, sh_name, name_len) < 0)
+            return -1;
+        if (memcmp(sh_name, name, name_len) == 0)
+            return 0;
     }
 
-    return NULL;
+    return -1;
 }
 
-/* Returns pointer to memory mapped ELF file. */
-Elf64_Ehdr *mmap_elf(FILE *fp, long size) {
-    int fd;
+/* Copies the rest of in to an in-memory image of up to ELF_MAX_IMAGE bytes,
+ * as far as the memory budget allows, and to a temporary file beyond that.
+ * Returns the copy rewound, or NULL on failure. */
+static FILE *spill_file(FILE *in, struct bytestream_elf_state *state) {
+    uint8_t buf[4096];
+    size_t len, image_len = 0;
+    uint8_t *image;
+    FILE *fp = NULL;
 
-    fd = fileno(fp);
-    if (fd < 0)
-        return NULL;
-    return mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    while ((len = fread(buf, 1, sizeof(buf), in)) > 0) {
+        /* Grow the image by doubling, charging the growth to the budget */
+        if (fp == NULL && image_len + len > state->image_size) {
+            size_t size = (state->image_size == 0) ? 65536 : state->image_size * 2;
+
+            image = NULL;
+            if (size <= ELF_MAX_IMAGE && budget_charge(size - state->image_size) == 0 && (image = realloc(state->image, size)) == NULL)
+                budget_release(size - state->image_size);
+            if (image != NULL) {
+                state->image = image;
+                state->image_size = size;
+            } else {
+                /* Too large or out of budget, continue in a temporary file */
+                if ((fp = tmpfile()) == NULL || fwrite(state->image, 1, image_len, fp) != image_len)
+                    goto fail;
+            }
+        }
+
+        if (fp != NULL) {
+            if (fwrite(buf, 1, len, fp) != len)
+                goto fail;
+        } else {
+            memcpy(state->image + image_len, buf, len);
+            image_len += len;
+        }
+    }
+    if (ferror(in))
+        goto fail;
+
+    if (fp != NULL) {
+        /* The image is in the file */
+        budget_release(state->image_size);
+        free(state->image);
+        state->image = NULL;
+        state->image_size = 0;
+        rewind(fp);
+        return fp;
+    }
+    if (image_len == 0)
+        return tmpfile();
+    return fmemopen(state->image, image_len, "r");
+
+    fail:
+    if (fp != NULL)
+        fclose(fp);
+    return NULL;
 }
 
-long filesize(FILE *fp) {
+static long filesize(FILE *fp) {
     long size;
 
     if (fseek(fp, 0, SEEK_END) < 0)
@@ -62,6 +147,7 @@ long filesize(FILE *fp) {
 /* Init function */
 int bytestream_elf_init(struct ByteStream *self) {
     struct bytestream_elf_state *state;
+    Elf64_Shdr text_sh;
 
     state = self->state = calloc(1, sizeof(struct bytestream_elf_state));
     if (state == NULL) {
@@ -69,26 +155,38 @@ int bytestream_elf_init(struct ByteStream *self) {
         return STREAM_ERROR_ALLOC;
     }
 
-    state->size = filesize(self->in);
+    /* Section headers are usually at the end of the file, so copy an input
+     * that cannot seek, e.g. standard input or a gzip file, to memory if it
+     * is small, or to a temporary file */
+    state->fp = self->in;
+    if ((state->size = filesize(state->fp)) < 0) {
+        if ((state->spill = spill_file(self->in, state)) == NULL) {
+            self->error = "Error copying ELF file!";
+            return STREAM_ERROR_INPUT;
+        }
+        state->fp = state->spill;
+        state->size = filesize(state->fp);
+    }
     if (state->size < 0) {
         self->error = "Error getting size of file!";
         return STREAM_ERROR_ALLOC;
     }
 
-    state->elf = mmap_elf(self->in, state->size);
-    if (state->elf == NULL) {
-        self->error = "mmap() failed!";
-        return STREAM_ERROR_ALLOC;
+    if (state->size < (long)sizeof(Elf64_Ehdr)) {
+        self->error = "File too small for an ELF header!";
+        return STREAM_ERROR_INPUT;
     }
 
-    Elf64_Shdr *text_sh = find_sh(state->elf, ".text");
-    if (text_sh == NULL) {
+    if (find_sh(state->fp, state->size, ".text", &text_sh) < 0 || text_sh.sh_offset > (uint64_t)state->size || text_sh.sh_size > (uint64_t)state->size - text_sh.sh_offset) {
         self->error = ".text section not found!";
         return STREAM_ERROR_ALLOC;
     }
-    state->text = (uint8_t *)state->elf + text_sh->sh_offset;
-    state->address_current = text_sh->sh_addr;
-    state->address_end = text_sh->sh_addr + text_sh->sh_size;
+    if (fseek(state->fp, text_sh.sh_offset, SEEK_SET) < 0) {
+        self->error = "Error seeking to .text section!";
+        return STREAM_ERROR_INPUT;
+    }
+    state->address_current = state->address_start = text_sh.sh_addr;
+    state->address_end = text_sh.sh_addr + text_sh.sh_size;
 
     self->error = NULL;
 
@@ -99,22 +197,66 @@ int bytestream_elf_init(struct ByteStream *self) {
 int bytestream_elf_close(struct ByteStream *self) {
     struct bytestream_elf_state *state = self->state;
 
-    munmap(state->elf, state->size);
+    if (state->spill != NULL)
+        fclose(state->spill);
+    if (state->image != NULL)
+        budget_release(state->image_size);
+    free(state->image);
     free(state);
     fclose(self->in);
 
     return 0;
 }
 
+/* Entry points function, after init */
+int bytestream_elf_entries(struct ByteStream *self, uint32_t *entries, unsigned int max_entries) {
+    struct bytestream_elf_state *state = self->state;
+    Elf64_Ehdr elf;
+    Elf64_Shdr symtab_sh;
+    Elf64_Sym sym;
+    unsigned int num_entries = 0;
+    uint64_t i;
+    long position;
+
+    /* Restore the position in the .text section after */
+    if ((position = ftell(state->fp)) < 0)
+        return -1;
+
+    if (read_at(state->fp, 0, &elf, sizeof(elf)) == 0 && elf.e_entry >= state->address_start && elf.e_entry < state->address_end && num_entries < max_entries)
+        entries[num_entries++] = elf.e_entry;
+
+    /* Functions defined in the .text section */
+    if (find_sh(state->fp, state->size, ".symtab", &symtab_sh) == 0 && symtab_sh.sh_offset <= (uint64_t)state->size && symtab_sh.sh_size <= (uint64_t)state->size - symtab_sh.sh_offset) {
+        for (i = 0; i + sizeof(Elf64_Sym) <= symtab_sh.sh_size && num_entries < max_entries; i += sizeof(Elf64_Sym)) {
+            if (read_at(state->fp, symtab_sh.sh_offset + i, &sym, sizeof(sym)) < 0)
+                break;
+            if (ELF64_ST_TYPE(sym.st_info) == STT_FUNC && sym.st_value >= state->address_start && sym.st_value < state->address_end)
+                entries[num_entries++] = sym.st_value;
+        }
+    }
+
+    if (fseek(state->fp, position, SEEK_SET) < 0)
+        return -1;
+
+    return num_entries;
+}
+
 /* Output function */
 int bytestream_elf_read(struct ByteStream *self, uint8_t *data, uint32_t *address) {
     struct bytestream_elf_state *state = self->state;
+    int c;
 
     if (state->address_current == state->address_end)
         return STREAM_EOF;
 
-    *data = *state->text++;
+    if ((c = fgetc(state->fp)) == EOF) {
+        self->error = "Error reading .text section!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    *data = c;
     *address = state->address_current++;
 
     return 0;
 }
+
@@ -29,3 +29,12 @@ int bytestream_asciihex_read(struct ByteStream *self, uint8_t *data, uint32_t *a
 int bytestream_elf_init(struct ByteStream *self);
 int bytestream_elf_close(struct ByteStream *self);
 int bytestream_elf_read(struct ByteStream *self, uint8_t *data, uint32_t *address);
+/* Entry point and function symbol addresses within the .text section, after
+ * init. Returns the number stored in entries, or -1 on failure. */
+int bytestream_elf_entries(struct ByteStream *self, uint32_t *entries, unsigned int max_entries);
+
+/* Memory Byte Stream Support, reads a caller owned buffer starting at address */
+int bytestream_memory_setup(struct ByteStream *self, const uint8_t *data, uint32_t len, uint32_t address);
+int bytestream_memory_init(struct ByteStream *self);
+int bytestream_memory_close(struct ByteStream *self);
+int bytestream_memory_read(struct ByteStream *self, uint8_t *data, uint32_t *address);
@@ -0,0 +1,220 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <zlib.h>
+
+#include <ring.h>
+#include "gzip.h"
+
+/******************************************************************************/
+/* Gzip Input Support */
+/******************************************************************************/
+
+/* A block of decompressed data, and the end of the stream if empty */
+struct gzip_block {
+    size_t len;
+    /* Error that ended the stream, or NULL */
+    const char *error;
+    uint8_t data[GZIP_BLOCK_LEN];
+};
+
+struct gzip_input {
+    FILE *in;
+    z_stream strm;
+    uint8_t in_buf[GZIP_BLOCK_LEN];
+    int in_eof;
+    /* Set at the end of the stream, with the error that ended it if any */
+    int done;
+    const char *error;
+
+    /* Blocks decompressed on the thread, or decompressed on demand into
+     * block if there is no thread */
+    struct ring ring;
+    pthread_t thread;
+    int threaded;
+    struct gzip_block *block;
+    size_t position;
+};
+
+int gzip_detect(FILE *in) {
+    int c1, c2;
+
+    c1 = fgetc(in);
+    if (c1 == EOF)
+        return 0;
+    c2 = fgetc(in);
+    if (c2 != EOF)
+        ungetc(c2, in);
+    ungetc(c1, in);
+
+    return c1 == 0x1f && c2 == 0x8b;
+}
+
+/* Decompress up to a block of data, an empty block at the end of the
+ * stream. Data decompressed before an error is returned first, and the
+ * error with the empty block after it. */
+static void gzip_inflate_block(struct gzip_input *input, struct gzip_block *block) {
+    z_stream *strm = &input->strm;
+    size_t len;
+    int ret;
+
+    block->len = 0;
+    block->error = input->error;
+    if (input->done)
+        return;
+
+    strm->next_out = block->data;
+    strm->avail_out = GZIP_BLOCK_LEN;
+
+    while (strm->avail_out > 0) {
+        if (strm->avail_in == 0 && !input->in_eof) {
+            len = fread(input->in_buf, 1, sizeof(input->in_buf), input->in);
+            if (len == 0) {
+                if (ferror(input->in)) {
+                    input->error = "Error reading gzip file!";
+                    break;
+                }
+                input->in_eof = 1;
+            }
+            strm->next_in = input->in_buf;
+            strm->avail_in = len;
+        }
+
+        ret = inflate(strm, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            /* Another gzip member may follow */
+            if (strm->avail_in == 0 && !input->in_eof) {
+                len = fread(input->in_buf, 1, sizeof(input->in_buf), input->in);
+                strm->next_in = input->in_buf;
+                strm->avail_in = len;
+                if (len == 0)
+                    input->in_eof = 1;
+            }
+            if (strm->avail_in == 0) {
+                input->done = 1;
+                break;
+            }
+            inflateReset(strm);
+        } else if (ret == Z_BUF_ERROR && strm->avail_in == 0 && input->in_eof) {
+            input->error = "Unexpected end of gzip file!";
+            break;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            input->error = "Invalid gzip data!";
+            break;
+        }
+    }
+
+    if (input->error != NULL)
+        input->done = 1;
+
+    block->len = GZIP_BLOCK_LEN - strm->avail_out;
+    if (block->len == 0)
+        block->error = input->error;
+}
+
+static void *gzip_inflate_thread(void *arg) {
+    struct gzip_input *input = (struct gzip_input *)arg;
+    struct gzip_block *block;
+
+    do {
+        if ((block = ring_write_acquire(&input->ring)) == NULL)
+            break;
+        gzip_inflate_block(input, block);
+        ring_write_commit(&input->ring);
+    } while (block->len > 0);
+
+    return NULL;
+}
+
+static ssize_t gzip_input_read(void *cookie, char *buf, size_t size) {
+    struct gzip_input *input = (struct gzip_input *)cookie;
+    struct gzip_block *block;
+    size_t len;
+
+    /* Move on to the next block once this one is read */
+    while (input->block == NULL || input->position == input->block->len) {
+        if (input->block != NULL && input->block->len == 0) {
+            /* End of stream */
+            if (input->block->error != NULL) {
+                errno = EIO;
+                return -1;
+            }
+            return 0;
+        }
+
+        if (input->threaded) {
+            if (input->block != NULL)
+                ring_read_release(&input->ring);
+            if ((input->block = ring_read_acquire(&input->ring)) == NULL)
+                return 0;
+        } else {
+            if (input->block == NULL && (input->block = malloc(sizeof(struct gzip_block))) == NULL)
+                return -1;
+            gzip_inflate_block(input, input->block);
+        }
+        input->position = 0;
+    }
+
+    block = input->block;
+    len = block->len - input->position;
+    if (len > size)
+        len = size;
+    memcpy(buf, block->data + input->position, len);
+    input->position += len;
+
+    return len;
+}
+
+static int gzip_input_close(void *cookie) {
+    struct gzip_input *input = (struct gzip_input *)cookie;
+    int ret;
+
+    if (input->threaded) {
+        ring_close(&input->ring);
+        pthread_join(input->thread, NULL);
+        ring_free(&input->ring);
+    } else {
+        free(input->block);
+    }
+    inflateEnd(&input->strm);
+    ret = fclose(input->in);
+    free(input);
+
+    return ret;
+}
+
+FILE *gzip_input_open(FILE *in) {
+    cookie_io_functions_t functions = {gzip_input_read, NULL, NULL, gzip_input_close};
+    struct gzip_input *input;
+    FILE *fp;
+
+    if ((input = calloc(1, sizeof(struct gzip_input))) == NULL)
+        return NULL;
+    input->in = in;
+
+    /* Accept only the gzip format, with 16 added to the window bits */
+    if (inflateInit2(&input->strm, 16 + MAX_WBITS) != Z_OK) {
+        free(input);
+        return NULL;
+    }
+
+    if ((fp = fopencookie(input, "r", functions)) == NULL) {
+        inflateEnd(&input->strm);
+        free(input);
+        return NULL;
+    }
+
+    /* Decompress ahead on a thread, if the ring fits in the memory budget */
+    if (ring_init(&input->ring, GZIP_RING_SLOTS, sizeof(struct gzip_block)) == 0) {
+        if (pthread_create(&input->thread, NULL, gzip_inflate_thread, input) == 0)
+            input->threaded = 1;
+        else
+            ring_free(&input->ring);
+    }
+
+    return fp;
+}
+
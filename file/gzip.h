@@ -0,0 +1,29 @@
+#ifndef GZIP_H
+#define GZIP_H
+
+#include <stdio.h>
+
+/* Gzip Input Support
+ *
+ * Program files compressed with gzip, e.g. firmware.hex.gz, are read
+ * through a stream of their decompressed contents, so every byte stream,
+ * including ELF, reads them without a temporary file. Decompression with
+ * zlib runs a block at a time on its own thread, a few blocks ahead of the
+ * reader, or on the reader's thread if a thread cannot be started.
+ * Concatenated gzip members are read as one file.
+ */
+
+/* Decompressed block size */
+#define GZIP_BLOCK_LEN          (64*1024)
+/* Blocks decompressed ahead of the reader, a power of two */
+#define GZIP_RING_SLOTS         8
+
+/* Returns 1 if in starts with the gzip magic, leaving in unread */
+int gzip_detect(FILE *in);
+
+/* Open a stream decompressing in, which is closed with it. Returns NULL on
+ * failure, leaving in open. */
+FILE *gzip_input_open(FILE *in);
+
+#endif
+
@@ -10,7 +10,7 @@
 #include "srecord.h"
 
 /* Lengths of the ASCII hex encoded address fields of different SRecord types */ 
-static int SRecord_Address_Lengths[] = {
+static const int SRecord_Address_Lengths[] = {
 	4, // S0
 	4, // S1
 	6, // S2
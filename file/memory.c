@@ -0,0 +1,83 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <bytestream.h>
+
+/******************************************************************************/
+/* Memory Byte Stream Support */
+/******************************************************************************/
+
+struct bytestream_memory_state {
+    const uint8_t *data;
+    uint32_t len;
+    uint32_t address;
+    uint32_t index;
+};
+
+int bytestream_memory_init(struct ByteStream *self) {
+    /* Rewind to the start of the buffer */
+    ((struct bytestream_memory_state *)self->state)->index = 0;
+
+    /* Reset error string to NULL */
+    self->error = NULL;
+
+    /* Initialize the input stream */
+    /* NULL file input */
+
+    return 0;
+}
+
+int bytestream_memory_close(struct ByteStream *self) {
+    /* Free stream state memory */
+    free(self->state);
+
+    /* Close input stream */
+    /* NULL file input, the buffer belongs to the caller */
+
+    return 0;
+}
+
+int bytestream_memory_read(struct ByteStream *self, uint8_t *data, uint32_t *address) {
+    struct bytestream_memory_state *state = (struct bytestream_memory_state *)self->state;
+
+    /* If we have no more data left in the buffer */
+    if (state->index == state->len)
+        return STREAM_EOF;
+
+    *data = state->data[state->index];
+    *address = state->address + state->index;
+    state->index++;
+
+    return 0;
+}
+
+int bytestream_memory_setup(struct ByteStream *self, const uint8_t *data, uint32_t len, uint32_t address) {
+    struct bytestream_memory_state *state;
+
+    /* Allocate stream state */
+    self->state = malloc(sizeof(struct bytestream_memory_state));
+    if (self->state == NULL) {
+        self->error = "Error allocating opcode stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    /* Initialize stream state */
+    state = (struct bytestream_memory_state *)self->state;
+    state->data = data;
+    state->len = len;
+    state->address = address;
+    state->index = 0;
+
+    /* No input file */
+    self->in = NULL;
+    self->error = NULL;
+
+    self->stream_init = bytestream_memory_init;
+    self->stream_close = bytestream_memory_close;
+    self->stream_read = bytestream_memory_read;
+
+    return 0;
+}
+
@@ -0,0 +1,606 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include <budget.h>
+#include "prefetch.h"
+
+/******************************************************************************/
+/* Prefetching File Reader Support */
+/******************************************************************************/
+
+enum {
+    /* Slot states */
+    PREFETCH_SLOT_FREE,
+    PREFETCH_SLOT_OPENING,
+    PREFETCH_SLOT_READING,
+    PREFETCH_SLOT_READY,
+    PREFETCH_SLOT_IN_USE,
+};
+
+enum {
+    /* File states */
+    PREFETCH_FILE_PENDING,
+    PREFETCH_FILE_PREFETCHED,
+    PREFETCH_FILE_DIRECT,
+};
+
+struct prefetch_slot {
+    int state;
+    unsigned int index;
+    int fd;
+    /* errno of a failed open or read */
+    int error;
+    uint8_t *buffer;
+    size_t len;
+};
+
+struct prefetch_uring {
+    int fd;
+    void *sq_ptr, *cq_ptr;
+    size_t sq_len, cq_len;
+    struct io_uring_sqe *sqes;
+    size_t sqes_len;
+    unsigned int *sq_tail, *sq_mask, *sq_array;
+    unsigned int *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+    /* Entries queued but not yet submitted, and submitted but not completed */
+    unsigned int to_submit, in_flight;
+};
+
+struct prefetch {
+    const char *const *paths;
+    unsigned int num_paths;
+    /* Next file to prefetch */
+    unsigned int next;
+    uint8_t *files;
+
+    struct prefetch_slot *slots;
+    unsigned int num_slots;
+    size_t buffer_size;
+
+    int backend;
+    struct prefetch_uring uring;
+    pthread_t *threads;
+    unsigned int num_threads;
+
+    int stop;
+    pthread_mutex_t lock;
+    /* Signalled when a slot becomes ready or free, and on stop */
+    pthread_cond_t cond;
+};
+
+/* Assign the next pending file to a free slot, with the lock held. Returns
+ * NULL if there is no free slot or no pending file. */
+static struct prefetch_slot *prefetch_claim(struct prefetch *p) {
+    unsigned int i;
+
+    while (p->next < p->num_paths && p->files[p->next] != PREFETCH_FILE_PENDING)
+        p->next++;
+    if (p->next == p->num_paths)
+        return NULL;
+
+    for (i = 0; i < p->num_slots; i++) {
+        if (p->slots[i].state == PREFETCH_SLOT_FREE) {
+            p->slots[i].state = PREFETCH_SLOT_OPENING;
+            p->slots[i].index = p->next;
+            p->slots[i].fd = -1;
+            p->slots[i].error = 0;
+            p->slots[i].len = 0;
+            p->files[p->next++] = PREFETCH_FILE_PREFETCHED;
+            return &p->slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Complete a slot's read, with the lock held */
+static void prefetch_ready(struct prefetch *p, struct prefetch_slot *slot, int error) {
+    slot->error = error;
+    slot->state = PREFETCH_SLOT_READY;
+    pthread_cond_broadcast(&p->cond);
+}
+
+/******************************************************************************/
+/* io_uring Backend */
+/******************************************************************************/
+
+static int util_io_uring_setup(unsigned int entries, struct io_uring_params *params) {
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int util_io_uring_enter(int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags) {
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int util_io_uring_register(int fd, unsigned int opcode, void *arg, unsigned int nr_args) {
+    return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void prefetch_uring_free(struct prefetch_uring *uring) {
+    if (uring->sqes != NULL)
+        munmap(uring->sqes, uring->sqes_len);
+    if (uring->cq_ptr != NULL && uring->cq_ptr != uring->sq_ptr)
+        munmap(uring->cq_ptr, uring->cq_len);
+    if (uring->sq_ptr != NULL)
+        munmap(uring->sq_ptr, uring->sq_len);
+    close(uring->fd);
+    uring->fd = -1;
+}
+
+/* Set up a ring of at least entries, checking that the kernel supports the
+ * operations used */
+static int prefetch_uring_init(struct prefetch_uring *uring, unsigned int entries) {
+    struct io_uring_params params;
+    struct io_uring_probe *probe;
+    size_t probe_len;
+    int supported;
+    uint8_t *sq, *cq;
+
+    memset(uring, 0, sizeof(struct prefetch_uring));
+    memset(&params, 0, sizeof(params));
+    if ((uring->fd = util_io_uring_setup(entries, &params)) < 0) {
+        uring->fd = -1;
+        return -1;
+    }
+
+    /* OPENAT and READ are available from Linux 5.6 */
+    probe_len = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    if ((probe = calloc(1, probe_len)) == NULL) {
+        prefetch_uring_free(uring);
+        return -1;
+    }
+    supported = util_io_uring_register(uring->fd, IORING_REGISTER_PROBE, probe, 256) == 0 &&
+                probe->ops_len > IORING_OP_OPENAT && (probe->ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED) &&
+                probe->ops_len > IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    if (!supported) {
+        prefetch_uring_free(uring);
+        return -1;
+    }
+
+    /* Map the submission and completion rings, and the submission entries */
+    uring->sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    uring->cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (uring->cq_len > uring->sq_len)
+            uring->sq_len = uring->cq_len;
+        uring->cq_len = uring->sq_len;
+    }
+    uring->sq_ptr = mmap(NULL, uring->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+    if (uring->sq_ptr == MAP_FAILED) {
+        uring->sq_ptr = NULL;
+        prefetch_uring_free(uring);
+        return -1;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        uring->cq_ptr = uring->sq_ptr;
+    } else {
+        uring->cq_ptr = mmap(NULL, uring->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_CQ_RING);
+        if (uring->cq_ptr == MAP_FAILED) {
+            uring->cq_ptr = NULL;
+            prefetch_uring_free(uring);
+            return -1;
+        }
+    }
+    uring->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring->sqes = mmap(NULL, uring->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+    if (uring->sqes == MAP_FAILED) {
+        uring->sqes = NULL;
+        prefetch_uring_free(uring);
+        return -1;
+    }
+
+    sq = uring->sq_ptr;
+    cq = uring->cq_ptr;
+    uring->sq_tail = (unsigned int *)(sq + params.sq_off.tail);
+    uring->sq_mask = (unsigned int *)(sq + params.sq_off.ring_mask);
+    uring->sq_array = (unsigned int *)(sq + params.sq_off.array);
+    uring->cq_head = (unsigned int *)(cq + params.cq_off.head);
+    uring->cq_tail = (unsigned int *)(cq + params.cq_off.tail);
+    uring->cq_mask = (unsigned int *)(cq + params.cq_off.ring_mask);
+    uring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    return 0;
+}
+
+/* Queue an open or a read of the rest of the buffer for a slot. There is at
+ * most one operation per slot in flight, so the ring never fills. */
+static void prefetch_uring_queue(struct prefetch *p, struct prefetch_slot *slot) {
+    struct prefetch_uring *uring = &p->uring;
+    struct io_uring_sqe *sqe;
+    unsigned int tail, index;
+
+    tail = *uring->sq_tail;
+    index = tail & *uring->sq_mask;
+    sqe = &uring->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+    if (slot->state == PREFETCH_SLOT_OPENING) {
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (uintptr_t)p->paths[slot->index];
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    } else {
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = slot->fd;
+        sqe->addr = (uintptr_t)(slot->buffer + slot->len);
+        sqe->len = p->buffer_size - slot->len;
+        sqe->off = slot->len;
+    }
+    sqe->user_data = slot - p->slots;
+
+    uring->sq_array[index] = index;
+    __atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    uring->to_submit++;
+    uring->in_flight++;
+}
+
+/* Handle a completion, with the lock held */
+static void prefetch_uring_complete(struct prefetch *p, struct io_uring_cqe *cqe) {
+    struct prefetch_slot *slot = &p->slots[cqe->user_data];
+
+    p->uring.in_flight--;
+
+    if (cqe->res < 0) {
+        if (cqe->res == -EINTR || cqe->res == -EAGAIN)
+            prefetch_uring_queue(p, slot);
+        else
+            prefetch_ready(p, slot, -cqe->res);
+        return;
+    }
+
+    if (slot->state == PREFETCH_SLOT_OPENING) {
+        slot->fd = cqe->res;
+        slot->state = PREFETCH_SLOT_READING;
+    } else {
+        slot->len += cqe->res;
+        /* Done at end of file or with the buffer full */
+        if (cqe->res == 0 || slot->len == p->buffer_size) {
+            prefetch_ready(p, slot, 0);
+            return;
+        }
+    }
+    prefetch_uring_queue(p, slot);
+}
+
+static void *prefetch_uring_thread(void *arg) {
+    struct prefetch *p = arg;
+    struct prefetch_uring *uring = &p->uring;
+    struct prefetch_slot *slot;
+    unsigned int head, to_submit, i;
+    int ret;
+
+    pthread_mutex_lock(&p->lock);
+    /* Once stopping, let the operations in flight complete, since the
+     * kernel still writes to their buffers */
+    while (!p->stop || uring->in_flight > 0) {
+        if (!p->stop) {
+            while ((slot = prefetch_claim(p)) != NULL)
+                prefetch_uring_queue(p, slot);
+        }
+
+        if (uring->in_flight == 0) {
+            pthread_cond_wait(&p->cond, &p->lock);
+            continue;
+        }
+
+        to_submit = uring->to_submit;
+        pthread_mutex_unlock(&p->lock);
+        ret = util_io_uring_enter(uring->fd, to_submit, 1, IORING_ENTER_GETEVENTS);
+        pthread_mutex_lock(&p->lock);
+        if (ret >= 0) {
+            uring->to_submit -= ret;
+        } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            /* Fail the reads still outstanding */
+            for (i = 0; i < p->num_slots; i++)
+                if (p->slots[i].state == PREFETCH_SLOT_OPENING || p->slots[i].state == PREFETCH_SLOT_READING)
+                    prefetch_ready(p, &p->slots[i], EIO);
+            break;
+        }
+
+        head = *uring->cq_head;
+        while (head != __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE)) {
+            prefetch_uring_complete(p, &uring->cqes[head & *uring->cq_mask]);
+            head++;
+        }
+        __atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    return NULL;
+}
+
+/******************************************************************************/
+/* Thread Backend */
+/******************************************************************************/
+
+static void *prefetch_reader_thread(void *arg) {
+    struct prefetch *p = arg;
+    struct prefetch_slot *slot;
+    ssize_t ret;
+    int error;
+
+    pthread_mutex_lock(&p->lock);
+    while (!p->stop) {
+        if ((slot = prefetch_claim(p)) == NULL) {
+            pthread_cond_wait(&p->cond, &p->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&p->lock);
+
+        error = 0;
+        if ((slot->fd = open(p->paths[slot->index], O_RDONLY | O_CLOEXEC)) < 0) {
+            error = errno;
+        } else {
+            while (slot->len < p->buffer_size) {
+                ret = read(slot->fd, slot->buffer + slot->len, p->buffer_size - slot->len);
+                if (ret < 0 && errno == EINTR)
+                    continue;
+                if (ret < 0)
+                    error = errno;
+                if (ret <= 0)
+                    break;
+                slot->len += ret;
+            }
+        }
+
+        pthread_mutex_lock(&p->lock);
+        prefetch_ready(p, slot, error);
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    return NULL;
+}
+
+/******************************************************************************/
+/* Prefetched Files */
+/******************************************************************************/
+
+struct prefetch_file {
+    struct prefetch *p;
+    struct prefetch_slot *slot;
+    off64_t position;
+};
+
+/* Return a slot for the next file */
+static void prefetch_release(struct prefetch *p, struct prefetch_slot *slot) {
+    if (slot->fd >= 0)
+        close(slot->fd);
+
+    pthread_mutex_lock(&p->lock);
+    slot->fd = -1;
+    slot->state = PREFETCH_SLOT_FREE;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static ssize_t prefetch_file_read(void *cookie, char *buf, size_t size) {
+    struct prefetch_file *file = cookie;
+    struct prefetch_slot *slot = file->slot;
+    ssize_t len;
+
+    if (file->position < (off64_t)slot->len) {
+        /* Serve the buffered start of the file */
+        len = slot->len - file->position;
+        if ((size_t)len > size)
+            len = size;
+        memcpy(buf, slot->buffer + file->position, len);
+    } else if (slot->len < file->p->buffer_size) {
+        /* The whole file is buffered */
+        return 0;
+    } else {
+        /* Read the rest of the file directly */
+        if ((len = pread(slot->fd, buf, size, file->position)) < 0)
+            return -1;
+    }
+
+    file->position += len;
+    return len;
+}
+
+static int prefetch_file_seek(void *cookie, off64_t *offset, int whence) {
+    struct prefetch_file *file = cookie;
+    struct stat st;
+    off64_t position;
+
+    switch (whence) {
+        case SEEK_SET:
+            position = *offset;
+            break;
+        case SEEK_CUR:
+            position = file->position + *offset;
+            break;
+        case SEEK_END:
+            if (fstat(file->slot->fd, &st) < 0)
+                return -1;
+            position = st.st_size + *offset;
+            break;
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+    if (position < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    file->position = *offset = position;
+    return 0;
+}
+
+static int prefetch_file_close(void *cookie) {
+    struct prefetch_file *file = cookie;
+
+    prefetch_release(file->p, file->slot);
+    free(file);
+
+    return 0;
+}
+
+FILE *prefetch_open(struct prefetch *p, unsigned int index) {
+    cookie_io_functions_t functions = {prefetch_file_read, NULL, prefetch_file_seek, prefetch_file_close};
+    struct prefetch_slot *slot = NULL;
+    struct prefetch_file *file;
+    unsigned int i;
+    FILE *fp;
+
+    pthread_mutex_lock(&p->lock);
+    /* Open a file the prefetcher has not reached directly */
+    if (p->files[index] == PREFETCH_FILE_PENDING) {
+        p->files[index] = PREFETCH_FILE_DIRECT;
+        pthread_mutex_unlock(&p->lock);
+        return fopen(p->paths[index], "r");
+    }
+
+    for (i = 0; i < p->num_slots; i++) {
+        if (p->slots[i].state != PREFETCH_SLOT_FREE && p->slots[i].index == index) {
+            slot = &p->slots[i];
+            break;
+        }
+    }
+    if (slot == NULL || slot->state == PREFETCH_SLOT_IN_USE) {
+        /* Already opened */
+        pthread_mutex_unlock(&p->lock);
+        errno = EBUSY;
+        return NULL;
+    }
+    while (slot->state != PREFETCH_SLOT_READY)
+        pthread_cond_wait(&p->cond, &p->lock);
+    slot->state = PREFETCH_SLOT_IN_USE;
+    pthread_mutex_unlock(&p->lock);
+
+    if (slot->error != 0) {
+        i = slot->error;
+        prefetch_release(p, slot);
+        errno = i;
+        return NULL;
+    }
+
+    if ((file = malloc(sizeof(struct prefetch_file))) == NULL) {
+        prefetch_release(p, slot);
+        return NULL;
+    }
+    file->p = p;
+    file->slot = slot;
+    file->position = 0;
+
+    if ((fp = fopencookie(file, "r", functions)) == NULL) {
+        prefetch_release(p, slot);
+        free(file);
+        return NULL;
+    }
+
+    return fp;
+}
+
+/******************************************************************************/
+/* Prefetcher */
+/******************************************************************************/
+
+struct prefetch *prefetch_start(const char *const *paths, unsigned int num_paths, unsigned int num_slots, size_t buffer_size, int backend) {
+    struct prefetch *p;
+    unsigned int i;
+
+    if (num_slots == 0 || buffer_size == 0 || num_slots > SIZE_MAX / buffer_size)
+        return NULL;
+
+    if ((p = calloc(1, sizeof(struct prefetch))) == NULL)
+        return NULL;
+    p->paths = paths;
+    p->num_paths = num_paths;
+    p->num_slots = num_slots;
+    p->buffer_size = buffer_size;
+    p->uring.fd = -1;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->cond, NULL);
+
+    /* Buffers are charged up front, files are read into them on demand */
+    if (budget_charge(num_slots * buffer_size) < 0) {
+        free(p);
+        return NULL;
+    }
+
+    p->files = calloc(num_paths > 0 ? num_paths : 1, sizeof(uint8_t));
+    p->slots = calloc(num_slots, sizeof(struct prefetch_slot));
+    p->threads = calloc(num_slots, sizeof(pthread_t));
+    if (p->files == NULL || p->slots == NULL || p->threads == NULL)
+        goto fail;
+    for (i = 0; i < num_slots; i++) {
+        p->slots[i].fd = -1;
+        if ((p->slots[i].buffer = malloc(buffer_size)) == NULL)
+            goto fail;
+    }
+
+    /* A single thread drives all reads through io_uring, or else a thread
+     * per slot reads with blocking system calls */
+    if (backend != PREFETCH_BACKEND_THREADS && prefetch_uring_init(&p->uring, num_slots) == 0) {
+        p->backend = PREFETCH_BACKEND_IO_URING;
+        if (pthread_create(&p->threads[0], NULL, prefetch_uring_thread, p) != 0)
+            goto fail;
+        p->num_threads = 1;
+    } else if (backend != PREFETCH_BACKEND_IO_URING) {
+        p->backend = PREFETCH_BACKEND_THREADS;
+        for (i = 0; i < num_slots; i++) {
+            if (pthread_create(&p->threads[i], NULL, prefetch_reader_thread, p) != 0)
+                break;
+            p->num_threads++;
+        }
+        if (p->num_threads == 0)
+            goto fail;
+    } else {
+        goto fail;
+    }
+
+    return p;
+
+    fail:
+    prefetch_stop(p);
+    return NULL;
+}
+
+int prefetch_backend(struct prefetch *p) {
+    return p->backend;
+}
+
+void prefetch_stop(struct prefetch *p) {
+    unsigned int i;
+
+    pthread_mutex_lock(&p->lock);
+    p->stop = 1;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+
+    for (i = 0; i < p->num_threads; i++)
+        pthread_join(p->threads[i], NULL);
+    if (p->uring.fd >= 0)
+        prefetch_uring_free(&p->uring);
+
+    /* Close files read ahead but never opened */
+    if (p->slots != NULL) {
+        for (i = 0; i < p->num_slots; i++) {
+            if (p->slots[i].fd >= 0)
+                close(p->slots[i].fd);
+            free(p->slots[i].buffer);
+        }
+    }
+    budget_release(p->num_slots * p->buffer_size);
+
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->cond);
+    free(p->threads);
+    free(p->slots);
+    free(p->files);
+    free(p);
+}
+
@@ -0,0 +1,54 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/* Prefetching File Reader Support
+ *
+ * Reads a list of program files ahead of their use, in list order, so that
+ * decoding one file overlaps reading the next ones. Up to num_slots files are
+ * opened and read at a time, each into a reusable buffer of buffer_size
+ * bytes, with io_uring where the kernel supports it (opened with
+ * IORING_OP_OPENAT and read with IORING_OP_READ, through raw system calls),
+ * or with a reader thread per slot otherwise.
+ *
+ * prefetch_open() returns a file as a read-only stdio stream, which serves
+ * the buffered start of the file and reads any remainder beyond the buffer
+ * directly. Closing the stream returns its buffer for the next file. A file
+ * opened before the prefetcher reached it is opened directly instead, and
+ * skipped by the prefetcher, so files may be opened in any order, each at
+ * most once.
+ *
+ * The buffers are charged to the memory budget; if that fails, no
+ * prefetcher is started and files should be opened directly.
+ */
+
+enum {
+    PREFETCH_BACKEND_AUTO,
+    PREFETCH_BACKEND_IO_URING,
+    PREFETCH_BACKEND_THREADS,
+};
+
+/* Bytes of each file read ahead */
+#define PREFETCH_BUFFER_LEN     (1024*1024)
+
+struct prefetch;
+
+/* Start prefetching paths, which must stay valid until prefetch_stop().
+ * PREFETCH_BACKEND_AUTO uses io_uring if available, and threads otherwise.
+ * Returns NULL if the backend is unavailable or on allocation failure. */
+struct prefetch *prefetch_start(const char *const *paths, unsigned int num_paths, unsigned int num_slots, size_t buffer_size, int backend);
+
+/* Open file index of the list, waiting for its read to complete. Returns
+ * NULL with errno set on failure. */
+FILE *prefetch_open(struct prefetch *prefetch, unsigned int index);
+
+/* Backend in use, PREFETCH_BACKEND_IO_URING or PREFETCH_BACKEND_THREADS */
+int prefetch_backend(struct prefetch *prefetch);
+
+/* Stop prefetching and free the buffers, once all opened files are closed */
+void prefetch_stop(struct prefetch *prefetch);
+
+#endif
+
@@ -0,0 +1,15 @@
+#include <stdint.h>
+
+#include <hash.h>
+
+uint64_t hash_fnv1a(uint64_t hash, uint64_t value, unsigned int len) {
+    unsigned int i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= (value >> (8*i)) & 0xff;
+        hash *= HASH_FNV_PRIME;
+    }
+
+    return hash;
+}
+
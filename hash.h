@@ -0,0 +1,18 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <stdint.h>
+
+/* 64-bit FNV-1a hash, shared by the image hash of sharding and the
+ * instruction tokens of diff and similarity, which must agree across runs
+ * and machines. A hash starts at HASH_FNV_OFFSET_BASIS and takes in values
+ * a byte at a time, least significant byte first. */
+
+#define HASH_FNV_OFFSET_BASIS   0xcbf29ce484222325ULL
+#define HASH_FNV_PRIME          0x100000001b3ULL
+
+/* Take the len low bytes of value into hash */
+uint64_t hash_fnv1a(uint64_t hash, uint64_t value, unsigned int len);
+
+#endif
+
@@ -0,0 +1,193 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bytestream.h>
+#include <budget.h>
+#include <image.h>
+
+/******************************************************************************/
+/* Program Image */
+/******************************************************************************/
+
+static int util_bit_test(const uint8_t *bitmap, uint64_t index) {
+    return (bitmap[index >> 3] >> (index & 7)) & 1;
+}
+
+void image_init(struct program_image *image) {
+    image->data = NULL;
+    image->present = NULL;
+    image->base = 0;
+    image->size = 0;
+    image->charged = 0;
+    image->ordered = 1;
+}
+
+void image_free(struct program_image *image) {
+    budget_release(image->charged);
+    free(image->data);
+    free(image->present);
+    image_init(image);
+}
+
+/* Grow the image to cover address, by at least doubling. Returns 0, or -1 on
+ * allocation failure. */
+static int util_image_cover(struct program_image *image, uint32_t address) {
+    uint64_t lo, hi, new_lo, new_hi, new_size;
+    uint8_t *data, *present;
+
+    lo = image->base;
+    hi = lo + image->size;
+    if (image->size > 0 && address >= lo && address < hi)
+        return 0;
+
+    new_lo = address & ~(IMAGE_BLOCK - 1);
+    new_hi = ((uint64_t)address | (IMAGE_BLOCK - 1)) + 1;
+    if (image->size > 0) {
+        if (address < lo) {
+            if (lo - new_lo < image->size)
+                new_lo = (lo > image->size) ? lo - image->size : 0;
+            new_hi = hi;
+        } else {
+            if (new_hi - hi < image->size)
+                new_hi = hi + image->size;
+            if (new_hi > (1ULL << 32))
+                new_hi = 1ULL << 32;
+            new_lo = lo;
+        }
+    }
+    new_size = new_hi - new_lo;
+
+    if (budget_charge(new_size + new_size/8) < 0)
+        return -1;
+    data = calloc(new_size, 1);
+    present = calloc(new_size/8, 1);
+    if (data == NULL || present == NULL) {
+        free(data);
+        free(present);
+        budget_release(new_size + new_size/8);
+        return -1;
+    }
+
+    if (image->size > 0) {
+        memcpy(data + (lo - new_lo), image->data, image->size);
+        memcpy(present + (lo - new_lo)/8, image->present, image->size/8);
+    }
+    budget_release(image->charged);
+    free(image->data);
+    free(image->present);
+    image->data = data;
+    image->present = present;
+    image->base = new_lo;
+    image->size = new_size;
+    image->charged = new_size + new_size/8;
+
+    return 0;
+}
+
+int image_read(struct program_image *image, struct ByteStream *source) {
+    uint8_t data;
+    uint32_t address, last = 0;
+    uint64_t offset;
+    int ret, first = 1;
+
+    while ((ret = source->stream_read(source, &data, &address)) == 0) {
+        if (util_image_cover(image, address) < 0)
+            return STREAM_ERROR_ALLOC;
+        offset = address - image->base;
+        image->data[offset] = data;
+        image->present[offset >> 3] |= 1 << (offset & 7);
+
+        if (!first && address <= last)
+            image->ordered = 0;
+        last = address;
+        first = 0;
+    }
+
+    return (ret == STREAM_EOF) ? 0 : STREAM_ERROR_INPUT;
+}
+
+uint64_t image_present_len(const struct program_image *image, uint32_t address, uint64_t max) {
+    uint64_t offset, len;
+
+    if (address < image->base)
+        return 0;
+    offset = address - image->base;
+    for (len = 0; len < max && offset + len < image->size; len++) {
+        if (!util_bit_test(image->present, offset + len))
+            break;
+    }
+
+    return len;
+}
+
+/******************************************************************************/
+/* Image Byte Stream Support */
+/******************************************************************************/
+
+struct image_bytestream_state {
+    const struct program_image *image;
+    /* Offsets of the next byte and the end */
+    uint64_t position, end;
+};
+
+int image_bytestream_setup(struct ByteStream *self, const struct program_image *image, uint32_t start, uint64_t end) {
+    struct image_bytestream_state *state;
+
+    /* Allocate stream state */
+    state = malloc(sizeof(struct image_bytestream_state));
+    if (state == NULL) {
+        self->error = "Error allocating image stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->image = image;
+
+    /* Clamp the range to the image */
+    state->position = (start > image->base) ? start - image->base : 0;
+    state->end = (end > image->base) ? end - image->base : 0;
+    if (state->end > image->size)
+        state->end = image->size;
+
+    self->in = NULL;
+    self->state = state;
+    self->error = NULL;
+    self->stream_init = image_bytestream_init;
+    self->stream_close = image_bytestream_close;
+    self->stream_read = image_bytestream_read;
+
+    return 0;
+}
+
+int image_bytestream_init(struct ByteStream *self) {
+    /* Reset the error to NULL */
+    self->error = NULL;
+    return 0;
+}
+
+int image_bytestream_close(struct ByteStream *self) {
+    /* Free stream state memory */
+    free(self->state);
+    return 0;
+}
+
+int image_bytestream_read(struct ByteStream *self, uint8_t *data, uint32_t *address) {
+    struct image_bytestream_state *state = (struct image_bytestream_state *)self->state;
+    const struct program_image *image = state->image;
+
+    /* Skip the addresses absent from the input */
+    while (state->position < state->end && !util_bit_test(image->present, state->position)) {
+        if ((state->position & 7) == 0 && image->present[state->position >> 3] == 0)
+            state->position += 8;
+        else
+            state->position++;
+    }
+    if (state->position >= state->end)
+        return STREAM_EOF;
+
+    *data = image->data[state->position];
+    *address = image->base + state->position;
+    state->position++;
+
+    return 0;
+}
+
@@ -0,0 +1,54 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <bytestream.h>
+
+/* Program Image Support
+ *
+ * A program image holds the bytes of a program file in memory, indexed by
+ * address, for the modes that need the whole program at once rather than a
+ * stream of its bytes. It covers the addresses base to base+size, grown in
+ * blocks of IMAGE_BLOCK at least doubling, with a bitmap of the addresses
+ * present in the input. The image is charged to the memory budget.
+ */
+
+/* Image growth granularity, which keeps the bitmap byte aligned */
+#define IMAGE_BLOCK     65536ULL
+
+struct program_image {
+    /* Bytes and presence bitmap of the addresses base to base+size */
+    uint8_t *data, *present;
+    uint32_t base;
+    uint64_t size;
+    /* Bytes charged to the memory budget */
+    size_t charged;
+    /* Addresses were read in strictly increasing order */
+    int ordered;
+};
+
+/* Initialize an empty image */
+void image_init(struct program_image *image);
+/* Free the image's memory */
+void image_free(struct program_image *image);
+
+/* Read the bytes of the initialized source stream into the image until its
+ * end. Returns 0, STREAM_ERROR_ALLOC if the image cannot grow, or
+ * STREAM_ERROR_INPUT with the error in source->error. */
+int image_read(struct program_image *image, struct ByteStream *source);
+
+/* Number of consecutive bytes present at address, up to max */
+uint64_t image_present_len(const struct program_image *image, uint32_t address, uint64_t max);
+
+/* Setup self to read the present bytes of the image at addresses [start,
+ * end) in address order */
+int image_bytestream_setup(struct ByteStream *self, const struct program_image *image, uint32_t start, uint64_t end);
+
+/* Image Byte Stream Support */
+int image_bytestream_init(struct ByteStream *self);
+int image_bytestream_close(struct ByteStream *self);
+int image_bytestream_read(struct ByteStream *self, uint8_t *data, uint32_t *address);
+
+#endif
+
@@ -0,0 +1,339 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <printstream_file.h>
+#include <ucdisasm.h>
+#include <image.h>
+#include <incremental.h>
+
+/* End of the address space */
+#define ADDRESS_END     (1ULL << 32)
+
+/* Line of the previous listing */
+struct listing_line {
+    char *text;
+    size_t capacity;
+    uint32_t address;
+    int valid;
+};
+
+struct incremental_state {
+    struct program_image old_image, new_image;
+    int arch, flags;
+    unsigned int align, max_width;
+    FILE *old_listing, *out;
+    /* Next line of the previous listing, and the last line before a changed
+     * block's reach, held back to be decoded again */
+    struct listing_line line, held;
+    /* Address of the last line read, if any, for the address order check */
+    uint32_t last_address;
+    int started;
+    const char *error;
+};
+
+/******************************************************************************/
+/* Images */
+/******************************************************************************/
+
+static int util_read_image(struct incremental_state *state, struct program_image *image, struct ByteStream *bs) {
+    int ret;
+
+    if (bs->stream_init(bs) < 0) {
+        state->error = (bs->error != NULL) ? bs->error : "Error in byte stream initialization!";
+        return -1;
+    }
+    ret = image_read(image, bs);
+    if (bs->stream_close(bs) < 0 && ret == 0)
+        ret = STREAM_ERROR_INPUT;
+
+    if (ret == STREAM_ERROR_ALLOC) {
+        state->error = "Error allocating program image!";
+        return -1;
+    } else if (ret < 0) {
+        state->error = (bs->error != NULL) ? bs->error : "Error reading program file!";
+        return -1;
+    } else if (!image->ordered) {
+        state->error = "Incremental disassembly requires program files in address order!";
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Data and presence bitmap of the block at address, returns 0 if the image
+ * does not cover it */
+static int util_block(const struct program_image *image, uint64_t address, const uint8_t **data, const uint8_t **present) {
+    /* Image bases are aligned on a multiple of the block size */
+    if (image->size == 0 || address < image->base || address >= image->base + image->size)
+        return 0;
+
+    *data = image->data + (address - image->base);
+    *present = image->present + (address - image->base)/8;
+
+    return 1;
+}
+
+/* Returns 1 if any bit of the bitmap is set */
+static int util_any_present(const uint8_t *present) {
+    unsigned int i;
+
+    for (i = 0; i < INCREMENTAL_BLOCK/8; i++) {
+        if (present[i] != 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+static int util_block_changed(struct incremental_state *state, uint64_t address) {
+    const uint8_t *old_data, *old_present, *new_data, *new_present;
+    int in_old, in_new;
+
+    in_old = util_block(&state->old_image, address, &old_data, &old_present);
+    in_new = util_block(&state->new_image, address, &new_data, &new_present);
+
+    /* Absent bytes are zero in both images */
+    if (in_old && in_new)
+        return memcmp(old_present, new_present, INCREMENTAL_BLOCK/8) != 0 || memcmp(old_data, new_data, INCREMENTAL_BLOCK) != 0;
+    else if (in_old)
+        return util_any_present(old_present);
+    else if (in_new)
+        return util_any_present(new_present);
+
+    return 0;
+}
+
+/* Address of the first changed block at or after address, or ADDRESS_END */
+static uint64_t util_next_changed(struct incremental_state *state, uint64_t address) {
+    uint64_t lo = ADDRESS_END, hi = 0;
+
+    if (state->old_image.size > 0) {
+        lo = state->old_image.base;
+        hi = state->old_image.base + state->old_image.size;
+    }
+    if (state->new_image.size > 0) {
+        if (state->new_image.base < lo)
+            lo = state->new_image.base;
+        if (state->new_image.base + state->new_image.size > hi)
+            hi = state->new_image.base + state->new_image.size;
+    }
+
+    address &= ~((uint64_t)INCREMENTAL_BLOCK - 1);
+    if (address < lo)
+        address = lo;
+    for (; address < hi; address += INCREMENTAL_BLOCK) {
+        if (util_block_changed(state, address))
+            return address;
+    }
+
+    return ADDRESS_END;
+}
+
+/******************************************************************************/
+/* Listings */
+/******************************************************************************/
+
+/* Read the next line of the previous listing */
+static int util_line_next(struct incremental_state *state) {
+    struct listing_line *line = &state->line;
+    unsigned long address;
+    char *end;
+
+    if (getline(&line->text, &line->capacity, state->old_listing) < 0) {
+        if (ferror(state->old_listing)) {
+            state->error = "Error reading previous listing!";
+            return -1;
+        }
+        line->valid = 0;
+        return 0;
+    }
+
+    address = strtoul(line->text, &end, 16);
+    if (end == line->text || *end != ':') {
+        state->error = "Previous listing is not a text listing with addresses!";
+        return -1;
+    }
+    if (state->started && address <= state->last_address) {
+        state->error = "Previous listing is not in address order!";
+        return -1;
+    }
+    line->address = address;
+    line->valid = 1;
+    state->last_address = address;
+    state->started = 1;
+
+    return 0;
+}
+
+static int util_write(struct incremental_state *state, const char *text) {
+    if (fputs(text, state->out) < 0) {
+        state->error = "Error writing to output file!";
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* Incremental Disassembly */
+/******************************************************************************/
+
+/* Decode the new image from start, past the changed block at changed and any
+ * within reach, until an instruction in step with the previous listing, whose
+ * address is returned in sync, or ADDRESS_END at the end of the image */
+static int util_decode_region(struct incremental_state *state, uint32_t start, uint64_t changed, uint64_t *sync, struct incremental_stats *stats) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct instruction instr;
+    char text[PRINTSTREAM_FILE_LINE_LEN];
+    uint64_t dirty_end, next_changed;
+    uint32_t address;
+    int len, ret, failed = 0;
+
+    *sync = ADDRESS_END;
+    dirty_end = changed + INCREMENTAL_BLOCK;
+    next_changed = util_next_changed(state, dirty_end);
+
+    if (image_bytestream_setup(&bs, &state->new_image, start, ADDRESS_END) < 0) {
+        state->error = bs.error;
+        return -1;
+    }
+    ds.in = &bs;
+    ds.error = NULL;
+    ucdisasm_disasmstream_setup(&ds, state->arch);
+    if (ds.stream_init(&ds) < 0) {
+        state->error = (ds.error != NULL) ? ds.error : "Error in disasm stream initialization!";
+        bs.stream_close(&bs);
+        return -1;
+    }
+    stats->regions++;
+
+    while ((ret = ds.stream_read(&ds, &instr)) == 0) {
+        if (instr.type == DISASM_TYPE_INSTRUCTION) {
+            address = instr.get_address(&instr);
+
+            /* Take in the changed blocks this instruction may read */
+            while (next_changed != ADDRESS_END && address + state->max_width > next_changed) {
+                dirty_end = next_changed + INCREMENTAL_BLOCK;
+                next_changed = util_next_changed(state, dirty_end);
+            }
+
+            /* Drop the lines of the previous listing decoded again */
+            while (state->line.valid && state->line.address < address) {
+                if (util_line_next(state) < 0) {
+                    failed = 1;
+                    break;
+                }
+            }
+
+            /* Back in step with the previous listing */
+            if (!failed && address >= dirty_end && state->line.valid && state->line.address == address) {
+                *sync = address;
+                instr.free(&instr);
+                break;
+            }
+
+            stats->decoded += instr.get_width(&instr);
+        }
+
+        len = printstream_file_format(&instr, text, sizeof(text), state->flags);
+        instr.free(&instr);
+        if (failed || (len > 0 && util_write(state, text) < 0)) {
+            failed = 1;
+            break;
+        }
+    }
+
+    if (!failed && ret != 0 && ret != STREAM_EOF) {
+        state->error = (ds.error != NULL) ? ds.error : "Error in disasm stream read!";
+        failed = 1;
+    }
+    if (ds.stream_close(&ds) < 0 && !failed) {
+        state->error = "Error in disasm stream close!";
+        failed = 1;
+    }
+
+    return failed ? -1 : 0;
+}
+
+static int util_render(struct incremental_state *state, struct incremental_stats *stats) {
+    struct listing_line swap;
+    uint64_t pos = 0, changed, limit;
+    uint32_t start;
+
+    if (util_line_next(state) < 0)
+        return -1;
+
+    while (1) {
+        /* Copy the rest of the previous listing if nothing else changed */
+        if ((changed = util_next_changed(state, pos)) == ADDRESS_END) {
+            while (state->line.valid) {
+                if (util_write(state, state->line.text) < 0 || util_line_next(state) < 0)
+                    return -1;
+            }
+            return 0;
+        }
+
+        /* Copy the previous listing up to the last instruction before the
+         * changed block's reach, which is decoded again in case it ends in
+         * a gap that the new image fills */
+        limit = (changed > state->max_width - 1) ? changed - (state->max_width - 1) : 0;
+        state->held.valid = 0;
+        while (state->line.valid && state->line.address < limit) {
+            if (state->held.valid && util_write(state, state->held.text) < 0)
+                return -1;
+            swap = state->held;
+            state->held = state->line;
+            state->line = swap;
+            if (util_line_next(state) < 0)
+                return -1;
+        }
+        start = state->held.valid ? state->held.address : pos;
+
+        if (util_decode_region(state, start, changed, &pos, stats) < 0)
+            return -1;
+        if (pos == ADDRESS_END)
+            return 0;
+    }
+}
+
+int incremental_render(struct ByteStream *old_bs, FILE *old_listing, struct ByteStream *new_bs, int arch, int flags, FILE *out, struct incremental_stats *stats, const char **error) {
+    struct incremental_state state;
+    uint64_t i;
+    int ret = -1;
+
+    memset(&state, 0, sizeof(state));
+    memset(stats, 0, sizeof(struct incremental_stats));
+    image_init(&state.old_image);
+    image_init(&state.new_image);
+    state.arch = arch;
+    state.flags = flags;
+    state.old_listing = old_listing;
+    state.out = out;
+
+    if (ucdisasm_arch_widths(arch, &state.align, &state.max_width) < 0) {
+        *error = "Unknown architecture!";
+        return -1;
+    }
+
+    if (util_read_image(&state, &state.old_image, old_bs) == 0 && util_read_image(&state, &state.new_image, new_bs) == 0) {
+        for (i = 0; i < state.new_image.size/8; i++)
+            stats->bytes += __builtin_popcount(state.new_image.present[i]);
+        ret = util_render(&state, stats);
+    }
+
+    image_free(&state.old_image);
+    image_free(&state.new_image);
+    free(state.line.text);
+    free(state.held.text);
+
+    *error = state.error;
+
+    return ret;
+}
+
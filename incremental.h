@@ -0,0 +1,46 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <bytestream.h>
+
+/* Incremental Disassembly Support
+ *
+ * Disassembles a new build of a program from the previous build's program
+ * file and its text listing, decoding only the regions around the bytes that
+ * changed and copying the rest of the previous listing.
+ *
+ * Both images are read into memory, charged to the memory budget (image.h)
+ * so that --max-memory bounds them, and compared in blocks of
+ * INCREMENTAL_BLOCK bytes, data and presence. The previous listing is read a
+ * line at a time. Before a changed block, the
+ * previous listing is copied up to the last instruction that reads none of
+ * its bytes, and the new image is decoded again from there. Decoding stops
+ * at the first instruction past the changed blocks that starts where an
+ * instruction of the previous listing does: from that boundary on, both
+ * builds decode the same bytes the same way, so the previous listing is
+ * copied again until the next changed block.
+ *
+ * The previous listing must be a text listing with addresses (not assembly),
+ * written with the same options as the new one, and both program files must
+ * be in address order, as linear disassembly lists them in input order.
+ */
+
+/* Comparison block size */
+#define INCREMENTAL_BLOCK   256
+
+struct incremental_stats {
+    /* Bytes of the new image, and of them decoded again */
+    uint64_t bytes, decoded;
+    /* Regions decoded again */
+    unsigned int regions;
+};
+
+/* Write the listing of the program read by new_bs to out, from the program
+ * read by old_bs and its listing old_listing. The byte streams are
+ * initialized and closed. Returns 0, or -1 with an error string. */
+int incremental_render(struct ByteStream *old_bs, FILE *old_listing, struct ByteStream *new_bs, int arch, int flags, FILE *out, struct incremental_stats *stats, const char **error);
+
+#endif
+
@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+struct instruction_cycles;
+
 struct instruction {
     void *data;
     int type;
@@ -12,7 +14,15 @@ struct instruction {
     unsigned int (*get_num_operands)(struct instruction *);
     unsigned int (*get_opcodes)(struct instruction *, uint8_t *dest);
 
+    int (*get_operand_kind)(struct instruction *, int index);
+    int32_t (*get_operand_value)(struct instruction *, int index);
+    int (*get_branch_target)(struct instruction *, uint32_t *dest);
+    int (*get_flow)(struct instruction *);
+    int (*get_isa_index)(struct instruction *);
+    int (*get_cycles)(struct instruction *, int variant, struct instruction_cycles *dest);
+
     int (*get_str_address_label)(struct instruction *, char *dest, int size, int flags);
+    int (*get_label_target)(struct instruction *, int index, uint32_t *dest);
     int (*get_str_address)(struct instruction *, char *dest, int size, int flags);
     int (*get_str_opcodes)(struct instruction *, char *dest, int size, int flags);
     int (*get_str_mnemonic)(struct instruction *, char *dest, int size, int flags);
@@ -27,4 +37,59 @@ enum {
     DISASM_TYPE_DIRECTIVE,
 };
 
+/* Architecture independent operand kinds, returned by get_operand_kind() */
+enum {
+    OPERAND_KIND_NONE,
+    OPERAND_KIND_REGISTER,          /* General purpose / file register number */
+    OPERAND_KIND_IO_REGISTER,       /* I/O space register address */
+    OPERAND_KIND_IMPLICIT,          /* Register implied by the opcode, e.g. A, DPTR */
+    OPERAND_KIND_INDIRECT,          /* Pointer register, e.g. Y+q, @R0, INDF1 */
+    OPERAND_KIND_DATA,              /* Immediate data constant */
+    OPERAND_KIND_BIT,               /* Bit index within a register */
+    OPERAND_KIND_BIT_ADDRESS,       /* Address in bit addressable memory */
+    OPERAND_KIND_FLAG,              /* Encoding flag, e.g. PIC destination / access bank */
+    OPERAND_KIND_DATA_ADDRESS,      /* Absolute data memory address */
+    OPERAND_KIND_PROG_ADDRESS,      /* Absolute program memory address */
+    OPERAND_KIND_RELATIVE_ADDRESS,  /* Program memory offset relative to the instruction */
+    OPERAND_KIND_RAW,               /* Raw word / byte of a data "instruction" */
+};
+
+/* Control flow of an instruction, returned by get_flow(). The target of a
+ * branch, jump, or call is given by get_branch_target(), if encoded. */
+enum {
+    FLOW_NEXT,                      /* Continues with the next instruction */
+    FLOW_BRANCH,                    /* Conditional branch, or continues */
+    FLOW_SKIP,                      /* Conditionally skips the next instruction */
+    FLOW_JUMP,                      /* Unconditional jump */
+    FLOW_CALL,                      /* Call, returns to the next instruction */
+    FLOW_INDIRECT_JUMP,             /* Jump to a computed address, e.g. ijmp */
+    FLOW_INDIRECT_CALL,             /* Call of a computed address, e.g. icall */
+    FLOW_RETURN,                    /* Return from a call or interrupt */
+    FLOW_INVALID,                   /* Raw data or reserved opcode, no instruction */
+};
+
+/* Execution time of an instruction, returned by get_cycles(): the cycles to
+ * continue with the next instruction, and the cycles when a branch is taken
+ * or a skip skips a one word instruction. Skipping a two word instruction
+ * takes one cycle more. Cycles are clock cycles on AVR, instruction cycles
+ * of four clocks on PIC, and machine cycles of twelve clocks on 8051. */
+struct instruction_cycles {
+    unsigned int next;
+    unsigned int taken;
+};
+
+/* Core variants with their own instruction timing, for get_cycles(). Only
+ * AVR has variants, the other architectures take CYCLES_VARIANT_DEFAULT. */
+enum {
+    CYCLES_VARIANT_DEFAULT,
+    CYCLES_VARIANT_AVRE = CYCLES_VARIANT_DEFAULT,
+    CYCLES_VARIANT_AVRXM,
+    CYCLES_VARIANT_AVRXT,
+    CYCLES_VARIANT_AVRRC,
+};
+
+/* Instruction set table lookup, returns the mnemonic of the table entry at
+ * index (as returned by get_isa_index()), or NULL past the end */
+typedef const char *(*isa_mnemonic_func)(unsigned int index);
+
 #endif
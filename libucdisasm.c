@@ -0,0 +1,302 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ucdisasm.h>
+#include <xref.h>
+
+/* File ByteStream Support */
+#include "file/file_support.h"
+/* DisasmStream Support */
+#include "avr/avr_support.h"
+#include "pic/pic_support.h"
+#include "8051/8051_support.h"
+
+/******************************************************************************/
+/* Architecture Support */
+/******************************************************************************/
+
+int ucdisasm_arch_lookup(const char *name) {
+    if (strcasecmp(name, "avr") == 0)
+        return UCDISASM_ARCH_AVR8;
+    else if (strcasecmp(name, "pic-baseline") == 0)
+        return UCDISASM_ARCH_PIC_BASELINE;
+    else if (strcasecmp(name, "pic-midrange") == 0)
+        return UCDISASM_ARCH_PIC_MIDRANGE;
+    else if (strcasecmp(name, "pic-enhanced") == 0)
+        return UCDISASM_ARCH_PIC_MIDRANGE_ENHANCED;
+    else if (strcasecmp(name, "pic-18") == 0)
+        return UCDISASM_ARCH_PIC_PIC18;
+    else if (strcasecmp(name, "8051") == 0)
+        return UCDISASM_ARCH_8051;
+    return -1;
+}
+
+int ucdisasm_cycles_variant_lookup(int arch, const char *name) {
+    if (strcasecmp(name, "default") == 0)
+        return CYCLES_VARIANT_DEFAULT;
+    if (arch != UCDISASM_ARCH_AVR8)
+        return -1;
+    if (strcasecmp(name, "avre") == 0)
+        return CYCLES_VARIANT_AVRE;
+    else if (strcasecmp(name, "avrxm") == 0)
+        return CYCLES_VARIANT_AVRXM;
+    else if (strcasecmp(name, "avrxt") == 0)
+        return CYCLES_VARIANT_AVRXT;
+    else if (strcasecmp(name, "avrrc") == 0)
+        return CYCLES_VARIANT_AVRRC;
+    return -1;
+}
+
+isa_mnemonic_func ucdisasm_disasmstream_setup(struct DisasmStream *ds, int arch) {
+    if (arch == UCDISASM_ARCH_AVR8) {
+        ds->stream_init = disasmstream_avr_init;
+        ds->stream_close = disasmstream_avr_close;
+        ds->stream_read = disasmstream_avr_read;
+        return avr_isa_mnemonic;
+    } else if (arch == UCDISASM_ARCH_PIC_BASELINE) {
+        ds->stream_init = disasmstream_pic_baseline_init;
+        ds->stream_close = disasmstream_pic_baseline_close;
+        ds->stream_read = disasmstream_pic_baseline_read;
+        return pic_baseline_isa_mnemonic;
+    } else if (arch == UCDISASM_ARCH_PIC_MIDRANGE) {
+        ds->stream_init = disasmstream_pic_midrange_init;
+        ds->stream_close = disasmstream_pic_midrange_close;
+        ds->stream_read = disasmstream_pic_midrange_read;
+        return pic_midrange_isa_mnemonic;
+    } else if (arch == UCDISASM_ARCH_PIC_MIDRANGE_ENHANCED) {
+        ds->stream_init = disasmstream_pic_midrange_enhanced_init;
+        ds->stream_close = disasmstream_pic_midrange_enhanced_close;
+        ds->stream_read = disasmstream_pic_midrange_enhanced_read;
+        return pic_midrange_enhanced_isa_mnemonic;
+    } else if (arch == UCDISASM_ARCH_PIC_PIC18) {
+        ds->stream_init = disasmstream_pic_pic18_init;
+        ds->stream_close = disasmstream_pic_pic18_close;
+        ds->stream_read = disasmstream_pic_pic18_read;
+        return pic_pic18_isa_mnemonic;
+    } else if (arch == UCDISASM_ARCH_8051) {
+        ds->stream_init = disasmstream_8051_init;
+        ds->stream_close = disasmstream_8051_close;
+        ds->stream_read = disasmstream_8051_read;
+        return a8051_isa_mnemonic;
+    }
+    return NULL;
+}
+
+int ucdisasm_arch_widths(int arch, unsigned int *align, unsigned int *max_width) {
+    if (arch == UCDISASM_ARCH_8051) {
+        *align = 1;
+        *max_width = 3;
+    } else if (arch >= UCDISASM_ARCH_AVR8 && arch <= UCDISASM_ARCH_PIC_PIC18) {
+        *align = 2;
+        *max_width = 4;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+unsigned int ucdisasm_instruction_width(int arch, const uint8_t *opcode) {
+    uint16_t word;
+
+    if (arch == UCDISASM_ARCH_8051)
+        return a8051_isa_width(opcode[0]);
+
+    /* 16-bit opcode words are little-endian */
+    word = (uint16_t)(opcode[1] << 8) | (uint16_t)(opcode[0]);
+    switch (arch) {
+        case UCDISASM_ARCH_AVR8:
+            return avr_isa_width(word);
+        case UCDISASM_ARCH_PIC_BASELINE:
+            return pic_baseline_isa_width(word);
+        case UCDISASM_ARCH_PIC_MIDRANGE:
+            return pic_midrange_isa_width(word);
+        case UCDISASM_ARCH_PIC_MIDRANGE_ENHANCED:
+            return pic_midrange_enhanced_isa_width(word);
+        case UCDISASM_ARCH_PIC_PIC18:
+            return pic_pic18_isa_width(word);
+    }
+    return 0;
+}
+
+int ucdisasm_raw_instruction(int arch, const uint8_t *data, unsigned int len, uint32_t address, struct instruction *instr) {
+    int ret;
+
+    if (len == 0)
+        return STREAM_ERROR_FAILURE;
+
+    switch (arch) {
+        case UCDISASM_ARCH_AVR8:
+            ret = avr_disasm_raw(instr, data, len, address);
+            break;
+        case UCDISASM_ARCH_PIC_BASELINE:
+            ret = pic_baseline_disasm_raw(instr, data, len, address);
+            break;
+        case UCDISASM_ARCH_PIC_MIDRANGE:
+            ret = pic_midrange_disasm_raw(instr, data, len, address);
+            break;
+        case UCDISASM_ARCH_PIC_MIDRANGE_ENHANCED:
+            ret = pic_midrange_enhanced_disasm_raw(instr, data, len, address);
+            break;
+        case UCDISASM_ARCH_PIC_PIC18:
+            ret = pic_pic18_disasm_raw(instr, data, len, address);
+            break;
+        case UCDISASM_ARCH_8051:
+            ret = a8051_disasm_raw(instr, data, len, address);
+            break;
+        default:
+            return STREAM_ERROR_FAILURE;
+    }
+
+    return (ret < 0) ? STREAM_ERROR_ALLOC : ret;
+}
+
+int ucdisasm_origin_directive(int arch, uint32_t address, struct instruction *instr) {
+    int ret;
+
+    if (arch == UCDISASM_ARCH_AVR8)
+        ret = avr_disasm_origin(instr, address);
+    else if (arch >= UCDISASM_ARCH_PIC_BASELINE && arch <= UCDISASM_ARCH_PIC_PIC18)
+        ret = pic_disasm_origin(instr, address);
+    else if (arch == UCDISASM_ARCH_8051)
+        ret = a8051_disasm_origin(instr, address);
+    else
+        return STREAM_ERROR_FAILURE;
+
+    return (ret < 0) ? STREAM_ERROR_ALLOC : 0;
+}
+
+/******************************************************************************/
+/* In-memory Disassembly */
+/******************************************************************************/
+
+int ucdisasm_disassemble(int arch, const uint8_t *data, uint32_t len, uint32_t address, ucdisasm_callback callback, void *arg) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct instruction instr;
+    int ret, stop;
+
+    if (ucdisasm_disasmstream_setup(&ds, arch) == NULL)
+        return STREAM_ERROR_FAILURE;
+
+    if ((ret = bytestream_memory_setup(&bs, data, len, address)) < 0)
+        return ret;
+    ds.in = &bs;
+
+    if ((ret = ds.stream_init(&ds)) < 0) {
+        bs.stream_close(&bs);
+        return ret;
+    }
+
+    for (stop = 0; !stop; ) {
+        if ((ret = ds.stream_read(&ds, &instr)) < 0)
+            break;
+        stop = callback(&instr, arg);
+        instr.free(&instr);
+    }
+
+    if (ds.stream_close(&ds) < 0 && (ret == 0 || ret == STREAM_EOF))
+        ret = STREAM_ERROR_INPUT;
+
+    return (ret == STREAM_EOF) ? 0 : ret;
+}
+
+/* Passes of a listing, with the labels nothing refers to removed */
+struct listing_pass {
+    struct xref_index index;
+    int failed;
+    ucdisasm_callback callback;
+    void *arg;
+};
+
+static int util_xref_callback(struct instruction *instr, void *arg) {
+    struct listing_pass *pass = (struct listing_pass *)arg;
+
+    /* Stop the pass if the index cannot grow */
+    if (xref_index_add_targets(&pass->index, instr) < 0)
+        pass->failed = 1;
+    return pass->failed;
+}
+
+static int util_listing_callback(struct instruction *instr, void *arg) {
+    struct listing_pass *pass = (struct listing_pass *)arg;
+
+    xref_filter_label(&pass->index, instr);
+    return pass->callback(instr, pass->arg);
+}
+
+int ucdisasm_disassemble_listing(int arch, const uint8_t *data, uint32_t len, uint32_t address, int flags, ucdisasm_callback callback, void *arg) {
+    struct listing_pass pass;
+    int ret;
+
+    if (!(flags & PRINT_FLAG_ASSEMBLY) || (flags & PRINT_FLAG_ALL_LABELS))
+        return ucdisasm_disassemble(arch, data, len, address, callback, arg);
+
+    xref_index_init(&pass.index);
+    pass.failed = 0;
+    pass.callback = callback;
+    pass.arg = arg;
+
+    ret = ucdisasm_disassemble(arch, data, len, address, util_xref_callback, &pass);
+    if (ret == 0 && pass.failed)
+        ret = STREAM_ERROR_ALLOC;
+    if (ret == 0)
+        ret = ucdisasm_disassemble(arch, data, len, address, util_listing_callback, &pass);
+    xref_index_free(&pass.index);
+
+    return ret;
+}
+
+/* Text listing output buffer */
+struct text_buffer {
+    char *dest;
+    size_t size;
+    size_t len;
+    int flags;
+};
+
+static int util_text_callback(struct instruction *instr, void *arg) {
+    struct text_buffer *buf = (struct text_buffer *)arg;
+    char line[PRINTSTREAM_FILE_LINE_LEN];
+    size_t n;
+    int len;
+
+    len = printstream_file_format(instr, line, sizeof(line), buf->flags);
+    if (len <= 0)
+        return 0;
+    if (len >= (int)sizeof(line))
+        len = sizeof(line) - 1;
+
+    /* Copy what fits, but keep counting the complete length */
+    if (buf->len < buf->size) {
+        n = buf->size - buf->len - 1;
+        if (n > (size_t)len)
+            n = len;
+        memcpy(buf->dest + buf->len, line, n);
+    }
+    buf->len += len;
+
+    return 0;
+}
+
+long ucdisasm_disassemble_text(int arch, const uint8_t *data, uint32_t len, uint32_t address, int flags, char *dest, size_t size) {
+    struct text_buffer buf;
+    int ret;
+
+    buf.dest = dest;
+    buf.size = size;
+    buf.len = 0;
+    buf.flags = flags;
+
+    ret = ucdisasm_disassemble_listing(arch, data, len, address, flags, util_text_callback, &buf);
+
+    if (size > 0)
+        dest[(buf.len < size) ? buf.len : size - 1] = '\0';
+
+    if (ret < 0)
+        return ret;
+
+    return buf.len;
+}
+
@@ -0,0 +1,345 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <live.h>
+
+/* Set by the SIGINT / SIGTERM handler to end live input */
+static volatile sig_atomic_t live_stopping;
+
+/******************************************************************************/
+/* Live Statistics */
+/******************************************************************************/
+
+static uint64_t util_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Bucket of a latency, with four buckets per power of two */
+static unsigned int util_bucket(uint64_t ns) {
+    unsigned int msb;
+
+    if (ns < 4)
+        return ns;
+    msb = 63 - __builtin_clzll(ns);
+    return (msb - 1) * 4 + ((ns >> (msb - 2)) & 3);
+}
+
+/* Smallest latency of a bucket */
+static uint64_t util_bucket_start(unsigned int bucket) {
+    if (bucket < 4)
+        return bucket;
+    return (uint64_t)(4 + (bucket & 3)) << (bucket / 4 - 1);
+}
+
+void live_stats_init(struct live_stats *stats, unsigned int flush_interval_ms) {
+    memset(stats, 0, sizeof(struct live_stats));
+    stats->flush_interval = (uint64_t)flush_interval_ms * 1000000ULL;
+    stats->last_flush = stats->arrival = util_now();
+}
+
+void live_flush(struct live_stats *stats) {
+    uint64_t now, latency;
+    unsigned int i;
+
+    fflush(NULL);
+    now = util_now();
+
+    for (i = 0; i < stats->num_pending; i++) {
+        latency = (now > stats->pending[i]) ? now - stats->pending[i] : 0;
+        stats->histogram[util_bucket(latency)]++;
+        stats->total += latency;
+        if (latency > stats->max)
+            stats->max = latency;
+    }
+    stats->count += stats->num_pending;
+    stats->num_pending = 0;
+    stats->last_flush = now;
+}
+
+void live_instruction(struct live_stats *stats) {
+    for (; stats->num_read > 0; stats->num_read--) {
+        stats->pending[stats->num_pending++] = stats->arrival;
+        if (stats->num_pending == LIVE_MAX_PENDING)
+            live_flush(stats);
+    }
+
+    if (stats->flush_interval == 0 || util_now() - stats->last_flush >= stats->flush_interval)
+        live_flush(stats);
+}
+
+uint64_t live_stats_percentile(const struct live_stats *stats, unsigned int percent) {
+    uint64_t rank, seen;
+    unsigned int i;
+
+    if (stats->count == 0)
+        return 0;
+
+    /* Upper end of the bucket holding the ranked latency */
+    rank = (stats->count * percent + 99) / 100;
+    for (i = 0, seen = 0; i < LIVE_HISTOGRAM_BUCKETS - 1; i++) {
+        seen += stats->histogram[i];
+        if (seen >= rank && seen > 0)
+            break;
+    }
+    if (i == LIVE_HISTOGRAM_BUCKETS - 1 || util_bucket_start(i + 1) > stats->max)
+        return stats->max;
+    return util_bucket_start(i + 1);
+}
+
+void live_stats_print(const struct live_stats *stats, FILE *out) {
+    fprintf(out, "Live: %llu instructions, latency mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+        (unsigned long long)stats->count,
+        (stats->count > 0) ? (double)stats->total / stats->count / 1e6 : 0.0,
+        live_stats_percentile(stats, 50) / 1e6,
+        live_stats_percentile(stats, 99) / 1e6,
+        stats->max / 1e6);
+}
+
+/******************************************************************************/
+/* Live Input Stream */
+/******************************************************************************/
+
+struct live_input {
+    FILE *in;
+    int fd;
+    int follow;
+    /* Regular files are always readable, and signal growth with inotify */
+    int regular;
+    int inotify_fd;
+    struct live_stats *stats;
+    /* Signal handlers to restore on close */
+    struct sigaction sigint, sigterm;
+};
+
+static void live_signal_handler(int signum) {
+    (void)signum;
+    live_stopping = 1;
+}
+
+/* Wait for fd to become readable, or for timeout_ms if not negative. Stop
+ * signals are unblocked only within ppoll(), so one arriving after the check
+ * still interrupts the wait. Returns -1 once stopping. */
+static int live_wait(int fd, int timeout_ms) {
+    struct pollfd pfd;
+    struct timespec ts, *timeout = NULL;
+    sigset_t block, orig;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+        timeout = &ts;
+    }
+
+    sigemptyset(&block);
+    sigaddset(&block, SIGINT);
+    sigaddset(&block, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &block, &orig);
+    if (!live_stopping)
+        ppoll(&pfd, 1, timeout, &orig);
+    pthread_sigmask(SIG_SETMASK, &orig, NULL);
+
+    return live_stopping ? -1 : 0;
+}
+
+static ssize_t live_input_read(void *cookie, char *buf, size_t size) {
+    struct live_input *input = cookie;
+    struct pollfd pfd;
+    char events[4096];
+    ssize_t len;
+
+    while (!live_stopping) {
+        /* With no data ready, write out what has been decoded so far before
+         * waiting for more */
+        pfd.fd = input->fd;
+        pfd.events = POLLIN;
+        if (!input->regular && poll(&pfd, 1, 0) == 0) {
+            live_flush(input->stats);
+            if (live_wait(input->fd, -1) < 0)
+                break;
+        }
+
+        len = read(input->fd, buf, size);
+        if (len > 0) {
+            input->stats->arrival = util_now();
+            return len;
+        } else if (len < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return -1;
+        }
+
+        /* End of file, unless following a regular file as it grows */
+        if (!input->follow || !input->regular)
+            break;
+        live_flush(input->stats);
+        if (live_wait(input->inotify_fd, (input->inotify_fd < 0) ? LIVE_FOLLOW_POLL_MS : -1) < 0)
+            break;
+        /* Drain the change notifications, the next read picks up the data */
+        if (input->inotify_fd >= 0)
+            while (read(input->inotify_fd, events, sizeof(events)) > 0)
+                ;
+    }
+
+    /* End of file completes any instruction still waiting on more bytes */
+    input->stats->arrival = util_now();
+
+    return 0;
+}
+
+static int live_input_close(void *cookie) {
+    struct live_input *input = cookie;
+    int ret;
+
+    ret = fclose(input->in);
+    sigaction(SIGINT, &input->sigint, NULL);
+    sigaction(SIGTERM, &input->sigterm, NULL);
+    if (input->inotify_fd >= 0)
+        close(input->inotify_fd);
+    free(input);
+
+    return ret;
+}
+
+FILE *live_input_open(FILE *in, int follow, struct live_stats *stats) {
+    cookie_io_functions_t functions = {live_input_read, NULL, NULL, live_input_close};
+    struct live_input *input;
+    struct sigaction sa;
+    struct stat st;
+    char path[64];
+    FILE *fp;
+
+    if ((input = calloc(1, sizeof(struct live_input))) == NULL)
+        return NULL;
+    input->in = in;
+    input->fd = fileno(in);
+    input->follow = follow;
+    input->inotify_fd = -1;
+    input->stats = stats;
+    if (input->fd < 0 || fstat(input->fd, &st) < 0) {
+        free(input);
+        return NULL;
+    }
+    input->regular = S_ISREG(st.st_mode);
+
+    /* Watch a followed file for writes, or fall back to polling it */
+    if (follow && input->regular && (input->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) >= 0) {
+        snprintf(path, sizeof(path), "/proc/self/fd/%d", input->fd);
+        if (inotify_add_watch(input->inotify_fd, path, IN_MODIFY | IN_CLOSE_WRITE) < 0) {
+            close(input->inotify_fd);
+            input->inotify_fd = -1;
+        }
+    }
+
+    if ((fp = fopencookie(input, "r", functions)) == NULL) {
+        if (input->inotify_fd >= 0)
+            close(input->inotify_fd);
+        free(input);
+        return NULL;
+    }
+
+    /* End the input on SIGINT / SIGTERM, interrupting the wait for data */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = live_signal_handler;
+    sigaction(SIGINT, &sa, &input->sigint);
+    sigaction(SIGTERM, &sa, &input->sigterm);
+    live_stopping = 0;
+
+    return fp;
+}
+
+/******************************************************************************/
+/* Live Disasm Stream Support */
+/******************************************************************************/
+
+struct live_disasmstream_state {
+    struct DisasmStream *source;
+    struct live_stats *stats;
+};
+
+int live_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, struct live_stats *stats) {
+    struct live_disasmstream_state *state;
+
+    /* Allocate stream state */
+    state = malloc(sizeof(struct live_disasmstream_state));
+    if (state == NULL) {
+        self->error = "Error allocating live stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->source = source;
+    state->stats = stats;
+
+    self->in = source->in;
+    self->state = state;
+    self->error = NULL;
+    self->stream_init = live_disasmstream_init;
+    self->stream_close = live_disasmstream_close;
+    self->stream_read = live_disasmstream_read;
+
+    return 0;
+}
+
+int live_disasmstream_init(struct DisasmStream *self) {
+    struct live_disasmstream_state *state = (struct live_disasmstream_state *)self->state;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the source stream */
+    if (state->source->stream_init(state->source) < 0) {
+        self->error = state->source->error;
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int live_disasmstream_close(struct DisasmStream *self) {
+    struct live_disasmstream_state *state = (struct live_disasmstream_state *)self->state;
+    int ret = 0;
+
+    /* Close the source stream */
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free stream state memory */
+    free(state);
+
+    return ret;
+}
+
+int live_disasmstream_read(struct DisasmStream *self, struct instruction *instr) {
+    struct live_disasmstream_state *state = (struct live_disasmstream_state *)self->state;
+    int ret;
+
+    if ((ret = state->source->stream_read(state->source, instr)) < 0) {
+        if (ret != STREAM_EOF)
+            self->error = state->source->error;
+        return ret;
+    }
+
+    /* Directives are written out, but not counted */
+    if (instr->type == DISASM_TYPE_INSTRUCTION)
+        state->stats->num_read++;
+
+    return 0;
+}
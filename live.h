@@ -0,0 +1,83 @@
+#ifndef LIVE_H
+#define LIVE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <disasmstream.h>
+
+/* Live Stream Support
+ *
+ * A live input stream reads a program file as its data arrives, e.g. from a
+ * serial port, a debug probe pipe, or a capture file still being written.
+ * Reads return as soon as any data is available, so the disassemblers, which
+ * decode an instruction as soon as its last byte is read, never wait on a
+ * full buffer. Whenever the input has no data ready, all output streams are
+ * flushed before waiting for more with poll(), or, when following a regular
+ * file as it grows, with inotify.
+ *
+ * Output is also flushed after every instruction, or with a flush interval,
+ * at most once per interval while input keeps arriving. The latency of each
+ * instruction, from the arrival of the read that completed it to the flush
+ * that wrote it out, is collected into a histogram of constant size. The
+ * instructions are counted by a live DisasmStream ahead of the output, so
+ * that directives are written out but not counted.
+ *
+ * While a live input stream is open, SIGINT and SIGTERM end it as if at end
+ * of file, so the disassembly is completed and the statistics can be printed.
+ */
+
+/* Instructions held back by a flush interval before a forced flush */
+#define LIVE_MAX_PENDING        1024
+/* Latency histogram buckets, four per power of two nanoseconds */
+#define LIVE_HISTOGRAM_BUCKETS  256
+/* Polling period when following a file without inotify, in milliseconds */
+#define LIVE_FOLLOW_POLL_MS     100
+
+struct live_stats {
+    /* Flush interval in nanoseconds, 0 to flush after every instruction */
+    uint64_t flush_interval;
+    /* Time of the last flush */
+    uint64_t last_flush;
+    /* Arrival time of the most recent input */
+    uint64_t arrival;
+    /* Arrival times of the instructions written since the last flush */
+    uint64_t pending[LIVE_MAX_PENDING];
+    unsigned int num_pending;
+    /* Instructions read through the live DisasmStream, not yet written */
+    unsigned int num_read;
+
+    /* Latencies of flushed instructions, in nanoseconds */
+    uint64_t count, total, max;
+    uint64_t histogram[LIVE_HISTOGRAM_BUCKETS];
+};
+
+/* Reset stats, with a flush interval in milliseconds */
+void live_stats_init(struct live_stats *stats, unsigned int flush_interval_ms);
+
+/* Open a live stream reading in, which is closed with it. With follow, end
+ * of file of a regular file waits for the file to grow instead. Returns NULL
+ * on failure. */
+FILE *live_input_open(FILE *in, int follow, struct live_stats *stats);
+
+/* Account for the instructions read since the last call, now written to the
+ * output, flushing as due */
+void live_instruction(struct live_stats *stats);
+/* Flush all output streams */
+void live_flush(struct live_stats *stats);
+
+/* Latency percentile, 0 to 100, in nanoseconds */
+uint64_t live_stats_percentile(const struct live_stats *stats, unsigned int percent);
+/* Print a one line latency summary */
+void live_stats_print(const struct live_stats *stats, FILE *out);
+
+/* Setup self to pass through the source stream, counting the instructions
+ * read in stats for live_instruction() */
+int live_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, struct live_stats *stats);
+
+/* Live Disasm Stream Support */
+int live_disasmstream_init(struct DisasmStream *self);
+int live_disasmstream_close(struct DisasmStream *self);
+int live_disasmstream_read(struct DisasmStream *self, struct instruction *instr);
+
+#endif
+
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <getopt.h>
+#include <unistd.h>
 
 #include <bytestream.h>
 #include <disasmstream.h>
@@ -9,18 +10,46 @@
 
 /* File ByteStream Support */
 #include "file/file_support.h"
-/* DisasmStream Support */
-#include "avr/avr_support.h"
-#include "pic/pic_support.h"
-#include "8051/8051_support.h"
+#include "file/prefetch.h"
+#include "file/gzip.h"
 /* File PrintStream Support */
 #include "printstream_file.h"
+#include "printstream_record.h"
+#include "printstream_template.h"
+#include "printstream_binary.h"
+#include "printstream_stats.h"
+#include "printstream_cycles.h"
+/* Pipelined Stream Support */
+#include "pipeline.h"
+#include "fanout.h"
+#include "range.h"
+#include "shard.h"
+#include "discover.h"
+#include "xref.h"
+#include "incremental.h"
+#include "diff.h"
+#include "similarity.h"
+#include "search.h"
+#include "cfg.h"
+#include "callgraph.h"
+/* Library Support (architectures) */
+#include "ucdisasm.h"
+/* Batch and Server Support */
+#include "batch.h"
+#include "serve.h"
+/* Memory Budget Support */
+#include "budget.h"
+/* Live Stream Support */
+#include "live.h"
 
 /* Debugging Unit Tests */
 #include <file/test/test_bytestream.h>
 #include <avr/test/test_avr.h>
 #include <pic/test/test_pic.h>
 #include <8051/test/test_8051.h>
+#include <test/test_pipeline.h>
+#include <test/test_record.h>
+#include <test/test_library.h>
 
 /* Supported file types */
 enum {
@@ -32,14 +61,17 @@ enum {
     FILE_TYPE_ELF
 };
 
-/* Supported architectures */
+/* Supported output formats */
 enum {
-    ARCH_AVR8,
-    ARCH_PIC_BASELINE,
-    ARCH_PIC_MIDRANGE,
-    ARCH_PIC_MIDRANGE_ENHANCED,
-    ARCH_PIC_PIC18,
-    ARCH_8051,
+    OUTPUT_FORMAT_TEXT,
+    OUTPUT_FORMAT_JSON,
+    OUTPUT_FORMAT_CSV,
+    OUTPUT_FORMAT_BINARY,
+    OUTPUT_FORMAT_COMPACT,
+    OUTPUT_FORMAT_STATS,
+    OUTPUT_FORMAT_CFG_DOT,
+    OUTPUT_FORMAT_CFG_JSON,
+    OUTPUT_FORMAT_STACK,
 };
 
 /* Supported data constant bases */
@@ -49,25 +81,115 @@ enum {
     DATA_BASE_DEC,
 };
 
+/* Additional outputs rendered from the same disassembly pass (--tee) */
+#define MAX_TEE_OUTPUTS     8
+
+struct tee_output {
+    char spec[4096];
+    char *file_str;
+    FILE *file;
+    int format;
+    int flags;
+};
+
+/* Options that rule each other out, see Option_Conflicts */
+enum {
+    OPTION_BATCH        = (1<<0),
+    OPTION_PIPELINE     = (1<<1),
+    OPTION_CONNECT      = (1<<2),
+    OPTION_SHARD        = (1<<3),
+    OPTION_TEE          = (1<<4),
+    OPTION_LIVE         = (1<<5),
+    OPTION_FOLLOW       = (1<<6),
+    OPTION_DISCOVER     = (1<<7),
+    OPTION_PREVIOUS     = (1<<8),
+    OPTION_DIFF         = (1<<9),
+    OPTION_RANGE        = (1<<10),
+    OPTION_SEARCH       = (1<<11),
+    OPTION_CYCLES       = (1<<12),
+    OPTION_FORMAT       = (1<<13),
+    OPTION_ASSEMBLY     = (1<<14),
+    OPTION_NO_ADDRESSES = (1<<15),
+    OPTION_STATS        = (1<<16),
+    OPTION_CFG          = (1<<17),
+};
+
+/* Names of the OPTION_* bits, in bit order */
+static const char *const Option_Names[] = {
+    "--batch", "--pipeline", "--connect", "--shard", "--tee", "--live",
+    "--follow", "--discover", "--previous", "--diff", "--range", "--search",
+    "--cycles", "--format", "--assembly", "--no-addresses", "--stats-only",
+    "-O dot, cfg, or stack",
+};
+
+/* Each option of options is not supported with any option of conflicts */
+static const struct {
+    unsigned int options;
+    unsigned int conflicts;
+} Option_Conflicts[] = {
+    {OPTION_STATS | OPTION_CFG, OPTION_FORMAT | OPTION_SHARD},
+    {OPTION_CYCLES, OPTION_FORMAT | OPTION_ASSEMBLY | OPTION_SHARD | OPTION_CONNECT | OPTION_SEARCH | OPTION_PREVIOUS | OPTION_DIFF},
+    {OPTION_SEARCH, OPTION_FORMAT | OPTION_SHARD | OPTION_CONNECT | OPTION_TEE | OPTION_PREVIOUS | OPTION_DIFF},
+    {OPTION_LIVE | OPTION_FOLLOW, OPTION_BATCH | OPTION_PIPELINE | OPTION_CONNECT | OPTION_SHARD},
+    {OPTION_SHARD, OPTION_BATCH | OPTION_CONNECT | OPTION_TEE},
+    {OPTION_DISCOVER, OPTION_BATCH | OPTION_PIPELINE | OPTION_CONNECT | OPTION_SHARD | OPTION_LIVE | OPTION_FOLLOW},
+    {OPTION_PREVIOUS, OPTION_BATCH | OPTION_PIPELINE | OPTION_CONNECT | OPTION_SHARD | OPTION_LIVE | OPTION_FOLLOW | OPTION_DISCOVER | OPTION_RANGE | OPTION_TEE | OPTION_FORMAT | OPTION_ASSEMBLY | OPTION_NO_ADDRESSES},
+    {OPTION_DIFF, OPTION_BATCH | OPTION_PIPELINE | OPTION_CONNECT | OPTION_SHARD | OPTION_LIVE | OPTION_FOLLOW | OPTION_DISCOVER | OPTION_PREVIOUS | OPTION_RANGE | OPTION_TEE | OPTION_FORMAT | OPTION_ASSEMBLY},
+    {OPTION_CONNECT, OPTION_FORMAT | OPTION_TEE},
+};
+
 /* getopt flags for some long options that don't have a short option equivalent */
 static int flag_no_addresses = 0;            /* Flag for --no-addresses */
 static int flag_no_destination_comments = 0; /* Flag for --no-destination-comments */
 static int flag_no_opcodes = 0;              /* Flag for --no-opcodes */
 static int flag_assembly = 0;                /* Flag for --assembly */
 static int flag_debug = 0;                   /* Flag for --debug */
+static int flag_pipeline = 0;                /* Flag for --pipeline */
+static int flag_batch = 0;                   /* Flag for --batch */
+static int flag_follow = 0;                  /* Flag for --follow */
+static int flag_discover = 0;                /* Flag for --discover */
+static int flag_all_labels = 0;              /* Flag for --all-labels */
+static int flag_stats_only = 0;              /* Flag for --stats-only */
+static int flag_cycles = 0;                  /* Flag for --cycles */
+static int cycles_variant = 0;               /* Core variant of --cycles (CYCLES_VARIANT_*) */
 static int flag_data_base = 0;               /* Base of data constants (hexadecimal, binary, decimal) */
 
 static struct option long_options[] = {
     {"architecture", required_argument, NULL, 'a'},
     {"file-type", required_argument, NULL, 't'},
     {"out-file", required_argument, NULL, 'o'},
+    {"output-format", required_argument, NULL, 'O'},
+    {"format", required_argument, NULL, 'f'},
+    {"stats-only", no_argument, &flag_stats_only, 1},
+    {"tee", required_argument, NULL, 'T'},
     {"assembly", no_argument, &flag_assembly, 1},
+    {"all-labels", no_argument, &flag_all_labels, 1},
     {"data-base-hex", no_argument, &flag_data_base, DATA_BASE_HEX},
     {"data-base-bin", no_argument, &flag_data_base, DATA_BASE_BIN},
     {"data-base-dec", no_argument, &flag_data_base, DATA_BASE_DEC},
     {"no-opcodes", no_argument, &flag_no_opcodes, 1},
     {"no-addresses", no_argument, &flag_no_addresses, 1},
     {"no-destination-comments", no_argument, &flag_no_destination_comments, 1},
+    {"cycles", optional_argument, NULL, 'Y'},
+    {"pipeline", no_argument, &flag_pipeline, 1},
+    {"batch", no_argument, &flag_batch, 1},
+    {"batch-output", required_argument, NULL, 'B'},
+    {"jobs", required_argument, NULL, 'j'},
+    {"prefetch", required_argument, NULL, 'P'},
+    {"range", required_argument, NULL, 'R'},
+    {"serve", required_argument, NULL, 'S'},
+    {"connect", required_argument, NULL, 'C'},
+    {"shard", required_argument, NULL, 'N'},
+    {"max-memory", required_argument, NULL, 'M'},
+    {"live", optional_argument, NULL, 'L'},
+    {"follow", no_argument, &flag_follow, 1},
+    {"discover", no_argument, &flag_discover, 1},
+    {"entry", required_argument, NULL, 'E'},
+    {"previous", required_argument, NULL, 'I'},
+    {"previous-listing", required_argument, NULL, 'J'},
+    {"diff", required_argument, NULL, 'D'},
+    {"search", required_argument, NULL, 'G'},
+    {"context", required_argument, NULL, 'A'},
     {"debug", no_argument, &flag_debug, 1},
     {"help", no_argument, NULL, 'h'},
     {"version", no_argument, NULL, 'v'},
@@ -119,6 +241,15 @@ void debug_tests(FILE *in, int file_type) {
     if (test_disasm_8051_unit_tests()) success = 0;
     if (test_print_8051_unit_tests()) success = 0;
 
+    /* Test Record Print Streams */
+    if (test_record_unit_tests()) success = 0;
+
+    /* Test Pipelined Streams */
+    if (test_pipeline_unit_tests()) success = 0;
+
+    /* Test In-memory Library */
+    if (test_library_unit_tests()) success = 0;
+
     if (success)
         printf("All tests passed!\n");
     else
@@ -127,6 +258,11 @@ void debug_tests(FILE *in, int file_type) {
 
 static void print_usage(const char *programName) {
     printf("Usage: %s -a <architecture> [option(s)] <file>\n", programName);
+    printf("       %s -a <architecture> --batch [option(s)] <file(s)>\n", programName);
+    printf("       %s --serve <socket> [-j <n>]\n", programName);
+    printf("       %s merge [-o <file>] <shard output(s)>\n", programName);
+    printf("       %s similarity index -a <architecture> [-t <type>] [-j <n>] -o <index> <file(s)>\n", programName);
+    printf("       %s similarity query [-t <type>] [-n <count>] <index> <file>\n", programName);
     printf("Disassembles program file <file>. Use - for standard input.\n\n");
     printf("ucdisasm version 1.0 - 02/04/2013.\n");
     printf("Written by Vanya A. Sergeev - <vsergeev@gmail.com>.\n\n");
@@ -134,10 +270,45 @@ static void print_usage(const char *programName) {
   -a, --architecture <arch>     Architecture to disassemble for.\n\
 \n\
   -o, --out-file <file>         Write to file instead of standard output.\n\
+\n\
+  -O, --output-format <format>  Output format: text (default), json (JSON\n\
+                                  Lines), csv, binary (fixed size\n\
+                                  records, see printstream_binary.h),\n\
+                                  compact (variable length records of\n\
+                                  the same header, for storage), stats,\n\
+                                  the control flow graph of the\n\
+                                  basic blocks as dot (Graphviz) or cfg\n\
+                                  (JSON, see cfg.h), or stack (worst case\n\
+                                  stack depth of each function and\n\
+                                  interrupt vector, see callgraph.h).\n\
+\n\
+  --stats-only                  Write only a JSON summary of the\n\
+                                  instructions: mnemonic histogram, width\n\
+                                  mix, flow, I/O register and data address\n\
+                                  use, and raw data fraction. Same as\n\
+                                  -O stats.\n\
+\n\
+  -f, --format <template>       Print each instruction with a line template,\n\
+                                  e.g. \"{addr:04x}: {bytes} {mnem} {ops}\".\n\
+                                  Fields are addr, label, width, bytes, mnem,\n\
+                                  ops, comment, and target, with an optional\n\
+                                  :[-][0][width][base] spec.\n\
+\n\
+  --tee <file>[,<option>...]    Also write the disassembly to <file>, from\n\
+                                  the same pass. Options are text, json,\n\
+                                  csv, binary, compact, stats, dot, cfg,\n\
+                                  stack, assembly, all-labels,\n\
+                                  no-addresses, no-opcodes,\n\
+                                  no-destination-comments, data-base-hex,\n\
+                                  data-base-bin, and data-base-dec. May be\n\
+                                  given up to 8 times.\n\
 \n\
   -t, --file-type <type>        Specify file type of the program file.\n\
 \n\
   --assembly                    Produce assemble-able code with address labels.\n\
+                                  Only instructions referred to are labeled,\n\
+                                  unless reading a --live input.\n\
+  --all-labels                  With --assembly, label every instruction.\n\
 \n\
   --data-base-hex               Represent data constants in hexadecimal\n\
                                   (default).\n\
@@ -149,6 +320,92 @@ static void print_usage(const char *programName) {
                                   disassembly.\n\
   --no-destination-comments     Do not display destination address comments\n\
                                   of relative branch/jump/call instructions.\n\
+\n\
+  --cycles[=<core>]             Display the cycles of each instruction, as\n\
+                                  next/taken for branches and skips, and\n\
+                                  the shortest and longest cycles of each\n\
+                                  basic block after the listing. AVR cores\n\
+                                  are avre (default), avrxm, avrxt, and\n\
+                                  avrrc.\n\
+\n\
+  --pipeline                    Parse, disassemble, and print on separate\n\
+                                  threads.\n\
+\n\
+  --batch                       Disassemble each of several program files\n\
+                                  to its own output file, in parallel, and\n\
+                                  print a per-file status summary. Use - to\n\
+                                  read the file list from standard input,\n\
+                                  one path per line.\n\
+  --batch-output <template>     Output file path for --batch, with {path},\n\
+                                  {dir}, {name}, {stem}, and {index}\n\
+                                  substituted (default {path}.lst).\n\
+  -j, --jobs <n>                Number of --batch or --serve worker threads\n\
+                                  (default number of processors).\n\
+  --prefetch <n>                Number of --batch program files to read\n\
+                                  ahead, with io_uring where available\n\
+                                  (default twice the jobs, 0 to disable).\n\
+\n\
+  --range <start>:<end>         Only print instructions at addresses within\n\
+                                  [start, end), e.g. 0x100:0x200.\n\
+\n\
+  --serve <socket>              Serve disassembly requests on a Unix domain\n\
+                                  socket, see serve.h for the protocol.\n\
+  --connect <socket>            Disassemble <file> on a --serve server.\n\
+\n\
+  --shard <i>/<n>               Disassemble only shard <i> of <n> of <file>,\n\
+                                  split at instruction boundaries. The\n\
+                                  outputs of all <n> shards, 0 to <n>-1,\n\
+                                  are joined with the merge command into\n\
+                                  the output of a single run.\n\
+\n\
+  --live[=<ms>]                 Disassemble input as it arrives, e.g. from a\n\
+                                  serial port or pipe, and write out each\n\
+                                  instruction as soon as it is decoded, or\n\
+                                  at most every <ms> milliseconds while input\n\
+                                  keeps arriving. Prints instruction latency\n\
+                                  statistics to standard error at the end.\n\
+  --follow                      Like --live, and keep following <file> as it\n\
+                                  grows, until interrupted.\n\
+\n\
+  --discover                    Disassemble only the code reachable from the\n\
+                                  reset and interrupt vectors, the ELF entry\n\
+                                  point and function symbols, and any\n\
+                                  --entry addresses, listing the remaining\n\
+                                  bytes as data. Reads all of <file> into\n\
+                                  memory first.\n\
+  --entry <address>             Also follow the code at <address>, implies\n\
+                                  --discover. May be repeated.\n\
+\n\
+  --previous <file>             Disassemble <file> incrementally from the\n\
+  --previous-listing <listing>    previous build's program file and its\n\
+                                  text listing, decoding again only the\n\
+                                  regions that changed. The listing must\n\
+                                  have been written with the same options.\n\
+\n\
+  --search <pattern>            Write only the instruction sequences that\n\
+                                  match <pattern>, e.g.\n\
+                                  \"ldi r30, *; ldi r31, *; ijmp\". Each\n\
+                                  instruction is a mnemonic, or mnemonics\n\
+                                  separated by |, and operands that are *,\n\
+                                  a number, or the operand text. May be\n\
+                                  repeated, and used with --batch.\n\
+  --context <n>                 Also write <n> instructions before and\n\
+                                  after each match.\n\
+\n\
+  --diff <old file>             List the instructions added, removed, or\n\
+                                  changed in <file> since <old file> as\n\
+                                  hunks of the text listing, ignoring\n\
+                                  changes of addresses alone. Exits with 0\n\
+                                  if there are none, 1 if there are, and\n\
+                                  2 on error, as diff(1).\n\
+\n\
+  --max-memory <size>           Fail rather than use more than <size> bytes\n\
+                                  of memory, e.g. 64M. Disassembly streams\n\
+                                  in memory bounded regardless of the size\n\
+                                  of <file>; this limits buffers that depend\n\
+                                  on the options. At least 16M. With\n\
+                                  --serve, limits the cached program files,\n\
+                                  uploads and buffered replies.\n\
 \n\
   -h, --help                    Display this usage/help.\n\
   -v, --version                 Display the program's version.\n\
@@ -166,7 +423,8 @@ static void print_usage(const char *programName) {
   Motorola S-Record         srec\n\
   Raw Binary                binary\n\
   ELF (64-bit)              elf\n\
-  ASCII Hex                 ascii\n\n");
+  ASCII Hex                 ascii\n\
+Any of these may be compressed with gzip.\n\n");
 }
 
 static void print_version(void) {
@@ -190,177 +448,237 @@ void printstream_error_trace(struct PrintStream *ps, struct DisasmStream *ds, st
     else
         fprintf(stderr, "\tByte Stream Error: %s\n", bs->error);
 
+    if (budget_exceeded())
+        fprintf(stderr, "\tMemory limit exceeded, see --max-memory\n");
+
     fprintf(stderr, "\tPlease file an issue at https://github.com/vsergeev/vAVRdisasm/issues\n\tor email the author!\n\n");
 }
 
-int main(int argc, const char *argv[]) {
-    /* User Options */
-    int optc;
-    char arch_str[16] = {0};
-    char file_type_str[8] = {0};
-    char file_out_str[4096] = {0};
+/* Returns 1 if argv gives --diff, or an abbreviation of it that getopt_long
+ * takes, so that every error exits as diff(1), even one met before --diff */
+static int gives_diff(int argc, const char *argv[]) {
+    size_t len;
+    int i;
 
-    /* Input / Output files */
-    FILE *file_in = NULL, *file_out = NULL;
+    for (i = 1; i < argc && strcmp(argv[i], "--") != 0; i++) {
+        if (strncmp(argv[i], "--", 2) != 0)
+            continue;
+        len = strcspn(argv[i] + 2, "=");
+        if (len >= 3 && len <= 4 && strncmp(argv[i] + 2, "diff", len) == 0)
+            return 1;
+    }
 
-    /* Disassembler Streams */
-    int file_type = 0;
-    int arch = 0;
-    int flags = 0;
-    struct ByteStream bs;
-    struct DisasmStream ds;
-    struct PrintStream ps;
-    int ret;
+    return 0;
+}
 
-    /* Parse command line options */
-    while (1) {
-        optc = getopt_long(argc, (char * const *)argv, "a:o:t:l:hv", long_options, NULL);
-        if (optc == -1)
-            break;
-        switch (optc) {
-            /* Long option */
-            case 0:
-                break;
-            case 'a':
-                strncpy(arch_str, optarg, sizeof(arch_str));
-                break;
-            case 't':
-                strncpy(file_type_str, optarg, sizeof(file_type_str));
-                break;
-            case 'o':
-                if (strcmp(optarg, "-") != 0)
-                    strncpy(file_out_str, optarg, sizeof(file_out_str));
-                break;
-            case 'h':
-                print_usage(argv[0]);
-                exit(EXIT_SUCCESS);
-            case 'v':
-                print_version();
-                exit(EXIT_SUCCESS);
-            default:
-                print_usage(argv[0]);
-                exit(EXIT_SUCCESS);
-        }
-    }
+/* Report the first conflict among the OPTION_* options given, returns 0, or
+ * -1 on a conflict */
+static int check_conflicts(unsigned int given) {
+    unsigned int i, option, conflict;
 
-    /* If there are no more arguments left but we're in debugging test mode */
-    if (optind == argc && flag_debug) {
-        debug_tests(file_in, 0);
-        goto cleanup_exit_success;
+    for (i = 0; i < sizeof(Option_Conflicts)/sizeof(Option_Conflicts[0]); i++) {
+        if (!(given & Option_Conflicts[i].options) || !(given & Option_Conflicts[i].conflicts))
+            continue;
+        for (option = 0; !(given & Option_Conflicts[i].options & (1u << option)); option++)
+            ;
+        for (conflict = 0; !(given & Option_Conflicts[i].conflicts & (1u << conflict)); conflict++)
+            ;
+        fprintf(stderr, "Error: %s is not supported with %s.\n", Option_Names[option], Option_Names[conflict]);
+        return -1;
     }
 
-    /* If there are no more arguments left */
-    if (optind == argc) {
-        fprintf(stderr, "Error: No program file specified! Use - for standard input.\n\n");
-        print_usage(argv[0]);
-        goto cleanup_exit_failure;
-    }
+    return 0;
+}
 
-    /*** Open input file ***/
+/* Parse a comma separated list of output format and formatting options, as
+ * taken by --tee and --serve requests */
+static int parse_output_options(char *options, int *format, int *flags, const char **bad_option) {
+    char *option, *saveptr;
 
-    /* Support reading from stdin with filename "-" */
-    if (strcmp(argv[optind], "-") == 0) {
-        file_in = stdin;
-    } else {
-    /* Otherwise, open the specified input file */
-        file_in = fopen(argv[optind], "r");
-        if (file_in == NULL) {
-            perror("Error: Cannot open program file for disassembly");
-            goto cleanup_exit_failure;
-        }
-    }
+    /* Start from the default formatting flags */
+    *format = OUTPUT_FORMAT_TEXT;
+    *flags = PRINT_FLAG_ADDRESSES | PRINT_FLAG_DESTINATION_COMMENT | PRINT_FLAG_OPCODES | PRINT_FLAG_DATA_HEX;
 
-    /*** Determine architecture ***/
+    if (options == NULL)
+        return 0;
 
-    if (arch_str[0] != '\0') {
-        if (strcasecmp(arch_str, "avr") == 0)
-            arch = ARCH_AVR8;
-        else if (strcasecmp(arch_str, "pic-baseline") == 0)
-            arch = ARCH_PIC_BASELINE;
-        else if (strcasecmp(arch_str, "pic-midrange") == 0)
-            arch = ARCH_PIC_MIDRANGE;
-        else if (strcasecmp(arch_str, "pic-enhanced") == 0)
-            arch = ARCH_PIC_MIDRANGE_ENHANCED;
-        else if (strcasecmp(arch_str, "pic-18") == 0)
-            arch = ARCH_PIC_PIC18;
-        else if (strcasecmp(arch_str, "8051") == 0)
-            arch = ARCH_8051;
+    for (option = strtok_r(options, ",", &saveptr); option != NULL; option = strtok_r(NULL, ",", &saveptr)) {
+        if (strcasecmp(option, "text") == 0)
+            *format = OUTPUT_FORMAT_TEXT;
+        else if (strcasecmp(option, "json") == 0)
+            *format = OUTPUT_FORMAT_JSON;
+        else if (strcasecmp(option, "csv") == 0)
+            *format = OUTPUT_FORMAT_CSV;
+        else if (strcasecmp(option, "binary") == 0)
+            *format = OUTPUT_FORMAT_BINARY;
+        else if (strcasecmp(option, "compact") == 0)
+            *format = OUTPUT_FORMAT_COMPACT;
+        else if (strcasecmp(option, "stats") == 0)
+            *format = OUTPUT_FORMAT_STATS;
+        else if (strcasecmp(option, "dot") == 0)
+            *format = OUTPUT_FORMAT_CFG_DOT;
+        else if (strcasecmp(option, "cfg") == 0)
+            *format = OUTPUT_FORMAT_CFG_JSON;
+        else if (strcasecmp(option, "stack") == 0)
+            *format = OUTPUT_FORMAT_STACK;
+        else if (strcasecmp(option, "assembly") == 0)
+            *flags |= PRINT_FLAG_ASSEMBLY;
+        else if (strcasecmp(option, "all-labels") == 0)
+            *flags |= PRINT_FLAG_ALL_LABELS;
+        else if (strcasecmp(option, "no-addresses") == 0)
+            *flags &= ~PRINT_FLAG_ADDRESSES;
+        else if (strcasecmp(option, "no-opcodes") == 0)
+            *flags &= ~PRINT_FLAG_OPCODES;
+        else if (strcasecmp(option, "no-destination-comments") == 0)
+            *flags &= ~PRINT_FLAG_DESTINATION_COMMENT;
+        else if (strcasecmp(option, "data-base-hex") == 0)
+            *flags = (*flags & ~(PRINT_FLAG_DATA_BIN | PRINT_FLAG_DATA_DEC)) | PRINT_FLAG_DATA_HEX;
+        else if (strcasecmp(option, "data-base-bin") == 0)
+            *flags = (*flags & ~(PRINT_FLAG_DATA_HEX | PRINT_FLAG_DATA_DEC)) | PRINT_FLAG_DATA_BIN;
+        else if (strcasecmp(option, "data-base-dec") == 0)
+            *flags = (*flags & ~(PRINT_FLAG_DATA_HEX | PRINT_FLAG_DATA_BIN)) | PRINT_FLAG_DATA_DEC;
         else {
-            fprintf(stderr, "Unknown architecture %s.\n", arch_str);
-            fprintf(stderr, "See program help/usage for supported architectures.\n");
-            goto cleanup_exit_failure;
+            *bad_option = option;
+            return -1;
         }
-    } else {
-        fprintf(stderr, "Error: No architecture specified!\n\n");
-        print_usage(argv[0]);
-        goto cleanup_exit_failure;
     }
 
-    /*** Determine input file type ***/
+    return 0;
+}
 
-    /* If a file type was specified */
-    if (file_type_str[0] != '\0') {
-        if (strcasecmp(file_type_str, "generic") == 0)
-            file_type = FILE_TYPE_ATMEL_GENERIC;
-        else if (strcasecmp(file_type_str, "ihex") == 0)
-            file_type = FILE_TYPE_INTEL_HEX;
-        else if (strcasecmp(file_type_str, "srec") == 0)
-            file_type = FILE_TYPE_MOTOROLA_SRECORD;
-        else if (strcasecmp(file_type_str, "ascii") == 0)
-            file_type = FILE_TYPE_ASCII_HEX;
-        else if (strcasecmp(file_type_str, "binary") == 0)
-            file_type = FILE_TYPE_BINARY;
-        else if (strcasecmp(file_type_str, "elf") == 0)
-            file_type = FILE_TYPE_ELF;
-        else {
-            fprintf(stderr, "Unknown file type %s.\n", file_type_str);
-            fprintf(stderr, "See program help/usage for supported file types.\n");
-            goto cleanup_exit_failure;
-        }
-    } else {
-    /* Otherwise, attempt to auto-detect file type by first character */
-        int c;
-        c = fgetc(file_in);
-        /* Intel HEX8 record statements start with : */
-        if ((char)c == ':')
-            file_type = FILE_TYPE_INTEL_HEX;
-        /* Motorola S-Record record statements start with S */
-        else if ((char)c == 'S')
-            file_type = FILE_TYPE_MOTOROLA_SRECORD;
-        /* Atmel Generic record statements start with a ASCII hex digit */
-        else if ( ((char)c >= '0' && (char)c <= '9') || ((char)c >= 'a' && (char)c <= 'f') || ((char)c >= 'A' && (char)c <= 'F') )
-            file_type = FILE_TYPE_ATMEL_GENERIC;
-        else if (c == 0x7f)
-            file_type = FILE_TYPE_ELF;
-        else {
-            fprintf(stderr, "Unable to auto-recognize file type by first character.\n");
-            fprintf(stderr, "Please specify file type with -t / --file-type option.\n");
-            goto cleanup_exit_failure;
-        }
-        ungetc(c, file_in);
-    }
+/* Build the option list for an output format and formatting flags */
+static void build_output_options(char *dest, size_t size, int format, int flags) {
+    static const char *const format_names[] = {
+        [OUTPUT_FORMAT_TEXT] = "text",
+        [OUTPUT_FORMAT_JSON] = "json",
+        [OUTPUT_FORMAT_CSV] = "csv",
+        [OUTPUT_FORMAT_BINARY] = "binary",
+        [OUTPUT_FORMAT_COMPACT] = "compact",
+        [OUTPUT_FORMAT_STATS] = "stats",
+        [OUTPUT_FORMAT_CFG_DOT] = "dot",
+        [OUTPUT_FORMAT_CFG_JSON] = "cfg",
+        [OUTPUT_FORMAT_STACK] = "stack",
+    };
 
-    /* Debug this file type if we're in debug mode */
-    if (flag_debug) {
-        debug_tests(file_in, file_type);
-        goto cleanup_exit_success;
+    snprintf(dest, size, "%s%s%s%s%s%s%s", format_names[format],
+        (flags & PRINT_FLAG_ASSEMBLY) ? ",assembly" : "",
+        (flags & PRINT_FLAG_ALL_LABELS) ? ",all-labels" : "",
+        (flags & PRINT_FLAG_ADDRESSES) ? "" : ",no-addresses",
+        (flags & PRINT_FLAG_OPCODES) ? "" : ",no-opcodes",
+        (flags & PRINT_FLAG_DESTINATION_COMMENT) ? "" : ",no-destination-comments",
+        (flags & PRINT_FLAG_DATA_BIN) ? ",data-base-bin" : (flags & PRINT_FLAG_DATA_DEC) ? ",data-base-dec" : "");
+}
+
+/* Parse a --tee <file>[,<option>...] specification */
+static int parse_tee_spec(struct tee_output *tee) {
+    char *options;
+    const char *bad_option;
+
+    tee->file_str = tee->spec;
+    options = strchr(tee->spec, ',');
+    if (options != NULL)
+        *options++ = '\0';
+    if (tee->file_str[0] == '\0')
+        return -1;
+
+    if (parse_output_options(options, &tee->format, &tee->flags, &bad_option) < 0) {
+        fprintf(stderr, "Unknown --tee option %s.\n", bad_option);
+        return -1;
     }
 
-    /*** Open output file ***/
+    return 0;
+}
 
-    /* If an output file was specified */
-    if (file_out_str[0] != '\0') {
-        file_out = fopen(file_out_str, "w");
-        if (file_out == NULL) {
-            perror("Error opening output file for writing");
-            goto cleanup_exit_failure;
-        }
+/* Returns 1 if an output with flags labels only the instructions that
+ * operands refer to, from an xref index */
+static int needs_xref(int flags) {
+    return (flags & PRINT_FLAG_ASSEMBLY) && !(flags & PRINT_FLAG_ALL_LABELS);
+}
+
+static int setup_printstream(struct PrintStream *ps, int output_format, const char *arch_name, isa_mnemonic_func isa_mnemonic) {
+    if (output_format == OUTPUT_FORMAT_BINARY) {
+        return printstream_binary_setup(ps, arch_name, isa_mnemonic);
+    } else if (output_format == OUTPUT_FORMAT_COMPACT) {
+        return printstream_compact_setup(ps, arch_name, isa_mnemonic);
+    } else if (output_format == OUTPUT_FORMAT_STATS) {
+        return printstream_stats_setup(ps, arch_name, isa_mnemonic);
+    } else if (output_format == OUTPUT_FORMAT_CFG_DOT) {
+        return printstream_cfg_setup(ps, CFG_FORMAT_DOT, arch_name);
+    } else if (output_format == OUTPUT_FORMAT_CFG_JSON) {
+        return printstream_cfg_setup(ps, CFG_FORMAT_JSON, arch_name);
+    } else if (output_format == OUTPUT_FORMAT_STACK) {
+        return printstream_stack_setup(ps, arch_name, isa_mnemonic);
+    } else if (output_format == OUTPUT_FORMAT_JSON) {
+        ps->stream_init = printstream_json_init;
+        ps->stream_close = printstream_json_close;
+        ps->stream_read = printstream_json_read;
+    } else if (output_format == OUTPUT_FORMAT_CSV) {
+        ps->stream_init = printstream_csv_init;
+        ps->stream_close = printstream_csv_close;
+        ps->stream_read = printstream_csv_read;
+    } else if (flag_cycles) {
+        ps->stream_init = printstream_cycles_init;
+        ps->stream_close = printstream_cycles_close;
+        ps->stream_read = printstream_cycles_read;
     } else {
-    /* Otherwise, default the output file to stdout */
-        file_out = stdout;
+        ps->stream_init = printstream_file_init;
+        ps->stream_close = printstream_file_close;
+        ps->stream_read = printstream_file_read;
     }
 
-    /*** Setup Formatting Flags ***/
+    return 0;
+}
+
+static int parse_file_type(const char *file_type_str) {
+    if (strcasecmp(file_type_str, "generic") == 0)
+        return FILE_TYPE_ATMEL_GENERIC;
+    else if (strcasecmp(file_type_str, "ihex") == 0)
+        return FILE_TYPE_INTEL_HEX;
+    else if (strcasecmp(file_type_str, "srec") == 0)
+        return FILE_TYPE_MOTOROLA_SRECORD;
+    else if (strcasecmp(file_type_str, "ascii") == 0)
+        return FILE_TYPE_ASCII_HEX;
+    else if (strcasecmp(file_type_str, "binary") == 0)
+        return FILE_TYPE_BINARY;
+    else if (strcasecmp(file_type_str, "elf") == 0)
+        return FILE_TYPE_ELF;
+    return -1;
+}
+
+/* Auto-detect the file type by the first character */
+static int detect_file_type(FILE *in) {
+    int c, file_type;
+
+    c = fgetc(in);
+    /* Intel HEX8 record statements start with : */
+    if ((char)c == ':')
+        file_type = FILE_TYPE_INTEL_HEX;
+    /* Motorola S-Record record statements start with S */
+    else if ((char)c == 'S')
+        file_type = FILE_TYPE_MOTOROLA_SRECORD;
+    /* Atmel Generic record statements start with a ASCII hex digit */
+    else if ( ((char)c >= '0' && (char)c <= '9') || ((char)c >= 'a' && (char)c <= 'f') || ((char)c >= 'A' && (char)c <= 'F') )
+        file_type = FILE_TYPE_ATMEL_GENERIC;
+    else if (c == 0x7f)
+        file_type = FILE_TYPE_ELF;
+    else
+        file_type = -1;
+    ungetc(c, in);
+
+    return file_type;
+}
+
+/* Read a gzip compressed program file as its decompressed contents. Returns
+ * in, a decompressing stream that closes in, or NULL on failure. */
+static FILE *decompress_input(FILE *in) {
+    if (!gzip_detect(in))
+        return in;
+    return gzip_input_open(in);
+}
+
+static int setup_flags(void) {
+    int flags = 0;
+
     if (!flag_no_addresses)
         flags |= PRINT_FLAG_ADDRESSES;
     if (!flag_no_destination_comments)
@@ -377,104 +695,1647 @@ int main(int argc, const char *argv[]) {
 
     if (flag_assembly)
         flags |= PRINT_FLAG_ASSEMBLY;
+    if (flag_all_labels)
+        flags |= PRINT_FLAG_ALL_LABELS;
 
-    /*** Setup disassembler streams ***/
+    if (flag_cycles)
+        flags |= PRINT_FLAG_CYCLES | PRINT_FLAG_CYCLES_VARIANT(cycles_variant);
+
+    return flags;
+}
 
-    /* Setup the ByteStream */
-    bs.in = file_in;
+static void setup_bytestream(struct ByteStream *bs, int file_type) {
     if (file_type == FILE_TYPE_ATMEL_GENERIC) {
-        bs.stream_init = bytestream_generic_init;
-        bs.stream_close = bytestream_generic_close;
-        bs.stream_read = bytestream_generic_read;
+        bs->stream_init = bytestream_generic_init;
+        bs->stream_close = bytestream_generic_close;
+        bs->stream_read = bytestream_generic_read;
     } else if (file_type == FILE_TYPE_INTEL_HEX) {
-        bs.stream_init = bytestream_ihex_init;
-        bs.stream_close = bytestream_ihex_close;
-        bs.stream_read = bytestream_ihex_read;
+        bs->stream_init = bytestream_ihex_init;
+        bs->stream_close = bytestream_ihex_close;
+        bs->stream_read = bytestream_ihex_read;
     } else if (file_type == FILE_TYPE_MOTOROLA_SRECORD) {
-        bs.stream_init = bytestream_srecord_init;
-        bs.stream_close = bytestream_srecord_close;
-        bs.stream_read = bytestream_srecord_read;
+        bs->stream_init = bytestream_srecord_init;
+        bs->stream_close = bytestream_srecord_close;
+        bs->stream_read = bytestream_srecord_read;
     } else if (file_type == FILE_TYPE_ASCII_HEX) {
-        bs.stream_init = bytestream_asciihex_init;
-        bs.stream_close = bytestream_asciihex_close;
-        bs.stream_read = bytestream_asciihex_read;
+        bs->stream_init = bytestream_asciihex_init;
+        bs->stream_close = bytestream_asciihex_close;
+        bs->stream_read = bytestream_asciihex_read;
     } else if (file_type == FILE_TYPE_ELF) {
-        bs.stream_init = bytestream_elf_init;
-        bs.stream_close = bytestream_elf_close;
-        bs.stream_read = bytestream_elf_read;
+        bs->stream_init = bytestream_elf_init;
+        bs->stream_close = bytestream_elf_close;
+        bs->stream_read = bytestream_elf_read;
     } else {
-        bs.stream_init = bytestream_binary_init;
-        bs.stream_close = bytestream_binary_close;
-        bs.stream_read = bytestream_binary_read;
+        bs->stream_init = bytestream_binary_init;
+        bs->stream_close = bytestream_binary_close;
+        bs->stream_read = bytestream_binary_read;
     }
+}
 
-    /* Setup the DisasmStream */
-    ds.in = &bs;
-    if (arch == ARCH_AVR8) {
-        ds.stream_init = disasmstream_avr_init;
-        ds.stream_close = disasmstream_avr_close;
-        ds.stream_read = disasmstream_avr_read;
-    } else if (arch == ARCH_PIC_BASELINE) {
-        ds.stream_init = disasmstream_pic_baseline_init;
-        ds.stream_close = disasmstream_pic_baseline_close;
-        ds.stream_read = disasmstream_pic_baseline_read;
-    } else if (arch == ARCH_PIC_MIDRANGE) {
-        ds.stream_init = disasmstream_pic_midrange_init;
-        ds.stream_close = disasmstream_pic_midrange_close;
-        ds.stream_read = disasmstream_pic_midrange_read;
-    } else if (arch == ARCH_PIC_MIDRANGE_ENHANCED) {
-        ds.stream_init = disasmstream_pic_midrange_enhanced_init;
-        ds.stream_close = disasmstream_pic_midrange_enhanced_close;
-        ds.stream_read = disasmstream_pic_midrange_enhanced_read;
-    } else if (arch == ARCH_PIC_PIC18) {
-        ds.stream_init = disasmstream_pic_pic18_init;
-        ds.stream_close = disasmstream_pic_pic18_close;
-        ds.stream_read = disasmstream_pic_pic18_read;
-    } else if (arch == ARCH_8051) {
-        ds.stream_init = disasmstream_8051_init;
-        ds.stream_close = disasmstream_8051_close;
-        ds.stream_read = disasmstream_8051_read;
+/* Setup bs to read the program file in, decompressing gzip input, and
+ * detecting its file type if *file_type is -1. Returns NULL, or an error
+ * string on failure, with in closed. */
+static const char *setup_input(struct ByteStream *bs, FILE *in, int *file_type) {
+    FILE *file_gzip;
+
+    if ((file_gzip = decompress_input(in)) == NULL) {
+        fclose(in);
+        return "Error opening gzip file";
+    }
+    if (*file_type < 0 && (*file_type = detect_file_type(file_gzip)) < 0) {
+        fclose(file_gzip);
+        return "Unable to auto-recognize file type by first character";
     }
 
-    /* Setup the File PrintStream */
+    bs->in = file_gzip;
+    bs->error = NULL;
+    setup_bytestream(bs, *file_type);
+
+    return NULL;
+}
+
+/* Setup bs to read the program file at path, as with setup_input() */
+static const char *open_input(struct ByteStream *bs, const char *path, int *file_type) {
+    FILE *in;
+
+    if ((in = fopen(path, "r")) == NULL)
+        return "Cannot open program file";
+    return setup_input(bs, in, file_type);
+}
+
+/******************************************************************************/
+/* Batch and Server Support */
+/******************************************************************************/
+
+/* Options for rendering one program file */
+struct render_options {
+    int arch;
+    const char *arch_name;
+    int output_format;
+    /* Line template, overrides output_format if not NULL */
+    const char *format_template;
+    /* Search patterns, override the output if not NULL */
+    const struct search_automaton *search;
+    unsigned int search_context;
+    int flags;
+    /* Address range, if has_range */
+    int has_range;
+    uint32_t start, end;
+};
+
+/* Deepest stream error, the most specific description of a failure */
+static const char *deepest_stream_error(struct PrintStream *ps, struct DisasmStream *ds, struct ByteStream *bs) {
+    if (bs->error != NULL)
+        return bs->error;
+    if (ds->error != NULL)
+        return ds->error;
+    if (ps->error != NULL)
+        return ps->error;
+    return "Unknown error";
+}
+
+/* Disassemble a whole program file from bs to out, for batch jobs and server
+ * requests. bs is closed. Returns NULL, or an error string on failure. */
+static const char *render_file(struct ByteStream *bs, FILE *out, struct render_options *options) {
+    isa_mnemonic_func isa_mnemonic;
+    struct ByteStream bs_pipeline;
+    struct DisasmStream ds, ds_pipeline, ds_xref, ds_range;
+    struct PrintStream ps;
+    struct xref_index xref;
+    int has_xref = 0;
+    const char *error = NULL;
+    int ret;
+
+    /* Label only the instructions that operands refer to in assembly, from a
+     * first pass over the program file */
+    if (needs_xref(options->flags)) {
+        xref_index_init(&xref);
+        if (xref_index_scan_input(&xref, bs, options->arch, NULL, &error) < 0) {
+            xref_index_free(&xref);
+            fclose(bs->in);
+            return error;
+        }
+        has_xref = 1;
+    }
+
+    ds.in = bs;
+    ds.error = NULL;
+    isa_mnemonic = ucdisasm_disasmstream_setup(&ds, options->arch);
     ps.in = &ds;
-    ps.stream_init = printstream_file_init;
-    ps.stream_close = printstream_file_close;
-    ps.stream_read = printstream_file_read;
+    ps.error = NULL;
+    if (options->search != NULL)
+        ret = printstream_search_setup(&ps, options->search, options->search_context);
+    else if (options->format_template != NULL)
+        ret = printstream_template_setup(&ps, options->format_template);
+    else
+        ret = setup_printstream(&ps, options->output_format, options->arch_name, isa_mnemonic);
+    if (ret < 0) {
+        fclose(bs->in);
+        error = ps.error;
+        goto cleanup;
+    }
 
-    /* Initialize streams */
-    if ((ret = ps.stream_init(&ps, flags)) < 0) {
-        fprintf(stderr, "Error initializing streams! Error code: %d\n", ret);
-        printstream_error_trace(&ps, &ds, &bs);
-        goto cleanup_exit_failure;
+    if (flag_pipeline) {
+        if (pipeline_bytestream_setup(&bs_pipeline, bs) < 0 || pipeline_disasmstream_setup(&ds_pipeline, &ds) < 0) {
+            fclose(bs->in);
+            error = "Error allocating pipelined streams!";
+            goto cleanup;
+        }
+        ds.in = &bs_pipeline;
+        ps.in = &ds_pipeline;
     }
 
-    /* Read from Print Stream until EOF */
-    while ( (ret = ps.stream_read(&ps, file_out)) != STREAM_EOF ) {
-        if (ret < 0) {
-            fprintf(stderr, "Error occured during disassembly! Error code: %d\n", ret);
-            printstream_error_trace(&ps, &ds, &bs);
-            goto cleanup_exit_failure;
+    if (has_xref) {
+        if (xref_disasmstream_setup(&ds_xref, ps.in, &xref) < 0) {
+            fclose(bs->in);
+            error = ds_xref.error;
+            goto cleanup;
         }
+        ps.in = &ds_xref;
     }
 
-    /* Close streams */
-    if ((ret = ps.stream_close(&ps)) < 0) {
-        fprintf(stderr, "Error closing streams! Error code: %d\n", ret);
-        printstream_error_trace(&ps, &ds, &bs);
-        goto cleanup_exit_failure;
+    if (options->has_range) {
+        if (range_disasmstream_setup(&ds_range, ps.in, options->start, options->end) < 0) {
+            fclose(bs->in);
+            error = ds_range.error;
+            goto cleanup;
+        }
+        ps.in = &ds_range;
     }
 
-    cleanup_exit_success:
-    if (file_out != stdout && file_out != NULL)
-        fclose(file_out);
-    exit(EXIT_SUCCESS);
+    if (ps.stream_init(&ps, options->flags) < 0) {
+        fclose(bs->in);
+        error = deepest_stream_error(&ps, &ds, bs);
+        goto cleanup;
+    }
 
-    cleanup_exit_failure:
-    if (file_in != stdin && file_in != NULL)
-        fclose(file_in);
-    if (file_out != stdout && file_out != NULL)
-        fclose(file_out);
-    exit(EXIT_FAILURE);
+    while ((ret = ps.stream_read(&ps, out)) == 0)
+        ;
+    if (ret != STREAM_EOF)
+        error = deepest_stream_error(&ps, &ds, bs);
+
+    if (ps.stream_close(&ps) < 0 && error == NULL)
+        error = deepest_stream_error(&ps, &ds, bs);
+
+    cleanup:
+    if (has_xref)
+        xref_index_free(&xref);
+
+    return error;
+}
+
+/******************************************************************************/
+/* Batch Mode */
+/******************************************************************************/
+
+/* Options shared by all batch jobs */
+struct batch_options {
+    const char *output_template;
+    /* File type, or -1 to auto-detect each file */
+    int file_type;
+    struct render_options render;
+    /* Reader of the program files ahead of the jobs, or NULL */
+    struct prefetch *prefetch;
+};
+
+/* Disassemble one file of the batch, runs on a worker thread */
+static void batch_process(struct batch_job *job, void *arg) {
+    struct batch_options *options = (struct batch_options *)arg;
+    struct ByteStream bs;
+    FILE *file_in, *file_out;
+    int file_type;
+
+    job->status = -1;
+    job->error = NULL;
+
+    if (options->prefetch != NULL)
+        file_in = prefetch_open(options->prefetch, job->index);
+    else
+        file_in = fopen(job->path, "r");
+    if (file_in == NULL) {
+        job->error = "Cannot open program file";
+        return;
+    }
+    file_type = options->file_type;
+    if ((job->error = setup_input(&bs, file_in, &file_type)) != NULL)
+        return;
+
+    if (batch_format_path(job->out_path, sizeof(job->out_path), options->output_template, job->path, job->index) < 0) {
+        job->error = "Invalid output path template";
+        fclose(bs.in);
+        return;
+    }
+
+    if ((file_out = fopen(job->out_path, "w")) == NULL) {
+        job->error = "Cannot open output file";
+        fclose(bs.in);
+        return;
+    }
+
+    job->error = render_file(&bs, file_out, &options->render);
+    if (fclose(file_out) != 0 && job->error == NULL)
+        job->error = "Error writing to output file";
+
+    if (job->error == NULL)
+        job->status = 0;
+}
+
+/* Read a newline separated list of program files */
+static char **batch_read_manifest(FILE *in, unsigned int *num_paths) {
+    char **paths = NULL, **p;
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t len;
+    unsigned int capacity = 0;
+
+    *num_paths = 0;
+    while ((len = getline(&line, &size, in)) >= 0) {
+        while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r'))
+            line[--len] = '\0';
+        if (len == 0)
+            continue;
+
+        if (*num_paths == capacity) {
+            capacity = (capacity == 0) ? 64 : capacity*2;
+            if ((p = realloc(paths, capacity * sizeof(char *))) == NULL)
+                break;
+            paths = p;
+        }
+        if ((paths[*num_paths] = strdup(line)) == NULL)
+            break;
+        (*num_paths)++;
+    }
+    free(line);
+
+    return paths;
+}
+
+static int batch_main(char **paths, unsigned int num_paths, unsigned int num_workers, unsigned int num_prefetch, struct batch_options *options) {
+    struct batch_job *jobs;
+    unsigned int i, failed = 0;
+    int ret;
+
+    if ((jobs = calloc(num_paths, sizeof(struct batch_job))) == NULL) {
+        fprintf(stderr, "Error allocating batch jobs!\n");
+        return -1;
+    }
+    for (i = 0; i < num_paths; i++) {
+        jobs[i].path = paths[i];
+        jobs[i].index = i;
+    }
+
+    /* Read files ahead of the workers, or open them directly if the read
+     * ahead buffers do not fit in the memory limit */
+    options->prefetch = NULL;
+    if (num_prefetch > num_paths)
+        num_prefetch = num_paths;
+    if (num_prefetch > 0)
+        options->prefetch = prefetch_start((const char *const *)paths, num_paths, num_prefetch, PREFETCH_BUFFER_LEN, PREFETCH_BACKEND_AUTO);
+
+    ret = batch_run(jobs, num_paths, num_workers, batch_process, options);
+    if (options->prefetch != NULL)
+        prefetch_stop(options->prefetch);
+    if (ret < 0) {
+        fprintf(stderr, "Error starting batch workers!\n");
+        free(jobs);
+        return -1;
+    }
+
+    /* Per-file status summary, in input order */
+    for (i = 0; i < num_paths; i++) {
+        if (jobs[i].status == 0) {
+            printf("ok      %s -> %s\n", jobs[i].path, jobs[i].out_path);
+        } else {
+            printf("failed  %s: %s\n", jobs[i].path, jobs[i].error);
+            failed++;
+        }
+    }
+    printf("%u files, %u ok, %u failed\n", num_paths, num_paths - failed, failed);
+
+    free(jobs);
+
+    return (failed > 0) ? -1 : 0;
+}
+
+/******************************************************************************/
+/* Server Mode */
+/******************************************************************************/
+
+/* Serve one request, runs on a server worker thread */
+static void serve_process(struct serve_request *req, FILE *out, void *arg) {
+    struct render_options options;
+    char option_list[sizeof(req->options)];
+    const char *bad_option;
+    struct ByteStream bs;
+    int file_type = -1;
+    FILE *in;
+
+    (void)arg;
+
+    memset(&options, 0, sizeof(options));
+    if ((options.arch = ucdisasm_arch_lookup(req->arch)) < 0) {
+        req->error = "Unknown architecture";
+        return;
+    }
+    options.arch_name = req->arch;
+    strcpy(option_list, req->options);
+    if (parse_output_options(option_list, &options.output_format, &options.flags, &bad_option) < 0) {
+        req->error = "Unknown output option";
+        return;
+    }
+    options.has_range = req->has_range;
+    options.start = req->start;
+    options.end = req->end;
+
+    if (req->file_type[0] != '\0' && (file_type = parse_file_type(req->file_type)) < 0) {
+        req->error = "Unknown file type";
+        return;
+    }
+
+    if (req->len == 0 || (in = fmemopen((void *)req->data, req->len, "r")) == NULL) {
+        req->error = "Empty program file";
+        return;
+    }
+    if ((req->error = setup_input(&bs, in, &file_type)) != NULL)
+        return;
+
+    req->error = render_file(&bs, out, &options);
+}
+
+/* Send the program file to a --serve server and print its reply */
+static int client_main(const char *socket_path, const char *path, const char *arch_name, const char *file_type_str, int output_format, int flags, int has_range, uint32_t start, uint32_t end, FILE *out) {
+    char header[8192], options[256], resolved[4096];
+    uint8_t *data = NULL;
+    size_t len = 0, n;
+    const char *error;
+    int ret;
+
+    build_output_options(options, sizeof(options), output_format, flags);
+    n = snprintf(header, sizeof(header), "arch=%s options=%s", arch_name, options);
+    if (file_type_str[0] != '\0')
+        n += snprintf(header + n, sizeof(header) - n, " type=%s", file_type_str);
+    if (has_range)
+        n += snprintf(header + n, sizeof(header) - n, " start=0x%x end=0x%x", start, end);
+
+    if (strcmp(path, "-") == 0) {
+        /* Upload standard input */
+        FILE *buf = open_memstream((char **)&data, &len);
+        char chunk[4096];
+        size_t count, charged = 0;
+
+        if (buf == NULL)
+            return -1;
+        while ((count = fread(chunk, 1, sizeof(chunk), stdin)) > 0) {
+            /* The upload is held in memory, so it counts against the budget */
+            if (budget_charge(count) < 0) {
+                fprintf(stderr, "Error: Standard input exceeds --max-memory, upload a program file instead.\n");
+                fclose(buf);
+                free(data);
+                budget_release(charged);
+                return -1;
+            }
+            charged += count;
+            fwrite(chunk, 1, count, buf);
+        }
+        fclose(buf);
+        snprintf(header + n, sizeof(header) - n, " size=%lu", (unsigned long)len);
+    } else {
+        /* The server resolves paths itself, so send an absolute one */
+        if (realpath(path, resolved) == NULL) {
+            perror("Error: Cannot open program file for disassembly");
+            return -1;
+        }
+        snprintf(header + n, sizeof(header) - n, " file=%s", resolved);
+    }
+
+    ret = serve_request(socket_path, header, data, len, out, &error);
+    if (ret < 0)
+        fprintf(stderr, "Error: %s\n", error);
+    free(data);
+    if (data != NULL)
+        budget_release(len);
+
+    return ret;
+}
+
+/* Parse a --range <start>:<end> address range */
+static int parse_range(const char *str, uint32_t *start, uint32_t *end) {
+    char *sep;
+
+    *start = strtoul(str, &sep, 0);
+    if (*sep != ':')
+        return -1;
+    *end = strtoul(sep + 1, &sep, 0);
+    if (*sep != '\0' || *end <= *start)
+        return -1;
+
+    return 0;
+}
+
+/* Parse a --max-memory <size> size, with an optional K, M, or G suffix */
+static int parse_size(const char *str, size_t *size) {
+    unsigned long long value;
+    char *suffix;
+
+    value = strtoull(str, &suffix, 0);
+    if (suffix == str)
+        return -1;
+    if (strcasecmp(suffix, "k") == 0)
+        value <<= 10;
+    else if (strcasecmp(suffix, "m") == 0)
+        value <<= 20;
+    else if (strcasecmp(suffix, "g") == 0)
+        value <<= 30;
+    else if (*suffix != '\0')
+        return -1;
+    *size = value;
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Shard Mode */
+/******************************************************************************/
+
+/* Parse a --shard <i>/<n> shard */
+static int parse_shard(const char *str, unsigned int *index, unsigned int *total) {
+    char *sep;
+
+    *index = strtoul(str, &sep, 10);
+    if (sep == str || *sep != '/')
+        return -1;
+    *total = strtoul(sep + 1, &sep, 10);
+    if (*sep != '\0' || *total == 0 || *index >= *total)
+        return -1;
+
+    return 0;
+}
+
+/* Summarize the program image for --shard with a pass of its own */
+static int shard_scan_file(const char *path, int file_type, struct shard_image *image) {
+    struct ByteStream bs;
+    const char *error;
+
+    if ((error = open_input(&bs, path, &file_type)) != NULL) {
+        fprintf(stderr, "Error: %s!\n", error);
+        return -1;
+    }
+
+    if (shard_scan_image(&bs, image) < 0) {
+        fprintf(stderr, "Error reading program file: %s\n", (bs.error != NULL) ? bs.error : "Unknown error");
+        return -1;
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Incremental Mode */
+/******************************************************************************/
+
+/* Disassemble in with --previous from the previous build's program file and
+ * listing. previous_file_type is -1 to auto-detect it. in is closed. */
+static int incremental_main(const char *previous_path, const char *listing_path, int previous_file_type, FILE *in, int file_type, int arch, int flags, FILE *out) {
+    struct ByteStream bs_old, bs_new;
+    struct incremental_stats stats;
+    FILE *file_listing;
+    const char *error;
+    int ret;
+
+    bs_new.in = in;
+    bs_new.error = NULL;
+    setup_bytestream(&bs_new, file_type);
+
+    if ((error = open_input(&bs_old, previous_path, &previous_file_type)) != NULL) {
+        fprintf(stderr, "Error: %s: %s!\n", previous_path, error);
+        fclose(in);
+        return -1;
+    }
+
+    if ((file_listing = fopen(listing_path, "r")) == NULL) {
+        perror("Error: Cannot open previous listing");
+        fclose(bs_old.in);
+        fclose(in);
+        return -1;
+    }
+
+    ret = incremental_render(&bs_old, file_listing, &bs_new, arch, flags, out, &stats, &error);
+    fclose(file_listing);
+
+    if (ret < 0) {
+        fprintf(stderr, "Error: %s\n", error);
+        return -1;
+    }
+    fprintf(stderr, "Disassembled %llu of %llu bytes again, in %u regions.\n", (unsigned long long)stats.decoded, (unsigned long long)stats.bytes, stats.regions);
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Diff Mode */
+/******************************************************************************/
+
+/* List the instruction changes from old_path to in with --diff.
+ * old_file_type is -1 to auto-detect it. in is closed. Returns 0 if the
+ * programs decode to the same instructions, 1 if they differ, or -1 on
+ * error. */
+static int diff_main(const char *old_path, int old_file_type, FILE *in, int file_type, int arch, int flags, FILE *out) {
+    struct ByteStream bs_old, bs_new;
+    struct diff_stats stats;
+    const char *error;
+    int ret;
+
+    bs_new.in = in;
+    bs_new.error = NULL;
+    setup_bytestream(&bs_new, file_type);
+
+    if ((error = open_input(&bs_old, old_path, &old_file_type)) != NULL) {
+        fprintf(stderr, "Error: %s: %s!\n", old_path, error);
+        fclose(in);
+        return -1;
+    }
+
+    ret = diff_render(&bs_old, &bs_new, arch, flags, out, &stats, &error);
+    if (ret < 0) {
+        fprintf(stderr, "Error: %s\n", error);
+        return -1;
+    }
+    fprintf(stderr, "%llu instructions modified, %llu deleted, %llu inserted, in %u hunks.\n", (unsigned long long)stats.modified, (unsigned long long)stats.deleted, (unsigned long long)stats.inserted, stats.hunks);
+
+    return (stats.hunks > 0) ? 1 : 0;
+}
+
+/* ucdisasm merge [-o <file>] <shard output(s)> */
+static int merge_main(int argc, const char *argv[]) {
+    const char *out_str = NULL;
+    const char *error;
+    FILE *out = stdout;
+    int optc, ret;
+
+    while ((optc = getopt(argc, (char * const *)argv, "o:")) != -1) {
+        if (optc != 'o') {
+            fprintf(stderr, "Usage: ucdisasm merge [-o <file>] <shard output(s)>\n");
+            return EXIT_FAILURE;
+        }
+        out_str = optarg;
+    }
+
+    if (optind == argc) {
+        fprintf(stderr, "Error: No shard outputs specified!\n");
+        return EXIT_FAILURE;
+    }
+
+    if (out_str != NULL && strcmp(out_str, "-") != 0 && (out = fopen(out_str, "w")) == NULL) {
+        perror("Error opening output file for writing");
+        return EXIT_FAILURE;
+    }
+
+    ret = shard_merge(&argv[optind], argc - optind, out, &error);
+    if (ret < 0)
+        fprintf(stderr, "Error: %s\n", error);
+    if (fclose(out) != 0 && ret == 0) {
+        fprintf(stderr, "Error writing to output file!\n");
+        ret = -1;
+    }
+
+    return (ret < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/******************************************************************************/
+/* Similarity Index */
+/******************************************************************************/
+
+/* Options shared by all signature jobs */
+struct similarity_options {
+    int arch;
+    /* File type, or -1 to auto-detect each file */
+    int file_type;
+    /* Signatures, indexed by job */
+    struct similarity_signature *signatures;
+    /* Reader of the program files ahead of the jobs, or NULL */
+    struct prefetch *prefetch;
+};
+
+/* Compute the signature of the program file in. in is closed. Returns NULL,
+ * or an error string on failure. */
+static const char *similarity_signature_file(FILE *in, int file_type, int arch, struct similarity_signature *signature) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    const char *error;
+
+    if ((error = setup_input(&bs, in, &file_type)) != NULL)
+        return error;
+    ds.in = &bs;
+    ds.error = NULL;
+    ucdisasm_disasmstream_setup(&ds, arch);
+
+    if (similarity_signature_compute(&ds, signature) < 0)
+        return (bs.error != NULL) ? bs.error : (ds.error != NULL) ? ds.error : "Unknown error";
+
+    return NULL;
+}
+
+/* Compute the signature of one file of the index, runs on a worker thread */
+static void similarity_process(struct batch_job *job, void *arg) {
+    struct similarity_options *options = (struct similarity_options *)arg;
+    FILE *file_in;
+
+    if (options->prefetch != NULL)
+        file_in = prefetch_open(options->prefetch, job->index);
+    else
+        file_in = fopen(job->path, "r");
+    if (file_in == NULL) {
+        job->status = -1;
+        job->error = "Cannot open program file";
+        return;
+    }
+
+    job->error = similarity_signature_file(file_in, options->file_type, options->arch, &options->signatures[job->index]);
+    job->status = (job->error == NULL) ? 0 : -1;
+}
+
+/* ucdisasm similarity index -a <arch> [-t <type>] [-j <n>] -o <index> <file(s)> */
+static int similarity_index_main(int argc, const char *argv[]) {
+    struct similarity_options options;
+    struct batch_job *jobs;
+    const char *arch_name = NULL, *out_str = NULL, *error;
+    const char **paths;
+    unsigned int num_paths, num_indexed, i;
+    long num_jobs = 0;
+    FILE *out;
+    int optc, ret;
+
+    options.file_type = -1;
+    while ((optc = getopt(argc, (char * const *)argv, "a:t:j:o:")) != -1) {
+        switch (optc) {
+            case 'a':
+                arch_name = optarg;
+                break;
+            case 't':
+                if ((options.file_type = parse_file_type(optarg)) < 0) {
+                    fprintf(stderr, "Unknown file type %s.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'j':
+                if ((num_jobs = strtol(optarg, NULL, 10)) <= 0) {
+                    fprintf(stderr, "Error: Invalid number of jobs %s.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'o':
+                out_str = optarg;
+                break;
+            default:
+                fprintf(stderr, "Usage: ucdisasm similarity index -a <architecture> [-t <type>] [-j <n>] -o <index> <file(s)>\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (arch_name == NULL || out_str == NULL) {
+        fprintf(stderr, "Error: An architecture and an index file are required!\n");
+        return EXIT_FAILURE;
+    }
+    if ((options.arch = ucdisasm_arch_lookup(arch_name)) < 0) {
+        fprintf(stderr, "Unknown architecture %s.\n", arch_name);
+        return EXIT_FAILURE;
+    }
+
+    /* Read the list of program files from stdin with a lone "-" */
+    paths = &argv[optind];
+    num_paths = argc - optind;
+    if (num_paths == 1 && strcmp(paths[0], "-") == 0)
+        paths = (const char **)batch_read_manifest(stdin, &num_paths);
+    if (num_paths == 0) {
+        fprintf(stderr, "Error: No program files specified!\n");
+        return EXIT_FAILURE;
+    }
+
+    if (num_jobs == 0)
+        num_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_jobs <= 0)
+        num_jobs = 1;
+
+    jobs = calloc(num_paths, sizeof(struct batch_job));
+    options.signatures = calloc(num_paths, sizeof(struct similarity_signature));
+    if (jobs == NULL || options.signatures == NULL) {
+        fprintf(stderr, "Error allocating signatures!\n");
+        free(jobs);
+        free(options.signatures);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < num_paths; i++) {
+        jobs[i].path = paths[i];
+        jobs[i].index = i;
+    }
+
+    options.prefetch = prefetch_start(paths, num_paths, (num_paths < 2*num_jobs) ? num_paths : 2*num_jobs, PREFETCH_BUFFER_LEN, PREFETCH_BACKEND_AUTO);
+    ret = batch_run(jobs, num_paths, num_jobs, similarity_process, &options);
+    if (options.prefetch != NULL)
+        prefetch_stop(options.prefetch);
+
+    if (ret < 0) {
+        fprintf(stderr, "Error starting batch workers!\n");
+    } else {
+        /* Index the files that were read, in input order */
+        for (i = 0, num_indexed = 0; i < num_paths; i++) {
+            if (jobs[i].status == 0) {
+                paths[num_indexed] = paths[i];
+                options.signatures[num_indexed++] = options.signatures[i];
+            } else {
+                fprintf(stderr, "failed  %s: %s\n", jobs[i].path, jobs[i].error);
+            }
+        }
+        fprintf(stderr, "%u files, %u indexed, %u failed\n", num_paths, num_indexed, num_paths - num_indexed);
+
+        if ((out = fopen(out_str, "w")) == NULL) {
+            perror("Error opening index file for writing");
+            ret = -1;
+        } else {
+            ret = similarity_index_write(out, arch_name, paths, options.signatures, num_indexed, &error);
+            if (fclose(out) != 0 && ret == 0) {
+                error = "Error writing to index file!";
+                ret = -1;
+            }
+            if (ret < 0)
+                fprintf(stderr, "Error: %s\n", error);
+        }
+        if (num_indexed < num_paths)
+            ret = -1;
+    }
+
+    free(jobs);
+    free(options.signatures);
+
+    return (ret < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* ucdisasm similarity query [-t <type>] [-n <count>] <index> <file> */
+static int similarity_query_main(int argc, const char *argv[]) {
+    struct similarity_index index;
+    struct similarity_signature signature;
+    struct similarity_match *matches;
+    const char *error;
+    long max_matches = 10;
+    int optc, file_type = -1, arch, i, ret;
+    FILE *in;
+
+    while ((optc = getopt(argc, (char * const *)argv, "t:n:")) != -1) {
+        switch (optc) {
+            case 't':
+                if ((file_type = parse_file_type(optarg)) < 0) {
+                    fprintf(stderr, "Unknown file type %s.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'n':
+                if ((max_matches = strtol(optarg, NULL, 10)) <= 0) {
+                    fprintf(stderr, "Error: Invalid number of matches %s.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            default:
+                fprintf(stderr, "Usage: ucdisasm similarity query [-t <type>] [-n <count>] <index> <file>\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 2) {
+        fprintf(stderr, "Usage: ucdisasm similarity query [-t <type>] [-n <count>] <index> <file>\n");
+        return EXIT_FAILURE;
+    }
+
+    if ((in = fopen(argv[optind], "r")) == NULL) {
+        perror("Error: Cannot open index file");
+        return EXIT_FAILURE;
+    }
+    ret = similarity_index_read(&index, in, &error);
+    fclose(in);
+    if (ret < 0) {
+        fprintf(stderr, "Error: %s\n", error);
+        return EXIT_FAILURE;
+    }
+    if ((arch = ucdisasm_arch_lookup(index.arch_name)) < 0) {
+        fprintf(stderr, "Error: Unknown index architecture %s.\n", index.arch_name);
+        similarity_index_free(&index);
+        return EXIT_FAILURE;
+    }
+
+    /* Signature of the program file, with the architecture of the index */
+    if (strcmp(argv[optind+1], "-") == 0)
+        in = stdin;
+    else if ((in = fopen(argv[optind+1], "r")) == NULL) {
+        perror("Error: Cannot open program file");
+        similarity_index_free(&index);
+        return EXIT_FAILURE;
+    }
+    if ((error = similarity_signature_file(in, file_type, arch, &signature)) != NULL) {
+        fprintf(stderr, "Error reading program file: %s\n", error);
+        similarity_index_free(&index);
+        return EXIT_FAILURE;
+    }
+    if (signature.shingles == 0) {
+        fprintf(stderr, "Error: Program file has too few instructions to compare!\n");
+        similarity_index_free(&index);
+        return EXIT_FAILURE;
+    }
+
+    if ((matches = calloc(max_matches, sizeof(struct similarity_match))) == NULL) {
+        fprintf(stderr, "Error allocating matches!\n");
+        similarity_index_free(&index);
+        return EXIT_FAILURE;
+    }
+    if ((ret = similarity_index_query(&index, &signature, matches, max_matches, &error)) < 0)
+        fprintf(stderr, "Error: %s\n", error);
+    for (i = 0; i < ret; i++)
+        printf("%.4f  %s\n", matches[i].similarity, matches[i].path);
+
+    free(matches);
+    similarity_index_free(&index);
+
+    return (ret < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* ucdisasm similarity index|query ... */
+static int similarity_main(int argc, const char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "index") == 0)
+        return similarity_index_main(argc - 1, argv + 1);
+    if (argc > 1 && strcmp(argv[1], "query") == 0)
+        return similarity_query_main(argc - 1, argv + 1);
+
+    fprintf(stderr, "Usage: ucdisasm similarity index -a <architecture> [-t <type>] [-j <n>] -o <index> <file(s)>\n");
+    fprintf(stderr, "       ucdisasm similarity query [-t <type>] [-n <count>] <index> <file>\n");
+
+    return EXIT_FAILURE;
+}
+
+int main(int argc, const char *argv[]) {
+    /* User Options */
+    int optc;
+    char arch_str[16] = {0};
+    char file_type_str[8] = {0};
+    char output_format_str[8] = {0};
+    const char *format_template = NULL;
+    const char *batch_output = "{path}.lst";
+    long num_jobs = 0;
+    long num_prefetch = -1;
+    const char *serve_socket = NULL, *connect_socket = NULL;
+    int has_range = 0;
+    uint32_t range_start = 0, range_end = 0;
+    int has_shard = 0;
+    size_t max_memory = 0;
+    int live = 0;
+    unsigned int live_interval = 0;
+    struct live_stats live_stats;
+    struct shard_spec shard;
+    struct discover_spec discover;
+    struct xref_index xref;
+    int has_xref = 0;
+    const char *previous_path = NULL, *previous_listing_path = NULL;
+    const char *diff_path = NULL;
+    /* Exit statuses, those of diff(1) with --diff */
+    int exit_success = EXIT_SUCCESS, exit_failure = gives_diff(argc, argv) ? DIFF_EXIT_TROUBLE : EXIT_FAILURE;
+    const char *cycles_str = NULL;
+    const char *search_patterns[SEARCH_MAX_PATTERNS];
+    unsigned int num_search_patterns = 0, search_context = 0;
+    struct search_automaton search;
+    char file_out_str[4096] = {0};
+
+    /* Input / Output files */
+    FILE *file_in = NULL, *file_out = NULL;
+    /* Shard output, written through to file_out */
+    FILE *file_shard = NULL;
+    struct tee_output tees[MAX_TEE_OUTPUTS];
+    int num_tees = 0;
+
+    /* Disassembler Streams */
+    int file_type = 0;
+    int arch = 0;
+    isa_mnemonic_func isa_mnemonic = NULL;
+    int output_format = OUTPUT_FORMAT_TEXT;
+    int flags = 0;
+    const char *error;
+    struct ByteStream bs, bs_pipeline, bs_shard;
+    struct DisasmStream ds, ds_pipeline, ds_range, ds_shard, ds_discover, ds_live;
+    struct PrintStream ps;
+    /* Additional outputs, fanned out from the DisasmStream */
+    struct DisasmStream ds_branches[MAX_TEE_OUTPUTS+1];
+    struct PrintStream ps_tees[MAX_TEE_OUTPUTS];
+    /* Label filters of the assembly outputs, the main one first */
+    struct DisasmStream ds_xrefs[MAX_TEE_OUTPUTS+1];
+    int i, done, ret;
+
+    discover.num_entries = 0;
+
+    /* Merge shard outputs */
+    if (argc > 1 && strcmp(argv[1], "merge") == 0)
+        return merge_main(argc - 1, argv + 1);
+    /* Build or query a similarity index */
+    if (argc > 1 && strcmp(argv[1], "similarity") == 0)
+        return similarity_main(argc - 1, argv + 1);
+
+    /* Parse command line options */
+    while (1) {
+        optc = getopt_long(argc, (char * const *)argv, "a:o:O:f:t:l:j:hv", long_options, NULL);
+        if (optc == -1)
+            break;
+        switch (optc) {
+            /* Long option */
+            case 0:
+                break;
+            case 'a':
+                strncpy(arch_str, optarg, sizeof(arch_str));
+                break;
+            case 't':
+                strncpy(file_type_str, optarg, sizeof(file_type_str));
+                break;
+            case 'O':
+                strncpy(output_format_str, optarg, sizeof(output_format_str));
+                break;
+            case 'f':
+                format_template = optarg;
+                break;
+            case 'T':
+                if (num_tees == MAX_TEE_OUTPUTS) {
+                    fprintf(stderr, "Error: Too many --tee outputs, at most %d supported.\n", MAX_TEE_OUTPUTS);
+                    exit(exit_failure);
+                }
+                strncpy(tees[num_tees].spec, optarg, sizeof(tees[num_tees].spec) - 1);
+                tees[num_tees].spec[sizeof(tees[num_tees].spec) - 1] = '\0';
+                tees[num_tees].file = NULL;
+                if (parse_tee_spec(&tees[num_tees]) < 0) {
+                    fprintf(stderr, "Error: Invalid --tee output %s.\n", optarg);
+                    exit(exit_failure);
+                }
+                num_tees++;
+                break;
+            case 'B':
+                batch_output = optarg;
+                break;
+            case 'j':
+                num_jobs = strtol(optarg, NULL, 10);
+                if (num_jobs <= 0) {
+                    fprintf(stderr, "Error: Invalid number of jobs %s.\n", optarg);
+                    exit(exit_failure);
+                }
+                break;
+            case 'P':
+                {
+                    char *end;
+                    num_prefetch = strtol(optarg, &end, 10);
+                    if (*end != '\0' || end == optarg || num_prefetch < 0 || num_prefetch > 4096) {
+                        fprintf(stderr, "Error: Invalid number of files to prefetch %s.\n", optarg);
+                        exit(exit_failure);
+                    }
+                }
+                break;
+            case 'R':
+                if (parse_range(optarg, &range_start, &range_end) < 0) {
+                    fprintf(stderr, "Error: Invalid address range %s, expected <start>:<end>.\n", optarg);
+                    exit(exit_failure);
+                }
+                has_range = 1;
+                break;
+            case 'N':
+                if (parse_shard(optarg, &shard.index, &shard.total) < 0) {
+                    fprintf(stderr, "Error: Invalid shard %s, expected <i>/<n> with <i> < <n>.\n", optarg);
+                    exit(exit_failure);
+                }
+                has_shard = 1;
+                break;
+            case 'G':
+                if (num_search_patterns == SEARCH_MAX_PATTERNS) {
+                    fprintf(stderr, "Error: Too many --search patterns, at most %d supported.\n", SEARCH_MAX_PATTERNS);
+                    exit(exit_failure);
+                }
+                search_patterns[num_search_patterns++] = optarg;
+                break;
+            case 'A':
+                {
+                    char *end;
+                    long context = strtol(optarg, &end, 10);
+                    if (*end != '\0' || end == optarg || context < 0 || context > SEARCH_MAX_CONTEXT) {
+                        fprintf(stderr, "Error: Invalid number of context instructions %s, at most %d supported.\n", optarg, SEARCH_MAX_CONTEXT);
+                        exit(exit_failure);
+                    }
+                    search_context = context;
+                }
+                break;
+            case 'E':
+                {
+                    char *end;
+                    if (discover.num_entries == DISCOVER_MAX_ENTRIES) {
+                        fprintf(stderr, "Error: Too many --entry addresses, at most %d supported.\n", DISCOVER_MAX_ENTRIES);
+                        exit(exit_failure);
+                    }
+                    discover.entries[discover.num_entries] = strtoul(optarg, &end, 0);
+                    if (*end != '\0' || end == optarg) {
+                        fprintf(stderr, "Error: Invalid entry address %s.\n", optarg);
+                        exit(exit_failure);
+                    }
+                    discover.num_entries++;
+                }
+                break;
+            case 'M':
+                if (parse_size(optarg, &max_memory) < 0 || max_memory < BUDGET_BASELINE) {
+                    fprintf(stderr, "Error: Invalid memory limit %s, expected at least %dM.\n", optarg, BUDGET_BASELINE >> 20);
+                    exit(exit_failure);
+                }
+                /* The baseline is set aside from the limit for the program
+                 * and the fixed size stream state */
+                budget_set_limit(max_memory - BUDGET_BASELINE);
+                break;
+            case 'L':
+                if (optarg != NULL) {
+                    char *end;
+                    live_interval = strtoul(optarg, &end, 10);
+                    if (*end != '\0' || end == optarg) {
+                        fprintf(stderr, "Error: Invalid flush interval %s, expected milliseconds.\n", optarg);
+                        exit(exit_failure);
+                    }
+                }
+                live = 1;
+                break;
+            case 'S':
+                serve_socket = optarg;
+                break;
+            case 'I':
+                previous_path = optarg;
+                break;
+            case 'J':
+                previous_listing_path = optarg;
+                break;
+            case 'Y':
+                flag_cycles = 1;
+                cycles_str = optarg;
+                break;
+            case 'D':
+                diff_path = optarg;
+                break;
+            case 'C':
+                connect_socket = optarg;
+                break;
+            case 'o':
+                if (strcmp(optarg, "-") != 0)
+                    strncpy(file_out_str, optarg, sizeof(file_out_str));
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                exit(EXIT_SUCCESS);
+            case 'v':
+                print_version();
+                exit(EXIT_SUCCESS);
+            default:
+                print_usage(argv[0]);
+                exit(exit_failure);
+        }
+    }
+
+    /* If there are no more arguments left but we're in debugging test mode */
+    if (optind == argc && flag_debug) {
+        debug_tests(file_in, 0);
+        goto cleanup_exit_success;
+    }
+
+    /* Serve requests until interrupted */
+    if (serve_socket != NULL) {
+        if (flag_cycles) {
+            fprintf(stderr, "Error: --cycles is not supported with --serve.\n");
+            goto cleanup_exit_failure;
+        }
+        if (num_jobs == 0)
+            num_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+        if (serve_run(serve_socket, (num_jobs > 0) ? num_jobs : 1, serve_process, NULL) < 0)
+            goto cleanup_exit_failure;
+        goto cleanup_exit_success;
+    }
+
+    /* If there are no more arguments left */
+    if (optind == argc) {
+        fprintf(stderr, "Error: No program file specified! Use - for standard input.\n\n");
+        print_usage(argv[0]);
+        goto cleanup_exit_failure;
+    }
+
+    /*** Determine architecture ***/
+
+    if (arch_str[0] != '\0') {
+        if ((arch = ucdisasm_arch_lookup(arch_str)) < 0) {
+            fprintf(stderr, "Unknown architecture %s.\n", arch_str);
+            fprintf(stderr, "See program help/usage for supported architectures.\n");
+            goto cleanup_exit_failure;
+        }
+    } else {
+        fprintf(stderr, "Error: No architecture specified!\n\n");
+        print_usage(argv[0]);
+        goto cleanup_exit_failure;
+    }
+
+    /*** Determine output format ***/
+
+    if (output_format_str[0] != '\0') {
+        if (strcasecmp(output_format_str, "text") == 0)
+            output_format = OUTPUT_FORMAT_TEXT;
+        else if (strcasecmp(output_format_str, "json") == 0)
+            output_format = OUTPUT_FORMAT_JSON;
+        else if (strcasecmp(output_format_str, "csv") == 0)
+            output_format = OUTPUT_FORMAT_CSV;
+        else if (strcasecmp(output_format_str, "binary") == 0)
+            output_format = OUTPUT_FORMAT_BINARY;
+        else if (strcasecmp(output_format_str, "compact") == 0)
+            output_format = OUTPUT_FORMAT_COMPACT;
+        else if (strcasecmp(output_format_str, "stats") == 0)
+            output_format = OUTPUT_FORMAT_STATS;
+        else if (strcasecmp(output_format_str, "dot") == 0)
+            output_format = OUTPUT_FORMAT_CFG_DOT;
+        else if (strcasecmp(output_format_str, "cfg") == 0)
+            output_format = OUTPUT_FORMAT_CFG_JSON;
+        else if (strcasecmp(output_format_str, "stack") == 0)
+            output_format = OUTPUT_FORMAT_STACK;
+        else {
+            fprintf(stderr, "Unknown output format %s.\n", output_format_str);
+            fprintf(stderr, "See program help/usage for supported output formats.\n");
+            goto cleanup_exit_failure;
+        }
+    }
+
+    if (flag_stats_only)
+        output_format = OUTPUT_FORMAT_STATS;
+    if (discover.num_entries > 0)
+        flag_discover = 1;
+
+    /* Reject the options that rule each other out */
+    if (check_conflicts(
+            (flag_batch ? OPTION_BATCH : 0) |
+            (flag_pipeline ? OPTION_PIPELINE : 0) |
+            ((connect_socket != NULL) ? OPTION_CONNECT : 0) |
+            (has_shard ? OPTION_SHARD : 0) |
+            ((num_tees > 0) ? OPTION_TEE : 0) |
+            (live ? OPTION_LIVE : 0) |
+            (flag_follow ? OPTION_FOLLOW : 0) |
+            (flag_discover ? OPTION_DISCOVER : 0) |
+            ((previous_path != NULL) ? OPTION_PREVIOUS : 0) |
+            ((diff_path != NULL) ? OPTION_DIFF : 0) |
+            (has_range ? OPTION_RANGE : 0) |
+            ((num_search_patterns > 0) ? OPTION_SEARCH : 0) |
+            (flag_cycles ? OPTION_CYCLES : 0) |
+            ((format_template != NULL) ? OPTION_FORMAT : 0) |
+            (flag_assembly ? OPTION_ASSEMBLY : 0) |
+            (flag_no_addresses ? OPTION_NO_ADDRESSES : 0) |
+            ((output_format == OUTPUT_FORMAT_STATS) ? OPTION_STATS : 0) |
+            ((output_format == OUTPUT_FORMAT_CFG_DOT || output_format == OUTPUT_FORMAT_CFG_JSON || output_format == OUTPUT_FORMAT_STACK) ? OPTION_CFG : 0)) < 0)
+        goto cleanup_exit_failure;
+
+    /* Following a file implies live output */
+    if (flag_follow)
+        live = 1;
+
+    if (flag_cycles && cycles_str != NULL && (cycles_variant = ucdisasm_cycles_variant_lookup(arch, cycles_str)) < 0) {
+        fprintf(stderr, "Unknown core %s for --cycles on %s.\n", cycles_str, arch_str);
+        fprintf(stderr, "See program help/usage for supported cores.\n");
+        goto cleanup_exit_failure;
+    }
+    if (flag_cycles && output_format != OUTPUT_FORMAT_TEXT && output_format != OUTPUT_FORMAT_CFG_DOT && output_format != OUTPUT_FORMAT_CFG_JSON) {
+        fprintf(stderr, "Error: --cycles requires the text, dot, or cfg output format.\n");
+        goto cleanup_exit_failure;
+    }
+
+    if (num_search_patterns > 0 && output_format != OUTPUT_FORMAT_TEXT) {
+        fprintf(stderr, "Error: --search requires the text output format.\n");
+        goto cleanup_exit_failure;
+    }
+    if (num_search_patterns > 0) {
+        if (search_compile(&search, search_patterns, num_search_patterns, ucdisasm_disasmstream_setup(&ds, arch), &error) < 0) {
+            fprintf(stderr, "Error: %s\n", error);
+            goto cleanup_exit_failure;
+        }
+    }
+
+    if ((previous_path != NULL) != (previous_listing_path != NULL)) {
+        fprintf(stderr, "Error: --previous and --previous-listing are required together.\n");
+        goto cleanup_exit_failure;
+    }
+    if (previous_path != NULL && output_format != OUTPUT_FORMAT_TEXT) {
+        fprintf(stderr, "Error: --previous requires the text output format with addresses.\n");
+        goto cleanup_exit_failure;
+    }
+    if (diff_path != NULL && output_format != OUTPUT_FORMAT_TEXT) {
+        fprintf(stderr, "Error: --diff requires the text output format.\n");
+        goto cleanup_exit_failure;
+    }
+
+    /*** Batch mode ***/
+
+    if (flag_batch) {
+        struct batch_options options;
+        char **paths = (char **)&argv[optind];
+        unsigned int num_paths = argc - optind;
+
+        if (num_tees > 0 || file_out_str[0] != '\0') {
+            fprintf(stderr, "Error: --tee and --out-file are not supported with --batch, use --batch-output.\n");
+            goto cleanup_exit_failure;
+        }
+
+        options.output_template = batch_output;
+        options.render.format_template = format_template;
+        options.render.search = (num_search_patterns > 0) ? &search : NULL;
+        options.render.search_context = search_context;
+        options.render.arch = arch;
+        options.render.arch_name = arch_str;
+        options.render.output_format = output_format;
+        options.render.flags = setup_flags();
+        options.render.has_range = has_range;
+        options.render.start = range_start;
+        options.render.end = range_end;
+        options.file_type = -1;
+        if (file_type_str[0] != '\0' && (options.file_type = parse_file_type(file_type_str)) < 0) {
+            fprintf(stderr, "Unknown file type %s.\n", file_type_str);
+            fprintf(stderr, "See program help/usage for supported file types.\n");
+            goto cleanup_exit_failure;
+        }
+
+        /* Read the list of program files from stdin with a lone "-" */
+        if (num_paths == 1 && strcmp(paths[0], "-") == 0)
+            paths = batch_read_manifest(stdin, &num_paths);
+        if (num_paths == 0) {
+            fprintf(stderr, "Error: No program files specified!\n");
+            goto cleanup_exit_failure;
+        }
+
+        if (num_jobs == 0)
+            num_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+        if (num_jobs <= 0)
+            num_jobs = 1;
+        if (num_prefetch < 0)
+            num_prefetch = 2*num_jobs;
+
+        if (batch_main(paths, num_paths, num_jobs, num_prefetch, &options) < 0)
+            goto cleanup_exit_failure;
+        goto cleanup_exit_success;
+    }
+
+    /*** Client mode ***/
+
+    if (connect_socket != NULL) {
+        if (file_out_str[0] != '\0' && (file_out = fopen(file_out_str, "w")) == NULL) {
+            perror("Error opening output file for writing");
+            goto cleanup_exit_failure;
+        }
+        if (client_main(connect_socket, argv[optind], arch_str, file_type_str, output_format, setup_flags(), has_range, range_start, range_end, (file_out != NULL) ? file_out : stdout) < 0)
+            goto cleanup_exit_failure;
+        goto cleanup_exit_success;
+    }
+
+    /*** Open input file ***/
+
+    /* Support reading from stdin with filename "-" */
+    if (strcmp(argv[optind], "-") == 0) {
+        /* Sharding reads the program file twice */
+        if (has_shard) {
+            fprintf(stderr, "Error: --shard requires a program file, not standard input.\n");
+            goto cleanup_exit_failure;
+        }
+        file_in = stdin;
+    } else {
+    /* Otherwise, open the specified input file */
+        file_in = fopen(argv[optind], "r");
+        if (file_in == NULL) {
+            perror("Error: Cannot open program file for disassembly");
+            goto cleanup_exit_failure;
+        }
+    }
+
+    /* Read the input as its data arrives, before anything is buffered */
+    if (live) {
+        FILE *file_live;
+
+        live_stats_init(&live_stats, live_interval);
+        if ((file_live = live_input_open(file_in, flag_follow, &live_stats)) == NULL) {
+            fprintf(stderr, "Error opening live input!\n");
+            goto cleanup_exit_failure;
+        }
+        file_in = file_live;
+    }
+
+    /* Decompression of gzip compressed input reads ahead in blocks */
+    if (live && gzip_detect(file_in)) {
+        fprintf(stderr, "Error: --live and --follow are not supported for gzip files.\n");
+        goto cleanup_exit_failure;
+    }
+
+    /*** Determine input file type ***/
+
+    /* If a file type was specified */
+    file_type = -1;
+    if (file_type_str[0] != '\0' && (file_type = parse_file_type(file_type_str)) < 0) {
+        fprintf(stderr, "Unknown file type %s.\n", file_type_str);
+        fprintf(stderr, "See program help/usage for supported file types.\n");
+        goto cleanup_exit_failure;
+    }
+
+    /* Setup the ByteStream, reading gzip compressed input as its decompressed
+     * contents, and otherwise attempting to auto-detect the file type by
+     * first character */
+    if ((error = setup_input(&bs, file_in, &file_type)) != NULL) {
+        /* The input file is closed on failure */
+        file_in = NULL;
+        fprintf(stderr, "Error: %s!\n", error);
+        if (file_type < 0)
+            fprintf(stderr, "Please specify file type with -t / --file-type option.\n");
+        goto cleanup_exit_failure;
+    }
+    file_in = bs.in;
+
+    /* The ELF reader needs the whole file before it can start */
+    if (live && file_type == FILE_TYPE_ELF) {
+        fprintf(stderr, "Error: --live and --follow are not supported for ELF files.\n");
+        goto cleanup_exit_failure;
+    }
+
+    /* Debug this file type if we're in debug mode */
+    if (flag_debug) {
+        debug_tests(file_in, file_type);
+        goto cleanup_exit_success;
+    }
+
+    /* Find the shard's extent from a first pass over the program file */
+    if (has_shard) {
+        shard.arch = arch;
+        if (shard_scan_file(argv[optind], file_type, &shard.image) < 0)
+            goto cleanup_exit_failure;
+    }
+
+    /* Label only the instructions that operands refer to in --assembly and
+     * the assembly --tee outputs, from a first pass over the program file,
+     * through the same discovery as the output. Live input is only read once. */
+    for (i = 0, has_xref = flag_assembly && !flag_all_labels; i < num_tees; i++) {
+        if (needs_xref(tees[i].flags))
+            has_xref = 1;
+    }
+    if (has_xref && !live) {
+        discover.arch = arch;
+        xref_index_init(&xref);
+        ret = xref_index_scan_input(&xref, &bs, arch, flag_discover ? &discover : NULL, &error);
+        /* The input may be replaced with a copy that can be read twice */
+        file_in = bs.in;
+        if (ret < 0) {
+            fprintf(stderr, "Error reading program file: %s\n", error);
+            xref_index_free(&xref);
+            goto cleanup_exit_failure;
+        }
+    } else {
+        has_xref = 0;
+    }
+
+    /*** Open output file ***/
+
+    /* If an output file was specified */
+    if (file_out_str[0] != '\0') {
+        file_out = fopen(file_out_str, "w");
+        if (file_out == NULL) {
+            perror("Error opening output file for writing");
+            goto cleanup_exit_failure;
+        }
+    } else {
+    /* Otherwise, default the output file to stdout */
+        file_out = stdout;
+    }
+
+    /* Open the --tee output files */
+    for (i = 0; i < num_tees; i++) {
+        tees[i].file = fopen(tees[i].file_str, "w");
+        if (tees[i].file == NULL) {
+            perror("Error opening --tee output file for writing");
+            goto cleanup_exit_failure;
+        }
+    }
+
+    /* Append the shard trailer to the output */
+    if (has_shard && (file_shard = shard_output_open(file_out, &shard)) == NULL) {
+        fprintf(stderr, "Error opening shard output!\n");
+        goto cleanup_exit_failure;
+    }
+
+    /*** Setup Formatting Flags ***/
+    flags = setup_flags();
+    /* Only the first shard carries the output's header */
+    if (has_shard && shard.index > 0)
+        flags |= PRINT_FLAG_NO_HEADER;
+
+    /*** Incremental disassembly ***/
+
+    if (previous_path != NULL) {
+        ret = incremental_main(previous_path, previous_listing_path, (file_type_str[0] != '\0') ? file_type : -1, file_in, file_type, arch, flags, file_out);
+        /* The input file is closed with its byte stream */
+        file_in = NULL;
+        if (ret < 0)
+            goto cleanup_exit_failure;
+        goto cleanup_exit_success;
+    }
+
+    /*** Diff against an old build ***/
+
+    if (diff_path != NULL) {
+        ret = diff_main(diff_path, (file_type_str[0] != '\0') ? file_type : -1, file_in, file_type, arch, flags, file_out);
+        /* The input file is closed with its byte stream */
+        file_in = NULL;
+        if (ret < 0)
+            goto cleanup_exit_failure;
+        if (ret > 0)
+            exit_success = DIFF_EXIT_DIFFERENT;
+        goto cleanup_exit_success;
+    }
+
+    /*** Setup disassembler streams ***/
+
+    /* Setup the DisasmStream */
+    ds.in = &bs;
+    isa_mnemonic = ucdisasm_disasmstream_setup(&ds, arch);
+
+    /* Setup the File PrintStream */
+    ps.in = &ds;
+    if (num_search_patterns > 0) {
+        if (printstream_search_setup(&ps, &search, search_context) < 0) {
+            fprintf(stderr, "Error: %s\n", ps.error);
+            goto cleanup_exit_failure;
+        }
+    } else if (format_template != NULL) {
+        if (printstream_template_setup(&ps, format_template) < 0) {
+            fprintf(stderr, "Error: %s\n", ps.error);
+            goto cleanup_exit_failure;
+        }
+    } else {
+        if (setup_printstream(&ps, output_format, arch_str, isa_mnemonic) < 0) {
+            fprintf(stderr, "Error: %s\n", ps.error);
+            goto cleanup_exit_failure;
+        }
+    }
+
+    /* Interpose pipelined streams to run parsing and disassembly on their
+     * own threads */
+    if (flag_pipeline) {
+        if (pipeline_bytestream_setup(&bs_pipeline, &bs) < 0 || pipeline_disasmstream_setup(&ds_pipeline, &ds) < 0) {
+            fprintf(stderr, "Error allocating pipelined streams!\n");
+            goto cleanup_exit_failure;
+        }
+        ds.in = &bs_pipeline;
+        ps.in = &ds_pipeline;
+    }
+
+    /* Disassemble only the code reachable from the entry points */
+    if (flag_discover) {
+        discover.arch = arch;
+        if (discover_disasmstream_setup(&ds_discover, &ds, &discover) < 0) {
+            fprintf(stderr, "Error: %s\n", ds_discover.error);
+            goto cleanup_exit_failure;
+        }
+        ps.in = &ds_discover;
+    }
+
+    /* Filter to the --range address range */
+    if (has_range) {
+        if (range_disasmstream_setup(&ds_range, ps.in, range_start, range_end) < 0) {
+            fprintf(stderr, "Error allocating range stream!\n");
+            goto cleanup_exit_failure;
+        }
+        ps.in = &ds_range;
+    }
+
+    /* Restrict the input to the --shard shard, and drop the directives at
+     * its edges from the disassembly */
+    if (has_shard) {
+        if (shard_bytestream_setup(&bs_shard, ds.in, &shard) < 0 || shard_disasmstream_setup(&ds_shard, ps.in, &shard) < 0) {
+            fprintf(stderr, "Error allocating shard streams!\n");
+            goto cleanup_exit_failure;
+        }
+        ds.in = &bs_shard;
+        ps.in = &ds_shard;
+    }
+
+    /* Count the instructions written out for the --live latency statistics */
+    if (live) {
+        if (live_disasmstream_setup(&ds_live, ps.in, &live_stats) < 0) {
+            fprintf(stderr, "Error: %s\n", ds_live.error);
+            goto cleanup_exit_failure;
+        }
+        ps.in = &ds_live;
+    }
+
+    /* Fan the disassembly out to the --tee outputs, one branch per Print
+     * Stream, so the input is parsed and disassembled only once */
+    if (num_tees > 0) {
+        if (fanout_disasmstream_setup(ds_branches, num_tees+1, ps.in) < 0) {
+            fprintf(stderr, "Error allocating fan-out streams!\n");
+            goto cleanup_exit_failure;
+        }
+        ps.in = &ds_branches[0];
+        for (i = 0; i < num_tees; i++) {
+            ps_tees[i].in = &ds_branches[i+1];
+            /* Remove the labels nothing refers to from an assembly branch */
+            if (has_xref && needs_xref(tees[i].flags)) {
+                if (xref_disasmstream_setup(&ds_xrefs[i+1], ps_tees[i].in, &xref) < 0) {
+                    fprintf(stderr, "Error: %s\n", ds_xrefs[i+1].error);
+                    goto cleanup_exit_failure;
+                }
+                ps_tees[i].in = &ds_xrefs[i+1];
+            }
+            if (setup_printstream(&ps_tees[i], tees[i].format, arch_str, isa_mnemonic) < 0) {
+                fprintf(stderr, "Error: %s\n", ps_tees[i].error);
+                goto cleanup_exit_failure;
+            }
+        }
+    }
+
+    /* Remove the labels nothing refers to from the --assembly output */
+    if (has_xref && flag_assembly && !flag_all_labels) {
+        if (xref_disasmstream_setup(&ds_xrefs[0], ps.in, &xref) < 0) {
+            fprintf(stderr, "Error: %s\n", ds_xrefs[0].error);
+            goto cleanup_exit_failure;
+        }
+        ps.in = &ds_xrefs[0];
+    }
+
+    /* Initialize streams */
+    if ((ret = ps.stream_init(&ps, flags)) < 0) {
+        fprintf(stderr, "Error initializing streams! Error code: %d\n", ret);
+        printstream_error_trace(&ps, &ds, &bs);
+        goto cleanup_exit_failure;
+    }
+    for (i = 0; i < num_tees; i++) {
+        if ((ret = ps_tees[i].stream_init(&ps_tees[i], tees[i].flags)) < 0) {
+            fprintf(stderr, "Error initializing streams! Error code: %d\n", ret);
+            printstream_error_trace(&ps_tees[i], &ds, &bs);
+            goto cleanup_exit_failure;
+        }
+    }
+
+    /* Read from the Print Streams in lockstep until EOF */
+    for (done = 0; !done; ) {
+        if ((ret = ps.stream_read(&ps, (file_shard != NULL) ? file_shard : file_out)) == STREAM_EOF) {
+            done = 1;
+        } else if (ret < 0) {
+            fprintf(stderr, "Error occured during disassembly! Error code: %d\n", ret);
+            printstream_error_trace(&ps, &ds, &bs);
+            goto cleanup_exit_failure;
+        }
+        for (i = 0; i < num_tees; i++) {
+            if ((ret = ps_tees[i].stream_read(&ps_tees[i], tees[i].file)) < 0 && ret != STREAM_EOF) {
+                fprintf(stderr, "Error occured during disassembly! Error code: %d\n", ret);
+                printstream_error_trace(&ps_tees[i], &ds, &bs);
+                goto cleanup_exit_failure;
+            }
+        }
+        /* Write out the instructions read, as due */
+        if (live && !done)
+            live_instruction(&live_stats);
+    }
+
+    /* Close streams */
+    for (i = 0; i < num_tees; i++) {
+        if ((ret = ps_tees[i].stream_close(&ps_tees[i])) < 0) {
+            fprintf(stderr, "Error closing streams! Error code: %d\n", ret);
+            printstream_error_trace(&ps_tees[i], &ds, &bs);
+            goto cleanup_exit_failure;
+        }
+    }
+    if ((ret = ps.stream_close(&ps)) < 0) {
+        fprintf(stderr, "Error closing streams! Error code: %d\n", ret);
+        printstream_error_trace(&ps, &ds, &bs);
+        goto cleanup_exit_failure;
+    }
+    if (has_xref)
+        xref_index_free(&xref);
+
+    /* Flush the shard output and write its trailer */
+    if (file_shard != NULL && fclose(file_shard) != 0) {
+        fprintf(stderr, "Error writing shard output!\n");
+        goto cleanup_exit_failure;
+    }
+
+    if (live) {
+        live_flush(&live_stats);
+        live_stats_print(&live_stats, stderr);
+    }
+
+    cleanup_exit_success:
+    if (file_out != stdout && file_out != NULL)
+        fclose(file_out);
+    for (i = 0; i < num_tees; i++) {
+        if (tees[i].file != NULL)
+            fclose(tees[i].file);
+    }
+    exit(exit_success);
+
+    cleanup_exit_failure:
+    if (file_in != stdin && file_in != NULL)
+        fclose(file_in);
+    if (file_out != stdout && file_out != NULL)
+        fclose(file_out);
+    for (i = 0; i < num_tees; i++) {
+        if (tees[i].file != NULL)
+            fclose(tees[i].file);
+    }
+    exit(exit_failure);
 }
 
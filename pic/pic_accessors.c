@@ -33,7 +33,14 @@ uint32_t pic_instruction_get_address(struct instruction *instr);
 unsigned int pic_instruction_get_width(struct instruction *instr);
 unsigned int pic_instruction_get_num_operands(struct instruction *instr);
 unsigned int pic_instruction_get_opcodes(struct instruction *instr, uint8_t *dest);
+int pic_instruction_get_operand_kind(struct instruction *instr, int index);
+int32_t pic_instruction_get_operand_value(struct instruction *instr, int index);
+int pic_instruction_get_branch_target(struct instruction *instr, uint32_t *dest);
+int pic_instruction_get_flow(struct instruction *instr);
+int pic_instruction_get_isa_index(struct instruction *instr);
+int pic_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest);
 int pic_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags);
+int pic_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest);
 int pic_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags);
 int pic_instruction_get_str_opcodes(struct instruction *instr, char *dest, int size, int flags);
 int pic_instruction_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
@@ -43,6 +50,8 @@ void pic_instruction_free(struct instruction *instr);
 
 /* PIC Directive Accessor Functions */
 unsigned int pic_directive_get_num_operands(struct instruction *instr);
+int pic_directive_get_operand_kind(struct instruction *instr, int index);
+int32_t pic_directive_get_operand_value(struct instruction *instr, int index);
 int pic_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
 int pic_directive_get_str_operand(struct instruction *instr, char *dest, int size, int index, int flags);
 void pic_directive_free(struct instruction *instr);
@@ -76,11 +85,170 @@ unsigned int pic_instruction_get_opcodes(struct instruction *instr, uint8_t *des
     return instructionDisasm->instructionInfo->width;
 }
 
+int pic_instruction_get_operand_kind(struct instruction *instr, int index) {
+    struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return OPERAND_KIND_NONE;
+
+    switch (instructionDisasm->instructionInfo->operandTypes[index]) {
+        case OPERAND_REGISTER:
+        case OPERAND_FSR_INDEX:
+            return OPERAND_KIND_REGISTER;
+        case OPERAND_BIT_REG_DEST:
+        case OPERAND_BIT_RAM_DEST:
+        case OPERAND_BIT_FAST_CALLRETURN:
+        case OPERAND_INCREMENT_MODE:
+            return OPERAND_KIND_FLAG;
+        case OPERAND_BIT:
+            return OPERAND_KIND_BIT;
+        case OPERAND_LITERAL:
+        case OPERAND_SIGNED_LITERAL:
+        case OPERAND_LONG_LFSR_LITERAL:
+            return OPERAND_KIND_DATA;
+        case OPERAND_INDF_INDEX:
+            return OPERAND_KIND_INDIRECT;
+        case OPERAND_ABSOLUTE_DATA_ADDRESS:
+        case OPERAND_LONG_ABSOLUTE_DATA_ADDRESS:
+        case OPERAND_LONG_MOVFF_DATA_ADDRESS:
+            return OPERAND_KIND_DATA_ADDRESS;
+        case OPERAND_ABSOLUTE_PROG_ADDRESS:
+        case OPERAND_LONG_ABSOLUTE_PROG_ADDRESS:
+            return OPERAND_KIND_PROG_ADDRESS;
+        case OPERAND_RELATIVE_PROG_ADDRESS:
+            return OPERAND_KIND_RELATIVE_ADDRESS;
+        case OPERAND_RAW_WORD:
+        case OPERAND_RAW_BYTE:
+            return OPERAND_KIND_RAW;
+        default:
+            break;
+    }
+
+    return OPERAND_KIND_NONE;
+}
+
+int32_t pic_instruction_get_operand_value(struct instruction *instr, int index) {
+    struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return 0;
+
+    return instructionDisasm->operandDisasms[index];
+}
+
+int pic_instruction_get_branch_target(struct instruction *instr, uint32_t *dest) {
+    struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
+    int i;
+
+    for (i = 0; i < instructionDisasm->instructionInfo->numOperands; i++) {
+        switch (pic_instruction_get_operand_kind(instr, i)) {
+            case OPERAND_KIND_RELATIVE_ADDRESS:
+                *dest = instructionDisasm->operandDisasms[i] + instructionDisasm->address + 2;
+                return 1;
+            case OPERAND_KIND_PROG_ADDRESS:
+                *dest = pic_instruction_get_operand_value(instr, i);
+                return 1;
+            default:
+                break;
+        }
+    }
+
+    return 0;
+}
+
+/* Instructions that change the control flow, of all subarchitectures */
+static const struct {
+    const char *mnemonic;
+    int flow;
+} PIC_Flow_Table[] = {
+    {"goto", FLOW_JUMP}, {"bra", FLOW_JUMP}, {"reset", FLOW_JUMP},
+    {"call", FLOW_CALL}, {"rcall", FLOW_CALL},
+    {"brw", FLOW_INDIRECT_JUMP}, {"callw", FLOW_INDIRECT_CALL},
+    {"return", FLOW_RETURN}, {"retlw", FLOW_RETURN}, {"retfie", FLOW_RETURN},
+    {"bc", FLOW_BRANCH}, {"bn", FLOW_BRANCH}, {"bnc", FLOW_BRANCH}, {"bnn", FLOW_BRANCH},
+    {"bnov", FLOW_BRANCH}, {"bnz", FLOW_BRANCH}, {"bov", FLOW_BRANCH}, {"bz", FLOW_BRANCH},
+    {"btfsc", FLOW_SKIP}, {"btfss", FLOW_SKIP}, {"decfsz", FLOW_SKIP}, {"incfsz", FLOW_SKIP},
+    {"dcfsnz", FLOW_SKIP}, {"infsnz", FLOW_SKIP}, {"cpfseq", FLOW_SKIP}, {"cpfsgt", FLOW_SKIP},
+    {"cpfslt", FLOW_SKIP}, {"tstfsz", FLOW_SKIP},
+};
+
+int pic_instruction_get_flow(struct instruction *instr) {
+    struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
+    const struct picInstructionInfo *instructionInfo = instructionDisasm->instructionInfo;
+    int i;
+
+    if (instructionInfo->operandTypes[0] == OPERAND_RAW_WORD || instructionInfo->operandTypes[0] == OPERAND_RAW_BYTE)
+        return FLOW_INVALID;
+
+    for (i = 0; i < sizeof(PIC_Flow_Table)/sizeof(PIC_Flow_Table[0]); i++) {
+        if (strcmp(instructionInfo->mnemonic, PIC_Flow_Table[i].mnemonic) == 0)
+            return PIC_Flow_Table[i].flow;
+    }
+
+    return FLOW_NEXT;
+}
+
+int pic_instruction_get_isa_index(struct instruction *instr) {
+    struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
+    int i;
+
+    /* Find the subarchitecture table the entry belongs to */
+    for (i = PIC_SUBARCH_BASELINE; i <= PIC_SUBARCH_PIC18; i++) {
+        if (instructionDisasm->instructionInfo >= PIC_Instruction_Sets[i] && instructionDisasm->instructionInfo < PIC_Instruction_Sets[i] + PIC_TOTAL_INSTRUCTIONS[i])
+            return instructionDisasm->instructionInfo - PIC_Instruction_Sets[i];
+    }
+
+    return -1;
+}
+
+int pic_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest) {
+    struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
+    int flow;
+
+    if (variant != CYCLES_VARIANT_DEFAULT || instructionDisasm->instructionInfo->cycles == 0)
+        return 0;
+
+    dest->next = dest->taken = instructionDisasm->instructionInfo->cycles;
+
+    /* A taken branch or a skip costs one more cycle */
+    flow = pic_instruction_get_flow(instr);
+    if (flow == FLOW_BRANCH || flow == FLOW_SKIP)
+        dest->taken++;
+
+    return 1;
+}
+
 int pic_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags) {
     struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
     return snprintf(dest, size, PIC_FORMAT_ADDRESS_LABEL("%0*x"), PIC_ADDRESS_WIDTH, instructionDisasm->address);
 }
 
+/* Address of the label that get_str_operand() prints for operand index in
+ * assembly, kept in step with its cases */
+int pic_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest) {
+    struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
+
+    if (index < 0 || index > instructionDisasm->instructionInfo->numOperands - 1)
+        return 0;
+
+    switch (instructionDisasm->instructionInfo->operandTypes[index]) {
+        case OPERAND_LONG_MOVFF_DATA_ADDRESS:
+        case OPERAND_ABSOLUTE_DATA_ADDRESS:
+        case OPERAND_LONG_ABSOLUTE_DATA_ADDRESS:
+        case OPERAND_ABSOLUTE_PROG_ADDRESS:
+        case OPERAND_LONG_ABSOLUTE_PROG_ADDRESS:
+            *dest = instructionDisasm->operandDisasms[index];
+            return 1;
+        case OPERAND_RELATIVE_PROG_ADDRESS:
+            *dest = instructionDisasm->operandDisasms[index] + instructionDisasm->address + 2;
+            return 1;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
 int pic_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags) {
     struct picInstructionDisasm *instructionDisasm = (struct picInstructionDisasm *)instr->data;
     return snprintf(dest, size, PIC_FORMAT_ADDRESS("%*x"), PIC_ADDRESS_WIDTH, instructionDisasm->address);
@@ -272,6 +440,20 @@ unsigned int pic_directive_get_num_operands(struct instruction *instr) {
     return 0;
 }
 
+int pic_directive_get_operand_kind(struct instruction *instr, int index) {
+    struct picDirective *directive = (struct picDirective *)instr->data;
+    if (strcmp(directive->name, PIC_DIRECTIVE_NAME_ORIGIN) == 0 && index == 0)
+        return OPERAND_KIND_PROG_ADDRESS;
+    return OPERAND_KIND_NONE;
+}
+
+int32_t pic_directive_get_operand_value(struct instruction *instr, int index) {
+    struct picDirective *directive = (struct picDirective *)instr->data;
+    if (strcmp(directive->name, PIC_DIRECTIVE_NAME_ORIGIN) == 0 && index == 0)
+        return directive->value;
+    return 0;
+}
+
 int pic_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags) {
     struct picDirective *directive = (struct picDirective *)instr->data;
     return snprintf(dest, size, "%s", directive->name);
@@ -291,3 +473,18 @@ void pic_directive_free(struct instruction *instr) {
     instr->data = NULL;
 }
 
+/******************************************************************************/
+/* PIC Instruction Set Tables */
+/******************************************************************************/
+
+static const char *util_isa_mnemonic(int subarch, unsigned int index) {
+    if (index >= PIC_TOTAL_INSTRUCTIONS[subarch])
+        return NULL;
+    return PIC_Instruction_Sets[subarch][index].mnemonic;
+}
+
+const char *pic_baseline_isa_mnemonic(unsigned int index) { return util_isa_mnemonic(PIC_SUBARCH_BASELINE, index); }
+const char *pic_midrange_isa_mnemonic(unsigned int index) { return util_isa_mnemonic(PIC_SUBARCH_MIDRANGE, index); }
+const char *pic_midrange_enhanced_isa_mnemonic(unsigned int index) { return util_isa_mnemonic(PIC_SUBARCH_MIDRANGE_ENHANCED, index); }
+const char *pic_pic18_isa_mnemonic(unsigned int index) { return util_isa_mnemonic(PIC_SUBARCH_PIC18, index); }
+
@@ -18,7 +18,14 @@ extern uint32_t pic_instruction_get_address(struct instruction *instr);
 extern unsigned int pic_instruction_get_width(struct instruction *instr);
 extern unsigned int pic_instruction_get_num_operands(struct instruction *instr);
 extern unsigned int pic_instruction_get_opcodes(struct instruction *instr, uint8_t *dest);
+extern int pic_instruction_get_operand_kind(struct instruction *instr, int index);
+extern int32_t pic_instruction_get_operand_value(struct instruction *instr, int index);
+extern int pic_instruction_get_branch_target(struct instruction *instr, uint32_t *dest);
+extern int pic_instruction_get_flow(struct instruction *instr);
+extern int pic_instruction_get_isa_index(struct instruction *instr);
+extern int pic_instruction_get_cycles(struct instruction *instr, int variant, struct instruction_cycles *dest);
 extern int pic_instruction_get_str_address_label(struct instruction *instr, char *dest, int size, int flags);
+extern int pic_instruction_get_label_target(struct instruction *instr, int index, uint32_t *dest);
 extern int pic_instruction_get_str_address(struct instruction *instr, char *dest, int size, int flags);
 extern int pic_instruction_get_str_opcodes(struct instruction *instr, char *dest, int size, int flags);
 extern int pic_instruction_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
@@ -27,6 +34,8 @@ extern int pic_instruction_get_str_comment(struct instruction *instr, char *dest
 extern void pic_instruction_free(struct instruction *instr);
 
 extern unsigned int pic_directive_get_num_operands(struct instruction *instr);
+extern int pic_directive_get_operand_kind(struct instruction *instr, int index);
+extern int32_t pic_directive_get_operand_value(struct instruction *instr, int index);
 extern int pic_directive_get_str_mnemonic(struct instruction *instr, char *dest, int size, int flags);
 extern int pic_directive_get_str_operand(struct instruction *instr, char *dest, int size, int index, int flags);
 extern void pic_directive_free(struct instruction *instr);
@@ -96,12 +105,12 @@ int disasmstream_pic_close(struct DisasmStream *self) {
 /******************************************************************************/
 
 static int util_disasm_directive(struct instruction *instr, char *name, uint32_t value);
-static int util_disasm_instruction(struct instruction *instr, struct picInstructionInfo *instructionInfo, struct disasmstream_pic_state *state);
+static int util_disasm_instruction(struct instruction *instr, const struct picInstructionInfo *instructionInfo, struct disasmstream_pic_state *state);
 static void util_disasm_operands(struct picInstructionDisasm *instructionDisasm);
-static int32_t util_disasm_operand(struct picInstructionInfo *instructionInfo, uint32_t operand, int index);
+static int32_t util_disasm_operand(const struct picInstructionInfo *instructionInfo, uint32_t operand, int index);
 static void util_opbuffer_shift(struct disasmstream_pic_state *state, int n);
 static int util_opbuffer_len_consecutive(struct disasmstream_pic_state *state);
-static struct picInstructionInfo *util_iset_lookup_by_opcode(int subarch, uint16_t opcode);
+static const struct picInstructionInfo *util_iset_lookup_by_opcode(int subarch, uint16_t opcode);
 static int util_bits_data_from_mask(uint16_t data, uint16_t mask);
 
 int disasmstream_pic_read(struct DisasmStream *self, struct instruction *instr) {
@@ -159,7 +168,7 @@ int disasmstream_pic_read(struct DisasmStream *self, struct instruction *instr)
 
         /* Two or more consecutive bytes */
         if (lenConsecutive >= 2) {
-            struct picInstructionInfo *instructionInfo;
+            const struct picInstructionInfo *instructionInfo;
             uint16_t opcode;
 
             /* Assemble the 16-bit opcode from little-endian input */
@@ -262,6 +271,8 @@ static int util_disasm_directive(struct instruction *instr, char *name, uint32_t
     instr->data = directive;
     instr->type = DISASM_TYPE_DIRECTIVE;
     instr->get_num_operands = pic_directive_get_num_operands;
+    instr->get_operand_kind = pic_directive_get_operand_kind;
+    instr->get_operand_value = pic_directive_get_operand_value;
     instr->get_str_mnemonic = pic_directive_get_str_mnemonic;
     instr->get_str_operand = pic_directive_get_str_operand;
     instr->free = pic_directive_free;
@@ -269,7 +280,7 @@ static int util_disasm_directive(struct instruction *instr, char *name, uint32_t
     return 0;
 }
 
-static int util_disasm_instruction(struct instruction *instr, struct picInstructionInfo *instructionInfo, struct disasmstream_pic_state *state) {
+static int util_disasm_instruction(struct instruction *instr, const struct picInstructionInfo *instructionInfo, struct disasmstream_pic_state *state) {
     struct picInstructionDisasm *instructionDisasm;
     int i;
 
@@ -296,7 +307,14 @@ static int util_disasm_instruction(struct instruction *instr, struct picInstruct
     instr->get_width = pic_instruction_get_width;
     instr->get_num_operands = pic_instruction_get_num_operands;
     instr->get_opcodes = pic_instruction_get_opcodes;
+    instr->get_operand_kind = pic_instruction_get_operand_kind;
+    instr->get_operand_value = pic_instruction_get_operand_value;
+    instr->get_branch_target = pic_instruction_get_branch_target;
+    instr->get_flow = pic_instruction_get_flow;
+    instr->get_isa_index = pic_instruction_get_isa_index;
+    instr->get_cycles = pic_instruction_get_cycles;
     instr->get_str_address_label = pic_instruction_get_str_address_label;
+    instr->get_label_target = pic_instruction_get_label_target;
     instr->get_str_address = pic_instruction_get_str_address;
     instr->get_str_opcodes = pic_instruction_get_str_opcodes;
     instr->get_str_mnemonic = pic_instruction_get_str_mnemonic;
@@ -311,7 +329,7 @@ static int util_disasm_instruction(struct instruction *instr, struct picInstruct
 }
 
 static void util_disasm_operands(struct picInstructionDisasm *instructionDisasm) {
-    struct picInstructionInfo *instructionInfo = instructionDisasm->instructionInfo;
+    const struct picInstructionInfo *instructionInfo = instructionDisasm->instructionInfo;
     int i;
     uint16_t opcode;
     uint32_t operand;
@@ -337,7 +355,7 @@ static void util_disasm_operands(struct picInstructionDisasm *instructionDisasm)
     }
 }
 
-static int32_t util_disasm_operand(struct picInstructionInfo *instructionInfo, uint32_t operand, int index) {
+static int32_t util_disasm_operand(const struct picInstructionInfo *instructionInfo, uint32_t operand, int index) {
     int32_t operandDisasm;
     uint32_t msb;
 
@@ -419,7 +437,7 @@ static int util_opbuffer_len_consecutive(struct disasmstream_pic_state *state) {
     return lenConsecutive;
 }
 
-static struct picInstructionInfo *util_iset_lookup_by_opcode(int subarch, uint16_t opcode) {
+static const struct picInstructionInfo *util_iset_lookup_by_opcode(int subarch, uint16_t opcode) {
     int i, j;
 
     uint16_t instructionBits;
@@ -462,3 +480,52 @@ static int util_bits_data_from_mask(uint16_t data, uint16_t mask) {
     return result;
 }
 
+/******************************************************************************/
+/* PIC Instruction Set Table Support */
+/******************************************************************************/
+
+static unsigned int util_isa_width(int subarch, uint16_t opcode) {
+    const struct picInstructionInfo *instructionInfo;
+
+    instructionInfo = util_iset_lookup_by_opcode(subarch, opcode);
+    return (instructionInfo != NULL) ? instructionInfo->width : 2;
+}
+
+unsigned int pic_baseline_isa_width(uint16_t opcode) { return util_isa_width(PIC_SUBARCH_BASELINE, opcode); }
+unsigned int pic_midrange_isa_width(uint16_t opcode) { return util_isa_width(PIC_SUBARCH_MIDRANGE, opcode); }
+unsigned int pic_midrange_enhanced_isa_width(uint16_t opcode) { return util_isa_width(PIC_SUBARCH_MIDRANGE_ENHANCED, opcode); }
+unsigned int pic_pic18_isa_width(uint16_t opcode) { return util_isa_width(PIC_SUBARCH_PIC18, opcode); }
+
+/******************************************************************************/
+/* PIC Raw Data Support */
+/******************************************************************************/
+
+static int util_disasm_raw(int subarch, struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address) {
+    struct disasmstream_pic_state state;
+    unsigned int i;
+
+    /* Load a word, or a lone byte, into an opcode buffer */
+    memset(&state, 0, sizeof(state));
+    state.subarch = subarch;
+    state.len = (len >= 2) ? 2 : 1;
+    for (i = 0; i < state.len; i++) {
+        state.data[i] = data[i];
+        state.address[i] = address + i;
+    }
+
+    memset(instr, 0, sizeof(struct instruction));
+    if (util_disasm_instruction(instr, &PIC_Instruction_Sets[subarch][(len >= 2) ? PIC_ISET_INDEX_WORD(subarch) : PIC_ISET_INDEX_BYTE(subarch)], &state) < 0)
+        return -1;
+
+    return (len >= 2) ? 2 : 1;
+}
+
+int pic_baseline_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address) { return util_disasm_raw(PIC_SUBARCH_BASELINE, instr, data, len, address); }
+int pic_midrange_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address) { return util_disasm_raw(PIC_SUBARCH_MIDRANGE, instr, data, len, address); }
+int pic_midrange_enhanced_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address) { return util_disasm_raw(PIC_SUBARCH_MIDRANGE_ENHANCED, instr, data, len, address); }
+int pic_pic18_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address) { return util_disasm_raw(PIC_SUBARCH_PIC18, instr, data, len, address); }
+
+int pic_disasm_origin(struct instruction *instr, uint32_t address) {
+    memset(instr, 0, sizeof(struct instruction));
+    return util_disasm_directive(instr, PIC_DIRECTIVE_NAME_ORIGIN, address);
+}
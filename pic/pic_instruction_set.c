@@ -1,234 +1,234 @@
 #include "pic_instruction_set.h"
 
-struct picInstructionInfo PIC_Instruction_Set_Baseline[] = {
-    {"nop", 2, 0x0000, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"clrw", 2, 0x0040, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"clrwdt", 2, 0x0004, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"option", 2, 0x0002, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"sleep", 2, 0x0003, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"andlw", 2, 0x0e00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"clrf", 2, 0x0060, 0x0000, 1, {0x001f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"movwf", 2, 0x0020, 0x0000, 1, {0x001f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"call", 2, 0x0900, 0x0000, 1, {0x00ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"goto", 2, 0x0a00, 0x0000, 1, {0x01ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"iorlw", 2, 0x0d00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"movlw", 2, 0x0c00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"retlw", 2, 0x0800, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"tris", 2, 0x0000, 0x0000, 1, {0x0007}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"xorlw", 2, 0x0f00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"addwf", 2, 0x01c0, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"andwf", 2, 0x0140, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"comf", 2, 0x0240, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"decf", 2, 0x00c0, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"decfsz", 2, 0x02c0, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"incf", 2, 0x0280, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"incfsz", 2, 0x03c0, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"iorwf", 2, 0x0100, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"movf", 2, 0x0200, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"rlf", 2, 0x0340, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"rrf", 2, 0x0300, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"subwf", 2, 0x0080, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"swapf", 2, 0x0380, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"xorwf", 2, 0x0180, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"bcf", 2, 0x0400, 0x0000, 2, {0x001f, 0x00e0}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"bsf", 2, 0x0500, 0x0000, 2, {0x001f, 0x00e0}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"btfsc", 2, 0x0600, 0x0000, 2, {0x001f, 0x00e0}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"btfss", 2, 0x0700, 0x0000, 2, {0x001f, 0x00e0}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"data", 2, 0x0000, 0x0000, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE, OPERAND_NONE}},
-    {"db", 2, 0x0000, 0x0000, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE, OPERAND_NONE}},
+const struct picInstructionInfo PIC_Instruction_Set_Baseline[] = {
+    {"nop", 2, 0x0000, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"clrw", 2, 0x0040, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"clrwdt", 2, 0x0004, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"option", 2, 0x0002, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"sleep", 2, 0x0003, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"andlw", 2, 0x0e00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"clrf", 2, 0x0060, 0x0000, 1, {0x001f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movwf", 2, 0x0020, 0x0000, 1, {0x001f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"call", 2, 0x0900, 0x0000, 1, {0x00ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"goto", 2, 0x0a00, 0x0000, 1, {0x01ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"iorlw", 2, 0x0d00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movlw", 2, 0x0c00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"retlw", 2, 0x0800, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"tris", 2, 0x0000, 0x0000, 1, {0x0007}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"xorlw", 2, 0x0f00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"addwf", 2, 0x01c0, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"andwf", 2, 0x0140, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"comf", 2, 0x0240, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"decf", 2, 0x00c0, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"decfsz", 2, 0x02c0, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"incf", 2, 0x0280, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"incfsz", 2, 0x03c0, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"iorwf", 2, 0x0100, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"movf", 2, 0x0200, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"rlf", 2, 0x0340, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"rrf", 2, 0x0300, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"subwf", 2, 0x0080, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"swapf", 2, 0x0380, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"xorwf", 2, 0x0180, 0x0000, 2, {0x001f, 0x0020}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"bcf", 2, 0x0400, 0x0000, 2, {0x001f, 0x00e0}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"bsf", 2, 0x0500, 0x0000, 2, {0x001f, 0x00e0}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"btfsc", 2, 0x0600, 0x0000, 2, {0x001f, 0x00e0}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"btfss", 2, 0x0700, 0x0000, 2, {0x001f, 0x00e0}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"data", 2, 0x0000, 0x0000, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE, OPERAND_NONE}, 0},
+    {"db", 1, 0x0000, 0x0000, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE, OPERAND_NONE}, 0},
 };
 
-struct picInstructionInfo PIC_Instruction_Set_Midrange[] = {
-    {"clrw", 2, 0x0100, 0x007f, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"nop", 2, 0x0000, 0x0060, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"option", 2, 0x0062, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"clrwdt", 2, 0x0064, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"sleep", 2, 0x0063, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"retfie", 2, 0x0009, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"return", 2, 0x0008, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"clrf", 2, 0x0180, 0x0000, 1, {0x007f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"movwf", 2, 0x0080, 0x0000, 1, {0x007f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"tris", 2, 0x0060, 0x0000, 1, {0x0007}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"addlw", 2, 0x3e00, 0x0100, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"andlw", 2, 0x3900, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"call", 2, 0x2000, 0x0000, 1, {0x07ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"goto", 2, 0x2800, 0x0000, 1, {0x07ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"iorlw", 2, 0x3800, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"movlw", 2, 0x3000, 0x0300, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"retlw", 2, 0x3400, 0x0300, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"sublw", 2, 0x3c00, 0x0100, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"xorlw", 2, 0x3a00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"addwf", 2, 0x0700, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"andwf", 2, 0x0500, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"comf", 2, 0x0900, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"decf", 2, 0x0300, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"decfsz", 2, 0x0b00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"incf", 2, 0x0a00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"incfsz", 2, 0x0f00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"iorwf", 2, 0x0400, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"movf", 2, 0x0800, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"rlf", 2, 0x0d00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"rrf", 2, 0x0c00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"subwf", 2, 0x0200, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"swapf", 2, 0x0e00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"xorwf", 2, 0x0600, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"bcf", 2, 0x1000, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"bsf", 2, 0x1400, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"btfsc", 2, 0x1800, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"btfss", 2, 0x1c00, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"dw", 2, 0x0000, 0x0000, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE, OPERAND_NONE}},
-    {"db", 1, 0x0000, 0x0000, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE, OPERAND_NONE}},
+const struct picInstructionInfo PIC_Instruction_Set_Midrange[] = {
+    {"clrw", 2, 0x0100, 0x007f, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"nop", 2, 0x0000, 0x0060, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"option", 2, 0x0062, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"clrwdt", 2, 0x0064, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"sleep", 2, 0x0063, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"retfie", 2, 0x0009, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"return", 2, 0x0008, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"clrf", 2, 0x0180, 0x0000, 1, {0x007f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movwf", 2, 0x0080, 0x0000, 1, {0x007f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"tris", 2, 0x0060, 0x0000, 1, {0x0007}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"addlw", 2, 0x3e00, 0x0100, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"andlw", 2, 0x3900, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"call", 2, 0x2000, 0x0000, 1, {0x07ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"goto", 2, 0x2800, 0x0000, 1, {0x07ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"iorlw", 2, 0x3800, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movlw", 2, 0x3000, 0x0300, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"retlw", 2, 0x3400, 0x0300, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"sublw", 2, 0x3c00, 0x0100, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"xorlw", 2, 0x3a00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"addwf", 2, 0x0700, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"andwf", 2, 0x0500, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"comf", 2, 0x0900, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"decf", 2, 0x0300, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"decfsz", 2, 0x0b00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"incf", 2, 0x0a00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"incfsz", 2, 0x0f00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"iorwf", 2, 0x0400, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"movf", 2, 0x0800, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"rlf", 2, 0x0d00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"rrf", 2, 0x0c00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"subwf", 2, 0x0200, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"swapf", 2, 0x0e00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"xorwf", 2, 0x0600, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"bcf", 2, 0x1000, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"bsf", 2, 0x1400, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"btfsc", 2, 0x1800, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"btfss", 2, 0x1c00, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"dw", 2, 0x0000, 0x0000, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE, OPERAND_NONE}, 0},
+    {"db", 1, 0x0000, 0x0000, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE, OPERAND_NONE}, 0},
 };
 
-struct picInstructionInfo PIC_Instruction_Set_Midrange_Enhanced[] = {
-    {"brw", 2, 0x000b, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"callw", 2, 0x000a, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"reset", 2, 0x0001, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"clrw", 2, 0x0100, 0x0003, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"nop", 2, 0x0000, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"option", 2, 0x0062, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"sleep", 2, 0x0063, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"clrwdt", 2, 0x0064, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"retfie", 2, 0x0009, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"return", 2, 0x0008, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"clrf", 2, 0x0180, 0x0000, 1, {0x007f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"movlb", 2, 0x0020, 0x0000, 1, {0x001f}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"movlp", 2, 0x3180, 0x0000, 1, {0x007f}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"bra", 2, 0x3200, 0x0000, 1, {0x01ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"movwf", 2, 0x0080, 0x0000, 1, {0x007f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"addlw", 2, 0x3e00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"andlw", 2, 0x3900, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"call", 2, 0x2000, 0x0000, 1, {0x07ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"goto", 2, 0x2800, 0x0000, 1, {0x07ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"iorlw", 2, 0x3800, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"movlw", 2, 0x3000, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"tris", 2, 0x0060, 0x0000, 1, {0x0007}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}},
-    {"retlw", 2, 0x3400, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"sublw", 2, 0x3c00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"xorlw", 2, 0x3a00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"addwfc", 2, 0x3d00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"subwfb", 2, 0x3b00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"lslf", 2, 0x3500, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"lsrf", 2, 0x3600, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"asrf", 2, 0x3700, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"addfsr", 2, 0x3100, 0x0000, 2, {0x0040, 0x003f}, {OPERAND_FSR_INDEX, OPERAND_SIGNED_LITERAL, OPERAND_NONE}},
-    {"moviw", 2, 0x0010, 0x0000, 2, {0x0004, 0x0003}, {OPERAND_INDF_INDEX, OPERAND_INCREMENT_MODE, OPERAND_NONE}},
-    {"moviw", 2, 0x3f00, 0x0000, 2, {0x0040, 0x003f}, {OPERAND_INDF_INDEX, OPERAND_SIGNED_LITERAL, OPERAND_NONE}},
-    {"movwi", 2, 0x0018, 0x0000, 2, {0x0004, 0x0003}, {OPERAND_INDF_INDEX, OPERAND_INCREMENT_MODE, OPERAND_NONE}},
-    {"movwi", 2, 0x3f80, 0x0000, 2, {0x0040, 0x003f}, {OPERAND_INDF_INDEX, OPERAND_SIGNED_LITERAL, OPERAND_NONE}},
-    {"addwf", 2, 0x0700, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"andwf", 2, 0x0500, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"comf", 2, 0x0900, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"decf", 2, 0x0300, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"decfsz", 2, 0x0b00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"incf", 2, 0x0a00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"incfsz", 2, 0x0f00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"iorwf", 2, 0x0400, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"movf", 2, 0x0800, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"rlf", 2, 0x0d00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"rrf", 2, 0x0c00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"subwf", 2, 0x0200, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"swapf", 2, 0x0e00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"xorwf", 2, 0x0600, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}},
-    {"bcf", 2, 0x1000, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"bsf", 2, 0x1400, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"btfsc", 2, 0x1800, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"btfss", 2, 0x1c00, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}},
-    {"dw", 2, 0x0000, 0x0000, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE, OPERAND_NONE}},
-    {"db", 1, 0x0000, 0x0000, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE, OPERAND_NONE}},
+const struct picInstructionInfo PIC_Instruction_Set_Midrange_Enhanced[] = {
+    {"brw", 2, 0x000b, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"callw", 2, 0x000a, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"reset", 2, 0x0001, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"clrw", 2, 0x0100, 0x0003, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"nop", 2, 0x0000, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"option", 2, 0x0062, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"sleep", 2, 0x0063, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"clrwdt", 2, 0x0064, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"retfie", 2, 0x0009, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"return", 2, 0x0008, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"clrf", 2, 0x0180, 0x0000, 1, {0x007f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movlb", 2, 0x0020, 0x0000, 1, {0x001f}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movlp", 2, 0x3180, 0x0000, 1, {0x007f}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"bra", 2, 0x3200, 0x0000, 1, {0x01ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"movwf", 2, 0x0080, 0x0000, 1, {0x007f}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"addlw", 2, 0x3e00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"andlw", 2, 0x3900, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"call", 2, 0x2000, 0x0000, 1, {0x07ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"goto", 2, 0x2800, 0x0000, 1, {0x07ff}, {OPERAND_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"iorlw", 2, 0x3800, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movlw", 2, 0x3000, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"tris", 2, 0x0060, 0x0000, 1, {0x0007}, {OPERAND_REGISTER, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"retlw", 2, 0x3400, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"sublw", 2, 0x3c00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"xorlw", 2, 0x3a00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"addwfc", 2, 0x3d00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"subwfb", 2, 0x3b00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"lslf", 2, 0x3500, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"lsrf", 2, 0x3600, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"asrf", 2, 0x3700, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"addfsr", 2, 0x3100, 0x0000, 2, {0x0040, 0x003f}, {OPERAND_FSR_INDEX, OPERAND_SIGNED_LITERAL, OPERAND_NONE}, 1},
+    {"moviw", 2, 0x0010, 0x0000, 2, {0x0004, 0x0003}, {OPERAND_INDF_INDEX, OPERAND_INCREMENT_MODE, OPERAND_NONE}, 1},
+    {"moviw", 2, 0x3f00, 0x0000, 2, {0x0040, 0x003f}, {OPERAND_INDF_INDEX, OPERAND_SIGNED_LITERAL, OPERAND_NONE}, 1},
+    {"movwi", 2, 0x0018, 0x0000, 2, {0x0004, 0x0003}, {OPERAND_INDF_INDEX, OPERAND_INCREMENT_MODE, OPERAND_NONE}, 1},
+    {"movwi", 2, 0x3f80, 0x0000, 2, {0x0040, 0x003f}, {OPERAND_INDF_INDEX, OPERAND_SIGNED_LITERAL, OPERAND_NONE}, 1},
+    {"addwf", 2, 0x0700, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"andwf", 2, 0x0500, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"comf", 2, 0x0900, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"decf", 2, 0x0300, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"decfsz", 2, 0x0b00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"incf", 2, 0x0a00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"incfsz", 2, 0x0f00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"iorwf", 2, 0x0400, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"movf", 2, 0x0800, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"rlf", 2, 0x0d00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"rrf", 2, 0x0c00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"subwf", 2, 0x0200, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"swapf", 2, 0x0e00, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"xorwf", 2, 0x0600, 0x0000, 2, {0x007f, 0x0080}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_NONE}, 1},
+    {"bcf", 2, 0x1000, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"bsf", 2, 0x1400, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"btfsc", 2, 0x1800, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"btfss", 2, 0x1c00, 0x0000, 2, {0x007f, 0x0380}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_NONE}, 1},
+    {"dw", 2, 0x0000, 0x0000, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE, OPERAND_NONE}, 0},
+    {"db", 1, 0x0000, 0x0000, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE, OPERAND_NONE}, 0},
 };
 
-struct picInstructionInfo PIC_Instruction_Set_PIC18[] = {
-    {"sleep", 2, 0x0003, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"tblrd*", 2, 0x0008, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"tblrd*+", 2, 0x0009, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"tblrd*-", 2, 0x000a, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"tblrd+*", 2, 0x000b, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"tblwt*", 2, 0x000c, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"tblwt*+", 2, 0x000d, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"tblwt*-", 2, 0x000e, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"tblwt+*", 2, 0x000f, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"clrwdt", 2, 0x0004, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"daw", 2, 0x0007, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"nop", 2, 0x0000, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"nop", 2, 0xf000, 0x0fff, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"pop", 2, 0x0006, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"reset", 2, 0x00ff, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"push", 2, 0x0005, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}},
-    {"goto", 4, 0xef00, 0x0000, 1, {0x00ff}, {OPERAND_LONG_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bc", 2, 0xe200, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bn", 2, 0xe600, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bnc", 2, 0xe300, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bnn", 2, 0xe700, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bnov", 2, 0xe500, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bnz", 2, 0xe100, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bov", 2, 0xe400, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bra", 2, 0xd000, 0x0000, 1, {0x07ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"bz", 2, 0xe000, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"rcall", 2, 0xd800, 0x0000, 1, {0x07ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}},
-    {"retfie", 2, 0x0010, 0x0000, 1, {0x0001}, {OPERAND_BIT_FAST_CALLRETURN, OPERAND_NONE, OPERAND_NONE}},
-    {"retlw", 2, 0x0c00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"return", 2, 0x0012, 0x0000, 1, {0x0001}, {OPERAND_BIT_FAST_CALLRETURN, OPERAND_NONE, OPERAND_NONE}},
-    {"addlw", 2, 0x0f00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"andlw", 2, 0x0b00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"iorlw", 2, 0x0900, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"movlb", 2, 0x0100, 0x0000, 1, {0x000f}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"movlw", 2, 0x0e00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"mullw", 2, 0x0d00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"retlw", 2, 0x0c00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"sublw", 2, 0x0800, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"xorlw", 2, 0x0a00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}},
-    {"movff", 4, 0xc000, 0x0000, 2, {0x0fff}, {OPERAND_ABSOLUTE_DATA_ADDRESS, OPERAND_LONG_MOVFF_DATA_ADDRESS}},
-    {"call", 4, 0xec00, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_LONG_ABSOLUTE_PROG_ADDRESS, OPERAND_BIT_FAST_CALLRETURN, OPERAND_NONE}},
-    {"clrf", 2, 0x6a00, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"lfsr", 4, 0xee00, 0x0000, 2, {0x0030, 0x000f}, {OPERAND_FSR_INDEX, OPERAND_LONG_LFSR_LITERAL}},
-    {"cpfseq", 2, 0x6200, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"cpfsgt", 2, 0x6400, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"cpfslt", 2, 0x6000, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"movwf", 2, 0x6e00, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"mulwf", 2, 0x0200, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"negf", 2, 0x6c00, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"setf", 2, 0x6800, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"tstfsz", 2, 0x6600, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}},
-    {"addwf", 2, 0x2400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"addwfc", 2, 0x2000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"andwf", 2, 0x1400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"comf", 2, 0x1c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"decf", 2, 0x0400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"decfsz", 2, 0x2c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"dcfsnz", 2, 0x4c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"incf", 2, 0x2800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"incfsz", 2, 0x3c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"infsnz", 2, 0x4800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"iorwf", 2, 0x1000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"movf", 2, 0x5000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"rlcf", 2, 0x3400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"rlncf", 2, 0x4400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"rrcf", 2, 0x3000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"rrncf", 2, 0x4000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"subfwb", 2, 0x5400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"subwf", 2, 0x5c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"subwfb", 2, 0x5800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"swapf", 2, 0x3800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"xorwf", 2, 0x1800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}},
-    {"bcf", 2, 0x9000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}},
-    {"bsf", 2, 0x8000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}},
-    {"btfsc", 2, 0xb000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}},
-    {"btfss", 2, 0xa000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}},
-    {"btg", 2, 0x7000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}},
-    {"dw", 2, 0x0000, 0x0000, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE, OPERAND_NONE}},
-    {"db", 1, 0x0000, 0x0000, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE, OPERAND_NONE}},
+const struct picInstructionInfo PIC_Instruction_Set_PIC18[] = {
+    {"sleep", 2, 0x0003, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"tblrd*", 2, 0x0008, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"tblrd*+", 2, 0x0009, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"tblrd*-", 2, 0x000a, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"tblrd+*", 2, 0x000b, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"tblwt*", 2, 0x000c, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"tblwt*+", 2, 0x000d, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"tblwt*-", 2, 0x000e, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"tblwt+*", 2, 0x000f, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"clrwdt", 2, 0x0004, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"daw", 2, 0x0007, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"nop", 2, 0x0000, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"nop", 2, 0xf000, 0x0fff, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"pop", 2, 0x0006, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"reset", 2, 0x00ff, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"push", 2, 0x0005, 0x0000, 0, {0}, {OPERAND_NONE, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"goto", 4, 0xef00, 0x0000, 1, {0x00ff}, {OPERAND_LONG_ABSOLUTE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"bc", 2, 0xe200, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"bn", 2, 0xe600, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"bnc", 2, 0xe300, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"bnn", 2, 0xe700, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"bnov", 2, 0xe500, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"bnz", 2, 0xe100, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"bov", 2, 0xe400, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"bra", 2, 0xd000, 0x0000, 1, {0x07ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"bz", 2, 0xe000, 0x0000, 1, {0x00ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"rcall", 2, 0xd800, 0x0000, 1, {0x07ff}, {OPERAND_RELATIVE_PROG_ADDRESS, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"retfie", 2, 0x0010, 0x0000, 1, {0x0001}, {OPERAND_BIT_FAST_CALLRETURN, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"retlw", 2, 0x0c00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"return", 2, 0x0012, 0x0000, 1, {0x0001}, {OPERAND_BIT_FAST_CALLRETURN, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"addlw", 2, 0x0f00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"andlw", 2, 0x0b00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"iorlw", 2, 0x0900, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movlb", 2, 0x0100, 0x0000, 1, {0x000f}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movlw", 2, 0x0e00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"mullw", 2, 0x0d00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"retlw", 2, 0x0c00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 2},
+    {"sublw", 2, 0x0800, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"xorlw", 2, 0x0a00, 0x0000, 1, {0x00ff}, {OPERAND_LITERAL, OPERAND_NONE, OPERAND_NONE}, 1},
+    {"movff", 4, 0xc000, 0x0000, 2, {0x0fff}, {OPERAND_ABSOLUTE_DATA_ADDRESS, OPERAND_LONG_MOVFF_DATA_ADDRESS}, 2},
+    {"call", 4, 0xec00, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_LONG_ABSOLUTE_PROG_ADDRESS, OPERAND_BIT_FAST_CALLRETURN, OPERAND_NONE}, 2},
+    {"clrf", 2, 0x6a00, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"lfsr", 4, 0xee00, 0x0000, 2, {0x0030, 0x000f}, {OPERAND_FSR_INDEX, OPERAND_LONG_LFSR_LITERAL}, 2},
+    {"cpfseq", 2, 0x6200, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"cpfsgt", 2, 0x6400, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"cpfslt", 2, 0x6000, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"movwf", 2, 0x6e00, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"mulwf", 2, 0x0200, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"negf", 2, 0x6c00, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"setf", 2, 0x6800, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"tstfsz", 2, 0x6600, 0x0000, 2, {0x00ff, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_RAM_DEST, OPERAND_NONE}, 1},
+    {"addwf", 2, 0x2400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"addwfc", 2, 0x2000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"andwf", 2, 0x1400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"comf", 2, 0x1c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"decf", 2, 0x0400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"decfsz", 2, 0x2c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"dcfsnz", 2, 0x4c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"incf", 2, 0x2800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"incfsz", 2, 0x3c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"infsnz", 2, 0x4800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"iorwf", 2, 0x1000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"movf", 2, 0x5000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"rlcf", 2, 0x3400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"rlncf", 2, 0x4400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"rrcf", 2, 0x3000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"rrncf", 2, 0x4000, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"subfwb", 2, 0x5400, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"subwf", 2, 0x5c00, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"subwfb", 2, 0x5800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"swapf", 2, 0x3800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"xorwf", 2, 0x1800, 0x0000, 3, {0x00ff, 0x0200, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT_REG_DEST, OPERAND_BIT_RAM_DEST}, 1},
+    {"bcf", 2, 0x9000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}, 1},
+    {"bsf", 2, 0x8000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}, 1},
+    {"btfsc", 2, 0xb000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}, 1},
+    {"btfss", 2, 0xa000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}, 1},
+    {"btg", 2, 0x7000, 0x0000, 3, {0x00ff, 0x0e00, 0x0100}, {OPERAND_REGISTER, OPERAND_BIT, OPERAND_BIT_REG_DEST}, 1},
+    {"dw", 2, 0x0000, 0x0000, 1, {0xffff}, {OPERAND_RAW_WORD, OPERAND_NONE, OPERAND_NONE}, 0},
+    {"db", 1, 0x0000, 0x0000, 1, {0xff}, {OPERAND_RAW_BYTE, OPERAND_NONE, OPERAND_NONE}, 0},
 };
 
-struct picInstructionInfo *PIC_Instruction_Sets[] = {
-    [PIC_SUBARCH_BASELINE] (struct picInstructionInfo *)&PIC_Instruction_Set_Baseline,
-    [PIC_SUBARCH_MIDRANGE] (struct picInstructionInfo *)&PIC_Instruction_Set_Midrange,
-    [PIC_SUBARCH_MIDRANGE_ENHANCED] (struct picInstructionInfo *)&PIC_Instruction_Set_Midrange_Enhanced,
-    [PIC_SUBARCH_PIC18] (struct picInstructionInfo *)&PIC_Instruction_Set_PIC18,
+const struct picInstructionInfo *const PIC_Instruction_Sets[] = {
+    [PIC_SUBARCH_BASELINE] (const struct picInstructionInfo *)&PIC_Instruction_Set_Baseline,
+    [PIC_SUBARCH_MIDRANGE] (const struct picInstructionInfo *)&PIC_Instruction_Set_Midrange,
+    [PIC_SUBARCH_MIDRANGE_ENHANCED] (const struct picInstructionInfo *)&PIC_Instruction_Set_Midrange_Enhanced,
+    [PIC_SUBARCH_PIC18] (const struct picInstructionInfo *)&PIC_Instruction_Set_PIC18,
 };
 
 /* Total number of PIC instructions */
-int PIC_TOTAL_INSTRUCTIONS[] = {
+const int PIC_TOTAL_INSTRUCTIONS[] = {
     [PIC_SUBARCH_BASELINE] (sizeof(PIC_Instruction_Set_Baseline)/sizeof(PIC_Instruction_Set_Baseline[0])),
     [PIC_SUBARCH_MIDRANGE] (sizeof(PIC_Instruction_Set_Midrange)/sizeof(PIC_Instruction_Set_Midrange[0])),
     [PIC_SUBARCH_MIDRANGE_ENHANCED] (sizeof(PIC_Instruction_Set_Midrange_Enhanced)/sizeof(PIC_Instruction_Set_Midrange_Enhanced[0])),
@@ -54,13 +54,15 @@ struct picInstructionInfo {
     int numOperands;
     uint16_t operandMasks[3];
     int operandTypes[3];
+    /* Instruction cycles of four clocks, 0 if unknown */
+    unsigned int cycles;
 };
 
 /* Structure for a disassembled instruction */
 struct picInstructionDisasm {
     uint32_t address;
     uint8_t opcode[4];
-    struct picInstructionInfo *instructionInfo;
+    const struct picInstructionInfo *instructionInfo;
     int32_t operandDisasms[3];
 };
 
@@ -70,8 +72,8 @@ struct picDirective {
     uint32_t value;
 };
 
-extern struct picInstructionInfo *PIC_Instruction_Sets[];
-extern int PIC_TOTAL_INSTRUCTIONS[];
+extern const struct picInstructionInfo *const PIC_Instruction_Sets[];
+extern const int PIC_TOTAL_INSTRUCTIONS[];
 
 #endif
 
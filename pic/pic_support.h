@@ -1,6 +1,7 @@
 #ifndef PIC_SUPPORT_H
 #define PIC_SUPPORT_H
 
+#include <stdint.h>
 #include <disasmstream.h>
 #include <instruction.h>
 
@@ -25,5 +26,27 @@ int disasmstream_pic_pic18_init(struct DisasmStream *self);
 #define disasmstream_pic_pic18_close        disasmstream_pic_close
 #define disasmstream_pic_pic18_read         disasmstream_pic_read
 
+/* PIC Instruction Set Table Support */
+const char *pic_baseline_isa_mnemonic(unsigned int index);
+const char *pic_midrange_isa_mnemonic(unsigned int index);
+const char *pic_midrange_enhanced_isa_mnemonic(unsigned int index);
+const char *pic_pic18_isa_mnemonic(unsigned int index);
+/* Width in bytes of the instruction with the first opcode word opcode */
+unsigned int pic_baseline_isa_width(uint16_t opcode);
+unsigned int pic_midrange_isa_width(uint16_t opcode);
+unsigned int pic_midrange_enhanced_isa_width(uint16_t opcode);
+unsigned int pic_pic18_isa_width(uint16_t opcode);
+
+/* PIC Raw Data Support, for streams that decode bytes out of input order */
+/* Raw dw word "instruction" of the first two of len bytes at data, loaded
+ * at address, or db byte if len is 1. Returns the number of bytes used, or
+ * -1 on allocation failure. */
+int pic_baseline_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address);
+int pic_midrange_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address);
+int pic_midrange_enhanced_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address);
+int pic_pic18_disasm_raw(struct instruction *instr, const uint8_t *data, unsigned int len, uint32_t address);
+/* Origin directive for address, returns 0, or -1 on allocation failure */
+int pic_disasm_origin(struct instruction *instr, uint32_t address);
+
 #endif
 
@@ -181,7 +181,7 @@ static int test_disasm_pic_unit_test_run(char *name, int subarch, uint8_t *test_
     return -1;
 }
 
-static struct picInstructionInfo *util_iset_lookup_by_mnemonic(int subarch, char *mnemonic) {
+static const struct picInstructionInfo *util_iset_lookup_by_mnemonic(int subarch, char *mnemonic) {
     int i;
 
     for (i = 0; i < PIC_TOTAL_INSTRUCTIONS[subarch]; i++) {
@@ -202,7 +202,7 @@ static struct picInstructionInfo *util_iset_lookup_by_mnemonic(int subarch, char
 int test_disasm_pic_unit_tests(void) {
     int i;
     int numTests = 0, passedTests = 0;
-    struct picInstructionInfo *(*lookup)(int, char *) = util_iset_lookup_by_mnemonic;
+    const struct picInstructionInfo *(*lookup)(int, char *) = util_iset_lookup_by_mnemonic;
 
     /* Check Sample Baseline Program */
     /* clrw; clrf 0x15; incf 5, f; movf 0x15, W; bsf 0x15, 3; btfsc 0x15, 2;
@@ -0,0 +1,370 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <ring.h>
+#include <pipeline.h>
+
+/* Ring geometry: slots in flight, and bytes / instructions per slot */
+#define PIPELINE_RING_SLOTS         16
+#define PIPELINE_BYTE_BLOCK_LEN     4096
+#define PIPELINE_INSTR_BATCH_LEN    256
+
+/******************************************************************************/
+/* Pipeline Byte Stream Support */
+/******************************************************************************/
+
+/* Block of bytes passed from the parsing thread */
+struct pipeline_byte_block {
+    /* Return code after the last byte, 0 if the block is just full */
+    int ret;
+    /* Source error string accompanying ret */
+    char *error;
+    unsigned int len;
+    uint8_t data[PIPELINE_BYTE_BLOCK_LEN];
+    uint32_t address[PIPELINE_BYTE_BLOCK_LEN];
+};
+
+struct pipeline_bytestream_state {
+    struct ByteStream *source;
+    struct ring ring;
+    pthread_t thread;
+    int running;
+
+    /* Block being consumed, and the read index into it */
+    struct pipeline_byte_block *block;
+    unsigned int index;
+    /* Final return code once the source has finished */
+    int done;
+};
+
+int pipeline_bytestream_setup(struct ByteStream *self, struct ByteStream *source) {
+    struct pipeline_bytestream_state *state;
+
+    /* Allocate stream state, which carries the source until init */
+    state = self->state = calloc(1, sizeof(struct pipeline_bytestream_state));
+    if (state == NULL) {
+        self->error = "Error allocating pipeline stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->source = source;
+
+    self->in = source->in;
+    self->error = NULL;
+    self->stream_init = pipeline_bytestream_init;
+    self->stream_close = pipeline_bytestream_close;
+    self->stream_read = pipeline_bytestream_read;
+
+    return 0;
+}
+
+static void *pipeline_bytestream_thread(void *arg) {
+    struct pipeline_bytestream_state *state = (struct pipeline_bytestream_state *)arg;
+    struct pipeline_byte_block *block;
+    int ret;
+
+    do {
+        /* Wait for a free block, or bail out if the consumer closed early */
+        if ((block = ring_write_acquire(&state->ring)) == NULL)
+            break;
+
+        /* Fill the block from the source stream */
+        for (ret = 0, block->len = 0; block->len < PIPELINE_BYTE_BLOCK_LEN; block->len++) {
+            ret = state->source->stream_read(state->source, &block->data[block->len], &block->address[block->len]);
+            if (ret != 0)
+                break;
+        }
+        block->ret = ret;
+        block->error = state->source->error;
+
+        ring_write_commit(&state->ring);
+    /* Stop after the block carrying EOF or an error */
+    } while (ret == 0);
+
+    return NULL;
+}
+
+int pipeline_bytestream_init(struct ByteStream *self) {
+    struct pipeline_bytestream_state *state = (struct pipeline_bytestream_state *)self->state;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Allocate the ring before the source is initialized, so that a failure
+     * leaves nothing to close */
+    if (ring_init(&state->ring, PIPELINE_RING_SLOTS, sizeof(struct pipeline_byte_block)) < 0) {
+        self->error = "Error allocating pipeline ring!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    /* Initialize the source stream */
+    if (state->source->stream_init(state->source) < 0) {
+        self->error = state->source->error;
+        ring_free(&state->ring);
+        return STREAM_ERROR_INPUT;
+    }
+
+    /* Start the parsing thread, or read the source on this thread if it
+     * cannot start */
+    if (pthread_create(&state->thread, NULL, pipeline_bytestream_thread, state) != 0) {
+        ring_free(&state->ring);
+        return 0;
+    }
+    state->running = 1;
+
+    return 0;
+}
+
+int pipeline_bytestream_close(struct ByteStream *self) {
+    struct pipeline_bytestream_state *state = (struct pipeline_bytestream_state *)self->state;
+    int ret = 0;
+
+    /* Stop and join the parsing thread */
+    if (state->running) {
+        ring_close(&state->ring);
+        pthread_join(state->thread, NULL);
+    }
+    ring_free(&state->ring);
+
+    /* Close the source stream */
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free stream state memory */
+    free(state);
+
+    return ret;
+}
+
+int pipeline_bytestream_read(struct ByteStream *self, uint8_t *data, uint32_t *address) {
+    struct pipeline_bytestream_state *state = (struct pipeline_bytestream_state *)self->state;
+    int ret;
+
+    if (state->done)
+        return state->done;
+
+    /* No parsing thread, read the source directly */
+    if (!state->running) {
+        if ((ret = state->source->stream_read(state->source, data, address)) < 0)
+            self->error = state->source->error;
+        return ret;
+    }
+
+    /* Fetch the next block if we exhausted the current one */
+    while (state->block == NULL || state->index == state->block->len) {
+        if (state->block != NULL) {
+            /* Deliver the block's terminating return code */
+            if (state->block->ret != 0) {
+                state->done = state->block->ret;
+                self->error = state->block->error;
+                ring_read_release(&state->ring);
+                state->block = NULL;
+                return state->done;
+            }
+            ring_read_release(&state->ring);
+        }
+
+        state->block = ring_read_acquire(&state->ring);
+        state->index = 0;
+        if (state->block == NULL) {
+            self->error = "Pipeline ring closed unexpectedly!";
+            return STREAM_ERROR_FAILURE;
+        }
+    }
+
+    *data = state->block->data[state->index];
+    *address = state->block->address[state->index];
+    state->index++;
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Pipeline Disasm Stream Support */
+/******************************************************************************/
+
+/* Batch of disassembled instructions passed from the decoding thread */
+struct pipeline_instr_batch {
+    /* Return code after the last instruction, 0 if the batch is just full */
+    int ret;
+    /* Source error string accompanying ret */
+    char *error;
+    unsigned int len;
+    struct instruction instrs[PIPELINE_INSTR_BATCH_LEN];
+};
+
+struct pipeline_disasmstream_state {
+    struct DisasmStream *source;
+    struct ring ring;
+    pthread_t thread;
+    int running;
+
+    /* Batch being consumed, and the read index into it */
+    struct pipeline_instr_batch *batch;
+    unsigned int index;
+    /* Final return code once the source has finished */
+    int done;
+};
+
+int pipeline_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source) {
+    struct pipeline_disasmstream_state *state;
+
+    /* Allocate stream state, which carries the source until init */
+    state = self->state = calloc(1, sizeof(struct pipeline_disasmstream_state));
+    if (state == NULL) {
+        self->error = "Error allocating pipeline stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->source = source;
+
+    self->in = source->in;
+    self->error = NULL;
+    self->stream_init = pipeline_disasmstream_init;
+    self->stream_close = pipeline_disasmstream_close;
+    self->stream_read = pipeline_disasmstream_read;
+
+    return 0;
+}
+
+static void *pipeline_disasmstream_thread(void *arg) {
+    struct pipeline_disasmstream_state *state = (struct pipeline_disasmstream_state *)arg;
+    struct pipeline_instr_batch *batch;
+    int ret;
+
+    do {
+        /* Wait for a free batch, or bail out if the consumer closed early */
+        if ((batch = ring_write_acquire(&state->ring)) == NULL)
+            break;
+
+        /* Fill the batch from the source stream */
+        for (ret = 0, batch->len = 0; batch->len < PIPELINE_INSTR_BATCH_LEN; batch->len++) {
+            ret = state->source->stream_read(state->source, &batch->instrs[batch->len]);
+            if (ret != 0)
+                break;
+        }
+        batch->ret = ret;
+        batch->error = state->source->error;
+
+        ring_write_commit(&state->ring);
+    /* Stop after the batch carrying EOF or an error */
+    } while (ret == 0);
+
+    return NULL;
+}
+
+int pipeline_disasmstream_init(struct DisasmStream *self) {
+    struct pipeline_disasmstream_state *state = (struct pipeline_disasmstream_state *)self->state;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Allocate the ring before the source is initialized, so that a failure
+     * leaves nothing to close */
+    if (ring_init(&state->ring, PIPELINE_RING_SLOTS, sizeof(struct pipeline_instr_batch)) < 0) {
+        self->error = "Error allocating pipeline ring!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    /* Initialize the source stream */
+    if (state->source->stream_init(state->source) < 0) {
+        self->error = state->source->error;
+        ring_free(&state->ring);
+        return STREAM_ERROR_INPUT;
+    }
+
+    /* Start the decoding thread, or read the source on this thread if it
+     * cannot start */
+    if (pthread_create(&state->thread, NULL, pipeline_disasmstream_thread, state) != 0) {
+        ring_free(&state->ring);
+        return 0;
+    }
+    state->running = 1;
+
+    return 0;
+}
+
+int pipeline_disasmstream_close(struct DisasmStream *self) {
+    struct pipeline_disasmstream_state *state = (struct pipeline_disasmstream_state *)self->state;
+    struct pipeline_instr_batch *batch;
+    int ret = 0;
+
+    /* Stop and join the decoding thread */
+    if (state->running) {
+        ring_close(&state->ring);
+        pthread_join(state->thread, NULL);
+    }
+
+    /* Free any instructions left unconsumed in the ring */
+    if (state->batch != NULL) {
+        for (; state->index < state->batch->len; state->index++)
+            state->batch->instrs[state->index].free(&state->batch->instrs[state->index]);
+        ring_read_release(&state->ring);
+    }
+    while (state->running && (batch = ring_read_acquire(&state->ring)) != NULL) {
+        for (state->index = 0; state->index < batch->len; state->index++)
+            batch->instrs[state->index].free(&batch->instrs[state->index]);
+        ring_read_release(&state->ring);
+    }
+    ring_free(&state->ring);
+
+    /* Close the source stream */
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free stream state memory */
+    free(state);
+
+    return ret;
+}
+
+int pipeline_disasmstream_read(struct DisasmStream *self, struct instruction *instr) {
+    struct pipeline_disasmstream_state *state = (struct pipeline_disasmstream_state *)self->state;
+    int ret;
+
+    if (state->done)
+        return state->done;
+
+    /* No decoding thread, read the source directly */
+    if (!state->running) {
+        if ((ret = state->source->stream_read(state->source, instr)) < 0)
+            self->error = state->source->error;
+        return ret;
+    }
+
+    /* Fetch the next batch if we exhausted the current one */
+    while (state->batch == NULL || state->index == state->batch->len) {
+        if (state->batch != NULL) {
+            /* Deliver the batch's terminating return code */
+            if (state->batch->ret != 0) {
+                state->done = state->batch->ret;
+                self->error = state->batch->error;
+                ring_read_release(&state->ring);
+                state->batch = NULL;
+                return state->done;
+            }
+            ring_read_release(&state->ring);
+        }
+
+        state->batch = ring_read_acquire(&state->ring);
+        state->index = 0;
+        if (state->batch == NULL) {
+            self->error = "Pipeline ring closed unexpectedly!";
+            return STREAM_ERROR_FAILURE;
+        }
+    }
+
+    /* Hand over ownership of the instruction */
+    *instr = state->batch->instrs[state->index];
+    state->index++;
+
+    return 0;
+}
+
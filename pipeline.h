@@ -0,0 +1,34 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <bytestream.h>
+#include <disasmstream.h>
+
+/* Pipeline Stream Support
+ *
+ * A pipeline stream runs its source stream on a dedicated thread and hands
+ * blocks of bytes (ByteStream) or batches of disassembled instructions
+ * (DisasmStream) to the consuming thread through a bounded lock-free ring.
+ * Wrapping both the ByteStream and the DisasmStream lets parsing, decoding
+ * and printing proceed concurrently on three threads. Errors and EOF from the
+ * source are delivered in stream order, along with the source's error string.
+ * If the thread cannot be created, the stream reads its source on the
+ * consuming thread instead.
+ */
+
+/* Setup self as a pipelined version of the source stream */
+int pipeline_bytestream_setup(struct ByteStream *self, struct ByteStream *source);
+int pipeline_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source);
+
+/* Pipeline Byte Stream Support */
+int pipeline_bytestream_init(struct ByteStream *self);
+int pipeline_bytestream_close(struct ByteStream *self);
+int pipeline_bytestream_read(struct ByteStream *self, uint8_t *data, uint32_t *address);
+
+/* Pipeline Disasm Stream Support */
+int pipeline_disasmstream_init(struct DisasmStream *self);
+int pipeline_disasmstream_close(struct DisasmStream *self);
+int pipeline_disasmstream_read(struct DisasmStream *self, struct instruction *instr);
+
+#endif
+
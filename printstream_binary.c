@@ -0,0 +1,367 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <printstream.h>
+#include <instruction.h>
+#include <printstream_record.h>
+#include <printstream_binary.h>
+#include <printstream_file.h>
+
+/* Maximum number of operands in a record */
+#define BINARY_MAX_OPERANDS     3
+/* Maximum number of opcode bytes in a record */
+#define BINARY_MAX_OPCODES      4
+
+const char *const Binary_Directive_Names[PRINTSTREAM_BINARY_NUM_DIRECTIVES] = {"org", "end"};
+#define BINARY_TOTAL_DIRECTIVES     PRINTSTREAM_BINARY_NUM_DIRECTIVES
+#define BINARY_TOTAL_OPERAND_KINDS  (OPERAND_KIND_RAW+1)
+
+/* Print Stream State */
+struct printstream_binary_state {
+    /* Print Option Bit Flags */
+    unsigned int flags;
+
+    const char *arch_name;
+    isa_mnemonic_func isa_mnemonic;
+    /* Header written */
+    int header;
+    /* Running address of compact records */
+    struct printstream_binary_cursor cursor;
+};
+
+/******************************************************************************/
+/* Little-endian Encoding */
+/******************************************************************************/
+
+static void util_put_u16(uint8_t *dest, uint16_t value) {
+    dest[0] = value & 0xff;
+    dest[1] = (value >> 8) & 0xff;
+}
+
+static void util_put_u32(uint8_t *dest, uint32_t value) {
+    dest[0] = value & 0xff;
+    dest[1] = (value >> 8) & 0xff;
+    dest[2] = (value >> 16) & 0xff;
+    dest[3] = (value >> 24) & 0xff;
+}
+
+/* LEB128, returns the number of bytes */
+static unsigned int util_put_varint(uint8_t *dest, uint32_t value) {
+    unsigned int len = 0;
+
+    while (value >= 0x80) {
+        dest[len++] = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    dest[len++] = value;
+
+    return len;
+}
+
+static unsigned int util_put_delta(uint8_t *dest, int32_t delta) {
+    return util_put_varint(dest, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+}
+
+/******************************************************************************/
+/* Binary Record Print Stream Support */
+/******************************************************************************/
+
+int printstream_binary_setup(struct PrintStream *self, const char *arch_name, isa_mnemonic_func isa_mnemonic) {
+    struct printstream_binary_state *state;
+
+    /* Allocate stream state, which carries the architecture until init */
+    state = self->state = calloc(1, sizeof(struct printstream_binary_state));
+    if (state == NULL) {
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->arch_name = arch_name;
+    state->isa_mnemonic = isa_mnemonic;
+
+    self->error = NULL;
+    self->stream_init = printstream_binary_init;
+    self->stream_close = printstream_binary_close;
+    self->stream_read = printstream_binary_read;
+
+    return 0;
+}
+
+int printstream_compact_setup(struct PrintStream *self, const char *arch_name, isa_mnemonic_func isa_mnemonic) {
+    int ret;
+
+    if ((ret = printstream_binary_setup(self, arch_name, isa_mnemonic)) < 0)
+        return ret;
+    self->stream_read = printstream_compact_read;
+
+    return 0;
+}
+
+int printstream_binary_init(struct PrintStream *self, int flags) {
+    struct printstream_binary_state *state = (struct printstream_binary_state *)self->state;
+
+    state->flags = flags;
+    state->header = (flags & PRINT_FLAG_NO_HEADER) ? 1 : 0;
+    /* Output without a header continues the running address before it */
+    state->cursor.address = 0;
+    state->cursor.known = state->header ? 0 : 1;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the input stream */
+    if (self->in->stream_init(self->in) < 0) {
+        self->error = "Error in input stream initialization!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int printstream_binary_close(struct PrintStream *self) {
+    /* Free stream state memory */
+    free(self->state);
+
+    /* Close input stream */
+    if (self->in->stream_close(self->in) < 0) {
+        self->error = "Error in input stream close!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+/* Write the header for records of record_size bytes, 0 for compact records */
+static int util_write_header(struct PrintStream *self, FILE *out, unsigned int record_size) {
+    struct printstream_binary_state *state = (struct printstream_binary_state *)self->state;
+    uint8_t *header;
+    const char *str;
+    uint32_t num_mnemonics, strings_len, header_size, len, i;
+
+    /* Size the string table */
+    strings_len = 0;
+    for (num_mnemonics = 0; (str = state->isa_mnemonic(num_mnemonics)) != NULL; num_mnemonics++)
+        strings_len += strlen(str) + 1;
+    for (i = 0; i < BINARY_TOTAL_OPERAND_KINDS; i++)
+        strings_len += strlen(Operand_Kind_Names[i]) + 1;
+    for (i = 0; i < BINARY_TOTAL_DIRECTIVES; i++)
+        strings_len += strlen(Binary_Directive_Names[i]) + 1;
+
+    /* Round the header up to a whole number of fixed size records */
+    header_size = 48 + strings_len;
+    if (record_size > 0)
+        header_size = (header_size + record_size - 1) / record_size * record_size;
+
+    header = calloc(1, header_size);
+    if (header == NULL) {
+        self->error = "Error allocating binary record header!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    memcpy(header, "UCDISREC", 8);
+    util_put_u16(header + 8, PRINTSTREAM_BINARY_VERSION);
+    util_put_u16(header + 10, record_size);
+    util_put_u32(header + 12, header_size);
+    strncpy((char *)header + 16, state->arch_name, 15);
+    util_put_u32(header + 32, num_mnemonics);
+    util_put_u32(header + 36, BINARY_TOTAL_OPERAND_KINDS);
+    util_put_u32(header + 40, BINARY_TOTAL_DIRECTIVES);
+    util_put_u32(header + 44, strings_len);
+
+    /* String table */
+    len = 48;
+    for (i = 0; i < num_mnemonics; i++) {
+        str = state->isa_mnemonic(i);
+        memcpy(header + len, str, strlen(str) + 1);
+        len += strlen(str) + 1;
+    }
+    for (i = 0; i < BINARY_TOTAL_OPERAND_KINDS; i++) {
+        memcpy(header + len, Operand_Kind_Names[i], strlen(Operand_Kind_Names[i]) + 1);
+        len += strlen(Operand_Kind_Names[i]) + 1;
+    }
+    for (i = 0; i < BINARY_TOTAL_DIRECTIVES; i++) {
+        memcpy(header + len, Binary_Directive_Names[i], strlen(Binary_Directive_Names[i]) + 1);
+        len += strlen(Binary_Directive_Names[i]) + 1;
+    }
+
+    if (fwrite(header, 1, header_size, out) != header_size) {
+        free(header);
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+    free(header);
+
+    state->header = 1;
+
+    return 0;
+}
+
+/* Look up the directive index from the directive's name, e.g. ".org" */
+static unsigned int util_directive_index(struct instruction *instr, int flags) {
+    char name[16], *p;
+    unsigned int i;
+
+    instr->get_str_mnemonic(instr, name, sizeof(name), flags);
+    p = (name[0] == '.') ? name + 1 : name;
+
+    for (i = 0; i < BINARY_TOTAL_DIRECTIVES; i++) {
+        if (strcmp(p, Binary_Directive_Names[i]) == 0)
+            return i;
+    }
+
+    return 0xffff;
+}
+
+void printstream_binary_encode(struct instruction *instr, uint8_t *record, int flags) {
+    uint8_t opcodes[8];
+    uint32_t target;
+    unsigned int i, numOperands, width;
+
+    memset(record, 0, PRINTSTREAM_BINARY_RECORD_SIZE);
+
+    numOperands = instr->get_num_operands(instr);
+    if (numOperands > BINARY_MAX_OPERANDS)
+        numOperands = BINARY_MAX_OPERANDS;
+
+    if (instr->type == DISASM_TYPE_DIRECTIVE) {
+        util_put_u16(record + 4, util_directive_index(instr, flags));
+        record[6] = 1;
+        util_put_u32(record + 28, 0xffffffff);
+    } else {
+        util_put_u32(record + 0, instr->get_address(instr));
+        util_put_u16(record + 4, instr->get_isa_index(instr));
+        width = instr->get_opcodes(instr, opcodes);
+        record[7] = width;
+        memcpy(record + 8, opcodes, (width < BINARY_MAX_OPCODES) ? width : BINARY_MAX_OPCODES);
+        util_put_u32(record + 28, instr->get_branch_target(instr, &target) ? target : 0xffffffff);
+    }
+
+    record[12] = numOperands;
+    for (i = 0; i < numOperands; i++) {
+        record[13 + i] = instr->get_operand_kind(instr, i);
+        util_put_u32(record + 16 + 4*i, (uint32_t)instr->get_operand_value(instr, i));
+    }
+}
+
+unsigned int printstream_binary_encode_compact(struct instruction *instr, uint8_t *record, struct printstream_binary_cursor *cursor, int flags) {
+    uint8_t opcodes[8];
+    uint32_t address, target;
+    unsigned int len = 1, index, width;
+
+    if (instr->type == DISASM_TYPE_DIRECTIVE) {
+        index = util_directive_index(instr, flags);
+        record[0] = BINARY_FLAG_DIRECTIVE;
+        len += util_put_varint(record + len, index);
+        if (instr->get_num_operands(instr) > 0) {
+            record[0] |= BINARY_FLAG_ADDRESS;
+            len += util_put_varint(record + len, (uint32_t)instr->get_operand_value(instr, 0));
+            /* An origin sets the running address */
+            if (index == 0) {
+                cursor->address = instr->get_operand_value(instr, 0);
+                cursor->known = 1;
+            }
+        }
+        return len;
+    }
+
+    address = instr->get_address(instr);
+    if (!cursor->known) {
+        cursor->address = address;
+        cursor->known = 1;
+    }
+
+    width = instr->get_opcodes(instr, opcodes);
+    if (width > BINARY_MAX_OPCODES)
+        width = BINARY_MAX_OPCODES;
+    index = instr->get_isa_index(instr);
+
+    record[0] = width;
+    len += util_put_varint(record + len, index);
+    if (address != cursor->address) {
+        record[0] |= BINARY_FLAG_ADDRESS;
+        len += util_put_delta(record + len, (int32_t)(address - cursor->address));
+    }
+    memcpy(record + len, opcodes, width);
+    len += width;
+    if (instr->get_branch_target(instr, &target)) {
+        record[0] |= BINARY_FLAG_TARGET;
+        len += util_put_delta(record + len, (int32_t)(target - address));
+    }
+
+    cursor->address = address + instr->get_width(instr);
+
+    return len;
+}
+
+int printstream_binary_read(struct PrintStream *self, FILE *out) {
+    struct printstream_binary_state *state = (struct printstream_binary_state *)self->state;
+    struct instruction instr;
+    uint8_t record[PRINTSTREAM_BINARY_RECORD_SIZE];
+    int ret;
+
+    /* Write the header ahead of the first record, even for an empty stream */
+    if (!state->header && (ret = util_write_header(self, out, PRINTSTREAM_BINARY_RECORD_SIZE)) < 0)
+        return ret;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, &instr);
+    switch (ret) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    printstream_binary_encode(&instr, record, state->flags);
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    if (fwrite(record, 1, sizeof(record), out) != sizeof(record)) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+
+    return 0;
+}
+
+int printstream_compact_read(struct PrintStream *self, FILE *out) {
+    struct printstream_binary_state *state = (struct printstream_binary_state *)self->state;
+    struct instruction instr;
+    uint8_t record[PRINTSTREAM_BINARY_MAX_COMPACT];
+    unsigned int len;
+    int ret;
+
+    /* Write the header ahead of the first record, even for an empty stream */
+    if (!state->header && (ret = util_write_header(self, out, 0)) < 0)
+        return ret;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, &instr);
+    switch (ret) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    len = printstream_binary_encode_compact(&instr, record, &state->cursor, state->flags);
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    if (fwrite(record, 1, len, out) != len) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+
+    return 0;
+}
+
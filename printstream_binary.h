@@ -0,0 +1,109 @@
+#ifndef PRINTSTREAM_BINARY_H
+#define PRINTSTREAM_BINARY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <printstream.h>
+
+/* Binary Record Print Stream Support
+ *
+ * Writes the decoded stream as fixed size little-endian records behind a
+ * self-describing header, so that tools can mmap the output and index it
+ * directly. The record count is (file size - header size) / record size.
+ *
+ * Header:
+ *   0   char[8]    magic "UCDISREC"
+ *   8   uint16     version (1)
+ *   10  uint16     record size (32), or 0 for compact records
+ *   12  uint32     header size, a multiple of the record size
+ *   16  char[16]   architecture name, NUL padded
+ *   32  uint32     number of mnemonics (instruction set table entries)
+ *   36  uint32     number of operand kind names
+ *   40  uint32     number of directive names
+ *   44  uint32     string table length
+ *   48  ...        string table: the mnemonics, operand kind names and
+ *                  directive names, each NUL terminated, then zero padding
+ *
+ * Record:
+ *   0   uint32     address (0 for directives)
+ *   4   uint16     instruction set table index, or directive index
+ *   6   uint8      type (0 instruction, 1 directive)
+ *   7   uint8      width
+ *   8   uint8[4]   opcode bytes, zero padded
+ *   12  uint8      number of operands
+ *   13  uint8[3]   operand kinds (OPERAND_KIND_*)
+ *   16  int32[3]   operand values
+ *   28  uint32     branch target, 0xffffffff if none
+ *
+ * The compact print stream (-O compact) writes the same header, with a
+ * record size of 0 and no padding, then records only as long as their
+ * instructions, for storage rather than direct indexing. Operands are left
+ * to the opcode bytes:
+ *
+ * Compact record:
+ *   0   uint8      flags: bits 0-2 width, the number of opcode bytes that
+ *                  follow, and the BINARY_FLAG_* bits
+ *   1   varint     instruction set table index, or directive index
+ *   .   varint     address delta of an instruction, or unsigned operand
+ *                  of a directive, if BINARY_FLAG_ADDRESS
+ *   .   uint8[]    opcode bytes
+ *   .   varint     branch target delta from the address, if
+ *                  BINARY_FLAG_TARGET
+ *
+ * Varints are LEB128, 7 bits per byte from the least significant, with the
+ * high bit set on all but the last byte; deltas are zigzag encoded first,
+ * (n << 1) ^ (n >> 31). The reader keeps a running address, from 0: an
+ * instruction is at the running address plus its delta, 0 without
+ * BINARY_FLAG_ADDRESS, and moves it past the instruction, and an origin
+ * directive sets it to its operand. Output without a header, as of the
+ * shards after the first, continues the running address of the output
+ * before it.
+ */
+
+#define PRINTSTREAM_BINARY_VERSION          1
+#define PRINTSTREAM_BINARY_RECORD_SIZE      32
+#define PRINTSTREAM_BINARY_NUM_DIRECTIVES   2
+/* Longest compact record */
+#define PRINTSTREAM_BINARY_MAX_COMPACT      24
+
+/* Compact record flags */
+enum {
+    BINARY_FLAG_DIRECTIVE   = (1<<3),
+    BINARY_FLAG_ADDRESS     = (1<<4),
+    BINARY_FLAG_TARGET      = (1<<5),
+};
+
+/* Running address of compact records */
+struct printstream_binary_cursor {
+    uint32_t address;
+    /* Unknown until the first instruction, which is taken to continue it */
+    int known;
+};
+
+/* Directive names, indexed by the directive index of a directive record */
+extern const char *const Binary_Directive_Names[PRINTSTREAM_BINARY_NUM_DIRECTIVES];
+
+/* Encode an instruction or directive as a record of
+ * PRINTSTREAM_BINARY_RECORD_SIZE bytes */
+void printstream_binary_encode(struct instruction *instr, uint8_t *record, int flags);
+
+/* Encode an instruction or directive as a compact record of at most
+ * PRINTSTREAM_BINARY_MAX_COMPACT bytes, after the records of cursor, and
+ * returns its length */
+unsigned int printstream_binary_encode_compact(struct instruction *instr, uint8_t *record, struct printstream_binary_cursor *cursor, int flags);
+
+/* Setup self as a binary record print stream for the architecture */
+int printstream_binary_setup(struct PrintStream *self, const char *arch_name, isa_mnemonic_func isa_mnemonic);
+
+int printstream_binary_init(struct PrintStream *self, int flags);
+int printstream_binary_close(struct PrintStream *self);
+int printstream_binary_read(struct PrintStream *self, FILE *out);
+
+/* Setup self as a compact record print stream for the architecture, with
+ * the init and close of the binary record print stream */
+int printstream_compact_setup(struct PrintStream *self, const char *arch_name, isa_mnemonic_func isa_mnemonic);
+
+int printstream_compact_read(struct PrintStream *self, FILE *out);
+
+#endif
+
@@ -0,0 +1,142 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <printstream.h>
+#include <instruction.h>
+#include <printstream_file.h>
+#include <printstream_cycles.h>
+#include <cfg.h>
+
+/* Print Stream State */
+struct printstream_cycles_state {
+    /* Print Option Bit Flags */
+    unsigned int flags;
+
+    struct cfg cfg;
+    /* Summary written */
+    int written;
+};
+
+/******************************************************************************/
+/* Cycle Count Print Stream Support */
+/******************************************************************************/
+
+int printstream_cycles_init(struct PrintStream *self, int flags) {
+    struct printstream_cycles_state *state;
+
+    /* Allocate stream state */
+    state = self->state = calloc(1, sizeof(struct printstream_cycles_state));
+    if (state == NULL) {
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->flags = flags | PRINT_FLAG_CYCLES;
+    cfg_init(&state->cfg, PRINT_CYCLES_VARIANT(flags));
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the input stream */
+    if (self->in->stream_init(self->in) < 0) {
+        self->error = "Error in input stream initialization!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int printstream_cycles_close(struct PrintStream *self) {
+    struct printstream_cycles_state *state = (struct printstream_cycles_state *)self->state;
+
+    /* Free stream state memory */
+    cfg_free(&state->cfg);
+    free(self->state);
+
+    /* Close input stream */
+    if (self->in->stream_close(self->in) < 0) {
+        self->error = "Error in input stream close!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+/* Write the basic block summary */
+static int util_write_summary(struct PrintStream *self, FILE *out) {
+    struct printstream_cycles_state *state = (struct printstream_cycles_state *)self->state;
+    const struct cfg_block *block;
+    unsigned long long min, max;
+    size_t i;
+
+    if (cfg_build(&state->cfg) < 0) {
+        self->error = "Error allocating basic block leaders!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    for (i = 0; i < state->cfg.num_blocks; i++) {
+        block = &state->cfg.blocks[i];
+        fprintf(out, "; block 0x%04x-0x%04x: %u instruction%s, ", block->start, block->end, block->count, (block->count == 1) ? "" : "s");
+        if (!cfg_block_cycles(&state->cfg, block, &min, &max))
+            fputs("unknown cycles\n", out);
+        else if (min == max)
+            fprintf(out, "%llu cycle%s\n", min, (min == 1) ? "" : "s");
+        else
+            fprintf(out, "%llu-%llu cycles\n", min, max);
+    }
+
+    if (ferror(out)) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+
+    state->written = 1;
+
+    return 0;
+}
+
+int printstream_cycles_read(struct PrintStream *self, FILE *out) {
+    struct printstream_cycles_state *state = (struct printstream_cycles_state *)self->state;
+    struct instruction instr;
+    char line[PRINTSTREAM_FILE_LINE_LEN];
+    int len, ret;
+
+    if (state->written)
+        return STREAM_EOF;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, &instr);
+    switch (ret) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            /* Write the summary at the end of the stream */
+            if ((ret = util_write_summary(self, out)) < 0)
+                return ret;
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    /* Keep the record of an instruction */
+    if (cfg_add(&state->cfg, &instr) < 0) {
+        instr.free(&instr);
+        self->error = "Error allocating instruction records!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    /* Format the line and write it out in one go */
+    len = printstream_file_format(&instr, line, sizeof(line), state->flags);
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    if (len > 0 && fputs(line, out) < 0) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+
+    return 0;
+}
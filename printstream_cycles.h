@@ -0,0 +1,35 @@
+#ifndef PRINTSTREAM_CYCLES_H
+#define PRINTSTREAM_CYCLES_H
+
+#include <stdio.h>
+#include <printstream.h>
+
+/* Cycle Count Print Stream Support
+ *
+ * Writes the text listing with the cycle column of PRINT_FLAG_CYCLES, for
+ * the core variant of PRINT_FLAG_CYCLES_VARIANT(), and after it one comment
+ * line per basic block of the listed code with its shortest and longest
+ * time in cycles:
+ *
+ *   ; block 0x0004-0x000c: 4 instructions, 5-6 cycles
+ *
+ * A basic block starts at the first instruction, at a branch, jump, or call
+ * target, after a branch, skip, jump, call, or return, and after raw data or
+ * a gap in the addresses. Its time adds up the cycles of its instructions,
+ * with the shorter and the longer of the next and taken cycles of its last
+ * one; a skip of a two word instruction takes one cycle more. The time of a
+ * called function is not included. A block with an instruction of unknown
+ * timing has "unknown" cycles.
+ *
+ * The listing is written as it is read, while a compact record of the
+ * address, width, flow, target, and cycles of each instruction is kept
+ * until the end of the stream, charged to the memory budget.
+ */
+
+/* Print Stream Support */
+int printstream_cycles_init(struct PrintStream *self, int flags);
+int printstream_cycles_close(struct PrintStream *self);
+int printstream_cycles_read(struct PrintStream *self, FILE *out);
+
+#endif
+
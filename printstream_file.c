@@ -54,118 +54,135 @@ int printstream_file_close(struct PrintStream *self) {
     return 0;
 }
 
-int printstream_file_read(struct PrintStream *self, FILE *out) {
-    struct printstream_file_state *state = (struct printstream_file_state *)self->state;
-    struct instruction instr;
-    char str[128];
-    int i, ret;
-
-    /* Read a disassembled instruction */
-    ret = self->in->stream_read(self->in, &instr);
-    switch (ret) {
-        case 0:
-            break;
-        case STREAM_EOF:
-            return STREAM_EOF;
-        default:
-            self->error = "Error in disasm stream read!";
-            return STREAM_ERROR_INPUT;
+/* Append src to the line, truncating at the end of dest */
+static void util_line_append(char *dest, int size, int *len, const char *src) {
+    for (; *src != '\0'; src++) {
+        if (*len < size - 1)
+            dest[*len] = *src;
+        (*len)++;
     }
+}
+
+int printstream_file_format(struct instruction *instr, char *dest, int size, int flags) {
+    struct instruction_cycles cycles;
+    char str[128];
+    int i, len = 0;
 
-    #define print_str() do { if (fputs(str, out) < 0) goto fputs_error; } while(0)
-    #define print_comma() do { if (fputs(", ", out) < 0) goto fputs_error; } while(0)
-    #define print_newline() do { if (fputs("\n", out) < 0) goto fputs_error; } while(0)
-    #define print_tab() do { if (fputs("\t", out) < 0) goto fputs_error; } while (0)
+    if (size <= 0)
+        return -1;
 
     /* If the disassembly stream emitted a directive instead of an instruction */
-    if (instr.type == DISASM_TYPE_DIRECTIVE) {
+    if (instr->type == DISASM_TYPE_DIRECTIVE) {
         /* If we're not outputting assembly, skip it */
-        if (!(state->flags & PRINT_FLAG_ASSEMBLY)) {
-            instr.free(&instr);
+        if (!(flags & PRINT_FLAG_ASSEMBLY)) {
+            dest[0] = '\0';
             return 0;
         }
 
-        print_tab();
+        util_line_append(dest, size, &len, "\t");
 
         /* Print the directive name */
-        instr.get_str_mnemonic(&instr, str, sizeof(str), state->flags);
-        print_str();
-        print_tab();
+        instr->get_str_mnemonic(instr, str, sizeof(str), flags);
+        util_line_append(dest, size, &len, str);
+        util_line_append(dest, size, &len, "\t");
 
         /* Print the directive operands */
-        for (i = 0; ; i++) {
-            /* Print this operand index i */
-            if (instr.get_str_operand(&instr, str, sizeof(str), i, state->flags) > 0) {
-                if (i > 0) print_comma();
-                print_str();
-            /* No more operands to print */
-            } else {
-                break;
-            }
+        for (i = 0; instr->get_str_operand(instr, str, sizeof(str), i, flags) > 0; i++) {
+            if (i > 0) util_line_append(dest, size, &len, ", ");
+            util_line_append(dest, size, &len, str);
         }
 
-        print_newline();
+        util_line_append(dest, size, &len, "\n");
+        dest[(len < size) ? len : size - 1] = '\0';
 
-        /* Free the allocated directive */
-        instr.free(&instr);
-
-        return 0;
+        return len;
     }
 
     /* Print an address label if we're printing assembly */
-    if (state->flags & PRINT_FLAG_ASSEMBLY) {
-        instr.get_str_address_label(&instr, str, sizeof(str), state->flags);
-        print_str();
-        print_tab();
+    if (flags & PRINT_FLAG_ASSEMBLY) {
+        instr->get_str_address_label(instr, str, sizeof(str), flags);
+        util_line_append(dest, size, &len, str);
+        util_line_append(dest, size, &len, "\t");
     /* Or print an normal address */
-    } else if (state->flags & PRINT_FLAG_ADDRESSES) {
-        instr.get_str_address(&instr, str, sizeof(str), state->flags);
-        print_str();
-        print_tab();
+    } else if (flags & PRINT_FLAG_ADDRESSES) {
+        instr->get_str_address(instr, str, sizeof(str), flags);
+        util_line_append(dest, size, &len, str);
+        util_line_append(dest, size, &len, "\t");
     }
 
     /* Print the opcodes */
-    if (state->flags & PRINT_FLAG_OPCODES) {
-        instr.get_str_opcodes(&instr, str, sizeof(str), state->flags);
-        print_str();
-        print_tab();
+    if (flags & PRINT_FLAG_OPCODES) {
+        instr->get_str_opcodes(instr, str, sizeof(str), flags);
+        util_line_append(dest, size, &len, str);
+        util_line_append(dest, size, &len, "\t");
+    }
+
+    /* Print the instruction cycles */
+    if (flags & PRINT_FLAG_CYCLES) {
+        if (instr->get_cycles(instr, PRINT_CYCLES_VARIANT(flags), &cycles) == 0)
+            snprintf(str, sizeof(str), "-");
+        else if (cycles.taken != cycles.next)
+            snprintf(str, sizeof(str), "%u/%u", cycles.next, cycles.taken);
+        else
+            snprintf(str, sizeof(str), "%u", cycles.next);
+        util_line_append(dest, size, &len, str);
+        util_line_append(dest, size, &len, "\t");
     }
 
     /* Print the mnemonic */
-    instr.get_str_mnemonic(&instr, str, sizeof(str), state->flags);
-    print_str();
-    print_tab();
+    instr->get_str_mnemonic(instr, str, sizeof(str), flags);
+    util_line_append(dest, size, &len, str);
+    util_line_append(dest, size, &len, "\t");
 
     /* Print the operands */
-    for (i = 0; ; i++) {
-        /* Print this operand index i */
-        if (instr.get_str_operand(&instr, str, sizeof(str), i, state->flags) > 0) {
-            if (i > 0) print_comma();
-            print_str();
-        /* No more operands to print */
-        } else {
-            break;
-        }
+    for (i = 0; instr->get_str_operand(instr, str, sizeof(str), i, flags) > 0; i++) {
+        if (i > 0) util_line_append(dest, size, &len, ", ");
+        util_line_append(dest, size, &len, str);
     }
 
     /* Print a comment (e.g. destination address comment) */
-    if (state->flags & PRINT_FLAG_DESTINATION_COMMENT) {
-        if (instr.get_str_comment(&instr, str, sizeof(str), state->flags) > 0) {
-            print_tab();
-            print_str();
+    if (flags & PRINT_FLAG_DESTINATION_COMMENT) {
+        if (instr->get_str_comment(instr, str, sizeof(str), flags) > 0) {
+            util_line_append(dest, size, &len, "\t");
+            util_line_append(dest, size, &len, str);
         }
     }
 
     /* Print a newline */
-    print_newline();
+    util_line_append(dest, size, &len, "\n");
+    dest[(len < size) ? len : size - 1] = '\0';
+
+    return len;
+}
+
+int printstream_file_read(struct PrintStream *self, FILE *out) {
+    struct printstream_file_state *state = (struct printstream_file_state *)self->state;
+    struct instruction instr;
+    char line[PRINTSTREAM_FILE_LINE_LEN];
+    int len, ret;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, &instr);
+    switch (ret) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    /* Format the line and write it out in one go */
+    len = printstream_file_format(&instr, line, sizeof(line), state->flags);
 
     /* Free the allocated disassembled instruction */
     instr.free(&instr);
 
-    return 0;
+    if (len > 0 && fputs(line, out) < 0) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
 
-    fputs_error:
-    self->error = "Error writing to output file!";
-    return STREAM_ERROR_OUTPUT;
+    return 0;
 }
-
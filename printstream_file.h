@@ -13,12 +13,34 @@ enum {
     PRINT_FLAG_DATA_BIN                = (1<<4),
     PRINT_FLAG_DATA_DEC                = (1<<5),
     PRINT_FLAG_OPCODES                 = (1<<6),
+    /* Omit the CSV header row / binary record header, e.g. for a
+     * continuation of another output */
+    PRINT_FLAG_NO_HEADER               = (1<<7),
+    /* Print a column of instruction cycles after the opcodes, "next/taken"
+     * for branches and skips, or "-" if unknown */
+    PRINT_FLAG_CYCLES                  = (1<<8),
+    /* With PRINT_FLAG_ASSEMBLY, label every instruction rather than only
+     * those that operands refer to, see xref.h */
+    PRINT_FLAG_ALL_LABELS              = (1<<9),
 };
 
+/* Core variant (CYCLES_VARIANT_*) of the cycle column, carried in the flags
+ * above the PRINT_FLAG_* bits */
+#define PRINT_FLAG_CYCLES_VARIANT(variant)  ((variant) << 12)
+#define PRINT_CYCLES_VARIANT(flags)         (((flags) >> 12) & 0xf)
+
+/* Longest formatted line */
+#define PRINTSTREAM_FILE_LINE_LEN   1024
+
 /* Print Stream Support */
 int printstream_file_init(struct PrintStream *self, int flags);
 int printstream_file_close(struct PrintStream *self);
 int printstream_file_read(struct PrintStream *self, FILE *out);
 
+/* Format an instruction or directive as one line of the text listing,
+ * including the newline. Returns the line length, which may exceed size - 1
+ * if the line was truncated, or 0 for a skipped directive. */
+int printstream_file_format(struct instruction *instr, char *dest, int size, int flags);
+
 #endif
 
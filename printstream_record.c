@@ -0,0 +1,337 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <printstream.h>
+#include <instruction.h>
+#include <printstream_record.h>
+#include <printstream_file.h>
+
+/* Maximum number of operands of any supported architecture */
+#define RECORD_MAX_OPERANDS     3
+/* Record buffer size, comfortably above the longest possible record */
+#define RECORD_BUFFER_LEN       2048
+
+const char *const Operand_Kind_Names[] = {
+    [OPERAND_KIND_NONE] = "none",
+    [OPERAND_KIND_REGISTER] = "register",
+    [OPERAND_KIND_IO_REGISTER] = "io_register",
+    [OPERAND_KIND_IMPLICIT] = "implicit",
+    [OPERAND_KIND_INDIRECT] = "indirect",
+    [OPERAND_KIND_DATA] = "data",
+    [OPERAND_KIND_BIT] = "bit",
+    [OPERAND_KIND_BIT_ADDRESS] = "bit_address",
+    [OPERAND_KIND_FLAG] = "flag",
+    [OPERAND_KIND_DATA_ADDRESS] = "data_address",
+    [OPERAND_KIND_PROG_ADDRESS] = "prog_address",
+    [OPERAND_KIND_RELATIVE_ADDRESS] = "relative_address",
+    [OPERAND_KIND_RAW] = "raw",
+};
+
+/******************************************************************************/
+/* Record Buffer Support */
+/******************************************************************************/
+
+/* A record is assembled in memory and written with a single fwrite(), number
+ * formatting is done by hand to stay clear of printf() on the hot path */
+struct record_buffer {
+    char data[RECORD_BUFFER_LEN];
+    unsigned int len;
+};
+
+static void util_append_char(struct record_buffer *buf, char c) {
+    if (buf->len < RECORD_BUFFER_LEN)
+        buf->data[buf->len++] = c;
+}
+
+static void util_append_str(struct record_buffer *buf, const char *str) {
+    for (; *str != '\0'; str++)
+        util_append_char(buf, *str);
+}
+
+static void util_append_uint(struct record_buffer *buf, uint32_t value) {
+    char digits[10];
+    int i = 0;
+
+    do {
+        digits[i++] = '0' + (value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (i > 0)
+        util_append_char(buf, digits[--i]);
+}
+
+static void util_append_int(struct record_buffer *buf, int32_t value) {
+    if (value < 0) {
+        util_append_char(buf, '-');
+        util_append_uint(buf, -(uint32_t)value);
+    } else {
+        util_append_uint(buf, value);
+    }
+}
+
+static void util_append_opcodes(struct record_buffer *buf, struct instruction *instr) {
+    static const char hex[] = "0123456789abcdef";
+    uint8_t opcodes[8];
+    unsigned int i, len;
+
+    len = instr->get_opcodes(instr, opcodes);
+    for (i = 0; i < len && i < sizeof(opcodes); i++) {
+        util_append_char(buf, hex[opcodes[i] >> 4]);
+        util_append_char(buf, hex[opcodes[i] & 0xf]);
+    }
+}
+
+/* Append a string, escaped for a JSON string literal */
+static void util_append_json_str(struct record_buffer *buf, const char *str) {
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\')
+            util_append_char(buf, '\\');
+        util_append_char(buf, *str);
+    }
+}
+
+/* Append a string, escaped for a quoted CSV field */
+static void util_append_csv_str(struct record_buffer *buf, const char *str) {
+    for (; *str != '\0'; str++) {
+        if (*str == '"')
+            util_append_char(buf, '"');
+        util_append_char(buf, *str);
+    }
+}
+
+/******************************************************************************/
+/* Record Print Stream Support */
+/******************************************************************************/
+
+/* Print Stream State */
+struct printstream_record_state {
+    /* Print Option Bit Flags */
+    unsigned int flags;
+    /* CSV header row written */
+    int header;
+};
+
+static int printstream_record_init(struct PrintStream *self, int flags) {
+    /* Allocate stream state */
+    self->state = malloc(sizeof(struct printstream_record_state));
+    if (self->state == NULL) {
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    /* Initialize stream state */
+    memset(self->state, 0, sizeof(struct printstream_record_state));
+    ((struct printstream_record_state *)self->state)->flags = flags;
+    ((struct printstream_record_state *)self->state)->header = (flags & PRINT_FLAG_NO_HEADER) ? 1 : 0;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the input stream */
+    if (self->in->stream_init(self->in) < 0) {
+        self->error = "Error in input stream initialization!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int printstream_json_init(struct PrintStream *self, int flags) {
+    return printstream_record_init(self, flags);
+}
+
+int printstream_csv_init(struct PrintStream *self, int flags) {
+    return printstream_record_init(self, flags);
+}
+
+int printstream_record_close(struct PrintStream *self) {
+    /* Free stream state memory */
+    free(self->state);
+
+    /* Close input stream */
+    if (self->in->stream_close(self->in) < 0) {
+        self->error = "Error in input stream close!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+static int util_read_instruction(struct PrintStream *self, struct instruction *instr) {
+    int ret;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, instr);
+    switch (ret) {
+        case 0:
+            return 0;
+        case STREAM_EOF:
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+}
+
+static int util_write_record(struct PrintStream *self, struct record_buffer *buf, FILE *out) {
+    if (fwrite(buf->data, 1, buf->len, out) != buf->len) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* JSON Lines Print Stream */
+/******************************************************************************/
+
+int printstream_json_read(struct PrintStream *self, FILE *out) {
+    struct printstream_record_state *state = (struct printstream_record_state *)self->state;
+    struct instruction instr;
+    struct record_buffer buf;
+    char str[128];
+    uint32_t target;
+    int i, numOperands, ret;
+
+    if ((ret = util_read_instruction(self, &instr)) != 0)
+        return ret;
+
+    buf.len = 0;
+
+    if (instr.type == DISASM_TYPE_DIRECTIVE) {
+        util_append_str(&buf, "{\"type\":\"directive\"");
+    } else {
+        util_append_str(&buf, "{\"type\":\"instruction\",\"address\":");
+        util_append_uint(&buf, instr.get_address(&instr));
+        util_append_str(&buf, ",\"width\":");
+        util_append_uint(&buf, instr.get_width(&instr));
+        util_append_str(&buf, ",\"opcodes\":\"");
+        util_append_opcodes(&buf, &instr);
+        util_append_char(&buf, '"');
+    }
+
+    instr.get_str_mnemonic(&instr, str, sizeof(str), state->flags);
+    util_append_str(&buf, ",\"mnemonic\":\"");
+    util_append_json_str(&buf, str);
+    util_append_str(&buf, "\",\"operands\":[");
+
+    numOperands = instr.get_num_operands(&instr);
+    for (i = 0; i < numOperands && i < RECORD_MAX_OPERANDS; i++) {
+        if (i > 0) util_append_char(&buf, ',');
+        util_append_str(&buf, "{\"kind\":\"");
+        util_append_str(&buf, Operand_Kind_Names[instr.get_operand_kind(&instr, i)]);
+        util_append_str(&buf, "\",\"value\":");
+        util_append_int(&buf, instr.get_operand_value(&instr, i));
+        util_append_str(&buf, ",\"text\":\"");
+        str[0] = '\0';
+        instr.get_str_operand(&instr, str, sizeof(str), i, state->flags);
+        util_append_json_str(&buf, str);
+        util_append_str(&buf, "\"}");
+    }
+    util_append_char(&buf, ']');
+
+    if (instr.type == DISASM_TYPE_INSTRUCTION) {
+        util_append_str(&buf, ",\"target\":");
+        if (instr.get_branch_target(&instr, &target))
+            util_append_uint(&buf, target);
+        else
+            util_append_str(&buf, "null");
+    }
+
+    util_append_str(&buf, "}\n");
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    return util_write_record(self, &buf, out);
+}
+
+/******************************************************************************/
+/* CSV Print Stream */
+/******************************************************************************/
+
+int printstream_csv_read(struct PrintStream *self, FILE *out) {
+    struct printstream_record_state *state = (struct printstream_record_state *)self->state;
+    struct instruction instr;
+    struct record_buffer buf;
+    char str[128];
+    uint32_t target;
+    int i, numOperands, ret;
+
+    if ((ret = util_read_instruction(self, &instr)) != 0)
+        return ret;
+
+    buf.len = 0;
+
+    /* Write the header row ahead of the first record */
+    if (!state->header) {
+        util_append_str(&buf, "type,address,width,opcodes,mnemonic,operands");
+        for (i = 1; i <= RECORD_MAX_OPERANDS; i++) {
+            util_append_str(&buf, ",op");
+            util_append_uint(&buf, i);
+            util_append_str(&buf, "_kind,op");
+            util_append_uint(&buf, i);
+            util_append_str(&buf, "_value");
+        }
+        util_append_str(&buf, ",target\n");
+        state->header = 1;
+    }
+
+    /* Directives have no address, width or opcodes */
+    if (instr.type == DISASM_TYPE_DIRECTIVE) {
+        util_append_str(&buf, "directive,,,,");
+    } else {
+        util_append_str(&buf, "instruction,");
+        util_append_uint(&buf, instr.get_address(&instr));
+        util_append_char(&buf, ',');
+        util_append_uint(&buf, instr.get_width(&instr));
+        util_append_char(&buf, ',');
+        util_append_opcodes(&buf, &instr);
+        util_append_char(&buf, ',');
+    }
+
+    /* Mnemonic as a quoted field */
+    instr.get_str_mnemonic(&instr, str, sizeof(str), state->flags);
+    util_append_char(&buf, '"');
+    util_append_csv_str(&buf, str);
+    util_append_char(&buf, '"');
+
+    /* Rendered operands as one quoted field */
+    numOperands = instr.get_num_operands(&instr);
+    if (numOperands > RECORD_MAX_OPERANDS)
+        numOperands = RECORD_MAX_OPERANDS;
+    util_append_str(&buf, ",\"");
+    for (i = 0; i < numOperands; i++) {
+        if (i > 0) util_append_str(&buf, ", ");
+        str[0] = '\0';
+        instr.get_str_operand(&instr, str, sizeof(str), i, state->flags);
+        util_append_csv_str(&buf, str);
+    }
+    util_append_char(&buf, '"');
+
+    /* Operand kinds and values, empty for absent operands */
+    for (i = 0; i < RECORD_MAX_OPERANDS; i++) {
+        util_append_char(&buf, ',');
+        if (i < numOperands) {
+            util_append_str(&buf, Operand_Kind_Names[instr.get_operand_kind(&instr, i)]);
+            util_append_char(&buf, ',');
+            util_append_int(&buf, instr.get_operand_value(&instr, i));
+        } else {
+            util_append_char(&buf, ',');
+        }
+    }
+
+    util_append_char(&buf, ',');
+    if (instr.type == DISASM_TYPE_INSTRUCTION && instr.get_branch_target(&instr, &target))
+        util_append_uint(&buf, target);
+    util_append_char(&buf, '\n');
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    return util_write_record(self, &buf, out);
+}
+
@@ -0,0 +1,38 @@
+#ifndef PRINTSTREAM_RECORD_H
+#define PRINTSTREAM_RECORD_H
+
+#include <stdio.h>
+#include <printstream.h>
+
+/* Record Print Stream Support
+ *
+ * Machine-readable print streams emitting one record per instruction or
+ * directive: JSON Lines (one JSON object per line) or CSV (with a header
+ * row). A record carries the address, width, raw opcode bytes, mnemonic,
+ * operands with their kind, numeric value and rendered text, and the
+ * resolved branch target, if any. The PRINT_FLAG_DATA_* and
+ * PRINT_FLAG_ASSEMBLY flags only affect the rendered operand text.
+ *
+ * The opcode bytes are hex digits in program memory order, as get_opcodes()
+ * returns them and the binary records store them, e.g. "02c0" for the AVR
+ * rjmp .+4 that the text listing shows as the word "c0 02". The mnemonic and
+ * the rendered operands are quoted CSV fields.
+ */
+
+/* Operand kind names, indexed by OPERAND_KIND_* */
+extern const char *const Operand_Kind_Names[];
+
+/* JSON Lines Print Stream Support */
+int printstream_json_init(struct PrintStream *self, int flags);
+int printstream_json_read(struct PrintStream *self, FILE *out);
+#define printstream_json_close  printstream_record_close
+
+/* CSV Print Stream Support */
+int printstream_csv_init(struct PrintStream *self, int flags);
+int printstream_csv_read(struct PrintStream *self, FILE *out);
+#define printstream_csv_close   printstream_record_close
+
+int printstream_record_close(struct PrintStream *self);
+
+#endif
+
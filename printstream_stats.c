@@ -0,0 +1,266 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <printstream.h>
+#include <instruction.h>
+#include <printstream_stats.h>
+#include <budget.h>
+
+/* Widest instruction counted by width */
+#define STATS_MAX_WIDTH     8
+
+/* Names of the counted flows, indexed by FLOW_* */
+static const char *const Stats_Flow_Names[] = {
+    [FLOW_BRANCH] = "branch",
+    [FLOW_SKIP] = "skip",
+    [FLOW_JUMP] = "jump",
+    [FLOW_CALL] = "call",
+    [FLOW_INDIRECT_JUMP] = "indirect_jump",
+    [FLOW_INDIRECT_CALL] = "indirect_call",
+    [FLOW_RETURN] = "return",
+};
+
+/* Accesses of an address space */
+struct stats_addresses {
+    uint64_t accesses;
+    /* Accesses per address, PRINTSTREAM_STATS_ADDRESSES long */
+    uint32_t *counts;
+};
+
+/* Print Stream State */
+struct printstream_stats_state {
+    const char *arch_name;
+    isa_mnemonic_func isa_mnemonic;
+
+    uint64_t instructions, directives, bytes, raw;
+    uint64_t widths[STATS_MAX_WIDTH + 1];
+    uint64_t flows[FLOW_INVALID + 1];
+    /* Instructions per instruction set table entry, num_entries long */
+    uint64_t *entries;
+    unsigned int num_entries;
+    struct stats_addresses io, data;
+
+    /* Bytes charged to the memory budget */
+    size_t charged;
+    /* Summary written */
+    int written;
+};
+
+/******************************************************************************/
+/* Statistics Print Stream Support */
+/******************************************************************************/
+
+int printstream_stats_setup(struct PrintStream *self, const char *arch_name, isa_mnemonic_func isa_mnemonic) {
+    struct printstream_stats_state *state;
+
+    /* Allocate stream state, which carries the architecture until init */
+    state = self->state = calloc(1, sizeof(struct printstream_stats_state));
+    if (state == NULL) {
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->arch_name = arch_name;
+    state->isa_mnemonic = isa_mnemonic;
+
+    self->error = NULL;
+    self->stream_init = printstream_stats_init;
+    self->stream_close = printstream_stats_close;
+    self->stream_read = printstream_stats_read;
+
+    return 0;
+}
+
+int printstream_stats_init(struct PrintStream *self, int flags) {
+    struct printstream_stats_state *state = (struct printstream_stats_state *)self->state;
+    size_t size;
+
+    (void)flags;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Allocate the counters */
+    for (state->num_entries = 0; state->isa_mnemonic(state->num_entries) != NULL; state->num_entries++)
+        ;
+    size = state->num_entries * sizeof(uint64_t) + 2 * PRINTSTREAM_STATS_ADDRESSES * sizeof(uint32_t);
+    if (budget_charge(size) < 0) {
+        self->error = "Error allocating statistics counters!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->charged = size;
+    state->entries = calloc(state->num_entries, sizeof(uint64_t));
+    state->io.counts = calloc(PRINTSTREAM_STATS_ADDRESSES, sizeof(uint32_t));
+    state->data.counts = calloc(PRINTSTREAM_STATS_ADDRESSES, sizeof(uint32_t));
+    if (state->entries == NULL || state->io.counts == NULL || state->data.counts == NULL) {
+        self->error = "Error allocating statistics counters!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    /* Initialize the input stream */
+    if (self->in->stream_init(self->in) < 0) {
+        self->error = "Error in input stream initialization!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int printstream_stats_close(struct PrintStream *self) {
+    struct printstream_stats_state *state = (struct printstream_stats_state *)self->state;
+
+    /* Free stream state memory */
+    free(state->entries);
+    free(state->io.counts);
+    free(state->data.counts);
+    budget_release(state->charged);
+    free(self->state);
+
+    /* Close input stream */
+    if (self->in->stream_close(self->in) < 0) {
+        self->error = "Error in input stream close!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+static void util_count_address(struct stats_addresses *addresses, int32_t value) {
+    addresses->accesses++;
+    if (value >= 0 && value < PRINTSTREAM_STATS_ADDRESSES && addresses->counts[value] < UINT32_MAX)
+        addresses->counts[value]++;
+}
+
+static void util_count(struct printstream_stats_state *state, struct instruction *instr) {
+    unsigned int i, num_operands, width, index;
+    int flow;
+
+    if (instr->type == DISASM_TYPE_DIRECTIVE) {
+        state->directives++;
+        return;
+    }
+
+    state->instructions++;
+    width = instr->get_width(instr);
+    state->bytes += width;
+    state->widths[(width < STATS_MAX_WIDTH) ? width : STATS_MAX_WIDTH]++;
+
+    index = instr->get_isa_index(instr);
+    if (index < state->num_entries)
+        state->entries[index]++;
+
+    flow = instr->get_flow(instr);
+    if (flow >= 0 && flow <= FLOW_INVALID)
+        state->flows[flow]++;
+    if (flow == FLOW_INVALID)
+        state->raw++;
+
+    num_operands = instr->get_num_operands(instr);
+    for (i = 0; i < num_operands; i++) {
+        switch (instr->get_operand_kind(instr, i)) {
+            case OPERAND_KIND_IO_REGISTER:
+                util_count_address(&state->io, instr->get_operand_value(instr, i));
+                break;
+            case OPERAND_KIND_DATA_ADDRESS:
+                util_count_address(&state->data, instr->get_operand_value(instr, i));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void util_write_addresses(FILE *out, const char *name, const struct stats_addresses *addresses) {
+    const char *separator = "";
+    unsigned int i;
+
+    fprintf(out, ",\"%s\":{\"accesses\":%llu,\"addresses\":{", name, (unsigned long long)addresses->accesses);
+    for (i = 0; i < PRINTSTREAM_STATS_ADDRESSES; i++) {
+        if (addresses->counts[i] > 0) {
+            fprintf(out, "%s\"%u\":%u", separator, i, addresses->counts[i]);
+            separator = ",";
+        }
+    }
+    fputs("}}", out);
+}
+
+/* Write the JSON summary */
+static int util_write_summary(struct PrintStream *self, FILE *out) {
+    struct printstream_stats_state *state = (struct printstream_stats_state *)self->state;
+    const char *separator;
+    unsigned int i;
+
+    fprintf(out, "{\"architecture\":\"%s\",\"instructions\":%llu,\"directives\":%llu,\"bytes\":%llu", state->arch_name,
+        (unsigned long long)state->instructions, (unsigned long long)state->directives, (unsigned long long)state->bytes);
+
+    fputs(",\"widths\":{", out);
+    for (i = 0, separator = ""; i <= STATS_MAX_WIDTH; i++) {
+        if (state->widths[i] > 0) {
+            fprintf(out, "%s\"%u\":%llu", separator, i, (unsigned long long)state->widths[i]);
+            separator = ",";
+        }
+    }
+
+    fputs("},\"mnemonics\":[", out);
+    for (i = 0, separator = ""; i < state->num_entries; i++) {
+        if (state->entries[i] > 0) {
+            fprintf(out, "%s{\"index\":%u,\"mnemonic\":\"%s\",\"count\":%llu}", separator, i, state->isa_mnemonic(i), (unsigned long long)state->entries[i]);
+            separator = ",";
+        }
+    }
+
+    fputs("],\"flow\":{", out);
+    for (i = FLOW_BRANCH, separator = ""; i < FLOW_INVALID; i++) {
+        fprintf(out, "%s\"%s\":%llu", separator, Stats_Flow_Names[i], (unsigned long long)state->flows[i]);
+        separator = ",";
+    }
+    fputc('}', out);
+
+    util_write_addresses(out, "io_registers", &state->io);
+    util_write_addresses(out, "data_addresses", &state->data);
+
+    fprintf(out, ",\"raw\":%llu,\"raw_fraction\":%.6f}\n", (unsigned long long)state->raw,
+        (state->instructions > 0) ? (double)state->raw / state->instructions : 0.0);
+
+    if (ferror(out)) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+
+    state->written = 1;
+
+    return 0;
+}
+
+int printstream_stats_read(struct PrintStream *self, FILE *out) {
+    struct printstream_stats_state *state = (struct printstream_stats_state *)self->state;
+    struct instruction instr;
+    int ret;
+
+    if (state->written)
+        return STREAM_EOF;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, &instr);
+    switch (ret) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            /* Write the summary at the end of the stream */
+            if ((ret = util_write_summary(self, out)) < 0)
+                return ret;
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    util_count(state, &instr);
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    return 0;
+}
+
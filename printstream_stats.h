@@ -0,0 +1,40 @@
+#ifndef PRINTSTREAM_STATS_H
+#define PRINTSTREAM_STATS_H
+
+#include <stdio.h>
+#include <printstream.h>
+
+/* Statistics Print Stream Support
+ *
+ * Counts facts about the decoded stream instead of writing it out, and
+ * writes them as one JSON object at its end. Counters are indexed by the
+ * instruction set table index and operand values of each instruction, so no
+ * instruction is formatted; only the mnemonics of the entries seen are
+ * looked up for the summary:
+ *
+ *   {"architecture":"avr","instructions":N,"directives":N,"bytes":N,
+ *    "widths":{"2":N,...},
+ *    "mnemonics":[{"index":N,"mnemonic":"ldi","count":N},...],
+ *    "flow":{"branch":N,"skip":N,"jump":N,"call":N,"indirect_jump":N,
+ *            "indirect_call":N,"return":N},
+ *    "io_registers":{"accesses":N,"addresses":{"63":N,...}},
+ *    "data_addresses":{"accesses":N,"addresses":{"96":N,...}},
+ *    "raw":N,"raw_fraction":F}
+ *
+ * raw counts the .dw / .db data and reserved opcodes among the
+ * instructions. Address counters cover the addresses below
+ * PRINTSTREAM_STATS_ADDRESSES, and are charged to the memory budget.
+ */
+
+/* Size of the I/O register and data address spaces counted per address */
+#define PRINTSTREAM_STATS_ADDRESSES     65536
+
+/* Setup self as a statistics print stream for the architecture */
+int printstream_stats_setup(struct PrintStream *self, const char *arch_name, isa_mnemonic_func isa_mnemonic);
+
+int printstream_stats_init(struct PrintStream *self, int flags);
+int printstream_stats_close(struct PrintStream *self);
+int printstream_stats_read(struct PrintStream *self, FILE *out);
+
+#endif
+
@@ -0,0 +1,426 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <printstream.h>
+#include <instruction.h>
+#include <printstream_file.h>
+#include <printstream_template.h>
+
+/* Maximum number of emit operations in a compiled template */
+#define TEMPLATE_MAX_OPS        64
+/* Line buffer size, comfortably above the longest possible line */
+#define TEMPLATE_BUFFER_LEN     4096
+/* Maximum field width */
+#define TEMPLATE_MAX_WIDTH      256
+
+/* Template emit operations */
+enum {
+    TEMPLATE_OP_LITERAL,
+    TEMPLATE_OP_FIELD,
+};
+
+/* Template fields */
+enum {
+    TEMPLATE_FIELD_ADDR,
+    TEMPLATE_FIELD_LABEL,
+    TEMPLATE_FIELD_WIDTH,
+    TEMPLATE_FIELD_BYTES,
+    TEMPLATE_FIELD_MNEM,
+    TEMPLATE_FIELD_OPS,
+    TEMPLATE_FIELD_COMMENT,
+    TEMPLATE_FIELD_TARGET,
+};
+
+static const struct {
+    char *name;
+    /* Numeric fields take a number base, the others are strings */
+    int numeric;
+    char default_base;
+} Template_Fields[] = {
+    [TEMPLATE_FIELD_ADDR] = {"addr", 1, 'x'},
+    [TEMPLATE_FIELD_LABEL] = {"label", 0, 's'},
+    [TEMPLATE_FIELD_WIDTH] = {"width", 1, 'd'},
+    [TEMPLATE_FIELD_BYTES] = {"bytes", 0, 's'},
+    [TEMPLATE_FIELD_MNEM] = {"mnem", 0, 's'},
+    [TEMPLATE_FIELD_OPS] = {"ops", 0, 's'},
+    [TEMPLATE_FIELD_COMMENT] = {"comment", 0, 's'},
+    [TEMPLATE_FIELD_TARGET] = {"target", 1, 'x'},
+};
+
+#define TEMPLATE_TOTAL_FIELDS   (sizeof(Template_Fields)/sizeof(Template_Fields[0]))
+
+/* Compiled emit operation */
+struct template_op {
+    int type;
+    /* Literal: offset and length into the literal pool */
+    unsigned int offset, len;
+    /* Field: field, minimum width, base, left alignment and zero padding */
+    int field;
+    int width;
+    char base;
+    int left, zero;
+};
+
+/* Print Stream State */
+struct printstream_template_state {
+    /* Print Option Bit Flags */
+    unsigned int flags;
+
+    /* Compiled template */
+    struct template_op ops[TEMPLATE_MAX_OPS];
+    unsigned int num_ops;
+    /* Literal text pool, with escapes and {{ }} resolved */
+    char *literals;
+    unsigned int literals_len;
+};
+
+/******************************************************************************/
+/* Template Compiler */
+/******************************************************************************/
+
+static int util_compile_field(struct template_op *op, const char *field, unsigned int len) {
+    const char *spec;
+    unsigned int i, name_len;
+
+    /* Split the field name from the spec */
+    spec = memchr(field, ':', len);
+    name_len = (spec != NULL) ? (unsigned int)(spec - field) : len;
+
+    op->type = TEMPLATE_OP_FIELD;
+    for (i = 0; i < TEMPLATE_TOTAL_FIELDS; i++) {
+        if (strlen(Template_Fields[i].name) == name_len && strncmp(Template_Fields[i].name, field, name_len) == 0)
+            break;
+    }
+    if (i == TEMPLATE_TOTAL_FIELDS)
+        return -1;
+    op->field = i;
+    op->base = Template_Fields[i].default_base;
+    op->width = 0;
+    op->left = op->zero = 0;
+
+    if (spec == NULL)
+        return 0;
+
+    /* Parse the [-][0][width][base] spec */
+    spec++;
+    len -= name_len + 1;
+    if (len > 0 && *spec == '-') {
+        op->left = 1;
+        spec++, len--;
+    }
+    if (len > 0 && *spec == '0') {
+        op->zero = 1;
+        spec++, len--;
+    }
+    for (; len > 0 && *spec >= '0' && *spec <= '9'; spec++, len--) {
+        op->width = op->width*10 + (*spec - '0');
+        if (op->width > TEMPLATE_MAX_WIDTH)
+            return -1;
+    }
+    if (len == 1) {
+        op->base = *spec;
+        len--;
+    }
+    if (len != 0)
+        return -1;
+
+    /* Check the base suits the field */
+    if (Template_Fields[op->field].numeric) {
+        if (op->base != 'x' && op->base != 'X' && op->base != 'd' && op->base != 'o')
+            return -1;
+    } else {
+        if (op->base != 's' || op->zero)
+            return -1;
+    }
+
+    return 0;
+}
+
+int printstream_template_setup(struct PrintStream *self, const char *template) {
+    struct printstream_template_state *state;
+    struct template_op *op;
+    const char *p, *end;
+
+    /* Allocate stream state, which carries the compiled template until init */
+    state = self->state = calloc(1, sizeof(struct printstream_template_state));
+    if (state == NULL) {
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    /* Literal text is never longer than the template */
+    state->literals = malloc(strlen(template) + 1);
+    if (state->literals == NULL) {
+        free(state);
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+
+    self->error = NULL;
+    self->stream_init = printstream_template_init;
+    self->stream_close = printstream_template_close;
+    self->stream_read = printstream_template_read;
+
+    for (p = template, op = NULL; *p != '\0'; ) {
+        if (*p == '{' && p[1] != '{') {
+            /* Field */
+            if ((end = strchr(p, '}')) == NULL) {
+                self->error = "Unterminated field in format template!";
+                goto compile_error;
+            }
+            if (state->num_ops == TEMPLATE_MAX_OPS) {
+                self->error = "Format template too long!";
+                goto compile_error;
+            }
+            op = &state->ops[state->num_ops++];
+            if (util_compile_field(op, p+1, end - (p+1)) < 0) {
+                self->error = "Invalid field in format template!";
+                goto compile_error;
+            }
+            p = end + 1;
+            op = NULL;
+            continue;
+        }
+
+        if (*p == '}' && p[1] != '}') {
+            self->error = "Unmatched } in format template!";
+            goto compile_error;
+        }
+
+        /* Literal character, extending the current literal op */
+        if (op == NULL) {
+            if (state->num_ops == TEMPLATE_MAX_OPS) {
+                self->error = "Format template too long!";
+                goto compile_error;
+            }
+            op = &state->ops[state->num_ops++];
+            op->type = TEMPLATE_OP_LITERAL;
+            op->offset = state->literals_len;
+            op->len = 0;
+        }
+
+        if ((*p == '{' || *p == '}') || (*p == '\\' && p[1] == '\\')) {
+            state->literals[state->literals_len++] = *p;
+            p += 2;
+        } else if (*p == '\\' && p[1] == 't') {
+            state->literals[state->literals_len++] = '\t';
+            p += 2;
+        } else if (*p == '\\' && p[1] == 'n') {
+            state->literals[state->literals_len++] = '\n';
+            p += 2;
+        } else {
+            state->literals[state->literals_len++] = *p++;
+        }
+        op->len++;
+    }
+
+    return 0;
+
+    compile_error:
+    free(state->literals);
+    free(state);
+    self->state = NULL;
+    return STREAM_ERROR_FAILURE;
+}
+
+/******************************************************************************/
+/* Template Print Stream Support */
+/******************************************************************************/
+
+int printstream_template_init(struct PrintStream *self, int flags) {
+    struct printstream_template_state *state = (struct printstream_template_state *)self->state;
+
+    state->flags = flags;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the input stream */
+    if (self->in->stream_init(self->in) < 0) {
+        self->error = "Error in input stream initialization!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int printstream_template_close(struct PrintStream *self) {
+    struct printstream_template_state *state = (struct printstream_template_state *)self->state;
+
+    /* Free stream state memory */
+    free(state->literals);
+    free(state);
+
+    /* Close input stream */
+    if (self->in->stream_close(self->in) < 0) {
+        self->error = "Error in input stream close!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+/* Render a number in the op's base, returning its length */
+static int util_render_number(char *dest, uint32_t value, char base) {
+    const char *digits = (base == 'X') ? "0123456789ABCDEF" : "0123456789abcdef";
+    unsigned int radix = (base == 'd') ? 10 : (base == 'o') ? 8 : 16;
+    char tmp[12];
+    int i = 0, len = 0;
+
+    do {
+        tmp[i++] = digits[value % radix];
+        value /= radix;
+    } while (value > 0);
+
+    while (i > 0)
+        dest[len++] = tmp[--i];
+
+    return len;
+}
+
+/* Render a field of the instruction into dest, returning its length */
+static int util_render_field(struct printstream_template_state *state, struct template_op *op, struct instruction *instr, char *dest, int size) {
+    uint8_t opcodes[8];
+    char operand[128];
+    uint32_t target;
+    int i, n, len;
+
+    switch (op->field) {
+        case TEMPLATE_FIELD_ADDR:
+            return util_render_number(dest, instr->get_address(instr), op->base);
+        case TEMPLATE_FIELD_WIDTH:
+            return util_render_number(dest, instr->get_width(instr), op->base);
+        case TEMPLATE_FIELD_TARGET:
+            if (instr->get_branch_target(instr, &target))
+                return util_render_number(dest, target, op->base);
+            return 0;
+        case TEMPLATE_FIELD_LABEL:
+            len = instr->get_str_address_label(instr, dest, size, state->flags);
+            /* Drop the label's trailing colon */
+            if (len > 0 && dest[len-1] == ':')
+                len--;
+            return len;
+        case TEMPLATE_FIELD_BYTES:
+            n = instr->get_opcodes(instr, opcodes);
+            for (i = 0, len = 0; i < n && i < sizeof(opcodes); i++) {
+                if (i > 0) dest[len++] = ' ';
+                dest[len++] = "0123456789abcdef"[opcodes[i] >> 4];
+                dest[len++] = "0123456789abcdef"[opcodes[i] & 0xf];
+            }
+            return len;
+        case TEMPLATE_FIELD_MNEM:
+            return instr->get_str_mnemonic(instr, dest, size, state->flags);
+        case TEMPLATE_FIELD_OPS:
+            /* Operands separated by commas, as in the text print stream */
+            for (i = 0, len = 0; ; i++) {
+                if ((n = instr->get_str_operand(instr, operand, sizeof(operand), i, state->flags)) <= 0)
+                    break;
+                if (n >= sizeof(operand))
+                    n = sizeof(operand) - 1;
+                if (len + n + 2 >= size)
+                    break;
+                if (i > 0) {
+                    dest[len++] = ',';
+                    dest[len++] = ' ';
+                }
+                memcpy(dest + len, operand, n);
+                len += n;
+            }
+            return len;
+        case TEMPLATE_FIELD_COMMENT:
+            len = instr->get_str_comment(instr, dest, size, state->flags);
+            /* Drop the comment's leading "; ", the template supplies it */
+            if (len >= 2 && dest[0] == ';' && dest[1] == ' ') {
+                memmove(dest, dest + 2, len - 2);
+                len -= 2;
+            }
+            return len;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+int printstream_template_read(struct PrintStream *self, FILE *out) {
+    struct printstream_template_state *state = (struct printstream_template_state *)self->state;
+    struct instruction instr;
+    char buf[TEMPLATE_BUFFER_LEN], field[TEMPLATE_MAX_WIDTH];
+    struct template_op *op;
+    unsigned int i;
+    int len, n, pad;
+
+    /* Read a disassembled instruction */
+    switch (self->in->stream_read(self->in, &instr)) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    len = 0;
+
+    /* Directives have no fields to fill in, print them as the text print
+     * stream does, if we're outputting assembly */
+    if (instr.type == DISASM_TYPE_DIRECTIVE) {
+        if (state->flags & PRINT_FLAG_ASSEMBLY) {
+            buf[len++] = '\t';
+            len += instr.get_str_mnemonic(&instr, buf + len, 128, state->flags);
+            buf[len++] = '\t';
+            n = instr.get_str_operand(&instr, buf + len, 128, 0, state->flags);
+            if (n > 0) len += n;
+            buf[len++] = '\n';
+        }
+        instr.free(&instr);
+        goto write_line;
+    }
+
+    /* Execute the compiled template */
+    for (i = 0, op = state->ops; i < state->num_ops; i++, op++) {
+        if (op->type == TEMPLATE_OP_LITERAL) {
+            if (len + op->len >= sizeof(buf) - 1)
+                break;
+            memcpy(buf + len, state->literals + op->offset, op->len);
+            len += op->len;
+            continue;
+        }
+
+        n = util_render_field(state, op, &instr, field, sizeof(field));
+        if (n < 0)
+            n = 0;
+        else if (n >= sizeof(field))
+            n = sizeof(field) - 1;
+        pad = (op->width > n) ? op->width - n : 0;
+        if (len + n + pad >= sizeof(buf) - 1)
+            break;
+
+        /* Absent values, e.g. no branch target, are padded with spaces */
+        if (!op->left) {
+            memset(buf + len, (op->zero && n > 0) ? '0' : ' ', pad);
+            len += pad;
+        }
+        memcpy(buf + len, field, n);
+        len += n;
+        if (op->left) {
+            memset(buf + len, ' ', pad);
+            len += pad;
+        }
+    }
+    buf[len++] = '\n';
+
+    /* Free the allocated disassembled instruction */
+    instr.free(&instr);
+
+    write_line:
+    if (len > 0 && fwrite(buf, 1, len, out) != len) {
+        self->error = "Error writing to output file!";
+        return STREAM_ERROR_OUTPUT;
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,30 @@
+#ifndef PRINTSTREAM_TEMPLATE_H
+#define PRINTSTREAM_TEMPLATE_H
+
+#include <stdio.h>
+#include <printstream.h>
+
+/* Template Print Stream Support
+ *
+ * Prints each instruction with a user-defined line template, e.g.
+ * "{addr:08x} {bytes} {mnem} {ops} ; {comment}". The template is compiled
+ * once by printstream_template_setup() into a sequence of emit operations
+ * (copy literal, render field with width / base / padding), which is then
+ * executed per instruction without interpreting the template again.
+ *
+ * Fields: addr, label, width, bytes, mnem, ops, comment, target.
+ * Field spec: {field[:[-][0][width][base]]}, where - left aligns, 0 zero
+ * pads numbers, and base is one of x, X, d, o for numeric fields (addr,
+ * width, target) or s for the others. {{ and }} are literal braces.
+ * Directives are printed as with the text print stream.
+ */
+
+/* Compile the template into the print stream state */
+int printstream_template_setup(struct PrintStream *self, const char *template);
+
+int printstream_template_init(struct PrintStream *self, int flags);
+int printstream_template_close(struct PrintStream *self);
+int printstream_template_read(struct PrintStream *self, FILE *out);
+
+#endif
+
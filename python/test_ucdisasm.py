@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+
+# Tests for the ucdisasm extension module, checked against the ucdisasm
+# program. Run with make python-test.
+
+import os
+import struct
+import subprocess
+import tempfile
+import threading
+import unittest
+
+import ucdisasm
+
+UCDISASM = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'ucdisasm')
+
+def run_ucdisasm(args, data):
+    with tempfile.NamedTemporaryFile(suffix='.bin') as f:
+        f.write(data)
+        f.flush()
+        return subprocess.check_output([UCDISASM] + args + ['-t', 'binary', f.name])
+
+def read_varint(data, pos):
+    value, shift = 0, 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+def read_delta(data, pos):
+    value, pos = read_varint(data, pos)
+    return (value >> 1) ^ -(value & 1), pos
+
+def read_compact_records(output):
+    """(type, address, index, width, opcodes, target) of the compact records
+    of ucdisasm -O compact, see printstream_binary.h, with a target of
+    0xffffffff if none, as in the fixed size records"""
+    pos = struct.unpack_from('<I', output, 12)[0]
+    address = 0
+    records = []
+    while pos < len(output):
+        flags = output[pos]
+        index, pos = read_varint(output, pos + 1)
+        if flags & 0x08:
+            operand = None
+            if flags & 0x10:
+                operand, pos = read_varint(output, pos)
+            if index == 0:
+                address = operand
+            records.append(('directive', None, index, 0, b'', 0xffffffff))
+            continue
+        delta = 0
+        if flags & 0x10:
+            delta, pos = read_delta(output, pos)
+        address += delta
+        width = flags & 0x07
+        opcodes = output[pos:pos + width]
+        pos += width
+        target = 0xffffffff
+        if flags & 0x20:
+            target, pos = read_delta(output, pos)
+            target = (target + address) & 0xffffffff
+        records.append(('instruction', address, index, width, opcodes, target))
+        address += width
+    return records
+
+class TestModule(unittest.TestCase):
+    def setUp(self):
+        self.data = os.urandom(4096)
+
+    def test_text_matches_program(self):
+        for arch in ucdisasm.ARCHITECTURES:
+            expected = run_ucdisasm(['-a', arch], self.data).decode()
+            self.assertEqual(ucdisasm.text(arch, self.data), expected, arch)
+
+    def test_text_flags_match_program(self):
+        flags = ucdisasm.FLAG_ASSEMBLY | ucdisasm.FLAG_ADDRESSES | ucdisasm.FLAG_DATA_DEC
+        expected = run_ucdisasm(['-a', 'avr', '--assembly', '--no-opcodes', '--no-destination-comments', '--data-base-dec'], self.data).decode()
+        self.assertEqual(ucdisasm.text('avr', self.data, flags=flags), expected)
+
+    def test_records_match_program(self):
+        for arch in ucdisasm.ARCHITECTURES:
+            output = run_ucdisasm(['-a', arch, '-O', 'binary'], self.data)
+            header_size = struct.unpack_from('<I', output, 12)[0]
+            records = ucdisasm.decode(arch, self.data)
+            self.assertEqual(bytes(memoryview(records)), output[header_size:], arch)
+            self.assertEqual(len(records), (len(output) - header_size) // ucdisasm.RECORD_SIZE)
+
+    def test_compact_records_match_program(self):
+        for arch in ucdisasm.ARCHITECTURES:
+            output = run_ucdisasm(['-a', arch, '-O', 'compact'], self.data)
+            records = ucdisasm.decode(arch, self.data)
+            compact = read_compact_records(output)
+            self.assertEqual(len(records), len(compact), arch)
+            mnemonics = ucdisasm.mnemonics(arch)
+            # Compare the raw target field, 0xffffffff if none
+            fields = struct.iter_unpack(ucdisasm.RECORD_FORMAT, memoryview(records))
+            for record, raw, (kind, address, index, width, opcodes, target) in zip(records, fields, compact):
+                self.assertEqual(record.type, kind, arch)
+                self.assertEqual(record.address, address, arch)
+                self.assertEqual(record.mnemonic, (ucdisasm.DIRECTIVES if kind == 'directive' else mnemonics)[index], arch)
+                self.assertEqual(record.width, width, arch)
+                self.assertEqual(record.opcodes, opcodes, arch)
+                self.assertEqual(raw[-1], target, arch)
+
+    def test_record_fields(self):
+        # rjmp .+0, then a call split across the end of the data
+        records = ucdisasm.decode('avr', b'\x00\xc0\x0e\x94', address=0x100)
+        self.assertEqual(len(records), 3)
+        self.assertEqual(records[0].type, 'directive')
+        self.assertEqual(records[0].mnemonic, 'org')
+        self.assertEqual(records[1].type, 'instruction')
+        self.assertEqual(records[1].address, 0x100)
+        self.assertEqual(records[1].mnemonic, 'rjmp')
+        self.assertEqual(records[1].opcodes, b'\x00\xc0')
+        self.assertEqual(records[1].target, 0x102)
+        self.assertEqual(records[2].width, 2)
+        self.assertEqual(records[2].target, None)
+        self.assertEqual(records[-1], records[2])
+
+    def test_records_unpack_in_place(self):
+        records = ucdisasm.decode('8051', self.data)
+        view = memoryview(records)
+        self.assertTrue(view.readonly)
+        mnemonics = ucdisasm.mnemonics('8051')
+        for i, fields in enumerate(struct.iter_unpack(ucdisasm.RECORD_FORMAT, view)):
+            if fields[2] == 0:
+                self.assertEqual(mnemonics[fields[1]], records[i].mnemonic)
+
+    def test_buffer_inputs(self):
+        expected = ucdisasm.text('pic-18', self.data)
+        self.assertEqual(ucdisasm.text('pic-18', bytearray(self.data)), expected)
+        self.assertEqual(ucdisasm.text('pic-18', memoryview(self.data)), expected)
+
+    def test_errors(self):
+        self.assertRaises(ValueError, ucdisasm.decode, 'z80', b'\x00')
+        self.assertRaises(TypeError, ucdisasm.decode, 'avr', 'not bytes')
+        self.assertRaises(IndexError, lambda: ucdisasm.decode('avr', b'')[0])
+
+    def test_threads(self):
+        expected = ucdisasm.text('avr', self.data)
+        results = []
+        def worker():
+            for i in range(20):
+                results.append(ucdisasm.text('avr', self.data) == expected)
+        threads = [threading.Thread(target=worker) for i in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertTrue(all(results))
+        self.assertEqual(len(results), 160)
+
+if __name__ == '__main__':
+    unittest.main()
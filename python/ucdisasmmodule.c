@@ -0,0 +1,471 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ucdisasm.h>
+#include <printstream_file.h>
+#include <printstream_record.h>
+#include <printstream_binary.h>
+
+/* Python Extension Module
+ *
+ * Exposes the in-memory disassembly of libucdisasm to Python, without a
+ * ucdisasm process per call. The input is read in place through the buffer
+ * protocol, and disassembly runs with the GIL released.
+ *
+ *   ucdisasm.decode(arch, data, address=0) -> Records
+ *   ucdisasm.text(arch, data, address=0, flags=DEFAULT_FLAGS) -> str
+ *   ucdisasm.mnemonics(arch) -> tuple of str
+ *
+ * Records holds the binary records of printstream_binary.h, without the
+ * header, and exports them through the buffer protocol, so that
+ * memoryview(records), struct.iter_unpack(RECORD_FORMAT, records), or
+ * numpy.frombuffer(records, ...) read them without a copy. Indexing Records
+ * decodes one record into a Record named tuple.
+ *
+ * text() with FLAG_ASSEMBLY labels only the instructions that operands refer
+ * to, as ucdisasm --assembly does, unless FLAG_ALL_LABELS is given.
+ */
+
+/* struct format of a record, see printstream_binary.h */
+#define RECORD_FORMAT   "<IHBB4sB3B3iI"
+
+/* Default text listing flags, as for the ucdisasm command line */
+#define DEFAULT_FLAGS   (PRINT_FLAG_ADDRESSES | PRINT_FLAG_DESTINATION_COMMENT | PRINT_FLAG_OPCODES | PRINT_FLAG_DATA_HEX)
+
+static PyObject *Error;
+
+/******************************************************************************/
+/* Growable Output Buffer */
+/******************************************************************************/
+
+/* Disassembly output, filled without the GIL */
+struct output_buffer {
+    char *data;
+    size_t len, capacity;
+    int flags;
+    int failed;
+};
+
+static char *util_buffer_reserve(struct output_buffer *buf, size_t len) {
+    char *data;
+    size_t capacity;
+
+    if (buf->len + len > buf->capacity) {
+        capacity = (buf->capacity == 0) ? 4096 : buf->capacity;
+        while (capacity < buf->len + len)
+            capacity *= 2;
+        if ((data = realloc(buf->data, capacity)) == NULL) {
+            buf->failed = 1;
+            return NULL;
+        }
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+
+    return buf->data + buf->len;
+}
+
+static int util_record_callback(struct instruction *instr, void *arg) {
+    struct output_buffer *buf = (struct output_buffer *)arg;
+    char *record;
+
+    if ((record = util_buffer_reserve(buf, PRINTSTREAM_BINARY_RECORD_SIZE)) == NULL)
+        return 1;
+    printstream_binary_encode(instr, (uint8_t *)record, buf->flags);
+    buf->len += PRINTSTREAM_BINARY_RECORD_SIZE;
+
+    return 0;
+}
+
+static int util_text_callback(struct instruction *instr, void *arg) {
+    struct output_buffer *buf = (struct output_buffer *)arg;
+    char *line;
+    int len;
+
+    if ((line = util_buffer_reserve(buf, PRINTSTREAM_FILE_LINE_LEN)) == NULL)
+        return 1;
+    len = printstream_file_format(instr, line, PRINTSTREAM_FILE_LINE_LEN, buf->flags);
+    if (len >= PRINTSTREAM_FILE_LINE_LEN)
+        len = PRINTSTREAM_FILE_LINE_LEN - 1;
+    if (len > 0)
+        buf->len += len;
+
+    return 0;
+}
+
+/* Disassemble data into buf with callback, raises and returns -1 on failure */
+static int util_disassemble(int arch, Py_buffer *data, unsigned long address, ucdisasm_callback callback, struct output_buffer *buf) {
+    int ret;
+
+    if ((uint64_t)data->len > UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "data is too long");
+        return -1;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = ucdisasm_disassemble_listing(arch, data->buf, data->len, address, buf->flags, callback, buf);
+    Py_END_ALLOW_THREADS
+
+    if (buf->failed) {
+        PyErr_NoMemory();
+        return -1;
+    } else if (ret < 0) {
+        PyErr_Format(Error, "disassembly failed with error %d", ret);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int util_arch_lookup(const char *name) {
+    int arch;
+
+    if ((arch = ucdisasm_arch_lookup(name)) < 0)
+        PyErr_Format(PyExc_ValueError, "unknown architecture '%s'", name);
+
+    return arch;
+}
+
+/******************************************************************************/
+/* Record Named Tuple */
+/******************************************************************************/
+
+static PyStructSequence_Field Record_Fields[] = {
+    {"type", "'instruction' or 'directive'"},
+    {"address", "address, or None for a directive"},
+    {"mnemonic", "instruction mnemonic or directive name"},
+    {"width", "width in bytes"},
+    {"opcodes", "opcode bytes"},
+    {"operands", "tuple of (kind, value) operands"},
+    {"target", "branch target address, or None"},
+    {NULL, NULL},
+};
+
+static PyStructSequence_Desc Record_Desc = {
+    "ucdisasm.Record",
+    "A disassembled instruction or directive",
+    Record_Fields,
+    7,
+};
+
+static PyTypeObject *RecordType;
+
+/******************************************************************************/
+/* Records Type */
+/******************************************************************************/
+
+typedef struct {
+    PyObject_HEAD
+    char *data;
+    Py_ssize_t len;
+    int arch;
+} RecordsObject;
+
+static void Records_dealloc(RecordsObject *self) {
+    free(self->data);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+/* The records are immutable, so views need no bookkeeping */
+static int Records_getbuffer(RecordsObject *self, Py_buffer *view, int flags) {
+    return PyBuffer_FillInfo(view, (PyObject *)self, self->data, self->len, 1, flags);
+}
+
+static Py_ssize_t Records_length(RecordsObject *self) {
+    return self->len / PRINTSTREAM_BINARY_RECORD_SIZE;
+}
+
+static uint32_t util_get_u32(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static PyObject *Records_item(RecordsObject *self, Py_ssize_t index) {
+    struct DisasmStream ds;
+    isa_mnemonic_func isa_mnemonic;
+    const uint8_t *record;
+    const char *mnemonic;
+    PyObject *result, *operands, *value;
+    unsigned int i, isa_index, kind, width;
+    uint32_t target;
+    int directive;
+
+    if (index < 0 || index >= Records_length(self)) {
+        PyErr_SetString(PyExc_IndexError, "record index out of range");
+        return NULL;
+    }
+    record = (const uint8_t *)self->data + index * PRINTSTREAM_BINARY_RECORD_SIZE;
+
+    directive = (record[6] == 1);
+    isa_index = record[4] | (record[5] << 8);
+    if (directive) {
+        mnemonic = (isa_index < PRINTSTREAM_BINARY_NUM_DIRECTIVES) ? Binary_Directive_Names[isa_index] : "";
+    } else {
+        isa_mnemonic = ucdisasm_disasmstream_setup(&ds, self->arch);
+        mnemonic = isa_mnemonic(isa_index);
+    }
+    width = (record[7] < 4) ? record[7] : 4;
+
+    if ((operands = PyTuple_New(record[12])) == NULL)
+        return NULL;
+    for (i = 0; i < record[12]; i++) {
+        kind = record[13 + i];
+        value = Py_BuildValue("(si)", (kind <= OPERAND_KIND_RAW) ? Operand_Kind_Names[kind] : "",
+                              (int32_t)util_get_u32(record + 16 + 4*i));
+        if (value == NULL) {
+            Py_DECREF(operands);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(operands, i, value);
+    }
+
+    if ((result = PyStructSequence_New(RecordType)) == NULL) {
+        Py_DECREF(operands);
+        return NULL;
+    }
+
+    target = util_get_u32(record + 28);
+    PyStructSequence_SET_ITEM(result, 0, PyUnicode_FromString(directive ? "directive" : "instruction"));
+    if (directive) {
+        Py_INCREF(Py_None);
+        PyStructSequence_SET_ITEM(result, 1, Py_None);
+    } else {
+        PyStructSequence_SET_ITEM(result, 1, PyLong_FromUnsignedLong(util_get_u32(record)));
+    }
+    PyStructSequence_SET_ITEM(result, 2, PyUnicode_FromString((mnemonic != NULL) ? mnemonic : ""));
+    PyStructSequence_SET_ITEM(result, 3, PyLong_FromLong(record[7]));
+    PyStructSequence_SET_ITEM(result, 4, PyBytes_FromStringAndSize((const char *)record + 8, width));
+    PyStructSequence_SET_ITEM(result, 5, operands);
+    if (target == 0xffffffff) {
+        Py_INCREF(Py_None);
+        PyStructSequence_SET_ITEM(result, 6, Py_None);
+    } else {
+        PyStructSequence_SET_ITEM(result, 6, PyLong_FromUnsignedLong(target));
+    }
+
+    for (i = 0; i < 7; i++) {
+        if (PyStructSequence_GET_ITEM(result, i) == NULL) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+static PyBufferProcs Records_as_buffer = {
+    (getbufferproc)Records_getbuffer,
+    NULL,
+};
+
+static PySequenceMethods Records_as_sequence = {
+    .sq_length = (lenfunc)Records_length,
+    .sq_item = (ssizeargfunc)Records_item,
+};
+
+static PyMemberDef Records_members[] = {
+    {"nbytes", T_PYSSIZET, offsetof(RecordsObject, len), READONLY, "length of the records in bytes"},
+    {NULL},
+};
+
+static PyTypeObject RecordsType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "ucdisasm.Records",
+    .tp_basicsize = sizeof(RecordsObject),
+    .tp_dealloc = (destructor)Records_dealloc,
+    .tp_as_sequence = &Records_as_sequence,
+    .tp_as_buffer = &Records_as_buffer,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Binary disassembly records, RECORD_SIZE bytes each, exported through the buffer protocol",
+    .tp_members = Records_members,
+};
+
+/******************************************************************************/
+/* Module Functions */
+/******************************************************************************/
+
+static PyObject *ucdisasm_decode(PyObject *module, PyObject *args, PyObject *kwargs) {
+    static char *keywords[] = {"arch", "data", "address", NULL};
+    struct output_buffer buf;
+    RecordsObject *records;
+    const char *arch_name;
+    unsigned long address = 0;
+    Py_buffer data;
+    int arch;
+
+    (void)module;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sy*|k", keywords, &arch_name, &data, &address))
+        return NULL;
+    if ((arch = util_arch_lookup(arch_name)) < 0) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    memset(&buf, 0, sizeof(buf));
+    buf.flags = PRINT_FLAG_DATA_HEX;
+    if (util_disassemble(arch, &data, address, util_record_callback, &buf) < 0) {
+        PyBuffer_Release(&data);
+        free(buf.data);
+        return NULL;
+    }
+    PyBuffer_Release(&data);
+
+    /* The records keep the buffer, instead of copying it into a bytes */
+    if ((records = PyObject_New(RecordsObject, &RecordsType)) == NULL) {
+        free(buf.data);
+        return NULL;
+    }
+    records->data = buf.data;
+    records->len = buf.len;
+    records->arch = arch;
+
+    return (PyObject *)records;
+}
+
+static PyObject *ucdisasm_text(PyObject *module, PyObject *args, PyObject *kwargs) {
+    static char *keywords[] = {"arch", "data", "address", "flags", NULL};
+    struct output_buffer buf;
+    PyObject *result;
+    const char *arch_name;
+    unsigned long address = 0;
+    int flags = DEFAULT_FLAGS;
+    Py_buffer data;
+    int arch;
+
+    (void)module;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sy*|ki", keywords, &arch_name, &data, &address, &flags))
+        return NULL;
+    if ((arch = util_arch_lookup(arch_name)) < 0) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    memset(&buf, 0, sizeof(buf));
+    buf.flags = flags;
+    if (util_disassemble(arch, &data, address, util_text_callback, &buf) < 0) {
+        PyBuffer_Release(&data);
+        free(buf.data);
+        return NULL;
+    }
+    PyBuffer_Release(&data);
+
+    result = PyUnicode_DecodeUTF8((buf.data != NULL) ? buf.data : "", buf.len, "replace");
+    free(buf.data);
+
+    return result;
+}
+
+static PyObject *ucdisasm_mnemonics(PyObject *module, PyObject *args) {
+    struct DisasmStream ds;
+    isa_mnemonic_func isa_mnemonic;
+    const char *arch_name, *mnemonic;
+    PyObject *list, *result, *str;
+    unsigned int i;
+    int arch;
+
+    (void)module;
+
+    if (!PyArg_ParseTuple(args, "s", &arch_name))
+        return NULL;
+    if ((arch = util_arch_lookup(arch_name)) < 0)
+        return NULL;
+    isa_mnemonic = ucdisasm_disasmstream_setup(&ds, arch);
+
+    if ((list = PyList_New(0)) == NULL)
+        return NULL;
+    for (i = 0; (mnemonic = isa_mnemonic(i)) != NULL; i++) {
+        if ((str = PyUnicode_FromString(mnemonic)) == NULL || PyList_Append(list, str) < 0) {
+            Py_XDECREF(str);
+            Py_DECREF(list);
+            return NULL;
+        }
+        Py_DECREF(str);
+    }
+
+    result = PyList_AsTuple(list);
+    Py_DECREF(list);
+
+    return result;
+}
+
+static PyMethodDef ucdisasm_methods[] = {
+    {"decode", (PyCFunction)(void (*)(void))ucdisasm_decode, METH_VARARGS | METH_KEYWORDS,
+     "decode(arch, data, address=0) -> Records\n\nDisassemble a bytes-like object loaded at address into binary records."},
+    {"text", (PyCFunction)(void (*)(void))ucdisasm_text, METH_VARARGS | METH_KEYWORDS,
+     "text(arch, data, address=0, flags=DEFAULT_FLAGS) -> str\n\nDisassemble a bytes-like object loaded at address into a text listing."},
+    {"mnemonics", ucdisasm_mnemonics, METH_VARARGS,
+     "mnemonics(arch) -> tuple\n\nInstruction set mnemonics, indexed by a record's instruction set index."},
+    {NULL, NULL, 0, NULL},
+};
+
+static struct PyModuleDef ucdisasm_module = {
+    PyModuleDef_HEAD_INIT,
+    "ucdisasm",
+    "Microcontroller disassembler",
+    -1,
+    ucdisasm_methods,
+};
+
+/* Tuple of the strings in names[0, n) */
+static PyObject *util_names_tuple(const char *const *names, unsigned int n) {
+    PyObject *tuple, *str;
+    unsigned int i;
+
+    if ((tuple = PyTuple_New(n)) == NULL)
+        return NULL;
+    for (i = 0; i < n; i++) {
+        if ((str = PyUnicode_FromString(names[i])) == NULL) {
+            Py_DECREF(tuple);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(tuple, i, str);
+    }
+
+    return tuple;
+}
+
+PyMODINIT_FUNC PyInit_ucdisasm(void) {
+    static const char *const arch_names[] = {"avr", "pic-baseline", "pic-midrange", "pic-enhanced", "pic-18", "8051"};
+    PyObject *module;
+
+    if (PyType_Ready(&RecordsType) < 0)
+        return NULL;
+    if ((RecordType = PyStructSequence_NewType(&Record_Desc)) == NULL)
+        return NULL;
+
+    if ((module = PyModule_Create(&ucdisasm_module)) == NULL)
+        return NULL;
+
+    Error = PyErr_NewException("ucdisasm.Error", NULL, NULL);
+    Py_INCREF(&RecordsType);
+    if (Error == NULL ||
+            PyModule_AddObject(module, "Error", Error) < 0 ||
+            PyModule_AddObject(module, "Records", (PyObject *)&RecordsType) < 0 ||
+            PyModule_AddObject(module, "Record", (PyObject *)RecordType) < 0 ||
+            PyModule_AddObject(module, "ARCHITECTURES", util_names_tuple(arch_names, sizeof(arch_names)/sizeof(arch_names[0]))) < 0 ||
+            PyModule_AddObject(module, "OPERAND_KINDS", util_names_tuple(Operand_Kind_Names, OPERAND_KIND_RAW + 1)) < 0 ||
+            PyModule_AddObject(module, "DIRECTIVES", util_names_tuple(Binary_Directive_Names, PRINTSTREAM_BINARY_NUM_DIRECTIVES)) < 0 ||
+            PyModule_AddIntConstant(module, "RECORD_SIZE", PRINTSTREAM_BINARY_RECORD_SIZE) < 0 ||
+            PyModule_AddStringConstant(module, "RECORD_FORMAT", RECORD_FORMAT) < 0 ||
+            PyModule_AddIntConstant(module, "FLAG_ASSEMBLY", PRINT_FLAG_ASSEMBLY) < 0 ||
+            PyModule_AddIntConstant(module, "FLAG_ADDRESSES", PRINT_FLAG_ADDRESSES) < 0 ||
+            PyModule_AddIntConstant(module, "FLAG_DESTINATION_COMMENT", PRINT_FLAG_DESTINATION_COMMENT) < 0 ||
+            PyModule_AddIntConstant(module, "FLAG_DATA_HEX", PRINT_FLAG_DATA_HEX) < 0 ||
+            PyModule_AddIntConstant(module, "FLAG_DATA_BIN", PRINT_FLAG_DATA_BIN) < 0 ||
+            PyModule_AddIntConstant(module, "FLAG_DATA_DEC", PRINT_FLAG_DATA_DEC) < 0 ||
+            PyModule_AddIntConstant(module, "FLAG_OPCODES", PRINT_FLAG_OPCODES) < 0 ||
+            PyModule_AddIntConstant(module, "FLAG_ALL_LABELS", PRINT_FLAG_ALL_LABELS) < 0 ||
+            PyModule_AddIntConstant(module, "DEFAULT_FLAGS", DEFAULT_FLAGS) < 0) {
+        Py_DECREF(module);
+        return NULL;
+    }
+
+    return module;
+}
+
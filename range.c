@@ -0,0 +1,97 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <range.h>
+
+/******************************************************************************/
+/* Address Range Disasm Stream Support */
+/******************************************************************************/
+
+struct range_state {
+    struct DisasmStream *source;
+    uint32_t start, end;
+};
+
+int range_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, uint32_t start, uint32_t end) {
+    struct range_state *state;
+
+    /* Allocate stream state */
+    state = malloc(sizeof(struct range_state));
+    if (state == NULL) {
+        self->error = "Error allocating range stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->source = source;
+    state->start = start;
+    state->end = end;
+
+    self->in = source->in;
+    self->state = state;
+    self->error = NULL;
+    self->stream_init = range_disasmstream_init;
+    self->stream_close = range_disasmstream_close;
+    self->stream_read = range_disasmstream_read;
+
+    return 0;
+}
+
+int range_disasmstream_init(struct DisasmStream *self) {
+    struct range_state *state = (struct range_state *)self->state;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the source stream */
+    if (state->source->stream_init(state->source) < 0) {
+        self->error = state->source->error;
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int range_disasmstream_close(struct DisasmStream *self) {
+    struct range_state *state = (struct range_state *)self->state;
+    int ret = 0;
+
+    /* Close the source stream */
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free stream state memory */
+    free(state);
+
+    return ret;
+}
+
+int range_disasmstream_read(struct DisasmStream *self, struct instruction *instr) {
+    struct range_state *state = (struct range_state *)self->state;
+    uint32_t address;
+    int ret;
+
+    while (1) {
+        ret = state->source->stream_read(state->source, instr);
+        if (ret == STREAM_EOF) {
+            return STREAM_EOF;
+        } else if (ret < 0) {
+            self->error = state->source->error;
+            return ret;
+        }
+
+        if (instr->type == DISASM_TYPE_DIRECTIVE)
+            return 0;
+
+        address = instr->get_address(instr);
+        if (address >= state->start && address < state->end)
+            return 0;
+
+        instr->free(instr);
+    }
+}
+
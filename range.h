@@ -0,0 +1,24 @@
+#ifndef RANGE_H
+#define RANGE_H
+
+#include <stdint.h>
+#include <disasmstream.h>
+
+/* Address Range Stream Support
+ *
+ * A range stream passes through the instructions of a source DisasmStream
+ * that start within [start, end), and drops the others. Directives are passed
+ * through unchanged. The source is initialized and closed with the range
+ * stream.
+ */
+
+/* Setup self to filter the source stream to [start, end) */
+int range_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, uint32_t start, uint32_t end);
+
+/* Range Disasm Stream Support */
+int range_disasmstream_init(struct DisasmStream *self);
+int range_disasmstream_close(struct DisasmStream *self);
+int range_disasmstream_read(struct DisasmStream *self, struct instruction *instr);
+
+#endif
+
@@ -0,0 +1,107 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+
+#include <ring.h>
+#include <budget.h>
+
+/******************************************************************************/
+/* Single-Producer / Single-Consumer Ring Support */
+/******************************************************************************/
+
+int ring_init(struct ring *ring, unsigned int num_slots, size_t slot_size) {
+    /* Number of slots must be a power of two for the index mask */
+    if (num_slots == 0 || (num_slots & (num_slots - 1)) != 0)
+        return -1;
+
+    /* Slots are charged to the memory budget */
+    if (budget_charge(num_slots * slot_size) < 0)
+        return -1;
+    ring->slots = malloc(num_slots * slot_size);
+    if (ring->slots == NULL) {
+        budget_release(num_slots * slot_size);
+        return -1;
+    }
+
+    ring->slot_size = slot_size;
+    ring->num_slots = num_slots;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->closed, 0);
+
+    return 0;
+}
+
+void ring_free(struct ring *ring) {
+    if (ring->slots != NULL)
+        budget_release(ring->num_slots * ring->slot_size);
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+void ring_close(struct ring *ring) {
+    atomic_store_explicit(&ring->closed, 1, memory_order_release);
+}
+
+/* Back off while waiting on the other side: spin briefly, then yield, then
+ * sleep, so that an idle stage does not burn a core */
+static void util_backoff(unsigned int *spins) {
+    struct timespec ts = {0, 50000};
+
+    if (*spins < 64) {
+        (*spins)++;
+    } else if (*spins < 128) {
+        (*spins)++;
+        sched_yield();
+    } else {
+        nanosleep(&ts, NULL);
+    }
+}
+
+void *ring_write_acquire(struct ring *ring) {
+    unsigned int tail, spins = 0;
+
+    tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    /* Wait for a free slot */
+    while (tail - atomic_load_explicit(&ring->head, memory_order_acquire) == ring->num_slots) {
+        if (atomic_load_explicit(&ring->closed, memory_order_acquire))
+            return NULL;
+        util_backoff(&spins);
+    }
+
+    if (atomic_load_explicit(&ring->closed, memory_order_acquire))
+        return NULL;
+
+    return ring->slots + (tail & (ring->num_slots - 1)) * ring->slot_size;
+}
+
+void ring_write_commit(struct ring *ring) {
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    /* Publish the slot contents along with the new tail */
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+void *ring_read_acquire(struct ring *ring) {
+    unsigned int head, spins = 0;
+
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    /* Wait for a filled slot */
+    while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head) {
+        if (atomic_load_explicit(&ring->closed, memory_order_acquire))
+            return NULL;
+        util_backoff(&spins);
+    }
+
+    return ring->slots + (head & (ring->num_slots - 1)) * ring->slot_size;
+}
+
+void ring_read_release(struct ring *ring) {
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    /* Hand the slot back to the producer */
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
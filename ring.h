@@ -0,0 +1,40 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+/* Bounded single-producer / single-consumer lock-free ring of fixed size
+ * slots. The producer fills a slot in place between ring_write_acquire() and
+ * ring_write_commit(), the consumer drains it in place between
+ * ring_read_acquire() and ring_read_release(). A full ring blocks the
+ * producer, which is the pipeline's backpressure. */
+struct ring {
+    /* Slot storage */
+    uint8_t *slots;
+    size_t slot_size;
+    /* Number of slots, a power of two */
+    unsigned int num_slots;
+
+    /* Free running read and write counters */
+    atomic_uint head;
+    atomic_uint tail;
+    /* Closed flag, set to abort a blocked producer or consumer */
+    atomic_int closed;
+};
+
+int ring_init(struct ring *ring, unsigned int num_slots, size_t slot_size);
+void ring_free(struct ring *ring);
+void ring_close(struct ring *ring);
+
+/* Producer side, acquire returns NULL if the ring was closed */
+void *ring_write_acquire(struct ring *ring);
+void ring_write_commit(struct ring *ring);
+
+/* Consumer side, acquire returns NULL if the ring was closed and is empty */
+void *ring_read_acquire(struct ring *ring);
+void ring_read_release(struct ring *ring);
+
+#endif
+
@@ -0,0 +1,516 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+#include <printstream.h>
+#include <instruction.h>
+#include <printstream_file.h>
+#include <budget.h>
+#include <search.h>
+
+/* Most alternative mnemonics of a pattern instruction */
+#define SEARCH_MAX_ALTERNATIVES     8
+
+/* Mnemonic classes of a pattern instruction, while compiling */
+struct search_alternatives {
+    unsigned int num_classes;
+    uint16_t classes[SEARCH_MAX_ALTERNATIVES];
+};
+
+/******************************************************************************/
+/* Pattern Parsing */
+/******************************************************************************/
+
+/* Trim leading and trailing whitespace in place */
+static char *util_trim(char *s) {
+    char *end;
+
+    while (isspace((unsigned char)*s))
+        s++;
+    end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1]))
+        *--end = '\0';
+
+    return s;
+}
+
+static int util_parse_operand(char *text, struct search_operand *operand) {
+    char *end;
+
+    text = util_trim(text);
+    memset(operand, 0, sizeof(struct search_operand));
+    if (strcmp(text, "*") == 0) {
+        operand->any = 1;
+        return 0;
+    }
+    if (text[0] == '\0' || strlen(text) >= sizeof(operand->text))
+        return -1;
+
+    strcpy(operand->text, text);
+    operand->value = strtol(text, &end, 0);
+    operand->has_value = (*end == '\0');
+
+    return 0;
+}
+
+/* Parse one instruction of a pattern, "mnemonic[|mnemonic...] [operand[, operand...]]" */
+static int util_parse_element(const struct search_automaton *automaton, isa_mnemonic_func isa_mnemonic, char *text, struct search_element *element, struct search_alternatives *alternatives, const char **error) {
+    char *mnemonics, *operands, *saveptr, *token;
+    unsigned int i;
+
+    text = util_trim(text);
+    mnemonics = text;
+    for (operands = text; *operands != '\0' && !isspace((unsigned char)*operands); operands++)
+        ;
+    if (*operands != '\0')
+        *operands++ = '\0';
+
+    /* Mnemonic classes */
+    alternatives->num_classes = 0;
+    for (token = strtok_r(mnemonics, "|", &saveptr); token != NULL; token = strtok_r(NULL, "|", &saveptr)) {
+        for (i = 0; i < automaton->num_entries; i++) {
+            if (strcasecmp(token, isa_mnemonic(i)) == 0)
+                break;
+        }
+        if (i == automaton->num_entries) {
+            *error = "Unknown mnemonic in search pattern!";
+            return -1;
+        }
+        if (alternatives->num_classes == SEARCH_MAX_ALTERNATIVES) {
+            *error = "Too many alternative mnemonics in search pattern!";
+            return -1;
+        }
+        alternatives->classes[alternatives->num_classes++] = automaton->classes[i];
+    }
+    if (alternatives->num_classes == 0) {
+        *error = "Missing mnemonic in search pattern!";
+        return -1;
+    }
+
+    /* Operand predicates */
+    element->num_operands = 0;
+    operands = util_trim(operands);
+    if (*operands == '\0')
+        return 0;
+    for (token = strtok_r(operands, ",", &saveptr); token != NULL; token = strtok_r(NULL, ",", &saveptr)) {
+        if (element->num_operands == SEARCH_MAX_OPERANDS) {
+            *error = "Too many operands in search pattern!";
+            return -1;
+        }
+        if (util_parse_operand(token, &element->operands[element->num_operands++]) < 0) {
+            *error = "Invalid operand in search pattern!";
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Automaton Construction */
+/******************************************************************************/
+
+/* Add the paths of a pattern's mnemonic alternatives from state to the trie,
+ * marking their ends with the pattern's bit */
+static int util_trie_insert(struct search_automaton *automaton, const struct search_alternatives *alternatives, unsigned int length, unsigned int depth, int32_t state, unsigned int pattern) {
+    int32_t *next;
+    unsigned int i;
+
+    if (depth == length) {
+        automaton->outputs[state] |= (uint64_t)1 << pattern;
+        return 0;
+    }
+
+    for (i = 0; i < alternatives[depth].num_classes; i++) {
+        next = &automaton->next[(size_t)state * automaton->num_classes + alternatives[depth].classes[i]];
+        if (*next < 0) {
+            if (automaton->num_states == SEARCH_MAX_STATES)
+                return -1;
+            *next = automaton->num_states++;
+        }
+        if (util_trie_insert(automaton, alternatives, length, depth + 1, *next, pattern) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+/* Complete the trie's transitions with its failure links, breadth first, so
+ * every state has a next state for every class */
+static int util_complete(struct search_automaton *automaton) {
+    int32_t *fail, *queue, *next = automaton->next;
+    unsigned int head = 0, tail = 0, c, num_classes = automaton->num_classes;
+    int32_t state, child;
+
+    fail = calloc(automaton->num_states, sizeof(int32_t));
+    queue = malloc(automaton->num_states * sizeof(int32_t));
+    if (fail == NULL || queue == NULL) {
+        free(fail);
+        free(queue);
+        return -1;
+    }
+
+    for (c = 0; c < num_classes; c++) {
+        if (next[c] < 0) {
+            next[c] = 0;
+        } else {
+            fail[next[c]] = 0;
+            queue[tail++] = next[c];
+        }
+    }
+
+    while (head < tail) {
+        state = queue[head++];
+        /* Patterns ending at the longest proper suffix also end here */
+        automaton->outputs[state] |= automaton->outputs[fail[state]];
+        for (c = 0; c < num_classes; c++) {
+            child = next[(size_t)state * num_classes + c];
+            if (child < 0) {
+                next[(size_t)state * num_classes + c] = next[(size_t)fail[state] * num_classes + c];
+            } else {
+                fail[child] = next[(size_t)fail[state] * num_classes + c];
+                queue[tail++] = child;
+            }
+        }
+    }
+
+    free(fail);
+    free(queue);
+
+    return 0;
+}
+
+int search_compile(struct search_automaton *automaton, const char *const *patterns, unsigned int num_patterns, isa_mnemonic_func isa_mnemonic, const char **error) {
+    struct search_alternatives alternatives[SEARCH_MAX_LENGTH];
+    struct search_pattern *pattern;
+    char *text, *element, *saveptr;
+    unsigned int i, j;
+    size_t size;
+    int32_t *next;
+
+    memset(automaton, 0, sizeof(struct search_automaton));
+
+    if (num_patterns == 0 || num_patterns > SEARCH_MAX_PATTERNS) {
+        *error = "Too many search patterns!";
+        return -1;
+    }
+
+    /* Mnemonic class of each instruction set table entry */
+    for (automaton->num_entries = 0; isa_mnemonic(automaton->num_entries) != NULL; automaton->num_entries++)
+        ;
+    if ((automaton->classes = malloc(automaton->num_entries * sizeof(uint16_t))) == NULL) {
+        *error = "Error allocating search automaton!";
+        return -1;
+    }
+    for (i = 0; i < automaton->num_entries; i++) {
+        for (j = 0; j < i; j++) {
+            if (strcasecmp(isa_mnemonic(i), isa_mnemonic(j)) == 0)
+                break;
+        }
+        automaton->classes[i] = (j < i) ? automaton->classes[j] : automaton->num_classes++;
+    }
+
+    /* Trie of the largest size, shrunk once built */
+    size = (size_t)SEARCH_MAX_STATES * automaton->num_classes * sizeof(int32_t) + SEARCH_MAX_STATES * sizeof(uint64_t);
+    if (budget_charge(size) < 0) {
+        *error = "Error allocating search automaton!";
+        search_free(automaton);
+        return -1;
+    }
+    automaton->charged = size;
+    automaton->next = malloc((size_t)SEARCH_MAX_STATES * automaton->num_classes * sizeof(int32_t));
+    automaton->outputs = calloc(SEARCH_MAX_STATES, sizeof(uint64_t));
+    if (automaton->next == NULL || automaton->outputs == NULL) {
+        *error = "Error allocating search automaton!";
+        search_free(automaton);
+        return -1;
+    }
+    memset(automaton->next, 0xff, (size_t)SEARCH_MAX_STATES * automaton->num_classes * sizeof(int32_t));
+    automaton->num_states = 1;
+
+    for (i = 0; i < num_patterns; i++) {
+        pattern = &automaton->patterns[i];
+        pattern->text = patterns[i];
+        pattern->length = 0;
+
+        if ((text = strdup(patterns[i])) == NULL) {
+            *error = "Error allocating search automaton!";
+            search_free(automaton);
+            return -1;
+        }
+        for (element = strtok_r(text, ";", &saveptr); element != NULL; element = strtok_r(NULL, ";", &saveptr)) {
+            if (*util_trim(element) == '\0')
+                continue;
+            if (pattern->length == SEARCH_MAX_LENGTH) {
+                *error = "Too many instructions in search pattern!";
+                break;
+            }
+            if (util_parse_element(automaton, isa_mnemonic, element, &pattern->elements[pattern->length], &alternatives[pattern->length], error) < 0)
+                break;
+            pattern->length++;
+        }
+        free(text);
+
+        if (element != NULL) {
+            search_free(automaton);
+            return -1;
+        }
+        if (pattern->length == 0) {
+            *error = "Empty search pattern!";
+            search_free(automaton);
+            return -1;
+        }
+        if (util_trie_insert(automaton, alternatives, pattern->length, 0, 0, i) < 0) {
+            *error = "Search patterns too large!";
+            search_free(automaton);
+            return -1;
+        }
+        if (pattern->length > automaton->max_length)
+            automaton->max_length = pattern->length;
+    }
+    automaton->num_patterns = num_patterns;
+
+    if (util_complete(automaton) < 0) {
+        *error = "Error allocating search automaton!";
+        search_free(automaton);
+        return -1;
+    }
+
+    /* Shrink the tables to the states used */
+    if ((next = realloc(automaton->next, (size_t)automaton->num_states * automaton->num_classes * sizeof(int32_t))) != NULL)
+        automaton->next = next;
+    size = (size_t)automaton->num_states * automaton->num_classes * sizeof(int32_t) + SEARCH_MAX_STATES * sizeof(uint64_t);
+    budget_release(automaton->charged - size);
+    automaton->charged = size;
+
+    return 0;
+}
+
+void search_free(struct search_automaton *automaton) {
+    free(automaton->classes);
+    free(automaton->next);
+    free(automaton->outputs);
+    budget_release(automaton->charged);
+    automaton->classes = NULL;
+    automaton->next = NULL;
+    automaton->outputs = NULL;
+    automaton->charged = 0;
+}
+
+/******************************************************************************/
+/* Search Print Stream */
+/******************************************************************************/
+
+/* Instructions held for operand checks and context before a match */
+#define SEARCH_WINDOW_LEN   (SEARCH_MAX_LENGTH + SEARCH_MAX_CONTEXT)
+
+struct printstream_search_state {
+    const struct search_automaton *automaton;
+    unsigned int context;
+    int flags;
+
+    /* Last instructions read, instruction n at window[n % SEARCH_WINDOW_LEN] */
+    struct instruction window[SEARCH_WINDOW_LEN];
+    uint64_t count;
+    /* Automaton state */
+    int32_t state;
+
+    /* Instructions written, through printed - 1, and the context left to
+     * write after the last match */
+    uint64_t printed;
+    unsigned int after;
+};
+
+int printstream_search_setup(struct PrintStream *self, const struct search_automaton *automaton, unsigned int context) {
+    struct printstream_search_state *state;
+
+    if (context > SEARCH_MAX_CONTEXT)
+        context = SEARCH_MAX_CONTEXT;
+
+    state = self->state = calloc(1, sizeof(struct printstream_search_state));
+    if (state == NULL) {
+        self->error = "Error allocating format stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->automaton = automaton;
+    state->context = context;
+
+    self->error = NULL;
+    self->stream_init = printstream_search_init;
+    self->stream_close = printstream_search_close;
+    self->stream_read = printstream_search_read;
+
+    return 0;
+}
+
+int printstream_search_init(struct PrintStream *self, int flags) {
+    struct printstream_search_state *state = (struct printstream_search_state *)self->state;
+
+    state->flags = flags;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the input stream */
+    if (self->in->stream_init(self->in) < 0) {
+        self->error = "Error in input stream initialization!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int printstream_search_close(struct PrintStream *self) {
+    struct printstream_search_state *state = (struct printstream_search_state *)self->state;
+    uint64_t n;
+
+    /* Free the instructions still held */
+    for (n = (state->count > SEARCH_WINDOW_LEN) ? state->count - SEARCH_WINDOW_LEN : 0; n < state->count; n++)
+        state->window[n % SEARCH_WINDOW_LEN].free(&state->window[n % SEARCH_WINDOW_LEN]);
+
+    /* Free stream state memory */
+    free(self->state);
+
+    /* Close input stream */
+    if (self->in->stream_close(self->in) < 0) {
+        self->error = "Error in input stream close!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+static int util_operand_matches(struct instruction *instr, unsigned int index, const struct search_operand *operand, int flags) {
+    char text[64];
+
+    if (operand->any)
+        return 1;
+    if (index >= instr->get_num_operands(instr))
+        return 0;
+    if (operand->has_value && instr->get_operand_value(instr, index) == operand->value)
+        return 1;
+
+    text[0] = '\0';
+    instr->get_str_operand(instr, text, sizeof(text), index, flags);
+
+    return strcasecmp(text, operand->text) == 0;
+}
+
+/* Check the operands of pattern against the instructions ending at the last
+ * one read */
+static int util_pattern_matches(struct printstream_search_state *state, const struct search_pattern *pattern) {
+    const struct search_element *element;
+    struct instruction *instr;
+    uint64_t start = state->count - pattern->length;
+    unsigned int i, j;
+
+    for (i = 0; i < pattern->length; i++) {
+        element = &pattern->elements[i];
+        instr = &state->window[(start + i) % SEARCH_WINDOW_LEN];
+        for (j = 0; j < element->num_operands; j++) {
+            if (!util_operand_matches(instr, j, &element->operands[j], state->flags))
+                return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* Write instructions from through the last one read */
+static int util_write_lines(struct PrintStream *self, uint64_t from, FILE *out) {
+    struct printstream_search_state *state = (struct printstream_search_state *)self->state;
+    char line[PRINTSTREAM_FILE_LINE_LEN];
+
+    for (; from < state->count; from++) {
+        if (printstream_file_format(&state->window[from % SEARCH_WINDOW_LEN], line, sizeof(line), state->flags) > 0 && fputs(line, out) < 0) {
+            self->error = "Error writing to output file!";
+            return STREAM_ERROR_OUTPUT;
+        }
+    }
+    state->printed = state->count;
+
+    return 0;
+}
+
+/* Write a match of pattern ending at the last instruction read, with the
+ * context before it that was not written yet */
+static int util_write_match(struct PrintStream *self, const struct search_pattern *pattern, FILE *out) {
+    struct printstream_search_state *state = (struct printstream_search_state *)self->state;
+    uint64_t from = state->count - pattern->length;
+
+    from = (from > state->context) ? from - state->context : 0;
+    if (from < state->printed)
+        from = state->printed;
+    else if (state->printed > 0 && from > state->printed && fputs("--\n", out) < 0)
+        goto write_error;
+
+    if (fprintf(out, "; match: %s\n", pattern->text) < 0)
+        goto write_error;
+
+    state->after = state->context;
+
+    return util_write_lines(self, from, out);
+
+    write_error:
+    self->error = "Error writing to output file!";
+    return STREAM_ERROR_OUTPUT;
+}
+
+int printstream_search_read(struct PrintStream *self, FILE *out) {
+    struct printstream_search_state *state = (struct printstream_search_state *)self->state;
+    const struct search_automaton *automaton = state->automaton;
+    struct instruction instr;
+    unsigned int index, i;
+    uint64_t matches;
+    int ret;
+
+    /* Read a disassembled instruction */
+    ret = self->in->stream_read(self->in, &instr);
+    switch (ret) {
+        case 0:
+            break;
+        case STREAM_EOF:
+            return STREAM_EOF;
+        default:
+            self->error = "Error in disasm stream read!";
+            return STREAM_ERROR_INPUT;
+    }
+
+    /* Matches do not span gaps in the addresses */
+    if (instr.type == DISASM_TYPE_DIRECTIVE) {
+        state->state = 0;
+        instr.free(&instr);
+        return 0;
+    }
+
+    /* Hold the instruction in the window, in place of the oldest */
+    if (state->count >= SEARCH_WINDOW_LEN)
+        state->window[state->count % SEARCH_WINDOW_LEN].free(&state->window[state->count % SEARCH_WINDOW_LEN]);
+    state->window[state->count % SEARCH_WINDOW_LEN] = instr;
+    state->count++;
+
+    index = instr.get_isa_index(&instr);
+    if (index < automaton->num_entries)
+        state->state = automaton->next[(size_t)state->state * automaton->num_classes + automaton->classes[index]];
+    else
+        state->state = 0;
+
+    /* Check the operands of the patterns whose mnemonics end here */
+    matches = automaton->outputs[state->state];
+    for (i = 0; matches != 0 && i < automaton->num_patterns; i++) {
+        if ((matches & ((uint64_t)1 << i)) && util_pattern_matches(state, &automaton->patterns[i]))
+            return util_write_match(self, &automaton->patterns[i], out);
+    }
+
+    /* Context after a match */
+    if (state->after > 0) {
+        state->after--;
+        return util_write_lines(self, state->count - 1, out);
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,100 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <printstream.h>
+
+/* Instruction Pattern Search Support
+ *
+ * Finds sequences of instructions in the decoded stream, rather than lines
+ * in a listing. A pattern is a list of instructions separated by ';', each a
+ * mnemonic, or alternative mnemonics separated by '|', followed by operands
+ * separated by ',':
+ *
+ *      ldi r30, *; ldi r31, *; ijmp
+ *      movlw 0x0f; movwf *
+ *
+ * An operand is '*' for any operand, or text that matches the operand as it
+ * is printed, ignoring case. A number also matches an operand of that value.
+ * Operands left out at the end of an instruction are not checked.
+ *
+ * The patterns are compiled into one Aho-Corasick automaton over mnemonics:
+ * each instruction set table entry maps to the class of its mnemonic, and
+ * the automaton's transitions are completed into a table indexed by state
+ * and class, so each decoded instruction costs one lookup. A state that ends
+ * a pattern's mnemonics has the pattern's bit in its output mask, and only
+ * then are the pattern's operands checked against the instructions held in
+ * a window of the last ones read. Gaps in the addresses restart the
+ * automaton.
+ *
+ * The search print stream writes each match as text listing lines after a
+ * "; match" comment, with up to context instructions before and after it,
+ * and "--" between matches that are not adjacent.
+ */
+
+#define SEARCH_MAX_PATTERNS     64
+/* Most instructions in a pattern */
+#define SEARCH_MAX_LENGTH       16
+/* Most operands checked per instruction */
+#define SEARCH_MAX_OPERANDS     3
+/* Most automaton states */
+#define SEARCH_MAX_STATES       4096
+/* Most context instructions around a match */
+#define SEARCH_MAX_CONTEXT      64
+
+struct search_operand {
+    /* Matches any operand */
+    int any;
+    /* Value also matched, if has_value */
+    int has_value;
+    int32_t value;
+    char text[32];
+};
+
+struct search_element {
+    unsigned int num_operands;
+    struct search_operand operands[SEARCH_MAX_OPERANDS];
+};
+
+struct search_pattern {
+    const char *text;
+    unsigned int length;
+    struct search_element elements[SEARCH_MAX_LENGTH];
+};
+
+struct search_automaton {
+    /* Mnemonic class of each instruction set table entry */
+    uint16_t *classes;
+    unsigned int num_entries, num_classes;
+
+    /* Next state by state and class, and the patterns ending at a state */
+    int32_t *next;
+    uint64_t *outputs;
+    unsigned int num_states;
+
+    struct search_pattern patterns[SEARCH_MAX_PATTERNS];
+    unsigned int num_patterns, max_length;
+
+    /* Bytes charged to the memory budget */
+    size_t charged;
+};
+
+/* Compile the patterns for the instruction set of isa_mnemonic. Returns 0,
+ * or -1 with an error string. The pattern strings must outlive the
+ * automaton. */
+int search_compile(struct search_automaton *automaton, const char *const *patterns, unsigned int num_patterns, isa_mnemonic_func isa_mnemonic, const char **error);
+void search_free(struct search_automaton *automaton);
+
+/* Setup self to write the matches of the compiled patterns, with context
+ * instructions before and after each. The automaton is only read, and may
+ * be shared by streams on several threads. */
+int printstream_search_setup(struct PrintStream *self, const struct search_automaton *automaton, unsigned int context);
+
+/* Search Print Stream Support */
+int printstream_search_init(struct PrintStream *self, int flags);
+int printstream_search_close(struct PrintStream *self);
+int printstream_search_read(struct PrintStream *self, FILE *out);
+
+#endif
+
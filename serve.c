@@ -0,0 +1,764 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <serve.h>
+#include <budget.h>
+
+/* Longest request header line */
+#define SERVE_HEADER_LEN        8192
+/* Largest uploaded program file */
+#define SERVE_MAX_UPLOAD        (64*1024*1024)
+/* Number of program files kept in memory */
+#define SERVE_CACHE_ENTRIES     16
+/* Pending connection backlog */
+#define SERVE_BACKLOG           64
+/* Socket read buffer */
+#define SERVE_READ_BUFFER       4096
+
+/* Set by the SIGINT / SIGTERM handler to stop accepting connections */
+static volatile sig_atomic_t serve_stopping;
+
+/******************************************************************************/
+/* Program File Cache */
+/******************************************************************************/
+
+struct serve_file {
+    char path[4096];
+    off_t size;
+    struct timespec mtime;
+    uint8_t *data;
+    size_t len;
+    /* Number of requests using the file, and whether it is still cached */
+    unsigned int refs;
+    int cached;
+    unsigned long last_used;
+};
+
+struct serve_state {
+    serve_process_func process;
+    void *arg;
+
+    /* Queue of accepted connections */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int *queue;
+    unsigned int queue_size, queue_head, queue_count;
+    int stop;
+
+    /* Program file cache, protected by lock */
+    struct serve_file *cache[SERVE_CACHE_ENTRIES];
+    unsigned long uses;
+};
+
+/* Free a program file and return its charge to the budget */
+static void serve_file_free(struct serve_file *file) {
+    budget_release(file->len + 1);
+    free(file->data);
+    free(file);
+}
+
+/* Charge size bytes to the budget, evicting unused cached program files,
+ * least recently used first, until the charge fits. Returns 0, or -1 if
+ * nothing is left to evict. */
+static int serve_charge(struct serve_state *state, size_t size) {
+    struct serve_file *victim;
+    unsigned int i, slot;
+
+    while (budget_charge(size) < 0) {
+        pthread_mutex_lock(&state->lock);
+        for (i = 0, victim = NULL, slot = 0; i < SERVE_CACHE_ENTRIES; i++) {
+            if (state->cache[i] != NULL && state->cache[i]->refs == 0 && (victim == NULL || state->cache[i]->last_used < victim->last_used)) {
+                victim = state->cache[i];
+                slot = i;
+            }
+        }
+        if (victim != NULL)
+            state->cache[slot] = NULL;
+        pthread_mutex_unlock(&state->lock);
+
+        if (victim == NULL)
+            return -1;
+        serve_file_free(victim);
+    }
+
+    return 0;
+}
+
+static int util_read_file(const char *path, uint8_t **data, size_t len) {
+    FILE *fp;
+
+    if ((fp = fopen(path, "r")) == NULL)
+        return -1;
+
+    /* Keep a valid pointer for empty files */
+    if ((*data = malloc(len + 1)) == NULL || fread(*data, 1, len, fp) != len) {
+        free(*data);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    return 0;
+}
+
+/* Look up a program file, loading it if it is not cached or has changed.
+ * Sets *error and returns NULL on failure. */
+static struct serve_file *serve_file_get(struct serve_state *state, const char *path, const char **error) {
+    struct serve_file *file, *victim;
+    struct stat st;
+    unsigned int i;
+
+    *error = "Cannot open program file";
+    if (stat(path, &st) < 0)
+        return NULL;
+
+    pthread_mutex_lock(&state->lock);
+    for (i = 0; i < SERVE_CACHE_ENTRIES; i++) {
+        file = state->cache[i];
+        if (file != NULL && strcmp(file->path, path) == 0 && file->size == st.st_size &&
+                file->mtime.tv_sec == st.st_mtim.tv_sec && file->mtime.tv_nsec == st.st_mtim.tv_nsec) {
+            file->refs++;
+            file->last_used = ++state->uses;
+            pthread_mutex_unlock(&state->lock);
+            return file;
+        }
+    }
+    pthread_mutex_unlock(&state->lock);
+
+    /* Load the file outside the lock, charged to the budget */
+    if ((file = calloc(1, sizeof(struct serve_file))) == NULL)
+        return NULL;
+    file->len = st.st_size;
+    if (serve_charge(state, file->len + 1) < 0) {
+        free(file);
+        *error = "Memory budget exceeded";
+        return NULL;
+    }
+    if (util_read_file(path, &file->data, file->len) < 0) {
+        budget_release(file->len + 1);
+        free(file);
+        return NULL;
+    }
+    strncpy(file->path, path, sizeof(file->path) - 1);
+    file->size = st.st_size;
+    file->mtime = st.st_mtim;
+    file->refs = 1;
+
+    /* Replace a stale entry for the same path, or the least recently used */
+    pthread_mutex_lock(&state->lock);
+    for (i = 0, victim = NULL; i < SERVE_CACHE_ENTRIES; i++) {
+        if (state->cache[i] == NULL || strcmp(state->cache[i]->path, path) == 0) {
+            victim = state->cache[i];
+            break;
+        }
+    }
+    if (i == SERVE_CACHE_ENTRIES) {
+        for (i = 0; i < SERVE_CACHE_ENTRIES; i++) {
+            if (victim == NULL || state->cache[i]->last_used < victim->last_used)
+                victim = state->cache[i];
+        }
+        for (i = 0; state->cache[i] != victim; i++)
+            ;
+    }
+    if (victim != NULL) {
+        victim->cached = 0;
+        if (victim->refs == 0)
+            serve_file_free(victim);
+    }
+    state->cache[i] = file;
+    file->cached = 1;
+    file->last_used = ++state->uses;
+    pthread_mutex_unlock(&state->lock);
+
+    return file;
+}
+
+static void serve_file_put(struct serve_state *state, struct serve_file *file) {
+    pthread_mutex_lock(&state->lock);
+    /* Free files evicted while in use once the last request is done */
+    if (--file->refs == 0 && !file->cached)
+        serve_file_free(file);
+    pthread_mutex_unlock(&state->lock);
+}
+
+/******************************************************************************/
+/* Socket I/O */
+/******************************************************************************/
+
+static int util_write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    ssize_t n;
+
+    while (len > 0) {
+        n = write(fd, p, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        p += n;
+        len -= n;
+    }
+
+    return 0;
+}
+
+/* Buffered reader of a connection */
+struct serve_reader {
+    int fd;
+    uint8_t buf[SERVE_READ_BUFFER];
+    size_t pos, len;
+};
+
+static void util_reader_init(struct serve_reader *reader, int fd) {
+    reader->fd = fd;
+    reader->pos = reader->len = 0;
+}
+
+/* Refill an empty buffer, returns -1 on EOF or error */
+static int util_reader_fill(struct serve_reader *reader) {
+    ssize_t n;
+
+    do {
+        n = read(reader->fd, reader->buf, sizeof(reader->buf));
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0)
+        return -1;
+    reader->pos = 0;
+    reader->len = n;
+
+    return 0;
+}
+
+static int util_read_all(struct serve_reader *reader, void *buf, size_t len) {
+    uint8_t *p = buf;
+    ssize_t n;
+    size_t chunk;
+
+    /* Drain the buffer first */
+    chunk = (len < reader->len - reader->pos) ? len : reader->len - reader->pos;
+    memcpy(p, reader->buf + reader->pos, chunk);
+    reader->pos += chunk;
+    p += chunk;
+    len -= chunk;
+
+    /* Read the rest of a large read directly */
+    while (len >= sizeof(reader->buf)) {
+        n = read(reader->fd, p, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        p += n;
+        len -= n;
+    }
+
+    while (len > 0) {
+        if (util_reader_fill(reader) < 0)
+            return -1;
+        chunk = (len < reader->len) ? len : reader->len;
+        memcpy(p, reader->buf, chunk);
+        reader->pos = chunk;
+        p += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
+
+/* Read and drop len bytes */
+static int util_skip_all(struct serve_reader *reader, size_t len) {
+    size_t chunk;
+
+    while (len > 0) {
+        if (reader->pos == reader->len && util_reader_fill(reader) < 0)
+            return -1;
+        chunk = (len < reader->len - reader->pos) ? len : reader->len - reader->pos;
+        reader->pos += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
+
+/* Read a header line, returns its length, or -1 on EOF or error */
+static int util_read_line(struct serve_reader *reader, char *line, size_t size) {
+    size_t len = 0, chunk;
+    uint8_t *newline;
+
+    while (1) {
+        if (reader->pos == reader->len && util_reader_fill(reader) < 0)
+            return -1;
+
+        newline = memchr(reader->buf + reader->pos, '\n', reader->len - reader->pos);
+        chunk = (newline != NULL) ? (size_t)(newline - (reader->buf + reader->pos)) : reader->len - reader->pos;
+        if (len + chunk > size - 1)
+            return -1;
+        memcpy(line + len, reader->buf + reader->pos, chunk);
+        len += chunk;
+        reader->pos += chunk;
+
+        if (newline != NULL) {
+            reader->pos++;
+            line[len] = '\0';
+            return len;
+        }
+    }
+}
+
+/******************************************************************************/
+/* Reply Output */
+/******************************************************************************/
+
+/* Reply output buffer, charged to the budget, which spills to a temporary
+ * file once the budget is exhausted */
+struct serve_output {
+    struct serve_state *state;
+    uint8_t *data;
+    size_t len, capacity;
+    FILE *spill;
+};
+
+static ssize_t util_output_write(void *cookie, const char *buf, size_t size) {
+    struct serve_output *output = (struct serve_output *)cookie;
+    uint8_t *data;
+    size_t capacity;
+
+    if (output->spill == NULL && output->len + size > output->capacity) {
+        capacity = (output->capacity == 0) ? SERVE_READ_BUFFER : output->capacity;
+        while (capacity < output->len + size)
+            capacity *= 2;
+
+        if (serve_charge(output->state, capacity - output->capacity) == 0) {
+            if ((data = realloc(output->data, capacity)) == NULL) {
+                budget_release(capacity - output->capacity);
+                return -1;
+            }
+            output->data = data;
+            output->capacity = capacity;
+        } else {
+            /* Move the output so far to a temporary file */
+            if ((output->spill = tmpfile()) == NULL || fwrite(output->data, 1, output->len, output->spill) != output->len)
+                return -1;
+            free(output->data);
+            budget_release(output->capacity);
+            output->data = NULL;
+            output->capacity = 0;
+        }
+    }
+
+    if (output->spill != NULL) {
+        if (fwrite(buf, 1, size, output->spill) != size)
+            return -1;
+    } else {
+        memcpy(output->data + output->len, buf, size);
+    }
+    output->len += size;
+
+    return size;
+}
+
+static FILE *serve_output_open(struct serve_output *output) {
+    cookie_io_functions_t functions = {NULL, util_output_write, NULL, NULL};
+
+    return fopencookie(output, "w", functions);
+}
+
+static int serve_output_send(struct serve_output *output, int fd) {
+    uint8_t buf[SERVE_READ_BUFFER];
+    size_t remaining, n;
+
+    if (output->spill == NULL)
+        return util_write_all(fd, output->data, output->len);
+
+    rewind(output->spill);
+    for (remaining = output->len; remaining > 0; remaining -= n) {
+        n = (remaining < sizeof(buf)) ? remaining : sizeof(buf);
+        if (fread(buf, 1, n, output->spill) != n || util_write_all(fd, buf, n) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static void serve_output_free(struct serve_output *output) {
+    if (output->spill != NULL)
+        fclose(output->spill);
+    free(output->data);
+    budget_release(output->capacity);
+}
+
+/******************************************************************************/
+/* Request Handling */
+/******************************************************************************/
+
+static int util_copy_field(char *dest, size_t size, const char *value) {
+    if (strlen(value) >= size)
+        return -1;
+    strcpy(dest, value);
+    return 0;
+}
+
+/* Parse a request header line, returns the upload size or -1 */
+static long serve_parse_header(char *line, struct serve_request *req, const char **error) {
+    char *field, *value, *saveptr;
+    long size = 0;
+
+    memset(req, 0, sizeof(struct serve_request));
+    req->end = UINT32_MAX;
+
+    for (field = strtok_r(line, " ", &saveptr); field != NULL; field = strtok_r(NULL, " ", &saveptr)) {
+        if ((value = strchr(field, '=')) == NULL) {
+            *error = "Malformed request field";
+            return -1;
+        }
+        *value++ = '\0';
+
+        if (strcmp(field, "arch") == 0 && util_copy_field(req->arch, sizeof(req->arch), value) == 0)
+            continue;
+        else if (strcmp(field, "type") == 0 && util_copy_field(req->file_type, sizeof(req->file_type), value) == 0)
+            continue;
+        else if (strcmp(field, "options") == 0 && util_copy_field(req->options, sizeof(req->options), value) == 0)
+            continue;
+        else if (strcmp(field, "file") == 0 && util_copy_field(req->path, sizeof(req->path), value) == 0)
+            continue;
+        else if (strcmp(field, "start") == 0) {
+            req->start = strtoul(value, NULL, 0);
+            req->has_range = 1;
+        } else if (strcmp(field, "end") == 0) {
+            req->end = strtoul(value, NULL, 0);
+            req->has_range = 1;
+        } else if (strcmp(field, "size") == 0) {
+            size = strtol(value, NULL, 0);
+            if (size < 0 || size > SERVE_MAX_UPLOAD) {
+                *error = "Invalid upload size";
+                return -1;
+            }
+        } else {
+            *error = "Unknown or invalid request field";
+            return -1;
+        }
+    }
+
+    if (req->arch[0] == '\0') {
+        *error = "No architecture specified";
+        return -1;
+    }
+
+    return size;
+}
+
+static int serve_reply_error(int fd, const char *error) {
+    char line[512];
+
+    snprintf(line, sizeof(line), "ERROR %s\n", error);
+    return util_write_all(fd, line, strlen(line));
+}
+
+/* Handle one request, returns -1 if the connection should be dropped */
+static int serve_handle_request(struct serve_state *state, struct serve_reader *reader, char *line) {
+    struct serve_request req;
+    struct serve_file *file = NULL;
+    struct serve_output output;
+    uint8_t *upload = NULL;
+    const char *error = NULL;
+    char reply[32];
+    FILE *out;
+    long size;
+    int ret;
+
+    /* The upload of a malformed header cannot be told from the next
+     * request, so the connection is dropped after the error */
+    if ((size = serve_parse_header(line, &req, &error)) < 0) {
+        serve_reply_error(reader->fd, error);
+        return -1;
+    }
+
+    if (size > 0 || req.path[0] == '\0') {
+        /* Read the uploaded program file, or drop it if it does not fit in
+         * the budget */
+        if (serve_charge(state, size + 1) < 0) {
+            if (util_skip_all(reader, size) < 0)
+                return -1;
+            return serve_reply_error(reader->fd, "Memory budget exceeded");
+        }
+        if ((upload = malloc(size + 1)) == NULL) {
+            budget_release(size + 1);
+            return -1;
+        }
+        if (util_read_all(reader, upload, size) < 0) {
+            free(upload);
+            budget_release(size + 1);
+            return -1;
+        }
+        req.data = upload;
+        req.len = size;
+    } else {
+        if ((file = serve_file_get(state, req.path, &error)) == NULL)
+            return serve_reply_error(reader->fd, error);
+        req.data = file->data;
+        req.len = file->len;
+    }
+
+    /* Render into a buffer, so the reply can carry the output length */
+    memset(&output, 0, sizeof(output));
+    output.state = state;
+    if ((out = serve_output_open(&output)) == NULL) {
+        req.error = "Error allocating output buffer";
+    } else {
+        state->process(&req, out, state->arg);
+        if (fclose(out) != 0 && req.error == NULL)
+            req.error = "Error buffering output";
+    }
+
+    if (upload != NULL) {
+        free(upload);
+        budget_release(size + 1);
+    }
+    if (file != NULL)
+        serve_file_put(state, file);
+
+    if (req.error != NULL) {
+        ret = serve_reply_error(reader->fd, req.error);
+    } else {
+        snprintf(reply, sizeof(reply), "OK %lu\n", (unsigned long)output.len);
+        ret = util_write_all(reader->fd, reply, strlen(reply));
+        if (ret == 0)
+            ret = serve_output_send(&output, reader->fd);
+    }
+    serve_output_free(&output);
+
+    return ret;
+}
+
+static void serve_handle_connection(struct serve_state *state, int fd) {
+    struct serve_reader *reader;
+    char *line;
+
+    if ((line = malloc(SERVE_HEADER_LEN)) == NULL || (reader = malloc(sizeof(struct serve_reader))) == NULL) {
+        free(line);
+        return;
+    }
+    util_reader_init(reader, fd);
+
+    while (util_read_line(reader, line, SERVE_HEADER_LEN) >= 0) {
+        if (serve_handle_request(state, reader, line) < 0)
+            break;
+    }
+
+    free(reader);
+    free(line);
+}
+
+/******************************************************************************/
+/* Worker Pool and Listener */
+/******************************************************************************/
+
+static void *serve_worker_thread(void *arg) {
+    struct serve_state *state = (struct serve_state *)arg;
+    int fd;
+
+    while (1) {
+        pthread_mutex_lock(&state->lock);
+        while (state->queue_count == 0 && !state->stop)
+            pthread_cond_wait(&state->cond, &state->lock);
+        if (state->queue_count == 0) {
+            pthread_mutex_unlock(&state->lock);
+            break;
+        }
+        fd = state->queue[state->queue_head];
+        state->queue_head = (state->queue_head + 1) % state->queue_size;
+        state->queue_count--;
+        pthread_mutex_unlock(&state->lock);
+
+        serve_handle_connection(state, fd);
+        close(fd);
+    }
+
+    return NULL;
+}
+
+static void serve_signal_handler(int signum) {
+    (void)signum;
+    serve_stopping = 1;
+}
+
+int serve_run(const char *socket_path, unsigned int num_workers, serve_process_func process, void *arg) {
+    struct serve_state state;
+    struct sockaddr_un addr;
+    struct sigaction sa;
+    pthread_t *workers = NULL;
+    unsigned int i, started;
+    int listen_fd, fd;
+
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Error: Socket path too long!\n");
+        return -1;
+    }
+    if (num_workers == 0)
+        num_workers = 1;
+
+    memset(&state, 0, sizeof(state));
+    state.process = process;
+    state.arg = arg;
+    state.queue_size = SERVE_BACKLOG;
+    if ((state.queue = malloc(state.queue_size * sizeof(int))) == NULL || (workers = malloc(num_workers * sizeof(pthread_t))) == NULL) {
+        free(state.queue);
+        fprintf(stderr, "Error allocating server state!\n");
+        return -1;
+    }
+    pthread_mutex_init(&state.lock, NULL);
+    pthread_cond_init(&state.cond, NULL);
+
+    /* Bind the socket, replacing a stale one */
+    if ((listen_fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        perror("Error creating socket");
+        goto cleanup_error;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    unlink(socket_path);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, SERVE_BACKLOG) < 0) {
+        perror("Error binding socket");
+        close(listen_fd);
+        goto cleanup_error;
+    }
+
+    /* Stop on SIGINT / SIGTERM, interrupting accept(). Replies to clients
+     * that hung up are handled by write() errors. */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = serve_signal_handler;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    serve_stopping = 0;
+
+    for (started = 0; started < num_workers; started++) {
+        if (pthread_create(&workers[started], NULL, serve_worker_thread, &state) != 0)
+            break;
+    }
+
+    while (!serve_stopping) {
+        if ((fd = accept(listen_fd, NULL, NULL)) < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("Error accepting connection");
+            break;
+        }
+
+        pthread_mutex_lock(&state.lock);
+        if (state.queue_count == state.queue_size) {
+            /* Overloaded, drop the connection */
+            pthread_mutex_unlock(&state.lock);
+            close(fd);
+            continue;
+        }
+        state.queue[(state.queue_head + state.queue_count) % state.queue_size] = fd;
+        state.queue_count++;
+        pthread_cond_signal(&state.cond);
+        pthread_mutex_unlock(&state.lock);
+    }
+
+    close(listen_fd);
+    unlink(socket_path);
+
+    /* Finish queued connections, then stop the workers */
+    pthread_mutex_lock(&state.lock);
+    state.stop = 1;
+    pthread_cond_broadcast(&state.cond);
+    pthread_mutex_unlock(&state.lock);
+    for (i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    for (i = 0; i < SERVE_CACHE_ENTRIES; i++) {
+        if (state.cache[i] != NULL)
+            serve_file_free(state.cache[i]);
+    }
+    pthread_cond_destroy(&state.cond);
+    pthread_mutex_destroy(&state.lock);
+    free(state.queue);
+    free(workers);
+
+    return 0;
+
+    cleanup_error:
+    pthread_cond_destroy(&state.cond);
+    pthread_mutex_destroy(&state.lock);
+    free(state.queue);
+    free(workers);
+    return -1;
+}
+
+/******************************************************************************/
+/* Client */
+/******************************************************************************/
+
+int serve_request(const char *socket_path, const char *header, const uint8_t *data, size_t len, FILE *out, const char **error) {
+    struct serve_reader reader;
+    struct sockaddr_un addr;
+    char line[SERVE_HEADER_LEN];
+    char buf[4096];
+    unsigned long remaining;
+    size_t n;
+    int fd;
+
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        *error = "Socket path too long";
+        return -1;
+    }
+
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        *error = "Error creating socket";
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        *error = "Cannot connect to server";
+        close(fd);
+        return -1;
+    }
+
+    if (util_write_all(fd, header, strlen(header)) < 0 || util_write_all(fd, "\n", 1) < 0 || (data != NULL && util_write_all(fd, data, len) < 0)) {
+        *error = "Error sending request";
+        close(fd);
+        return -1;
+    }
+
+    util_reader_init(&reader, fd);
+    if (util_read_line(&reader, line, sizeof(line)) < 0) {
+        *error = "Error reading reply";
+        close(fd);
+        return -1;
+    }
+
+    if (strncmp(line, "OK ", 3) != 0) {
+        /* Keep the server's error message for the caller */
+        *error = (strncmp(line, "ERROR ", 6) == 0) ? strdup(line + 6) : "Malformed reply";
+        close(fd);
+        return -1;
+    }
+
+    for (remaining = strtoul(line + 3, NULL, 10); remaining > 0; remaining -= n) {
+        n = (remaining < sizeof(buf)) ? remaining : sizeof(buf);
+        if (util_read_all(&reader, buf, n) < 0 || fwrite(buf, 1, n, out) != n) {
+            *error = "Error reading reply";
+            close(fd);
+            return -1;
+        }
+    }
+
+    close(fd);
+    return 0;
+}
+
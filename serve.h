@@ -0,0 +1,61 @@
+#ifndef SERVE_H
+#define SERVE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Disassembly Server Support
+ *
+ * Serves disassembly requests on a Unix domain socket, from a pool of worker
+ * threads that stay resident between requests. A client connection carries
+ * any number of requests, each a single header line of space separated
+ * key=value fields:
+ *
+ *   arch=<arch> [type=<file type>] [options=<format>,<option>...]
+ *   [start=<address>] [end=<address>] (file=<path> | size=<n>)
+ *
+ * followed, for size=<n>, by n bytes of uploaded program file. Options are
+ * those of --tee. Each request is answered with "OK <n>\n" and n bytes of
+ * output, or with "ERROR <message>\n". A malformed header line is answered
+ * with an error and closes the connection. Program files named by path are
+ * cached in memory, and reloaded when their size or modification time
+ * changes.
+ *
+ * Cached program files, uploads and replies are charged to the memory budget
+ * of budget.h. Unused cached files are evicted, least recently used first,
+ * to make room; a program file or upload that still does not fit is refused
+ * with an error, and a reply that does not fit is spilled to a temporary
+ * file.
+ */
+
+struct serve_request {
+    /* Header fields, empty if not given */
+    char arch[16];
+    char file_type[8];
+    char options[256];
+    char path[4096];
+    /* Address range, if given */
+    int has_range;
+    uint32_t start, end;
+
+    /* Program file contents, from the cache or uploaded */
+    const uint8_t *data;
+    size_t len;
+
+    /* Error string, set by the processing function on failure */
+    const char *error;
+};
+
+/* Render a request to out, setting req->error on failure */
+typedef void (*serve_process_func)(struct serve_request *req, FILE *out, void *arg);
+
+/* Serve requests on socket_path until SIGINT or SIGTERM, returns 0 on a
+ * clean shutdown or -1 if the socket could not be set up */
+int serve_run(const char *socket_path, unsigned int num_workers, serve_process_func process, void *arg);
+
+/* Send one request and copy its output to out. Uploads len bytes of data if
+ * data is not NULL. Returns 0, or -1 with *error set. */
+int serve_request(const char *socket_path, const char *header, const uint8_t *data, size_t len, FILE *out, const char **error);
+
+#endif
+
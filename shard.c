@@ -0,0 +1,506 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <ucdisasm.h>
+#include <hash.h>
+#include <shard.h>
+
+/* Most directives a shard disasm stream holds back at once */
+#define SHARD_MAX_PENDING   8
+
+/******************************************************************************/
+/* Image Scan */
+/******************************************************************************/
+
+int shard_scan_image(struct ByteStream *source, struct shard_image *image) {
+    uint8_t data;
+    uint32_t address;
+    int ret;
+
+    image->count = 0;
+    image->hash = HASH_FNV_OFFSET_BASIS;
+
+    if ((ret = source->stream_init(source)) < 0)
+        return ret;
+
+    while ((ret = source->stream_read(source, &data, &address)) == 0) {
+        image->hash = hash_fnv1a(image->hash, address, 4);
+        image->hash = hash_fnv1a(image->hash, data, 1);
+        image->count++;
+    }
+
+    if (source->stream_close(source) < 0 && ret == STREAM_EOF)
+        ret = STREAM_ERROR_INPUT;
+
+    return (ret == STREAM_EOF) ? 0 : ret;
+}
+
+/******************************************************************************/
+/* Shard Byte Stream Support */
+/******************************************************************************/
+
+struct shard_bytestream_state {
+    struct ByteStream *source;
+    int arch;
+    unsigned int align, max_width;
+
+    /* Nominal start and end byte positions */
+    uint64_t start, end;
+    /* First shard, which starts at the first byte */
+    int first;
+    /* Passing bytes through, reached the end of the shard */
+    int started, done;
+
+    /* Position of the next byte */
+    uint64_t position;
+    /* Consecutive bytes before the next byte, and the last four of them */
+    uint64_t run;
+    uint8_t history[4];
+    uint32_t last_address;
+};
+
+int shard_bytestream_setup(struct ByteStream *self, struct ByteStream *source, const struct shard_spec *spec) {
+    struct shard_bytestream_state *state;
+
+    /* Allocate stream state */
+    state = self->state = calloc(1, sizeof(struct shard_bytestream_state));
+    if (state == NULL) {
+        self->error = "Error allocating shard stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    if (ucdisasm_arch_widths(spec->arch, &state->align, &state->max_width) < 0) {
+        free(state);
+        self->error = "Unknown shard architecture!";
+        return STREAM_ERROR_FAILURE;
+    }
+    state->source = source;
+    state->arch = spec->arch;
+    state->first = (spec->index == 0);
+    state->start = spec->image.count * spec->index / spec->total;
+    state->end = (spec->index + 1 < spec->total) ? spec->image.count * (spec->index + 1) / spec->total : UINT64_MAX;
+
+    self->in = source->in;
+    self->error = NULL;
+    self->stream_init = shard_bytestream_init;
+    self->stream_close = shard_bytestream_close;
+    self->stream_read = shard_bytestream_read;
+
+    return 0;
+}
+
+int shard_bytestream_init(struct ByteStream *self) {
+    struct shard_bytestream_state *state = (struct shard_bytestream_state *)self->state;
+
+    state->started = state->done = 0;
+    state->position = state->run = 0;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the source stream */
+    if (state->source->stream_init(state->source) < 0) {
+        self->error = state->source->error;
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int shard_bytestream_close(struct ByteStream *self) {
+    struct shard_bytestream_state *state = (struct shard_bytestream_state *)self->state;
+    int ret = 0;
+
+    /* Close the source stream */
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free stream state memory */
+    free(state);
+
+    return ret;
+}
+
+/* Whether an instruction boundary necessarily falls before the next byte */
+static int util_boundary_safe(struct shard_bytestream_state *state) {
+    unsigned int k;
+
+    /* Decoding restarts at the start of a run, so stay on its alignment */
+    if (state->run == 0 || state->run % state->align != 0)
+        return 0;
+
+    /* No instruction starting k bytes back may be more than k bytes wide */
+    for (k = state->align; k < state->max_width && k <= state->run; k += state->align) {
+        if (ucdisasm_instruction_width(state->arch, &state->history[4 - k]) > k)
+            return 0;
+    }
+
+    return 1;
+}
+
+int shard_bytestream_read(struct ByteStream *self, uint8_t *data, uint32_t *address) {
+    struct shard_bytestream_state *state = (struct shard_bytestream_state *)self->state;
+    int ret, safe;
+
+    while (!state->done) {
+        ret = state->source->stream_read(state->source, data, address);
+        if (ret == STREAM_EOF) {
+            state->done = 1;
+            break;
+        } else if (ret < 0) {
+            self->error = state->source->error;
+            return ret;
+        }
+
+        /* A gap in addresses starts a new run */
+        if (state->position > 0 && *address != state->last_address + 1)
+            state->run = 0;
+
+        safe = util_boundary_safe(state);
+        if (!state->started && state->position >= state->start && (state->first || safe))
+            state->started = 1;
+        if (state->started && state->position >= state->end && safe) {
+            state->done = 1;
+            break;
+        }
+
+        memmove(state->history, state->history + 1, sizeof(state->history) - 1);
+        state->history[sizeof(state->history) - 1] = *data;
+        state->run++;
+        state->last_address = *address;
+        state->position++;
+
+        if (state->started)
+            return 0;
+    }
+
+    return STREAM_EOF;
+}
+
+/******************************************************************************/
+/* Shard Disasm Stream Support */
+/******************************************************************************/
+
+struct shard_disasmstream_state {
+    struct DisasmStream *source;
+    /* First shard, last shard */
+    int first, last;
+    /* Instruction seen, source EOF reached */
+    int instruction, eof;
+    /* Directives held back until the next instruction, then the instruction */
+    struct instruction pending[SHARD_MAX_PENDING];
+    unsigned int head, count;
+};
+
+int shard_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, const struct shard_spec *spec) {
+    struct shard_disasmstream_state *state;
+
+    /* Allocate stream state */
+    state = self->state = calloc(1, sizeof(struct shard_disasmstream_state));
+    if (state == NULL) {
+        self->error = "Error allocating shard stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->source = source;
+    state->first = (spec->index == 0);
+    state->last = (spec->index + 1 == spec->total);
+
+    self->in = source->in;
+    self->error = NULL;
+    self->stream_init = shard_disasmstream_init;
+    self->stream_close = shard_disasmstream_close;
+    self->stream_read = shard_disasmstream_read;
+
+    return 0;
+}
+
+int shard_disasmstream_init(struct DisasmStream *self) {
+    struct shard_disasmstream_state *state = (struct shard_disasmstream_state *)self->state;
+
+    state->instruction = state->eof = 0;
+    state->head = state->count = 0;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the source stream */
+    if (state->source->stream_init(state->source) < 0) {
+        self->error = state->source->error;
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+static void util_pending_free(struct shard_disasmstream_state *state, unsigned int n) {
+    for (; n > 0; n--) {
+        state->pending[state->head].free(&state->pending[state->head]);
+        state->head++;
+        state->count--;
+    }
+}
+
+int shard_disasmstream_close(struct DisasmStream *self) {
+    struct shard_disasmstream_state *state = (struct shard_disasmstream_state *)self->state;
+    int ret = 0;
+
+    util_pending_free(state, state->count);
+
+    /* Close the source stream */
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free stream state memory */
+    free(state);
+
+    return ret;
+}
+
+/* Read the source up to and including the next instruction, or to EOF */
+static int util_fill_pending(struct DisasmStream *self, struct shard_disasmstream_state *state) {
+    struct instruction *instr;
+    int ret;
+
+    state->head = 0;
+
+    while (1) {
+        if (state->count == SHARD_MAX_PENDING) {
+            self->error = "Error, too many consecutive directives in shard!";
+            return STREAM_ERROR_FAILURE;
+        }
+
+        instr = &state->pending[state->count];
+        ret = state->source->stream_read(state->source, instr);
+        if (ret == STREAM_EOF) {
+            /* Only the last shard keeps the closing directives */
+            state->eof = 1;
+            if (!state->last)
+                util_pending_free(state, state->count);
+            return 0;
+        } else if (ret < 0) {
+            self->error = state->source->error;
+            return ret;
+        }
+        state->count++;
+
+        if (instr->type == DISASM_TYPE_INSTRUCTION) {
+            /* Drop the origin directive the shard's first byte produced */
+            if (!state->instruction && !state->first)
+                util_pending_free(state, state->count - 1);
+            state->instruction = 1;
+            return 0;
+        }
+    }
+}
+
+int shard_disasmstream_read(struct DisasmStream *self, struct instruction *instr) {
+    struct shard_disasmstream_state *state = (struct shard_disasmstream_state *)self->state;
+    int ret;
+
+    if (state->count == 0) {
+        if (state->eof)
+            return STREAM_EOF;
+        if ((ret = util_fill_pending(self, state)) < 0)
+            return ret;
+        if (state->count == 0)
+            return STREAM_EOF;
+    }
+
+    *instr = state->pending[state->head++];
+    state->count--;
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Shard Output and Merge */
+/******************************************************************************/
+
+/* Shard output stream cookie */
+struct shard_output {
+    FILE *out;
+    struct shard_spec spec;
+    uint64_t len;
+};
+
+static int util_format_trailer(char *dest, const struct shard_spec *spec, uint64_t len) {
+    int n;
+
+    n = snprintf(dest, SHARD_TRAILER_LEN + 1, "UCDSHARD 1 %u/%u %d %016llx %016llx %016llx",
+                spec->index, spec->total, spec->arch, (unsigned long long)spec->image.hash,
+                (unsigned long long)spec->image.count, (unsigned long long)len);
+    if (n < 0 || n >= SHARD_TRAILER_LEN)
+        return -1;
+
+    /* Pad to the fixed length, ending in a newline */
+    memset(dest + n, ' ', SHARD_TRAILER_LEN - n);
+    dest[SHARD_TRAILER_LEN - 1] = '\n';
+
+    return 0;
+}
+
+static ssize_t util_output_write(void *cookie, const char *buf, size_t size) {
+    struct shard_output *output = (struct shard_output *)cookie;
+
+    if (fwrite(buf, 1, size, output->out) != size)
+        return -1;
+    output->len += size;
+
+    return size;
+}
+
+static int util_output_close(void *cookie) {
+    struct shard_output *output = (struct shard_output *)cookie;
+    char trailer[SHARD_TRAILER_LEN + 1];
+    int ret = 0;
+
+    if (util_format_trailer(trailer, &output->spec, output->len) < 0 ||
+            fwrite(trailer, 1, SHARD_TRAILER_LEN, output->out) != SHARD_TRAILER_LEN ||
+            fflush(output->out) != 0)
+        ret = EOF;
+    free(output);
+
+    return ret;
+}
+
+FILE *shard_output_open(FILE *out, const struct shard_spec *spec) {
+    cookie_io_functions_t functions = {NULL, util_output_write, NULL, util_output_close};
+    struct shard_output *output;
+    FILE *file;
+
+    if ((output = calloc(1, sizeof(struct shard_output))) == NULL)
+        return NULL;
+    output->out = out;
+    output->spec = *spec;
+
+    if ((file = fopencookie(output, "w", functions)) == NULL)
+        free(output);
+
+    return file;
+}
+
+/* A shard output file, as described by its trailer */
+struct shard_file {
+    const char *path;
+    FILE *in;
+    struct shard_spec spec;
+    uint64_t len;
+};
+
+static int util_read_trailer(struct shard_file *file, const char **error) {
+    char trailer[SHARD_TRAILER_LEN + 1];
+    unsigned long long hash, count, len;
+    off_t size;
+
+    if ((file->in = fopen(file->path, "rb")) == NULL) {
+        *error = "Cannot open shard output file";
+        return -1;
+    }
+
+    if (fseeko(file->in, 0, SEEK_END) < 0 || (size = ftello(file->in)) < SHARD_TRAILER_LEN ||
+            fseeko(file->in, size - SHARD_TRAILER_LEN, SEEK_SET) < 0 ||
+            fread(trailer, 1, SHARD_TRAILER_LEN, file->in) != SHARD_TRAILER_LEN) {
+        *error = "Missing shard trailer";
+        return -1;
+    }
+    trailer[SHARD_TRAILER_LEN] = '\0';
+
+    if (sscanf(trailer, "UCDSHARD 1 %u/%u %d %16llx %16llx %16llx", &file->spec.index, &file->spec.total, &file->spec.arch, &hash, &count, &len) != 6) {
+        *error = "Invalid shard trailer";
+        return -1;
+    }
+    if ((uint64_t)len != (uint64_t)(size - SHARD_TRAILER_LEN)) {
+        *error = "Truncated shard output";
+        return -1;
+    }
+    file->spec.image.hash = hash;
+    file->spec.image.count = count;
+    file->len = len;
+
+    rewind(file->in);
+
+    return 0;
+}
+
+static int util_copy_payload(struct shard_file *file, FILE *out) {
+    char buf[65536];
+    uint64_t left;
+    size_t n;
+
+    for (left = file->len; left > 0; left -= n) {
+        n = (left < sizeof(buf)) ? left : sizeof(buf);
+        if (fread(buf, 1, n, file->in) != n || fwrite(buf, 1, n, out) != n)
+            return -1;
+    }
+
+    return 0;
+}
+
+int shard_merge(const char *const *paths, unsigned int num_paths, FILE *out, const char **error) {
+    struct shard_file *files, **order;
+    unsigned int i, index;
+    int ret = -1;
+
+    files = calloc(num_paths, sizeof(struct shard_file));
+    order = calloc(num_paths, sizeof(struct shard_file *));
+    if (files == NULL || order == NULL) {
+        *error = "Error allocating shard files";
+        goto cleanup;
+    }
+
+    for (i = 0; i < num_paths; i++) {
+        files[i].path = paths[i];
+        if (util_read_trailer(&files[i], error) < 0) {
+            num_paths = i + 1;
+            goto cleanup;
+        }
+    }
+
+    /* All shards of one image, each exactly once */
+    for (i = 0; i < num_paths; i++) {
+        if (files[i].spec.total != num_paths) {
+            *error = "Wrong number of shards";
+            goto cleanup;
+        }
+        if (files[i].spec.arch != files[0].spec.arch || files[i].spec.image.hash != files[0].spec.image.hash ||
+                files[i].spec.image.count != files[0].spec.image.count) {
+            *error = "Shards are of different program images or architectures";
+            goto cleanup;
+        }
+        index = files[i].spec.index;
+        if (index >= num_paths || order[index] != NULL) {
+            *error = "Duplicate shard";
+            goto cleanup;
+        }
+        order[index] = &files[i];
+    }
+
+    for (i = 0; i < num_paths; i++) {
+        if (util_copy_payload(order[i], out) < 0) {
+            *error = "Error copying shard output";
+            goto cleanup;
+        }
+    }
+    ret = 0;
+
+    cleanup:
+    if (files != NULL) {
+        for (i = 0; i < num_paths; i++) {
+            if (files[i].in != NULL)
+                fclose(files[i].in);
+        }
+    }
+    free(files);
+    free(order);
+
+    return ret;
+}
+
@@ -0,0 +1,84 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <bytestream.h>
+#include <disasmstream.h>
+
+/* Shard Support
+ *
+ * Splits the disassembly of one program image into N shards, which can be
+ * rendered independently, e.g. on separate machines, and merged back into
+ * output byte-identical to a single run.
+ *
+ * The data bytes of the image are numbered in input order. Shard i nominally
+ * starts at byte count*i/N, and actually starts at the first byte from there
+ * that is an instruction-safe boundary: it continues a run of consecutive
+ * addresses, lies on the architecture's alignment from the start of the run,
+ * and no instruction starting at the bytes before it could extend across it
+ * (e.g. an AVR call/jmp/lds/sts, a PIC18 two-word instruction, or an 8051
+ * two or three byte instruction). Every shard finds the boundaries the same
+ * way from the same bytes, so together the shards cover the image exactly.
+ *
+ * The shard byte stream passes through the bytes of one shard. The shard
+ * disasm stream drops the origin directive a shard after the first starts
+ * with, and the end directive of shards before the last. Print streams of
+ * shards after the first are initialized with PRINT_FLAG_NO_HEADER.
+ *
+ * Shard output ends with a SHARD_TRAILER_LEN byte text trailer naming the
+ * shard, the architecture, and the image, which shard_merge() checks before
+ * concatenating the shard outputs, without their trailers, in shard order.
+ */
+
+/* Program image summary, identical for all shards of an image */
+struct shard_image {
+    /* Number of data bytes */
+    uint64_t count;
+    /* FNV-1a hash of the data bytes and their addresses */
+    uint64_t hash;
+};
+
+struct shard_spec {
+    /* Shard index, 0 to total-1 */
+    unsigned int index, total;
+    /* Architecture (UCDISASM_ARCH_*) */
+    int arch;
+    struct shard_image image;
+};
+
+/* Length of the trailer at the end of shard output */
+#define SHARD_TRAILER_LEN   96
+
+/* Read the whole source stream to summarize the image. The source is
+ * initialized and closed. Returns 0, or a negative STREAM_ERROR_* code with
+ * the source's error. */
+int shard_scan_image(struct ByteStream *source, struct shard_image *image);
+
+/* Setup self to pass through the bytes of the source stream in the shard */
+int shard_bytestream_setup(struct ByteStream *self, struct ByteStream *source, const struct shard_spec *spec);
+
+/* Setup self to drop the directives at the shard's edges from the source
+ * stream */
+int shard_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, const struct shard_spec *spec);
+
+/* Open a stream writing shard output through to out, which appends the
+ * shard trailer to out when closed. Returns NULL on failure. */
+FILE *shard_output_open(FILE *out, const struct shard_spec *spec);
+
+/* Merge the outputs of all shards of an image, in any order, into out.
+ * Returns 0, or -1 with an error string. */
+int shard_merge(const char *const *paths, unsigned int num_paths, FILE *out, const char **error);
+
+/* Shard Byte Stream Support */
+int shard_bytestream_init(struct ByteStream *self);
+int shard_bytestream_close(struct ByteStream *self);
+int shard_bytestream_read(struct ByteStream *self, uint8_t *data, uint32_t *address);
+
+/* Shard Disasm Stream Support */
+int shard_disasmstream_init(struct DisasmStream *self);
+int shard_disasmstream_close(struct DisasmStream *self);
+int shard_disasmstream_read(struct DisasmStream *self, struct instruction *instr);
+
+#endif
+
@@ -0,0 +1,402 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <disasmstream.h>
+#include <instruction.h>
+#include <budget.h>
+#include <hash.h>
+#include <diff.h>
+#include <similarity.h>
+
+/* Band hash and entry of an index band table */
+#define SIMILARITY_BAND_PAIR_SIZE   8
+
+/******************************************************************************/
+/* Hashing */
+/******************************************************************************/
+
+/* SplitMix64 finalizer, which spreads the shingle hashes and seeds the hash
+ * functions */
+static uint64_t util_mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/* Multiply-shift hash functions h_i(x) = (a_i x + b_i) >> 32, with odd a_i */
+static void util_hash_functions(uint64_t *a, uint64_t *b) {
+    unsigned int i;
+
+    for (i = 0; i < SIMILARITY_NUM_HASHES; i++) {
+        a[i] = util_mix64(2*i) | 1;
+        b[i] = util_mix64(2*i + 1);
+    }
+}
+
+static uint32_t util_band_hash(const uint32_t *mins) {
+    uint64_t hash = HASH_FNV_OFFSET_BASIS;
+    unsigned int i;
+
+    for (i = 0; i < SIMILARITY_ROWS; i++)
+        hash = hash_fnv1a(hash, mins[i], 4);
+
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/******************************************************************************/
+/* Signatures */
+/******************************************************************************/
+
+int similarity_signature_compute(struct DisasmStream *source, struct similarity_signature *signature) {
+    uint64_t a[SIMILARITY_NUM_HASHES], b[SIMILARITY_NUM_HASHES];
+    uint64_t tokens[SIMILARITY_NGRAM], shingle, x;
+    unsigned int i, run = 0;
+    struct instruction instr;
+    uint32_t h;
+    int ret;
+
+    util_hash_functions(a, b);
+    signature->shingles = 0;
+    for (i = 0; i < SIMILARITY_NUM_HASHES; i++)
+        signature->mins[i] = UINT32_MAX;
+
+    if ((ret = source->stream_init(source)) < 0)
+        return ret;
+
+    while ((ret = source->stream_read(source, &instr)) == 0) {
+        /* Shingles do not span gaps or data */
+        if (instr.type != DISASM_TYPE_INSTRUCTION || instr.get_flow(&instr) == FLOW_INVALID) {
+            run = 0;
+            instr.free(&instr);
+            continue;
+        }
+
+        tokens[run % SIMILARITY_NGRAM] = diff_token_hash(&instr);
+        instr.free(&instr);
+        if (++run < SIMILARITY_NGRAM)
+            continue;
+
+        /* Hash the last SIMILARITY_NGRAM tokens, oldest first */
+        shingle = HASH_FNV_OFFSET_BASIS;
+        for (i = 0; i < SIMILARITY_NGRAM; i++)
+            shingle = hash_fnv1a(shingle, tokens[(run + i) % SIMILARITY_NGRAM], 8);
+        x = util_mix64(shingle);
+
+        for (i = 0; i < SIMILARITY_NUM_HASHES; i++) {
+            h = (uint32_t)((a[i]*x + b[i]) >> 32);
+            if (h < signature->mins[i])
+                signature->mins[i] = h;
+        }
+        signature->shingles++;
+    }
+
+    if (ret == STREAM_EOF)
+        ret = 0;
+    if (source->stream_close(source) < 0 && ret == 0)
+        ret = STREAM_ERROR_INPUT;
+
+    return ret;
+}
+
+double similarity_estimate(const struct similarity_signature *a, const struct similarity_signature *b) {
+    unsigned int i, equal = 0;
+
+    for (i = 0; i < SIMILARITY_NUM_HASHES; i++) {
+        if (a->mins[i] == b->mins[i])
+            equal++;
+    }
+
+    return (double)equal / SIMILARITY_NUM_HASHES;
+}
+
+/******************************************************************************/
+/* Little-endian Encoding */
+/******************************************************************************/
+
+static void util_put_u16(uint8_t *dest, uint16_t value) {
+    dest[0] = value & 0xff;
+    dest[1] = (value >> 8) & 0xff;
+}
+
+static void util_put_u32(uint8_t *dest, uint32_t value) {
+    dest[0] = value & 0xff;
+    dest[1] = (value >> 8) & 0xff;
+    dest[2] = (value >> 16) & 0xff;
+    dest[3] = (value >> 24) & 0xff;
+}
+
+static void util_put_u64(uint8_t *dest, uint64_t value) {
+    util_put_u32(dest, (uint32_t)value);
+    util_put_u32(dest + 4, (uint32_t)(value >> 32));
+}
+
+static uint16_t util_get_u16(const uint8_t *src) {
+    return src[0] | (src[1] << 8);
+}
+
+static uint32_t util_get_u32(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static uint64_t util_get_u64(const uint8_t *src) {
+    return util_get_u32(src) | ((uint64_t)util_get_u32(src + 4) << 32);
+}
+
+/******************************************************************************/
+/* Index File */
+/******************************************************************************/
+
+/* Band table entry, sorted by band hash then entry */
+struct band_pair {
+    uint32_t hash, entry;
+};
+
+static int util_band_pair_compare(const void *a, const void *b) {
+    const struct band_pair *pa = a, *pb = b;
+
+    if (pa->hash != pb->hash)
+        return (pa->hash < pb->hash) ? -1 : 1;
+    if (pa->entry != pb->entry)
+        return (pa->entry < pb->entry) ? -1 : 1;
+    return 0;
+}
+
+int similarity_index_write(FILE *out, const char *arch_name, const char *const *paths, const struct similarity_signature *signatures, unsigned int num_entries, const char **error) {
+    uint8_t header[SIMILARITY_HEADER_SIZE], entry[SIMILARITY_ENTRY_SIZE], pair[SIMILARITY_BAND_PAIR_SIZE];
+    struct band_pair *pairs;
+    uint32_t strings_len = 0;
+    unsigned int i, j;
+
+    *error = "Error writing to index file!";
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, "UCDISIMX", 8);
+    util_put_u16(header + 8, SIMILARITY_VERSION);
+    util_put_u16(header + 10, SIMILARITY_NUM_HASHES);
+    util_put_u16(header + 12, SIMILARITY_BANDS);
+    util_put_u16(header + 14, SIMILARITY_NGRAM);
+    strncpy((char *)header + 16, arch_name, 15);
+    util_put_u32(header + 32, num_entries);
+    for (i = 0; i < num_entries; i++)
+        strings_len += strlen(paths[i]) + 1;
+    util_put_u32(header + 36, strings_len);
+    if (fwrite(header, 1, sizeof(header), out) != sizeof(header))
+        return -1;
+
+    /* Signatures */
+    strings_len = 0;
+    for (i = 0; i < num_entries; i++) {
+        util_put_u64(entry, signatures[i].shingles);
+        util_put_u32(entry + 8, strings_len);
+        util_put_u32(entry + 12, 0);
+        for (j = 0; j < SIMILARITY_NUM_HASHES; j++)
+            util_put_u32(entry + 16 + 4*j, signatures[i].mins[j]);
+        if (fwrite(entry, 1, sizeof(entry), out) != sizeof(entry))
+            return -1;
+        strings_len += strlen(paths[i]) + 1;
+    }
+
+    /* Band tables */
+    if (budget_charge(num_entries * sizeof(struct band_pair)) < 0) {
+        *error = "Error allocating index band table!";
+        return -1;
+    }
+    if ((pairs = malloc((num_entries + 1) * sizeof(struct band_pair))) == NULL) {
+        budget_release(num_entries * sizeof(struct band_pair));
+        *error = "Error allocating index band table!";
+        return -1;
+    }
+    for (i = 0; i < SIMILARITY_BANDS; i++) {
+        for (j = 0; j < num_entries; j++) {
+            pairs[j].hash = util_band_hash(signatures[j].mins + i*SIMILARITY_ROWS);
+            pairs[j].entry = j;
+        }
+        qsort(pairs, num_entries, sizeof(struct band_pair), util_band_pair_compare);
+        for (j = 0; j < num_entries; j++) {
+            util_put_u32(pair, pairs[j].hash);
+            util_put_u32(pair + 4, pairs[j].entry);
+            if (fwrite(pair, 1, sizeof(pair), out) != sizeof(pair))
+                break;
+        }
+        if (j < num_entries)
+            break;
+    }
+    free(pairs);
+    budget_release(num_entries * sizeof(struct band_pair));
+    if (i < SIMILARITY_BANDS)
+        return -1;
+
+    /* String table */
+    for (i = 0; i < num_entries; i++) {
+        if (fwrite(paths[i], 1, strlen(paths[i]) + 1, out) != strlen(paths[i]) + 1)
+            return -1;
+    }
+
+    *error = NULL;
+
+    return 0;
+}
+
+int similarity_index_read(struct similarity_index *index, FILE *in, const char **error) {
+    uint8_t *data;
+    size_t len, capacity;
+    uint64_t expected;
+
+    memset(index, 0, sizeof(struct similarity_index));
+
+    /* Read the whole file, doubling the buffer as it fills */
+    for (len = 0; ; ) {
+        if (len == index->size) {
+            capacity = (index->size == 0) ? 65536 : index->size*2;
+            if (budget_charge(capacity - index->size) < 0) {
+                *error = "Error allocating index!";
+                similarity_index_free(index);
+                return -1;
+            }
+            if ((data = realloc(index->data, capacity)) == NULL) {
+                budget_release(capacity - index->size);
+                *error = "Error allocating index!";
+                similarity_index_free(index);
+                return -1;
+            }
+            index->data = data;
+            index->size = capacity;
+        }
+
+        len += fread(index->data + len, 1, index->size - len, in);
+        if (len < index->size)
+            break;
+    }
+    if (ferror(in)) {
+        *error = "Error reading index file!";
+        similarity_index_free(index);
+        return -1;
+    }
+
+    data = index->data;
+    if (len < SIMILARITY_HEADER_SIZE || memcmp(data, "UCDISIMX", 8) != 0) {
+        *error = "Not a similarity index file!";
+        similarity_index_free(index);
+        return -1;
+    }
+    if (util_get_u16(data + 8) != SIMILARITY_VERSION || util_get_u16(data + 10) != SIMILARITY_NUM_HASHES || util_get_u16(data + 12) != SIMILARITY_BANDS || util_get_u16(data + 14) != SIMILARITY_NGRAM) {
+        *error = "Unsupported similarity index version or parameters!";
+        similarity_index_free(index);
+        return -1;
+    }
+
+    memcpy(index->arch_name, data + 16, 15);
+    index->num_entries = util_get_u32(data + 32);
+    index->strings_len = util_get_u32(data + 36);
+    expected = SIMILARITY_HEADER_SIZE + (uint64_t)index->num_entries * (SIMILARITY_ENTRY_SIZE + SIMILARITY_BANDS*SIMILARITY_BAND_PAIR_SIZE) + index->strings_len;
+    if (expected != len || (index->strings_len > 0 && data[len - 1] != '\0')) {
+        *error = "Truncated or corrupt similarity index file!";
+        similarity_index_free(index);
+        return -1;
+    }
+    index->entries = data + SIMILARITY_HEADER_SIZE;
+    index->bands = index->entries + (size_t)index->num_entries * SIMILARITY_ENTRY_SIZE;
+    index->strings = (const char *)index->bands + (size_t)index->num_entries * SIMILARITY_BANDS * SIMILARITY_BAND_PAIR_SIZE;
+
+    return 0;
+}
+
+void similarity_index_free(struct similarity_index *index) {
+    budget_release(index->size);
+    free(index->data);
+    index->data = NULL;
+    index->size = 0;
+}
+
+static int util_match_compare(const void *a, const void *b) {
+    const struct similarity_match *ma = a, *mb = b;
+
+    if (ma->similarity != mb->similarity)
+        return (ma->similarity > mb->similarity) ? -1 : 1;
+    return strcmp(ma->path, mb->path);
+}
+
+/* Signature of entry i of the index */
+static void util_entry_signature(const struct similarity_index *index, uint32_t i, struct similarity_signature *signature) {
+    const uint8_t *entry = index->entries + (size_t)i * SIMILARITY_ENTRY_SIZE;
+    unsigned int j;
+
+    signature->shingles = util_get_u64(entry);
+    for (j = 0; j < SIMILARITY_NUM_HASHES; j++)
+        signature->mins[j] = util_get_u32(entry + 16 + 4*j);
+}
+
+int similarity_index_query(const struct similarity_index *index, const struct similarity_signature *signature, struct similarity_match *matches, unsigned int max_matches, const char **error) {
+    struct similarity_signature candidate;
+    struct similarity_match *found;
+    const uint8_t *table, *pair;
+    uint8_t *seen;
+    uint32_t hash, lo, hi, mid, i, offset;
+    unsigned int band, num_found = 0;
+    size_t size;
+
+    /* Marks of the candidates, and their matches */
+    size = index->num_entries * (1 + sizeof(struct similarity_match));
+    if (budget_charge(size) < 0) {
+        *error = "Error allocating query candidates!";
+        return -1;
+    }
+    seen = calloc(index->num_entries + 1, 1);
+    found = malloc((index->num_entries + 1) * sizeof(struct similarity_match));
+    if (seen == NULL || found == NULL) {
+        free(seen);
+        free(found);
+        budget_release(size);
+        *error = "Error allocating query candidates!";
+        return -1;
+    }
+
+    for (band = 0; band < SIMILARITY_BANDS && signature->shingles > 0; band++) {
+        table = index->bands + (size_t)band * index->num_entries * SIMILARITY_BAND_PAIR_SIZE;
+        hash = util_band_hash(signature->mins + band*SIMILARITY_ROWS);
+
+        /* First pair of the band hash */
+        for (lo = 0, hi = index->num_entries; lo < hi; ) {
+            mid = lo + (hi - lo)/2;
+            if (util_get_u32(table + (size_t)mid * SIMILARITY_BAND_PAIR_SIZE) < hash)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        for (pair = table + (size_t)lo * SIMILARITY_BAND_PAIR_SIZE; lo < index->num_entries && util_get_u32(pair) == hash; lo++, pair += SIMILARITY_BAND_PAIR_SIZE) {
+            i = util_get_u32(pair + 4);
+            if (i >= index->num_entries || seen[i])
+                continue;
+            seen[i] = 1;
+
+            util_entry_signature(index, i, &candidate);
+            /* Programs too short for a shingle match nothing */
+            if (candidate.shingles == 0)
+                continue;
+            offset = util_get_u32(index->entries + (size_t)i * SIMILARITY_ENTRY_SIZE + 8);
+            if (offset >= index->strings_len)
+                continue;
+
+            found[num_found].path = index->strings + offset;
+            found[num_found].similarity = similarity_estimate(signature, &candidate);
+            found[num_found].shingles = candidate.shingles;
+            num_found++;
+        }
+    }
+
+    qsort(found, num_found, sizeof(struct similarity_match), util_match_compare);
+    if (num_found > max_matches)
+        num_found = max_matches;
+    memcpy(matches, found, num_found * sizeof(struct similarity_match));
+
+    free(seen);
+    free(found);
+    budget_release(size);
+
+    return num_found;
+}
+
@@ -0,0 +1,100 @@
+#ifndef SIMILARITY_H
+#define SIMILARITY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <disasmstream.h>
+
+/* Similarity Index Support
+ *
+ * Finds the program files of an archive that share code with a program.
+ *
+ * A program's instructions are reduced to the tokens of the instruction diff
+ * (see diff.h), which leave out program address operands, and every run of
+ * SIMILARITY_NGRAM consecutive tokens is a shingle. Runs restart at gaps in
+ * the addresses and at raw data. The program's signature is the minimum over
+ * its shingles of each of SIMILARITY_NUM_HASHES hash functions (MinHash), so
+ * the fraction of equal minimums of two signatures estimates the Jaccard
+ * similarity of their shingle sets.
+ *
+ * The index file holds the signatures of the archive and, for locality
+ * sensitive hashing, SIMILARITY_BANDS tables of the hashes of each band of
+ * SIMILARITY_ROWS minimums, sorted. A query looks up the bands of its
+ * signature and estimates the similarity of only the programs that share one
+ * of them, which catches a program of similarity s with probability
+ * 1 - (1 - s^SIMILARITY_ROWS)^SIMILARITY_BANDS: about 0.5 at s = 0.38 and 0.99
+ * at s = 0.61.
+ *
+ * Index file, all integers little-endian:
+ *   0   char[8]    magic "UCDISIMX"
+ *   8   uint16     version (1)
+ *   10  uint16     number of hashes (SIMILARITY_NUM_HASHES)
+ *   12  uint16     number of bands (SIMILARITY_BANDS)
+ *   14  uint16     n-gram length (SIMILARITY_NGRAM)
+ *   16  char[16]   architecture name, NUL padded
+ *   32  uint32     number of entries
+ *   36  uint32     string table length
+ *   40  entries:   uint64 number of shingles, uint32 path offset in the
+ *                  string table, uint32 zero, uint32[number of hashes]
+ *                  minimums
+ *   ... bands:     for each band, uint32 band hash and uint32 entry pairs of
+ *                  every entry, sorted
+ *   ... string table: the paths, each NUL terminated
+ */
+
+#define SIMILARITY_NGRAM            4
+#define SIMILARITY_NUM_HASHES       128
+#define SIMILARITY_BANDS            32
+#define SIMILARITY_ROWS             (SIMILARITY_NUM_HASHES / SIMILARITY_BANDS)
+
+#define SIMILARITY_VERSION          1
+#define SIMILARITY_HEADER_SIZE      40
+#define SIMILARITY_ENTRY_SIZE       (16 + 4*SIMILARITY_NUM_HASHES)
+
+struct similarity_signature {
+    /* Shingles hashed, 0 for a program too short to have one */
+    uint64_t shingles;
+    uint32_t mins[SIMILARITY_NUM_HASHES];
+};
+
+/* Compute the signature of the instructions read by source, which is
+ * initialized and closed. Returns 0, or a STREAM_ERROR_* code with the error
+ * in source->error or its byte stream's. */
+int similarity_signature_compute(struct DisasmStream *source, struct similarity_signature *signature);
+
+/* Estimated Jaccard similarity of two signatures */
+double similarity_estimate(const struct similarity_signature *a, const struct similarity_signature *b);
+
+/* Write an index of the signatures of the paths. Returns 0, or -1 with an
+ * error string. */
+int similarity_index_write(FILE *out, const char *arch_name, const char *const *paths, const struct similarity_signature *signatures, unsigned int num_entries, const char **error);
+
+/* An index file read into memory, charged to the memory budget */
+struct similarity_index {
+    uint8_t *data;
+    size_t size;
+    char arch_name[16];
+    uint32_t num_entries;
+    const uint8_t *entries, *bands;
+    const char *strings;
+    uint32_t strings_len;
+};
+
+struct similarity_match {
+    const char *path;
+    double similarity;
+    uint64_t shingles;
+};
+
+/* Read and check an index file. Returns 0, or -1 with an error string. */
+int similarity_index_read(struct similarity_index *index, FILE *in, const char **error);
+void similarity_index_free(struct similarity_index *index);
+
+/* Find the entries sharing a band with the signature, and store up to
+ * max_matches of them in matches, most similar first. Returns the number
+ * stored, or -1 with an error string. */
+int similarity_index_query(const struct similarity_index *index, const struct similarity_signature *signature, struct similarity_match *matches, unsigned int max_matches, const char **error);
+
+#endif
+
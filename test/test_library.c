@@ -0,0 +1,258 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <ucdisasm.h>
+
+/******************************************************************************/
+/* Library Test Instrumentation */
+/******************************************************************************/
+
+#define TEST_FLAGS  (PRINT_FLAG_ADDRESSES | PRINT_FLAG_DESTINATION_COMMENT | PRINT_FLAG_OPCODES | PRINT_FLAG_DATA_HEX)
+
+static int test_text(char *name, int arch, uint8_t *data, uint32_t len, uint32_t address, int flags, size_t size, char *expected) {
+    char output[1024];
+    long ret;
+
+    printf("Running test \"%s\"\n", name);
+
+    ret = ucdisasm_disassemble_text(arch, data, len, address, flags, output, size);
+    if (ret < 0) {
+        printf("\tFAILURE error %ld\n\n", ret);
+        return -1;
+    }
+
+    /* Check the complete length is reported, even if truncated */
+    if (ret != (long)strlen(expected) || strncmp(output, expected, size - 1) != 0 || strlen(output) >= size) {
+        printf("\tFAILURE (%ld)\n\tExpected:\n%s\n\tGot:\n%s\n\n", ret, expected, output);
+        return -1;
+    }
+
+    printf("\tSUCCESS\n\n");
+    return 0;
+}
+
+struct test_count {
+    unsigned int count;
+    unsigned int stop;
+    uint32_t last_address;
+};
+
+static int test_count_callback(struct instruction *instr, void *arg) {
+    struct test_count *count = (struct test_count *)arg;
+
+    if (instr->type != DISASM_TYPE_INSTRUCTION)
+        return 0;
+
+    count->last_address = instr->get_address(instr);
+    return (++count->count == count->stop);
+}
+
+/******************************************************************************/
+/* Concurrent Disassembly Stress Test */
+/******************************************************************************/
+
+#define TEST_STRESS_THREADS     16
+#define TEST_STRESS_ROUNDS      4
+#define TEST_STRESS_DATA_LEN    4096
+#define TEST_STRESS_ARCHS       (UCDISASM_ARCH_8051+1)
+
+/* Shared, read-only inputs and single-threaded reference listings */
+struct test_stress {
+    uint8_t data[TEST_STRESS_DATA_LEN];
+    char *reference[TEST_STRESS_ARCHS];
+    long reference_len[TEST_STRESS_ARCHS];
+};
+
+struct test_stress_thread {
+    struct test_stress *stress;
+    unsigned int id;
+    pthread_t thread;
+    int failures;
+};
+
+static void *test_stress_thread(void *arg) {
+    struct test_stress_thread *thread = (struct test_stress_thread *)arg;
+    struct test_stress *stress = thread->stress;
+    unsigned int round, i;
+    int arch;
+    long len;
+    char *output;
+
+    for (round = 0; round < TEST_STRESS_ROUNDS; round++) {
+        for (i = 0; i < TEST_STRESS_ARCHS; i++) {
+            /* Stagger the architectures so threads run different decoders */
+            arch = (thread->id + i) % TEST_STRESS_ARCHS;
+            if ((output = malloc(stress->reference_len[arch] + 1)) == NULL) {
+                thread->failures++;
+                continue;
+            }
+            len = ucdisasm_disassemble_text(arch, stress->data, sizeof(stress->data), 0, TEST_FLAGS | PRINT_FLAG_ASSEMBLY, output, stress->reference_len[arch] + 1);
+            if (len != stress->reference_len[arch] || memcmp(output, stress->reference[arch], len) != 0)
+                thread->failures++;
+            free(output);
+        }
+    }
+
+    return NULL;
+}
+
+/* Run many independent disassemblies concurrently, and check each matches a
+ * single-threaded run. Build with make tsan to check for data races. */
+static int test_stress_concurrent(void) {
+    struct test_stress *stress;
+    struct test_stress_thread threads[TEST_STRESS_THREADS];
+    uint32_t lfsr = 0xace1u;
+    unsigned int i, started;
+    int arch, failures = 0;
+
+    if ((stress = calloc(1, sizeof(struct test_stress))) == NULL)
+        return -1;
+
+    /* Pseudo-random program image */
+    for (i = 0; i < TEST_STRESS_DATA_LEN; i++) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xb400u);
+        stress->data[i] = lfsr & 0xff;
+    }
+
+    for (arch = 0; arch < TEST_STRESS_ARCHS; arch++) {
+        stress->reference_len[arch] = ucdisasm_disassemble_text(arch, stress->data, sizeof(stress->data), 0, TEST_FLAGS | PRINT_FLAG_ASSEMBLY, NULL, 0);
+        if (stress->reference_len[arch] < 0 || (stress->reference[arch] = malloc(stress->reference_len[arch] + 1)) == NULL) {
+            failures++;
+            break;
+        }
+        ucdisasm_disassemble_text(arch, stress->data, sizeof(stress->data), 0, TEST_FLAGS | PRINT_FLAG_ASSEMBLY, stress->reference[arch], stress->reference_len[arch] + 1);
+    }
+
+    for (started = 0; failures == 0 && started < TEST_STRESS_THREADS; started++) {
+        threads[started].stress = stress;
+        threads[started].id = started;
+        threads[started].failures = 0;
+        if (pthread_create(&threads[started].thread, NULL, test_stress_thread, &threads[started]) != 0) {
+            failures++;
+            break;
+        }
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i].thread, NULL);
+        failures += threads[i].failures;
+    }
+
+    for (arch = 0; arch < TEST_STRESS_ARCHS; arch++)
+        free(stress->reference[arch]);
+    free(stress);
+
+    return (failures > 0) ? -1 : 0;
+}
+
+/******************************************************************************/
+/* Library Unit Tests */
+/******************************************************************************/
+
+int test_library_unit_tests(void) {
+    int numTests = 0, passedTests = 0;
+
+    uint8_t avr_data[] = {0x0c, 0x94, 0x34, 0x00, 0xff, 0xcf, 0x00, 0x00, 0x08, 0x95};
+    uint8_t a8051_data[] = {0x02, 0x01, 0x00, 0x80, 0xfe, 0x22};
+
+    printf("Running test_library_unit_tests()\n\n");
+
+    /* Text listings */
+    if (test_text("AVR Text Listing", UCDISASM_ARCH_AVR8, avr_data, sizeof(avr_data), 0, TEST_FLAGS, 1024,
+            "   0:\t00 34 94 0c\tjmp\t0x0034\n"
+            "   4:\tcf ff      \trjmp\t.-2\t; 0x4\n"
+            "   6:\t00 00      \tnop\t\n"
+            "   8:\t95 08      \tret\t\n") == 0)
+        passedTests++;
+    numTests++;
+
+    if (test_text("AVR Text Listing at Base Address", UCDISASM_ARCH_AVR8, avr_data, sizeof(avr_data), 0x100, TEST_FLAGS, 1024,
+            " 100:\t00 34 94 0c\tjmp\t0x0034\n"
+            " 104:\tcf ff      \trjmp\t.-2\t; 0x104\n"
+            " 106:\t00 00      \tnop\t\n"
+            " 108:\t95 08      \tret\t\n") == 0)
+        passedTests++;
+    numTests++;
+
+    if (test_text("8051 Text Listing", UCDISASM_ARCH_8051, a8051_data, sizeof(a8051_data), 0, TEST_FLAGS, 1024,
+            "   0:\t00 01 02\tljmp\t00100h\n"
+            "   3:\tfe 80   \tsjmp\t.-2\t; 03h\n"
+            "   5:\t22      \tret\t\n") == 0)
+        passedTests++;
+    numTests++;
+
+    if (test_text("Truncated Text Listing", UCDISASM_ARCH_8051, a8051_data, sizeof(a8051_data), 0, TEST_FLAGS, 16,
+            "   0:\t00 01 02\tljmp\t00100h\n"
+            "   3:\tfe 80   \tsjmp\t.-2\t; 03h\n"
+            "   5:\t22      \tret\t\n") == 0)
+        passedTests++;
+    numTests++;
+
+    /* Assembly listings label only the instructions operands refer to */
+    if (test_text("AVR Assembly Listing", UCDISASM_ARCH_AVR8, avr_data, sizeof(avr_data), 0, TEST_FLAGS | PRINT_FLAG_ASSEMBLY, 1024,
+            "\t.org\t0x0000\n"
+            "\t00 34 94 0c\tjmp\tA_0068\n"
+            "A_0004:\tcf ff      \trjmp\tA_0004\t; 0x4\n"
+            "\t00 00      \tnop\t\n"
+            "\t95 08      \tret\t\n") == 0)
+        passedTests++;
+    numTests++;
+
+    if (test_text("AVR Assembly Listing with All Labels", UCDISASM_ARCH_AVR8, avr_data, sizeof(avr_data), 0, TEST_FLAGS | PRINT_FLAG_ASSEMBLY | PRINT_FLAG_ALL_LABELS, 1024,
+            "\t.org\t0x0000\n"
+            "A_0000:\t00 34 94 0c\tjmp\tA_0068\n"
+            "A_0004:\tcf ff      \trjmp\tA_0004\t; 0x4\n"
+            "A_0006:\t00 00      \tnop\t\n"
+            "A_0008:\t95 08      \tret\t\n") == 0)
+        passedTests++;
+    numTests++;
+
+    /* Callback and early stop */
+    {
+        struct test_count count = {0, 2, 0};
+
+        printf("Running test \"Callback Early Stop\"\n");
+        if (ucdisasm_disassemble(UCDISASM_ARCH_AVR8, avr_data, sizeof(avr_data), 0, test_count_callback, &count) == 0 && count.count == 2 && count.last_address == 4) {
+            printf("\tSUCCESS\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE count %u, last address %u\n\n", count.count, count.last_address);
+        }
+        numTests++;
+    }
+
+    /* Architecture lookup */
+    {
+        printf("Running test \"Architecture Lookup\"\n");
+        if (ucdisasm_arch_lookup("pic-18") == UCDISASM_ARCH_PIC_PIC18 && ucdisasm_arch_lookup("z80") == -1 &&
+                ucdisasm_disassemble(42, avr_data, sizeof(avr_data), 0, test_count_callback, NULL) < 0) {
+            printf("\tSUCCESS\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE\n\n");
+        }
+        numTests++;
+    }
+
+    /* Concurrent, independent disassemblies */
+    {
+        printf("Running test \"Concurrent Disassembly Stress\"\n");
+        if (test_stress_concurrent() == 0) {
+            printf("\tSUCCESS %d threads match single-threaded output\n\n", TEST_STRESS_THREADS);
+            passedTests++;
+        } else {
+            printf("\tFAILURE concurrent output differs\n\n");
+        }
+        numTests++;
+    }
+
+    printf("%d / %d tests passed.\n\n", passedTests, numTests);
+
+    if (passedTests == numTests)
+        return 0;
+
+    return -1;
+}
+
@@ -0,0 +1,8 @@
+#ifndef TEST_LIBRARY_H
+#define TEST_LIBRARY_H
+
+/* Test In-memory Library Disassembly */
+int test_library_unit_tests(void);
+
+#endif
+
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+
+# Streams synthetic program files of several GB through ucdisasm and checks
+# that its peak RSS stays under --max-memory, for each file type and for
+# standard input. Run with make memory-test [MEMORY_TEST_SIZE=<size>].
+#
+# Usage: test_memory.py <ucdisasm> <size>
+
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+import threading
+import unittest
+
+UCDISASM = None
+SIZE = 2 << 30
+MAX_MEMORY = 32 << 20
+
+def parse_size(s):
+    units = {'k': 10, 'm': 20, 'g': 30}
+    if s[-1].lower() in units:
+        return int(s[:-1], 0) << units[s[-1].lower()]
+    return int(s, 0)
+
+def run_ucdisasm(args, source=None, max_memory=MAX_MEMORY):
+    """Run ucdisasm with args, feeding standard input from the source
+    generator if given, and return its exit status and peak RSS in bytes"""
+    proc = subprocess.Popen([UCDISASM, '--max-memory', str(max_memory)] + args,
+        stdin=subprocess.PIPE if source else subprocess.DEVNULL,
+        stdout=subprocess.DEVNULL)
+
+    def feed():
+        try:
+            for chunk in source:
+                proc.stdin.write(chunk)
+        except BrokenPipeError:
+            pass
+        finally:
+            try:
+                proc.stdin.close()
+            except BrokenPipeError:
+                pass
+
+    if source:
+        writer = threading.Thread(target=feed)
+        writer.start()
+    _, status, rusage = os.wait4(proc.pid, 0)
+    if source:
+        writer.join()
+    return os.waitstatus_to_exitcode(status), rusage.ru_maxrss * 1024
+
+def binary_source(size, block=os.urandom(1 << 20)):
+    while size > 0:
+        yield block[:size]
+        size -= len(block)
+
+def record_source(size, encode, end=b''):
+    """Program file of size data bytes, in records of 16 bytes each"""
+    data = os.urandom(1 << 16)
+    # Encode one block of records per 64K page, and reuse it across pages
+    # with only the page address changing
+    for page in range((size + len(data) - 1) >> 16):
+        yield b''.join(encode(page, offset, data[offset:offset+16]) for offset in range(0, min(len(data), size - (page << 16)), 16))
+    yield end
+
+def ihex_record(address, rtype, data):
+    record = bytes([len(data), (address >> 8) & 0xff, address & 0xff, rtype]) + data
+    return b':' + record.hex().upper().encode() + b'%02X\n' % ((-sum(record)) & 0xff)
+
+def srec_record(address, data):
+    record = bytes([len(data) + 5]) + address.to_bytes(4, 'big') + data
+    return b'S3' + record.hex().upper().encode() + b'%02X\n' % ((~sum(record)) & 0xff)
+
+def ihex_source(size):
+    return record_source(size, lambda page, offset, data:
+        (ihex_record(0, 4, page.to_bytes(2, 'big')) if offset == 0 else b'') + ihex_record(offset, 0, data),
+        ihex_record(0, 1, b''))
+
+def srec_source(size):
+    return record_source(size, lambda page, offset, data: srec_record((page << 16) + offset, data), b'S70500000000FA\n')
+
+def generic_source(size):
+    # Atmel Generic records are <word address>:<word>
+    return record_source(size, lambda page, offset, data:
+        b''.join(b'%06x:%02x%02x\n' % ((((page << 16) + offset + i) >> 1) & 0xffffff, data[i], data[i+1]) for i in range(0, len(data), 2)))
+
+def ascii_source(size):
+    return record_source(size, lambda page, offset, data: data.hex(' ').encode() + b'\n')
+
+def write_sparse_elf(path, text_size):
+    """ELF file with a text_size byte .text section of zeros, left as a hole
+    in the file so it takes no disk space"""
+    text_offset = 0x1000
+    shstrtab = b'\0.text\0.shstrtab\0'
+    shstrtab_offset = text_offset + text_size
+    shoff = (shstrtab_offset + len(shstrtab) + 7) & ~7
+    with open(path, 'wb') as f:
+        f.write(b'\x7fELF' + bytes([2, 1, 1]) + bytes(9))
+        f.write(struct.pack('<HHIQQQIHHHHHH', 2, 0x3e, 1, 0, 0, shoff, 0, 64, 0, 0, 64, 3, 2))
+        f.seek(shstrtab_offset)
+        f.write(shstrtab)
+        f.seek(shoff)
+        f.write(bytes(64))
+        f.write(struct.pack('<IIQQQQIIQQ', 1, 1, 6, 0, text_offset, text_size, 0, 0, 16, 0))
+        f.write(struct.pack('<IIQQQQIIQQ', 7, 3, 0, 0, shstrtab_offset, len(shstrtab), 0, 0, 1, 0))
+
+class TestMemory(unittest.TestCase):
+    def check(self, args, source=None):
+        status, peak = run_ucdisasm(args, source)
+        self.assertEqual(status, 0, args)
+        self.assertLessEqual(peak, MAX_MEMORY, args)
+        return peak
+
+    def test_binary_stdin(self):
+        self.check(['-a', 'avr', '-t', 'binary', '-O', 'binary', '-'], binary_source(SIZE))
+
+    def test_elf(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, 'large.elf')
+            write_sparse_elf(path, SIZE)
+            self.check(['-a', 'avr', '-O', 'binary', path])
+
+    def test_elf_stdin(self):
+        # Standard input is spilled to a temporary file, so keep it smaller
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, 'small.elf')
+            write_sparse_elf(path, SIZE >> 6)
+            with open(path, 'rb') as f:
+                self.check(['-a', '8051', '-'], iter(lambda: f.read(1 << 20), b''))
+
+    def test_record_formats_stdin(self):
+        # Parsing text records is slower, so these are smaller
+        for file_type, source in (('ihex', ihex_source), ('srec', srec_source), ('generic', generic_source), ('ascii', ascii_source)):
+            self.check(['-a', 'pic-18', '-t', file_type, '-'], source(SIZE >> 6))
+
+    def test_pipeline_tee(self):
+        self.check(['-a', 'avr', '-t', 'binary', '--pipeline', '--tee', os.devnull + ',json', '-'], binary_source(SIZE >> 6))
+
+    def test_limit_fails_fast(self):
+        # The pipeline's rings do not fit in a limit of just the baseline
+        status, _ = run_ucdisasm(['-a', 'avr', '-t', 'binary', '--pipeline', '-'], binary_source(1 << 20), max_memory=16 << 20)
+        self.assertNotEqual(status, 0)
+
+if __name__ == '__main__':
+    if len(sys.argv) < 3:
+        sys.stderr.write("Usage: %s <ucdisasm> <size>\n" % sys.argv[0])
+        sys.exit(1)
+    UCDISASM = os.path.abspath(sys.argv[1])
+    SIZE = parse_size(sys.argv[2])
+    unittest.main(argv=sys.argv[:1] + sys.argv[3:])
@@ -0,0 +1,1183 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <printstream.h>
+#include <instruction.h>
+#include <printstream_file.h>
+#include <pipeline.h>
+#include <fanout.h>
+#include <batch.h>
+#include <range.h>
+#include <shard.h>
+#include <live.h>
+#include <discover.h>
+#include <xref.h>
+#include <incremental.h>
+#include <diff.h>
+#include <similarity.h>
+#include <search.h>
+#include <ucdisasm.h>
+#include <file/file_support.h>
+#include <file/prefetch.h>
+#include <file/gzip.h>
+
+#include <avr/avr_support.h>
+
+/******************************************************************************/
+/* Generated Byte Stream, with an optional failure to check error propagation */
+/******************************************************************************/
+
+#define TEST_STREAM_LEN     50000
+
+struct bytestream_generated_state {
+    unsigned int index;
+    int failing;
+};
+
+static int bytestream_generated_init_common(struct ByteStream *self, int failing) {
+    self->state = calloc(1, sizeof(struct bytestream_generated_state));
+    if (self->state == NULL) {
+        self->error = "Error allocating opcode stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    ((struct bytestream_generated_state *)self->state)->failing = failing;
+    self->error = NULL;
+    return 0;
+}
+
+static int bytestream_generated_init(struct ByteStream *self) { return bytestream_generated_init_common(self, 0); }
+static int bytestream_failing_init(struct ByteStream *self) { return bytestream_generated_init_common(self, 1); }
+
+static int bytestream_generated_close(struct ByteStream *self) {
+    free(self->state);
+    return 0;
+}
+
+static int bytestream_generated_read(struct ByteStream *self, uint8_t *data, uint32_t *address) {
+    struct bytestream_generated_state *state = (struct bytestream_generated_state *)self->state;
+
+    if (state->failing && state->index == TEST_STREAM_LEN/5) {
+        self->error = "Simulated read failure!";
+        return STREAM_ERROR_INPUT;
+    }
+    if (state->index == TEST_STREAM_LEN)
+        return STREAM_EOF;
+
+    /* Pseudo-random program, with an address jump halfway through to
+     * exercise the origin directive logic across block boundaries */
+    *data = (uint8_t)((state->index * 2654435761u) >> 13);
+    *address = (state->index < TEST_STREAM_LEN/2) ? state->index : state->index + 0x1001;
+    state->index++;
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Pipeline Test Instrumentation */
+/******************************************************************************/
+
+static int test_run(int failing, int pipelined, FILE *out) {
+    struct ByteStream bs, bs_pipeline;
+    struct DisasmStream ds, ds_pipeline;
+    struct PrintStream ps;
+    int ret;
+
+    /* Setup the Generated Byte Stream */
+    bs.in = NULL;
+    bs.stream_init = failing ? bytestream_failing_init : bytestream_generated_init;
+    bs.stream_close = bytestream_generated_close;
+    bs.stream_read = bytestream_generated_read;
+
+    /* Setup the AVR Disasm Stream */
+    ds.in = &bs;
+    ds.stream_init = disasmstream_avr_init;
+    ds.stream_close = disasmstream_avr_close;
+    ds.stream_read = disasmstream_avr_read;
+
+    /* Setup the Print Stream */
+    ps.in = &ds;
+    ps.stream_init = printstream_file_init;
+    ps.stream_close = printstream_file_close;
+    ps.stream_read = printstream_file_read;
+
+    if (pipelined) {
+        if (pipeline_bytestream_setup(&bs_pipeline, &bs) < 0 || pipeline_disasmstream_setup(&ds_pipeline, &ds) < 0)
+            return STREAM_ERROR_ALLOC;
+        ds.in = &bs_pipeline;
+        ps.in = &ds_pipeline;
+    }
+
+    /* Initialize the stream */
+    ret = ps.stream_init(&ps, PRINT_FLAG_ADDRESSES | PRINT_FLAG_OPCODES | PRINT_FLAG_DATA_HEX | PRINT_FLAG_DESTINATION_COMMENT);
+    if (ret < 0) {
+        printf("\tps.stream_init(): %d\n", ret);
+        printf("\t\tError: %s\n", ps.error);
+        return ret;
+    }
+
+    /* Read until EOF or error */
+    while ( (ret = ps.stream_read(&ps, out)) == 0 )
+        ;
+
+    ps.stream_close(&ps);
+
+    return ret;
+}
+
+static int test_run_fanout(FILE *out_a, FILE *out_b) {
+    struct ByteStream bs;
+    struct DisasmStream ds, ds_branches[2];
+    struct PrintStream ps_a, ps_b;
+    int flags = PRINT_FLAG_ADDRESSES | PRINT_FLAG_OPCODES | PRINT_FLAG_DATA_HEX | PRINT_FLAG_DESTINATION_COMMENT;
+    int ret_a, ret_b;
+
+    /* Setup the Generated Byte Stream */
+    bs.in = NULL;
+    bs.stream_init = bytestream_generated_init;
+    bs.stream_close = bytestream_generated_close;
+    bs.stream_read = bytestream_generated_read;
+
+    /* Setup the AVR Disasm Stream */
+    ds.in = &bs;
+    ds.stream_init = disasmstream_avr_init;
+    ds.stream_close = disasmstream_avr_close;
+    ds.stream_read = disasmstream_avr_read;
+
+    /* Fan out to two Print Streams */
+    if (fanout_disasmstream_setup(ds_branches, 2, &ds) < 0)
+        return STREAM_ERROR_ALLOC;
+    ps_a.in = &ds_branches[0];
+    ps_a.stream_init = printstream_file_init;
+    ps_a.stream_close = printstream_file_close;
+    ps_a.stream_read = printstream_file_read;
+    ps_b = ps_a;
+    ps_b.in = &ds_branches[1];
+
+    if ((ret_a = ps_a.stream_init(&ps_a, flags)) < 0 || (ret_b = ps_b.stream_init(&ps_b, flags)) < 0) {
+        printf("\tps.stream_init() failed\n");
+        return STREAM_ERROR_FAILURE;
+    }
+
+    /* Read both in lockstep until EOF or error */
+    do {
+        ret_a = ps_a.stream_read(&ps_a, out_a);
+        ret_b = ps_b.stream_read(&ps_b, out_b);
+    } while (ret_a == 0 && ret_b == 0);
+
+    ps_b.stream_close(&ps_b);
+    ps_a.stream_close(&ps_a);
+
+    return (ret_a == ret_b) ? ret_a : STREAM_ERROR_FAILURE;
+}
+
+static int test_compare_files(FILE *a, FILE *b) {
+    int ca, cb;
+
+    rewind(a);
+    rewind(b);
+    do {
+        ca = fgetc(a);
+        cb = fgetc(b);
+        if (ca != cb)
+            return -1;
+    } while (ca != EOF);
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Batch Worker Pool */
+/******************************************************************************/
+
+#define TEST_BATCH_JOBS     97
+
+/* Count each run of a job, with some uneven work so workers steal */
+static void test_batch_process(struct batch_job *job, void *arg) {
+    volatile unsigned int i;
+
+    (void)arg;
+    for (i = 0; i < (job->index % 7) * 10000; i++)
+        ;
+    __sync_fetch_and_add(&job->status, 1);
+}
+
+static int test_batch_run(unsigned int num_workers) {
+    struct batch_job jobs[TEST_BATCH_JOBS];
+    unsigned int i;
+
+    memset(jobs, 0, sizeof(jobs));
+    for (i = 0; i < TEST_BATCH_JOBS; i++)
+        jobs[i].index = i;
+
+    if (batch_run(jobs, TEST_BATCH_JOBS, num_workers, test_batch_process, NULL) < 0)
+        return -1;
+
+    /* Every job must have run exactly once */
+    for (i = 0; i < TEST_BATCH_JOBS; i++) {
+        if (jobs[i].status != 1)
+            return -1;
+    }
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Prefetching File Reader */
+/******************************************************************************/
+
+#define TEST_PREFETCH_FILES     6
+#define TEST_PREFETCH_BUFFER    4096
+
+static const unsigned int test_prefetch_sizes[TEST_PREFETCH_FILES] = {0, 1, 100, 4096, 10000, 9999};
+
+static uint8_t test_prefetch_byte(unsigned int file, unsigned int offset) {
+    return (file * 31 + offset * 7) & 0xff;
+}
+
+/* Check a prefetched file reads back its contents, and seeks */
+static int test_prefetch_check(FILE *in, unsigned int file) {
+    unsigned int size = test_prefetch_sizes[file], i;
+    int c;
+
+    for (i = 0; (c = fgetc(in)) != EOF; i++) {
+        if (i >= size || c != test_prefetch_byte(file, i))
+            return -1;
+    }
+    if (i != size)
+        return -1;
+
+    /* The ELF reader takes the size from the end, and seeks back */
+    if (fseek(in, 0, SEEK_END) < 0 || ftell(in) != (long)size)
+        return -1;
+    if (size > 0) {
+        if (fseek(in, size - 1, SEEK_SET) < 0 || fgetc(in) != test_prefetch_byte(file, size - 1))
+            return -1;
+    }
+
+    return 0;
+}
+
+/* Write the test files, plus a missing one, and read them back opened out of
+ * order with buffers smaller than the larger files. With few buffers, files
+ * may be opened before they are prefetched, with enough for all files the
+ * larger ones are read past their buffers. Returns 1 if the backend is
+ * unavailable. */
+static int test_prefetch_run(int backend, unsigned int num_slots) {
+    char dir[] = "/tmp/ucdisasm-prefetch-XXXXXX";
+    char paths[TEST_PREFETCH_FILES + 1][64];
+    const char *path_list[TEST_PREFETCH_FILES + 1];
+    static const unsigned int order[TEST_PREFETCH_FILES] = {2, 0, 1, 3, 5, 4};
+    struct prefetch *prefetch;
+    unsigned int i, j;
+    FILE *fp;
+    int ret = 0;
+
+    if (mkdtemp(dir) == NULL)
+        return -1;
+    for (i = 0; i <= TEST_PREFETCH_FILES; i++) {
+        snprintf(paths[i], sizeof(paths[i]), "%s/%u.bin", dir, i);
+        path_list[i] = paths[i];
+        if (i == TEST_PREFETCH_FILES)
+            break;
+        if ((fp = fopen(paths[i], "w")) == NULL)
+            return -1;
+        for (j = 0; j < test_prefetch_sizes[i]; j++)
+            fputc(test_prefetch_byte(i, j), fp);
+        fclose(fp);
+    }
+
+    if ((prefetch = prefetch_start(path_list, TEST_PREFETCH_FILES + 1, num_slots, TEST_PREFETCH_BUFFER, backend)) == NULL) {
+        ret = 1;
+    } else {
+        for (i = 0; i < TEST_PREFETCH_FILES && ret == 0; i++) {
+            if ((fp = prefetch_open(prefetch, order[i])) == NULL) {
+                ret = -1;
+                break;
+            }
+            ret = test_prefetch_check(fp, order[i]);
+            fclose(fp);
+        }
+        /* A missing file fails to open, and a file opens only once */
+        if (ret == 0 && (fp = prefetch_open(prefetch, TEST_PREFETCH_FILES)) != NULL) {
+            fclose(fp);
+            ret = -1;
+        }
+        if (ret == 0 && (fp = prefetch_open(prefetch, 0)) != NULL) {
+            fclose(fp);
+            ret = -1;
+        }
+        prefetch_stop(prefetch);
+    }
+
+    for (i = 0; i < TEST_PREFETCH_FILES; i++)
+        unlink(paths[i]);
+    rmdir(dir);
+
+    return ret;
+}
+
+/******************************************************************************/
+/* Gzip Input */
+/******************************************************************************/
+
+#define TEST_GZIP_LEN       300000
+
+/* Append data to out as a gzip member */
+static int test_gzip_member(FILE *out, const uint8_t *data, size_t len) {
+    static uint8_t buf[TEST_GZIP_LEN + 1024];
+    z_stream strm;
+    int ret;
+
+    memset(&strm, 0, sizeof(strm));
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return -1;
+    strm.next_in = (uint8_t *)data;
+    strm.avail_in = len;
+    strm.next_out = buf;
+    strm.avail_out = sizeof(buf);
+    ret = deflate(&strm, Z_FINISH);
+    deflateEnd(&strm);
+    if (ret != Z_STREAM_END)
+        return -1;
+
+    return (fwrite(buf, 1, sizeof(buf) - strm.avail_out, out) == sizeof(buf) - strm.avail_out) ? 0 : -1;
+}
+
+/* Decompress data split into two gzip members, longer than the ring of
+ * blocks, and check it reads back whole. With truncate, the second member is
+ * cut short and must end in a read error after the first member's data. */
+static int test_gzip_run(int truncate) {
+    static uint8_t data[TEST_GZIP_LEN];
+    FILE *fp, *in;
+    long size;
+    unsigned int i;
+    int c, ret = 0;
+
+    for (i = 0; i < TEST_GZIP_LEN; i++)
+        data[i] = (i * 7 + (i >> 10)) & 0xff;
+
+    if ((fp = tmpfile()) == NULL)
+        return -1;
+    if (test_gzip_member(fp, data, 1000) < 0 || test_gzip_member(fp, data + 1000, TEST_GZIP_LEN - 1000) < 0) {
+        fclose(fp);
+        return -1;
+    }
+    if (truncate) {
+        size = ftell(fp);
+        if (fflush(fp) != 0 || ftruncate(fileno(fp), size - 100) < 0) {
+            fclose(fp);
+            return -1;
+        }
+    }
+    rewind(fp);
+
+    if (!gzip_detect(fp) || (in = gzip_input_open(fp)) == NULL) {
+        fclose(fp);
+        return -1;
+    }
+    for (i = 0; (c = fgetc(in)) != EOF; i++) {
+        if (i >= TEST_GZIP_LEN || c != data[i]) {
+            ret = -1;
+            break;
+        }
+    }
+    if (ret == 0 && truncate)
+        ret = (ferror(in) && i >= 1000) ? 0 : -1;
+    else if (ret == 0)
+        ret = (!ferror(in) && i == TEST_GZIP_LEN) ? 0 : -1;
+    fclose(in);
+
+    return ret;
+}
+
+/******************************************************************************/
+/* Address Range Filter */
+/******************************************************************************/
+
+/* Disassemble 64 bytes of AVR nops filtered to [0x10, 0x20), returns the
+ * number of instructions passed through, or -1 if one is out of range */
+static int test_range_run(void) {
+    uint8_t data[64] = {0};
+    struct ByteStream bs;
+    struct DisasmStream ds, ds_range;
+    struct instruction instr;
+    uint32_t address;
+    int count = 0;
+
+    if (bytestream_memory_setup(&bs, data, sizeof(data), 0) < 0)
+        return -1;
+    ds.in = &bs;
+    ds.stream_init = disasmstream_avr_init;
+    ds.stream_close = disasmstream_avr_close;
+    ds.stream_read = disasmstream_avr_read;
+    if (range_disasmstream_setup(&ds_range, &ds, 0x10, 0x20) < 0 || ds_range.stream_init(&ds_range) < 0)
+        return -1;
+
+    while (ds_range.stream_read(&ds_range, &instr) == 0) {
+        if (instr.type == DISASM_TYPE_INSTRUCTION) {
+            address = instr.get_address(&instr);
+            if (address < 0x10 || address >= 0x20)
+                count = -1000;
+            count++;
+        }
+        instr.free(&instr);
+    }
+
+    if (ds_range.stream_close(&ds_range) < 0)
+        return -1;
+
+    return (count < 0) ? -1 : count;
+}
+
+/******************************************************************************/
+/* Recursive Descent */
+/******************************************************************************/
+
+/* Discover the AVR code at 0: rcall to 0x8, a skip over a jump back to 0,
+ * and two returns, followed by the first word of a jmp cut short. Returns
+ * the number of instructions, with raw data counted from 100, or -1 if an
+ * instruction is out of place. */
+static int test_discover_run(void) {
+    static const uint8_t data[] = {0x03, 0xd0, 0x00, 0xff, 0xfd, 0xcf, 0x08, 0x95,
+                                   0x01, 0xe0, 0x08, 0x95, 0x0c, 0x94, 0x34, 0x12};
+    struct discover_spec spec = {UCDISASM_ARCH_AVR8, {0}, 0};
+    struct ByteStream bs;
+    struct DisasmStream ds, ds_discover;
+    struct instruction instr;
+    uint32_t address, expected = 0;
+    int count = 0;
+
+    if (bytestream_memory_setup(&bs, (uint8_t *)data, sizeof(data), 0) < 0)
+        return -1;
+    ds.in = &bs;
+    ds.stream_init = disasmstream_avr_init;
+    ds.stream_close = disasmstream_avr_close;
+    ds.stream_read = disasmstream_avr_read;
+    if (discover_disasmstream_setup(&ds_discover, &ds, &spec) < 0 || ds_discover.stream_init(&ds_discover) < 0)
+        return -1;
+
+    while (ds_discover.stream_read(&ds_discover, &instr) == 0) {
+        if (instr.type == DISASM_TYPE_INSTRUCTION) {
+            address = instr.get_address(&instr);
+            if (address != expected)
+                count = -1000;
+            expected += instr.get_width(&instr);
+            count += (instr.get_flow(&instr) == FLOW_INVALID) ? 100 : 1;
+        }
+        instr.free(&instr);
+    }
+
+    if (ds_discover.stream_close(&ds_discover) < 0)
+        return -1;
+
+    return (count < 0) ? -1 : count;
+}
+
+/******************************************************************************/
+/* Cross-Reference Labels */
+/******************************************************************************/
+
+static void test_xref_setup(struct ByteStream *bs, struct DisasmStream *ds, const uint8_t *data, unsigned int len) {
+    bytestream_memory_setup(bs, (uint8_t *)data, len, 0);
+    ds->in = bs;
+    ds->stream_init = disasmstream_avr_init;
+    ds->stream_close = disasmstream_avr_close;
+    ds->stream_read = disasmstream_avr_read;
+}
+
+/* Label the AVR code rcall .+2, nop, nop, ret with a scan and a second pass.
+ * Returns the address of the only label, or -1 if there is not exactly one. */
+static int test_xref_run(void) {
+    static const uint8_t data[] = {0x01, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x08, 0x95};
+    struct ByteStream bs;
+    struct DisasmStream ds, ds_xref;
+    struct xref_index index;
+    struct instruction instr;
+    char label[32];
+    int labeled = -1, count = 0, ret;
+
+    xref_index_init(&index);
+    test_xref_setup(&bs, &ds, data, sizeof(data));
+    if (xref_index_scan(&index, &ds) < 0) {
+        xref_index_free(&index);
+        return -1;
+    }
+
+    test_xref_setup(&bs, &ds, data, sizeof(data));
+    if (xref_disasmstream_setup(&ds_xref, &ds, &index) < 0 || ds_xref.stream_init(&ds_xref) < 0) {
+        xref_index_free(&index);
+        return -1;
+    }
+
+    while (ds_xref.stream_read(&ds_xref, &instr) == 0) {
+        if (instr.type == DISASM_TYPE_INSTRUCTION && instr.get_str_address_label(&instr, label, sizeof(label), 0) > 0) {
+            labeled = instr.get_address(&instr);
+            count++;
+        }
+        instr.free(&instr);
+    }
+
+    ret = ds_xref.stream_close(&ds_xref);
+    xref_index_free(&index);
+    if (ret < 0)
+        return -1;
+
+    return (count == 1) ? labeled : -1;
+}
+
+/******************************************************************************/
+/* Incremental Disassembly */
+/******************************************************************************/
+
+#define TEST_INCREMENTAL_LEN    4096
+
+static void test_incremental_setup(struct ByteStream *bs, const uint8_t *data) {
+    bytestream_memory_setup(bs, (uint8_t *)data, TEST_INCREMENTAL_LEN, 0);
+}
+
+/* Write the full AVR text listing of data to out */
+static int test_incremental_listing(const uint8_t *data, FILE *out) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct instruction instr;
+    char line[PRINTSTREAM_FILE_LINE_LEN];
+
+    test_incremental_setup(&bs, data);
+    ds.in = &bs;
+    ucdisasm_disasmstream_setup(&ds, UCDISASM_ARCH_AVR8);
+    if (ds.stream_init(&ds) < 0)
+        return -1;
+    while (ds.stream_read(&ds, &instr) == 0) {
+        if (printstream_file_format(&instr, line, sizeof(line), PRINT_FLAG_ADDRESSES | PRINT_FLAG_OPCODES) > 0)
+            fputs(line, out);
+        instr.free(&instr);
+    }
+
+    return ds.stream_close(&ds);
+}
+
+/* Change two bytes of an AVR image, one making a jmp out of two words, and
+ * check the incremental listing matches the full one. Returns the number of
+ * regions decoded again, or -1 on a mismatch or failure. */
+static int test_incremental_run(void) {
+    static uint8_t old_data[TEST_INCREMENTAL_LEN], new_data[TEST_INCREMENTAL_LEN];
+    struct ByteStream bs_old, bs_new;
+    struct incremental_stats stats;
+    FILE *old_listing, *full, *incremental;
+    const char *error;
+    int i, ret = -1;
+
+    for (i = 0; i < TEST_INCREMENTAL_LEN; i++)
+        old_data[i] = (i*7 + (i >> 8)) & 0xff;
+    memcpy(new_data, old_data, sizeof(new_data));
+    new_data[1000] = 0x0c;
+    new_data[1001] = 0x94;
+    new_data[3001] ^= 0xff;
+
+    old_listing = tmpfile();
+    full = tmpfile();
+    incremental = tmpfile();
+    if (old_listing != NULL && full != NULL && incremental != NULL &&
+        test_incremental_listing(old_data, old_listing) == 0 && test_incremental_listing(new_data, full) == 0) {
+        rewind(old_listing);
+        test_incremental_setup(&bs_old, old_data);
+        test_incremental_setup(&bs_new, new_data);
+        if (incremental_render(&bs_old, old_listing, &bs_new, UCDISASM_ARCH_AVR8, PRINT_FLAG_ADDRESSES | PRINT_FLAG_OPCODES, incremental, &stats, &error) == 0 &&
+            test_compare_files(full, incremental) == 0 && stats.decoded < TEST_INCREMENTAL_LEN/4)
+            ret = stats.regions;
+    }
+
+    if (old_listing != NULL) fclose(old_listing);
+    if (full != NULL) fclose(full);
+    if (incremental != NULL) fclose(incremental);
+
+    return ret;
+}
+
+/******************************************************************************/
+/* Diff */
+/******************************************************************************/
+
+/* Insert an ldi at the start of an AVR image, moving all of the code after
+ * it, and check the diff lists only the ldi. Returns the number of hunks, or
+ * -1 if other instructions were listed or on failure. */
+static int test_diff_run(void) {
+    static uint8_t old_data[TEST_INCREMENTAL_LEN], new_data[TEST_INCREMENTAL_LEN + 2];
+    struct ByteStream bs_old, bs_new;
+    struct diff_stats stats;
+    const char *error;
+    FILE *out;
+    int i, ret = -1;
+
+    for (i = 0; i < TEST_INCREMENTAL_LEN; i++)
+        old_data[i] = (i*7 + (i >> 8)) & 0xff;
+    /* ldi r16, 0x55 */
+    new_data[0] = 0x05;
+    new_data[1] = 0xe5;
+    memcpy(new_data + 2, old_data, sizeof(old_data));
+
+    if ((out = tmpfile()) == NULL)
+        return -1;
+    bytestream_memory_setup(&bs_old, old_data, sizeof(old_data), 0);
+    bytestream_memory_setup(&bs_new, new_data, sizeof(new_data), 0);
+    if (diff_render(&bs_old, &bs_new, UCDISASM_ARCH_AVR8, PRINT_FLAG_ADDRESSES | PRINT_FLAG_OPCODES, out, &stats, &error) == 0 &&
+        stats.inserted == 1 && stats.deleted == 0 && stats.modified == 0 && stats.old_count + 1 == stats.new_count)
+        ret = stats.hunks;
+    fclose(out);
+
+    return ret;
+}
+
+/******************************************************************************/
+/* Similarity Index */
+/******************************************************************************/
+
+static int test_similarity_signature(const uint8_t *data, uint32_t len, struct similarity_signature *signature) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+
+    bytestream_memory_setup(&bs, (uint8_t *)data, len, 0);
+    ds.in = &bs;
+    ucdisasm_disasmstream_setup(&ds, UCDISASM_ARCH_AVR8);
+
+    return similarity_signature_compute(&ds, signature);
+}
+
+/* Index an AVR image with an ldi inserted, and an unrelated image, and query
+ * the index with the original image. Returns the number of matches, or -1 if
+ * the edited image is not the closest match or on failure. */
+static int test_similarity_run(void) {
+    static uint8_t original[TEST_INCREMENTAL_LEN], edited[TEST_INCREMENTAL_LEN + 2], unrelated[TEST_INCREMENTAL_LEN];
+    static struct similarity_signature signatures[2], signature;
+    const char *paths[2] = {"edited", "unrelated"};
+    struct similarity_index index;
+    struct similarity_match matches[2];
+    const char *error;
+    FILE *file;
+    int i, ret = -1;
+
+    for (i = 0; i < TEST_INCREMENTAL_LEN; i++) {
+        original[i] = (i*7 + (i >> 8)) & 0xff;
+        unrelated[i] = (i*i*13 + (i >> 4)) & 0xff;
+    }
+    /* ldi r16, 0x55 */
+    memcpy(edited + 2, original, sizeof(original));
+    edited[0] = 0x05;
+    edited[1] = 0xe5;
+
+    if (test_similarity_signature(edited, sizeof(edited), &signatures[0]) < 0 ||
+        test_similarity_signature(unrelated, sizeof(unrelated), &signatures[1]) < 0 ||
+        test_similarity_signature(original, sizeof(original), &signature) < 0)
+        return -1;
+
+    if ((file = tmpfile()) == NULL)
+        return -1;
+    if (similarity_index_write(file, "avr", paths, signatures, 2, &error) == 0) {
+        rewind(file);
+        if (similarity_index_read(&index, file, &error) == 0) {
+            ret = similarity_index_query(&index, &signature, matches, 2, &error);
+            if (ret < 1 || strcmp(matches[0].path, "edited") != 0 || matches[0].similarity < 0.9 || (ret == 2 && matches[1].similarity > 0.1))
+                ret = -1;
+            similarity_index_free(&index);
+        }
+    }
+    fclose(file);
+
+    return ret;
+}
+
+/******************************************************************************/
+/* Pattern Search */
+/******************************************************************************/
+
+/* Search an AVR image for a computed jump through Z loaded with 0x1234, and
+ * a decoy loading r30 twice. Returns the number of matches written, or -1 if
+ * the context lines are wrong or on failure. */
+static int test_search_run(void) {
+    /* nop; ldi r30, 0x12; ldi r31, 0x34; ijmp; nop; ldi r30, 0x12; ldi r30, 0x34; ijmp; nop */
+    static uint8_t data[] = {0x00, 0x00, 0xe2, 0xe1, 0xf4, 0xe3, 0x09, 0x94, 0x00, 0x00, 0xe2, 0xe1, 0xe4, 0xe3, 0x09, 0x94, 0x00, 0x00};
+    const char *patterns[] = {"ldi r30, 0x12; ldi r31, *; ijmp", "nop; ldi r30, 52"};
+    struct search_automaton automaton;
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct PrintStream ps;
+    char line[PRINTSTREAM_FILE_LINE_LEN];
+    const char *error;
+    int lines = 0, matches = 0, ret;
+    FILE *out;
+
+    if ((out = tmpfile()) == NULL)
+        return -1;
+
+    bytestream_memory_setup(&bs, data, sizeof(data), 0);
+    ds.in = &bs;
+    if (search_compile(&automaton, patterns, 2, ucdisasm_disasmstream_setup(&ds, UCDISASM_ARCH_AVR8), &error) < 0) {
+        fclose(out);
+        return -1;
+    }
+    ps.in = &ds;
+    if (printstream_search_setup(&ps, &automaton, 1) < 0 || ps.stream_init(&ps, PRINT_FLAG_ADDRESSES | PRINT_FLAG_OPCODES) < 0) {
+        search_free(&automaton);
+        fclose(out);
+        return -1;
+    }
+    while ((ret = ps.stream_read(&ps, out)) == 0)
+        ;
+    ps.stream_close(&ps);
+    search_free(&automaton);
+
+    /* One match with a nop of context on each side */
+    rewind(out);
+    while (fgets(line, sizeof(line), out) != NULL) {
+        if (strncmp(line, "; match", 7) == 0)
+            matches++;
+        else
+            lines++;
+    }
+    fclose(out);
+
+    if (ret != STREAM_EOF || lines != 5)
+        return -1;
+
+    return matches;
+}
+
+/******************************************************************************/
+/* Live Input */
+/******************************************************************************/
+
+struct test_live_writer {
+    int in_fd, out_fd;
+    /* Set if the first instruction was written out before more input */
+    int flushed;
+};
+
+/* Write one AVR instruction, wait for its disassembly to be written out,
+ * then write another and hang up */
+static void *test_live_writer_thread(void *arg) {
+    struct test_live_writer *writer = arg;
+    struct pollfd pfd = {writer->out_fd, POLLIN, 0};
+    uint8_t nop[2] = {0x00, 0x00};
+
+    if (write(writer->in_fd, nop, sizeof(nop)) == sizeof(nop))
+        writer->flushed = (poll(&pfd, 1, 2000) == 1);
+    if (write(writer->in_fd, nop, sizeof(nop)) != sizeof(nop))
+        writer->flushed = 0;
+    close(writer->in_fd);
+
+    return NULL;
+}
+
+/* Disassemble a pipe fed by the writer thread to a fully buffered pipe,
+ * returns the number of instructions written out, or -1 if the output was
+ * not flushed while waiting on input */
+static int test_live_run(void) {
+    struct test_live_writer writer;
+    struct live_stats stats;
+    struct ByteStream bs;
+    struct DisasmStream ds, ds_live;
+    struct PrintStream ps;
+    int in_fds[2], out_fds[2];
+    pthread_t thread;
+    FILE *out;
+    int ret;
+
+    if (pipe(in_fds) < 0 || pipe(out_fds) < 0)
+        return -1;
+    if ((out = fdopen(out_fds[1], "w")) == NULL)
+        return -1;
+    setvbuf(out, NULL, _IOFBF, BUFSIZ);
+
+    /* With a long flush interval, only waiting on input flushes */
+    live_stats_init(&stats, 60000);
+    if ((bs.in = live_input_open(fdopen(in_fds[0], "r"), 0, &stats)) == NULL)
+        return -1;
+    bs.stream_init = bytestream_binary_init;
+    bs.stream_close = bytestream_binary_close;
+    bs.stream_read = bytestream_binary_read;
+    ds.in = &bs;
+    ds.stream_init = disasmstream_avr_init;
+    ds.stream_close = disasmstream_avr_close;
+    ds.stream_read = disasmstream_avr_read;
+    if (live_disasmstream_setup(&ds_live, &ds, &stats) < 0)
+        return -1;
+    ps.in = &ds_live;
+    ps.stream_init = printstream_file_init;
+    ps.stream_close = printstream_file_close;
+    ps.stream_read = printstream_file_read;
+
+    writer.in_fd = in_fds[1];
+    writer.out_fd = out_fds[0];
+    writer.flushed = 0;
+    if (pthread_create(&thread, NULL, test_live_writer_thread, &writer) != 0)
+        return -1;
+
+    if (ps.stream_init(&ps, PRINT_FLAG_ADDRESSES | PRINT_FLAG_OPCODES | PRINT_FLAG_DATA_HEX) == 0) {
+        while ((ret = ps.stream_read(&ps, out)) == 0)
+            live_instruction(&stats);
+        live_flush(&stats);
+        ps.stream_close(&ps);
+    }
+    pthread_join(thread, NULL);
+    fclose(out);
+    close(out_fds[0]);
+
+    /* Two instructions, the origin directive is not counted */
+    return writer.flushed ? (int)stats.count : -1;
+}
+
+/******************************************************************************/
+/* Shard Split */
+/******************************************************************************/
+
+#define TEST_SHARD_LEN      4096
+
+/* Pseudo-random program data, with plenty of AVR 32-bit instructions */
+static void test_shard_data(uint8_t *data) {
+    uint32_t x = 12345;
+    int i;
+
+    for (i = 0; i < TEST_SHARD_LEN; i += 2) {
+        x = x*1103515245 + 12345;
+        data[i] = (x >> 16) & 0xff;
+        data[i+1] = (x >> 24) & 0xff;
+        /* call */
+        if ((x & 0x7) == 0) {
+            data[i] = 0x0e;
+            data[i+1] = 0x94;
+        }
+    }
+}
+
+/* Print shard index of total of the data as a text listing to out */
+static int test_shard_run(int arch, const uint8_t *data, unsigned int index, unsigned int total, FILE *out) {
+    struct shard_spec spec;
+    struct ByteStream bs, bs_shard;
+    struct DisasmStream ds, ds_shard;
+    struct instruction instr;
+    char line[PRINTSTREAM_FILE_LINE_LEN];
+    int ret;
+
+    spec.index = index;
+    spec.total = total;
+    spec.arch = arch;
+    if (bytestream_memory_setup(&bs, data, TEST_SHARD_LEN, 0x100) < 0 || shard_scan_image(&bs, &spec.image) < 0)
+        return STREAM_ERROR_FAILURE;
+
+    if (bytestream_memory_setup(&bs, data, TEST_SHARD_LEN, 0x100) < 0)
+        return STREAM_ERROR_FAILURE;
+    ds.in = &bs;
+    ucdisasm_disasmstream_setup(&ds, arch);
+    if (shard_bytestream_setup(&bs_shard, &bs, &spec) < 0)
+        return STREAM_ERROR_FAILURE;
+    ds.in = &bs_shard;
+    if (shard_disasmstream_setup(&ds_shard, &ds, &spec) < 0 || ds_shard.stream_init(&ds_shard) < 0)
+        return STREAM_ERROR_FAILURE;
+
+    while ((ret = ds_shard.stream_read(&ds_shard, &instr)) == 0) {
+        if (printstream_file_format(&instr, line, sizeof(line), PRINT_FLAG_ADDRESSES | PRINT_FLAG_OPCODES | PRINT_FLAG_DATA_HEX) > 0)
+            fputs(line, out);
+        instr.free(&instr);
+    }
+
+    if (ds_shard.stream_close(&ds_shard) < 0)
+        return STREAM_ERROR_FAILURE;
+
+    return ret;
+}
+
+/* Check the concatenated shards of 1 to 8 match a single run, returns the
+ * failing number of shards, or 0 */
+static int test_shard_split(int arch) {
+    uint8_t data[TEST_SHARD_LEN];
+    FILE *single_out, *shards_out;
+    unsigned int i, total;
+    int ret = 0;
+
+    test_shard_data(data);
+
+    for (total = 1; total <= 8 && ret == 0; total++) {
+        single_out = tmpfile();
+        shards_out = tmpfile();
+        if (single_out == NULL || shards_out == NULL || test_shard_run(arch, data, 0, 1, single_out) != STREAM_EOF)
+            ret = total;
+        for (i = 0; i < total && ret == 0; i++) {
+            if (test_shard_run(arch, data, i, total, shards_out) != STREAM_EOF)
+                ret = total;
+        }
+        if (ret == 0 && test_compare_files(single_out, shards_out) < 0)
+            ret = total;
+        if (single_out != NULL) fclose(single_out);
+        if (shards_out != NULL) fclose(shards_out);
+    }
+
+    return ret;
+}
+
+/******************************************************************************/
+/* Pipeline Unit Tests */
+/******************************************************************************/
+
+int test_pipeline_unit_tests(void) {
+    int numTests = 0, passedTests = 0;
+    FILE *sync_out, *pipelined_out;
+    int ret_sync, ret_pipelined;
+
+    printf("Running test_pipeline_unit_tests()\n\n");
+
+    /* Check pipelined output matches synchronous output */
+    {
+        sync_out = tmpfile();
+        pipelined_out = tmpfile();
+
+        printf("Running test \"Pipelined Output Matches Synchronous Output\"\n");
+        if (sync_out != NULL && pipelined_out != NULL) {
+            ret_sync = test_run(0, 0, sync_out);
+            ret_pipelined = test_run(0, 1, pipelined_out);
+            if (ret_sync == STREAM_EOF && ret_pipelined == STREAM_EOF && test_compare_files(sync_out, pipelined_out) == 0) {
+                printf("\tSUCCESS outputs match\n\n");
+                passedTests++;
+            } else {
+                printf("\tFAILURE outputs differ (%d, %d)\n\n", ret_sync, ret_pipelined);
+            }
+        }
+        numTests++;
+
+        if (sync_out != NULL) fclose(sync_out);
+        if (pipelined_out != NULL) fclose(pipelined_out);
+    }
+
+    /* Check errors propagate in stream order */
+    {
+        sync_out = tmpfile();
+        pipelined_out = tmpfile();
+
+        printf("Running test \"Pipelined Error Propagation\"\n");
+        if (sync_out != NULL && pipelined_out != NULL) {
+            ret_sync = test_run(1, 0, sync_out);
+            ret_pipelined = test_run(1, 1, pipelined_out);
+            if (ret_sync == STREAM_ERROR_INPUT && ret_pipelined == STREAM_ERROR_INPUT && test_compare_files(sync_out, pipelined_out) == 0) {
+                printf("\tSUCCESS error code %d after identical output\n\n", ret_pipelined);
+                passedTests++;
+            } else {
+                printf("\tFAILURE error codes (%d, %d)\n\n", ret_sync, ret_pipelined);
+            }
+        }
+        numTests++;
+
+        if (sync_out != NULL) fclose(sync_out);
+        if (pipelined_out != NULL) fclose(pipelined_out);
+    }
+
+    /* Check fan-out branches each match a single output */
+    {
+        FILE *fanout_out;
+
+        sync_out = tmpfile();
+        pipelined_out = tmpfile();
+        fanout_out = tmpfile();
+
+        printf("Running test \"Fan-out Outputs Match Single Output\"\n");
+        if (sync_out != NULL && pipelined_out != NULL && fanout_out != NULL) {
+            ret_sync = test_run(0, 0, sync_out);
+            ret_pipelined = test_run_fanout(pipelined_out, fanout_out);
+            if (ret_sync == STREAM_EOF && ret_pipelined == STREAM_EOF && test_compare_files(sync_out, pipelined_out) == 0 && test_compare_files(sync_out, fanout_out) == 0) {
+                printf("\tSUCCESS outputs match\n\n");
+                passedTests++;
+            } else {
+                printf("\tFAILURE outputs differ (%d, %d)\n\n", ret_sync, ret_pipelined);
+            }
+        }
+        numTests++;
+
+        if (sync_out != NULL) fclose(sync_out);
+        if (pipelined_out != NULL) fclose(pipelined_out);
+        if (fanout_out != NULL) fclose(fanout_out);
+    }
+
+    /* Check the batch worker pool runs every job exactly once */
+    {
+        printf("Running test \"Batch Pool Runs Each Job Once\"\n");
+        if (test_batch_run(1) == 0 && test_batch_run(4) == 0 && test_batch_run(200) == 0) {
+            printf("\tSUCCESS all jobs run once\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE jobs skipped or repeated\n\n");
+        }
+        numTests++;
+    }
+
+    /* Check prefetched files read back whole, with each backend */
+    {
+        int ret_uring, ret_threads;
+
+        printf("Running test \"Prefetch Reads Match Files\"\n");
+        if ((ret_uring = test_prefetch_run(PREFETCH_BACKEND_IO_URING, 2)) == 0)
+            ret_uring = test_prefetch_run(PREFETCH_BACKEND_IO_URING, TEST_PREFETCH_FILES + 1);
+        if ((ret_threads = test_prefetch_run(PREFETCH_BACKEND_THREADS, 2)) == 0)
+            ret_threads = test_prefetch_run(PREFETCH_BACKEND_THREADS, TEST_PREFETCH_FILES + 1);
+        if (ret_uring >= 0 && ret_threads == 0) {
+            printf("\tSUCCESS prefetched files match%s\n\n", (ret_uring > 0) ? ", io_uring unavailable" : "");
+            passedTests++;
+        } else {
+            printf("\tFAILURE io_uring %d, threads %d\n\n", ret_uring, ret_threads);
+        }
+        numTests++;
+    }
+
+    /* Check gzip input decompresses whole, and fails on truncation */
+    {
+        printf("Running test \"Gzip Input Matches Uncompressed\"\n");
+        if (test_gzip_run(0) == 0 && test_gzip_run(1) == 0) {
+            printf("\tSUCCESS decompressed data matches\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE decompressed data differs\n\n");
+        }
+        numTests++;
+    }
+
+    /* Check the range stream passes only instructions within the range */
+    {
+        int count;
+
+        printf("Running test \"Address Range Filter\"\n");
+        if ((count = test_range_run()) == 8) {
+            printf("\tSUCCESS 8 instructions in range\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE %d instructions in range\n\n", count);
+        }
+        numTests++;
+    }
+
+    /* Check concatenated shards match a single run */
+    {
+        int ret_avr, ret_8051;
+
+        printf("Running test \"Shard Split Matches Single Run\"\n");
+        ret_avr = test_shard_split(UCDISASM_ARCH_AVR8);
+        ret_8051 = test_shard_split(UCDISASM_ARCH_8051);
+        if (ret_avr == 0 && ret_8051 == 0) {
+            printf("\tSUCCESS shard outputs match\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE outputs differ with %d avr, %d 8051 shards\n\n", ret_avr, ret_8051);
+        }
+        numTests++;
+    }
+
+    /* Check discovery decodes the reachable code and lists the rest as data */
+    {
+        int count;
+
+        printf("Running test \"Discovery Skips Unreachable Data\"\n");
+        if ((count = test_discover_run()) == 206) {
+            printf("\tSUCCESS 6 instructions, 2 data words\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE %d instructions, data words counted by 100\n\n", count);
+        }
+        numTests++;
+    }
+
+    /* Check only the instruction an operand refers to is labeled */
+    {
+        int labeled;
+
+        printf("Running test \"Labels Only Where Referenced\"\n");
+        if ((labeled = test_xref_run()) == 4) {
+            printf("\tSUCCESS only 0x4 labeled\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE labeled %d\n\n", labeled);
+        }
+        numTests++;
+    }
+
+    /* Check an incremental listing matches a full one */
+    {
+        int regions;
+
+        printf("Running test \"Incremental Listing Matches Full Listing\"\n");
+        if ((regions = test_incremental_run()) == 2) {
+            printf("\tSUCCESS 2 regions decoded again\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE %d regions decoded again\n\n", regions);
+        }
+        numTests++;
+    }
+
+    /* Check a diff lists only the changed instructions */
+    {
+        int hunks;
+
+        printf("Running test \"Diff Reports Only Changed Instructions\"\n");
+        if ((hunks = test_diff_run()) == 1) {
+            printf("\tSUCCESS 1 hunk listed\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE %d hunks listed\n\n", hunks);
+        }
+        numTests++;
+    }
+
+    /* Check a similarity index query finds the image sharing code */
+    {
+        int count;
+
+        printf("Running test \"Similarity Index Finds Shared Code\"\n");
+        if ((count = test_similarity_run()) == 1) {
+            printf("\tSUCCESS only the edited image matched\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE %d images matched\n\n", count);
+        }
+        numTests++;
+    }
+
+    /* Check a pattern search finds only the sequence with matching operands */
+    {
+        int matches;
+
+        printf("Running test \"Search Matches Operand Predicates\"\n");
+        if ((matches = test_search_run()) == 1) {
+            printf("\tSUCCESS 1 match written\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE %d matches written\n\n", matches);
+        }
+        numTests++;
+    }
+
+    /* Check live input writes out each instruction before waiting on more */
+    {
+        int count;
+
+        printf("Running test \"Live Input Flushes Before Waiting\"\n");
+        if ((count = test_live_run()) == 2) {
+            printf("\tSUCCESS output flushed while waiting on input\n\n");
+            passedTests++;
+        } else {
+            printf("\tFAILURE %d instructions written out\n\n", count);
+        }
+        numTests++;
+    }
+
+    printf("%d / %d tests passed.\n\n", passedTests, numTests);
+
+    if (passedTests == numTests)
+        return 0;
+
+    return -1;
+}
+
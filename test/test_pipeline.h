@@ -0,0 +1,8 @@
+#ifndef TEST_PIPELINE_H
+#define TEST_PIPELINE_H
+
+/* Test Pipelined and Fan-out Streams against synchronous streams */
+int test_pipeline_unit_tests(void);
+
+#endif
+
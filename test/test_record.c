@@ -0,0 +1,586 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <printstream.h>
+#include <instruction.h>
+#include <file/debug.h>
+#include <printstream_file.h>
+#include <printstream_record.h>
+#include <printstream_template.h>
+#include <printstream_binary.h>
+#include <printstream_stats.h>
+#include <printstream_cycles.h>
+#include <cfg.h>
+#include <callgraph.h>
+
+#include <avr/avr_support.h>
+#include <8051/8051_support.h>
+
+/******************************************************************************/
+/* Record Print Stream Test Instrumentation */
+/******************************************************************************/
+
+static int test_record(char *name, int (*disasm_init)(struct DisasmStream *), int (*disasm_close)(struct DisasmStream *), int (*disasm_read)(struct DisasmStream *, struct instruction *), int csv, char *template, uint8_t *test_data, uint32_t *test_address, unsigned int test_len, char *expected) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct PrintStream ps;
+    char output[4096];
+    FILE *out;
+    size_t len;
+    int ret;
+
+    printf("Running test \"%s\"\n", name);
+
+    /* Setup a Debug Byte Stream */
+    bs.in = NULL;
+    bs.stream_init = bytestream_debug_init;
+    bs.stream_close = bytestream_debug_close;
+    bs.stream_read = bytestream_debug_read;
+
+    /* Setup the Disasm Stream */
+    ds.in = &bs;
+    ds.stream_init = disasm_init;
+    ds.stream_close = disasm_close;
+    ds.stream_read = disasm_read;
+
+    /* Setup the Record Print Stream */
+    ps.in = &ds;
+    ps.stream_init = csv ? printstream_csv_init : printstream_json_init;
+    ps.stream_close = csv ? printstream_csv_close : printstream_json_close;
+    ps.stream_read = csv ? printstream_csv_read : printstream_json_read;
+
+    /* Or a Template Print Stream */
+    if (template != NULL && printstream_template_setup(&ps, template) < 0) {
+        printf("\tprintstream_template_setup(): %s\n", ps.error);
+        return -1;
+    }
+
+    if ((out = tmpfile()) == NULL)
+        return -1;
+
+    /* Initialize the stream */
+    ret = ps.stream_init(&ps, PRINT_FLAG_ADDRESSES | PRINT_FLAG_DATA_HEX);
+    if (ret < 0) {
+        printf("\tps.stream_init(): %d\n", ret);
+        printf("\t\tError: %s\n", ps.error);
+        fclose(out);
+        return -1;
+    }
+
+    /* Load the Byte Stream with the test vector */
+    ((struct bytestream_debug_state *)bs.state)->data = test_data;
+    ((struct bytestream_debug_state *)bs.state)->address = test_address;
+    ((struct bytestream_debug_state *)bs.state)->len = test_len;
+
+    /* Read records until EOF */
+    while ( (ret = ps.stream_read(&ps, out)) == 0 )
+        ;
+    ps.stream_close(&ps);
+
+    if (ret != STREAM_EOF) {
+        printf("\tps.stream_read(): %d\n", ret);
+        printf("\t\tError: %s\n", ps.error);
+        fclose(out);
+        return -1;
+    }
+
+    /* Compare the records with the expected records */
+    rewind(out);
+    len = fread(output, 1, sizeof(output) - 1, out);
+    output[len] = '\0';
+    fclose(out);
+
+    printf("%s", output);
+
+    if (strcmp(output, expected) != 0) {
+        printf("\tFAILURE records differ, expected:\n%s\n", expected);
+        return -1;
+    }
+
+    printf("\tSUCCESS records match\n\n");
+
+    return 0;
+}
+
+static int test_binary(char *name, int compact, uint8_t *test_data, uint32_t *test_address, unsigned int test_len, uint8_t *expected, unsigned int expected_len) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct PrintStream ps;
+    uint8_t output[4096];
+    unsigned int header_size;
+    FILE *out;
+    size_t len;
+    int ret;
+
+    printf("Running test \"%s\"\n", name);
+
+    /* Setup a Debug Byte Stream, AVR Disasm Stream and Binary or Compact Print Stream */
+    bs.in = NULL;
+    bs.stream_init = bytestream_debug_init;
+    bs.stream_close = bytestream_debug_close;
+    bs.stream_read = bytestream_debug_read;
+    ds.in = &bs;
+    ds.stream_init = disasmstream_avr_init;
+    ds.stream_close = disasmstream_avr_close;
+    ds.stream_read = disasmstream_avr_read;
+    ps.in = &ds;
+    if ((compact ? printstream_compact_setup(&ps, "avr", avr_isa_mnemonic) : printstream_binary_setup(&ps, "avr", avr_isa_mnemonic)) < 0)
+        return -1;
+
+    if ((out = tmpfile()) == NULL)
+        return -1;
+
+    if ((ret = ps.stream_init(&ps, PRINT_FLAG_DATA_HEX)) < 0) {
+        printf("\tps.stream_init(): %d\n", ret);
+        fclose(out);
+        return -1;
+    }
+
+    ((struct bytestream_debug_state *)bs.state)->data = test_data;
+    ((struct bytestream_debug_state *)bs.state)->address = test_address;
+    ((struct bytestream_debug_state *)bs.state)->len = test_len;
+
+    while ( (ret = ps.stream_read(&ps, out)) == 0 )
+        ;
+    ps.stream_close(&ps);
+
+    rewind(out);
+    len = fread(output, 1, sizeof(output), out);
+    fclose(out);
+
+    if (ret != STREAM_EOF || len < 48 || memcmp(output, "UCDISREC", 8) != 0) {
+        printf("\tFAILURE bad header (%d)\n\n", ret);
+        return -1;
+    }
+
+    /* Compare the records following the header */
+    header_size = output[12] | (output[13] << 8) | (output[14] << 16) | (output[15] << 24);
+    if ((output[10] | (output[11] << 8)) != (compact ? 0 : PRINTSTREAM_BINARY_RECORD_SIZE) || (!compact && header_size % PRINTSTREAM_BINARY_RECORD_SIZE != 0) ||
+            len != header_size + expected_len || memcmp(output + header_size, expected, expected_len) != 0) {
+        printf("\tFAILURE records differ\n\n");
+        return -1;
+    }
+
+    printf("\tSUCCESS records match\n\n");
+
+    return 0;
+}
+
+static int test_stats(char *name, uint8_t *test_data, uint32_t *test_address, unsigned int test_len, char **expected) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct PrintStream ps;
+    char output[4096];
+    FILE *out;
+    size_t len;
+    int i, ret;
+
+    printf("Running test \"%s\"\n", name);
+
+    /* Setup a Debug Byte Stream, AVR Disasm Stream and Statistics Print Stream */
+    bs.in = NULL;
+    bs.stream_init = bytestream_debug_init;
+    bs.stream_close = bytestream_debug_close;
+    bs.stream_read = bytestream_debug_read;
+    ds.in = &bs;
+    ds.stream_init = disasmstream_avr_init;
+    ds.stream_close = disasmstream_avr_close;
+    ds.stream_read = disasmstream_avr_read;
+    ps.in = &ds;
+    if (printstream_stats_setup(&ps, "avr", avr_isa_mnemonic) < 0)
+        return -1;
+
+    if ((out = tmpfile()) == NULL)
+        return -1;
+
+    if ((ret = ps.stream_init(&ps, PRINT_FLAG_DATA_HEX)) < 0) {
+        printf("\tps.stream_init(): %d\n", ret);
+        fclose(out);
+        return -1;
+    }
+
+    ((struct bytestream_debug_state *)bs.state)->data = test_data;
+    ((struct bytestream_debug_state *)bs.state)->address = test_address;
+    ((struct bytestream_debug_state *)bs.state)->len = test_len;
+
+    while ( (ret = ps.stream_read(&ps, out)) == 0 )
+        ;
+    ps.stream_close(&ps);
+
+    rewind(out);
+    len = fread(output, 1, sizeof(output) - 1, out);
+    output[len] = '\0';
+    fclose(out);
+
+    if (ret != STREAM_EOF) {
+        printf("\tFAILURE stream read: %d\n\n", ret);
+        return -1;
+    }
+
+    /* Look for each expected field in the summary */
+    for (i = 0; expected[i] != NULL; i++) {
+        if (strstr(output, expected[i]) == NULL) {
+            printf("\tFAILURE %s missing from\n%s\n", expected[i], output);
+            return -1;
+        }
+    }
+
+    printf("\tSUCCESS summary matches\n\n");
+
+    return 0;
+}
+
+/* Print streams of test_blocks() */
+enum {
+    TEST_BLOCKS_CYCLES,
+    TEST_BLOCKS_CFG_DOT,
+    TEST_BLOCKS_CFG_JSON,
+    TEST_BLOCKS_STACK,
+};
+
+static int test_blocks(char *name, int stream, int flags, uint8_t *test_data, uint32_t *test_address, unsigned int test_len, char *expected) {
+    struct ByteStream bs;
+    struct DisasmStream ds;
+    struct PrintStream ps;
+    char output[4096];
+    FILE *out;
+    size_t len;
+    int ret;
+
+    printf("Running test \"%s\"\n", name);
+
+    /* Setup a Debug Byte Stream, AVR Disasm Stream and Cycle Count, CFG, or Stack Print Stream */
+    bs.in = NULL;
+    bs.stream_init = bytestream_debug_init;
+    bs.stream_close = bytestream_debug_close;
+    bs.stream_read = bytestream_debug_read;
+    ds.in = &bs;
+    ds.stream_init = disasmstream_avr_init;
+    ds.stream_close = disasmstream_avr_close;
+    ds.stream_read = disasmstream_avr_read;
+    ps.in = &ds;
+    ps.stream_init = printstream_cycles_init;
+    ps.stream_close = printstream_cycles_close;
+    ps.stream_read = printstream_cycles_read;
+
+    if ((out = tmpfile()) == NULL)
+        return -1;
+
+    if ((stream == TEST_BLOCKS_CFG_DOT && printstream_cfg_setup(&ps, CFG_FORMAT_DOT, "avr") < 0) ||
+        (stream == TEST_BLOCKS_CFG_JSON && printstream_cfg_setup(&ps, CFG_FORMAT_JSON, "avr") < 0) ||
+        (stream == TEST_BLOCKS_STACK && printstream_stack_setup(&ps, "avr", avr_isa_mnemonic) < 0)) {
+        fclose(out);
+        return -1;
+    }
+
+    if ((ret = ps.stream_init(&ps, flags)) < 0) {
+        printf("\tps.stream_init(): %d\n", ret);
+        fclose(out);
+        return -1;
+    }
+
+    ((struct bytestream_debug_state *)bs.state)->data = test_data;
+    ((struct bytestream_debug_state *)bs.state)->address = test_address;
+    ((struct bytestream_debug_state *)bs.state)->len = test_len;
+
+    while ( (ret = ps.stream_read(&ps, out)) == 0 )
+        ;
+    ps.stream_close(&ps);
+
+    rewind(out);
+    len = fread(output, 1, sizeof(output) - 1, out);
+    output[len] = '\0';
+    fclose(out);
+
+    if (ret != STREAM_EOF) {
+        printf("\tFAILURE stream read: %d\n\n", ret);
+        return -1;
+    }
+
+    if (strcmp(output, expected) != 0) {
+        printf("\tFAILURE output mismatch, expected\n%s\ngot\n%s\n", expected, output);
+        return -1;
+    }
+
+    printf("\tSUCCESS listing and blocks match\n\n");
+
+    return 0;
+}
+
+/******************************************************************************/
+/* Record Print Stream Unit Tests */
+/******************************************************************************/
+
+int test_record_unit_tests(void) {
+    int numTests = 0, passedTests = 0;
+
+    printf("Running test_record_unit_tests()\n\n");
+
+    /* rjmp .-2; call 0x4; lds r16, 0x100; st Y+, r2; .org 0x100; ldi r16, 0xaf */
+    uint8_t avr_d[] = {0xff, 0xcf, 0x0e, 0x94, 0x02, 0x00, 0x00, 0x91, 0x00, 0x01, 0x29, 0x92, 0x0f, 0xea};
+    uint32_t avr_a[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0x100, 0x101};
+
+    /* acall 0x0123 at 0x0ffe (target in the next 2KB page); sjmp .-2; mov a, @r1 */
+    uint8_t a8051_d[] = {0x31, 0x23, 0x80, 0xfe, 0xe7};
+    uint32_t a8051_a[] = {0x0ffe, 0x0fff, 0x1000, 0x1001, 0x1002};
+
+    {
+        char *expected =
+            "{\"type\":\"directive\",\"mnemonic\":\".org\",\"operands\":[{\"kind\":\"prog_address\",\"value\":0,\"text\":\"0x0000\"}]}\n"
+            "{\"type\":\"instruction\",\"address\":0,\"width\":2,\"opcodes\":\"ffcf\",\"mnemonic\":\"rjmp\",\"operands\":[{\"kind\":\"relative_address\",\"value\":-2,\"text\":\".-2\"}],\"target\":0}\n"
+            "{\"type\":\"instruction\",\"address\":2,\"width\":4,\"opcodes\":\"0e940200\",\"mnemonic\":\"call\",\"operands\":[{\"kind\":\"prog_address\",\"value\":4,\"text\":\"0x0002\"}],\"target\":4}\n"
+            "{\"type\":\"instruction\",\"address\":6,\"width\":4,\"opcodes\":\"00910001\",\"mnemonic\":\"lds\",\"operands\":[{\"kind\":\"register\",\"value\":16,\"text\":\"R16\"},{\"kind\":\"data_address\",\"value\":256,\"text\":\"0x0100\"}],\"target\":null}\n"
+            "{\"type\":\"instruction\",\"address\":10,\"width\":2,\"opcodes\":\"2992\",\"mnemonic\":\"st\",\"operands\":[{\"kind\":\"indirect\",\"value\":0,\"text\":\"Y+\"},{\"kind\":\"register\",\"value\":2,\"text\":\"R2\"}],\"target\":null}\n"
+            "{\"type\":\"directive\",\"mnemonic\":\".org\",\"operands\":[{\"kind\":\"prog_address\",\"value\":256,\"text\":\"0x0100\"}]}\n"
+            "{\"type\":\"instruction\",\"address\":256,\"width\":2,\"opcodes\":\"0fea\",\"mnemonic\":\"ldi\",\"operands\":[{\"kind\":\"register\",\"value\":16,\"text\":\"R16\"},{\"kind\":\"data\",\"value\":175,\"text\":\"0xaf\"}],\"target\":null}\n";
+
+        if (test_record("AVR8 JSON Lines", disasmstream_avr_init, disasmstream_avr_close, disasmstream_avr_read, 0, NULL, avr_d, avr_a, sizeof(avr_d), expected) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        char *expected =
+            "type,address,width,opcodes,mnemonic,operands,op1_kind,op1_value,op2_kind,op2_value,op3_kind,op3_value,target\n"
+            "directive,,,,\".org\",\"0x0000\",prog_address,0,,,,,\n"
+            "instruction,0,2,ffcf,\"rjmp\",\".-2\",relative_address,-2,,,,,0\n"
+            "instruction,2,4,0e940200,\"call\",\"0x0002\",prog_address,4,,,,,4\n"
+            "instruction,6,4,00910001,\"lds\",\"R16, 0x0100\",register,16,data_address,256,,,\n"
+            "instruction,10,2,2992,\"st\",\"Y+, R2\",indirect,0,register,2,,,\n"
+            "directive,,,,\".org\",\"0x0100\",prog_address,256,,,,,\n"
+            "instruction,256,2,0fea,\"ldi\",\"R16, 0xaf\",register,16,data,175,,,\n";
+
+        if (test_record("AVR8 CSV", disasmstream_avr_init, disasmstream_avr_close, disasmstream_avr_read, 1, NULL, avr_d, avr_a, sizeof(avr_d), expected) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        char *expected =
+            "{\"type\":\"directive\",\"mnemonic\":\".org\",\"operands\":[{\"kind\":\"prog_address\",\"value\":4094,\"text\":\"00ffeh\"}]}\n"
+            "{\"type\":\"instruction\",\"address\":4094,\"width\":2,\"opcodes\":\"3123\",\"mnemonic\":\"acall\",\"operands\":[{\"kind\":\"prog_address\",\"value\":4387,\"text\":\"00123h\"}],\"target\":4387}\n"
+            "{\"type\":\"instruction\",\"address\":4096,\"width\":2,\"opcodes\":\"80fe\",\"mnemonic\":\"sjmp\",\"operands\":[{\"kind\":\"relative_address\",\"value\":-2,\"text\":\".-2\"}],\"target\":4096}\n"
+            "{\"type\":\"instruction\",\"address\":4098,\"width\":1,\"opcodes\":\"e7\",\"mnemonic\":\"mov\",\"operands\":[{\"kind\":\"implicit\",\"value\":0,\"text\":\"A\"},{\"kind\":\"indirect\",\"value\":1,\"text\":\"@R1\"}],\"target\":null}\n"
+            "{\"type\":\"directive\",\"mnemonic\":\"end\",\"operands\":[]}\n";
+
+        if (test_record("8051 JSON Lines", disasmstream_8051_init, disasmstream_8051_close, disasmstream_8051_read, 0, NULL, a8051_d, a8051_a, sizeof(a8051_d), expected) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        char *expected =
+            "0000 ff cf       rjmp   .-2 ; 0x0 -> 0000\n"
+            "0002 0e 94 02 00 call   0x0002 ;  -> 0004\n"
+            "0006 00 91 00 01 lds    R16, 0x0100 ;  ->     \n"
+            "000A 29 92       st     Y+, R2 ;  ->     \n"
+            "0100 0f ea       ldi    R16, 0xaf ;  ->     \n";
+
+        if (test_record("AVR8 Template", disasmstream_avr_init, disasmstream_avr_close, disasmstream_avr_read, 0, "{addr:04X} {bytes:-11} {mnem:-6} {ops} ; {comment} -> {target:04x}", avr_d, avr_a, sizeof(avr_d), expected) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        /* .org 0x0000; rjmp .-2; call 0x0004 */
+        uint8_t expected[] = {
+            0x00, 0x00, 0x00, 0x00,  0x00, 0x00,  0x01,  0x00,  0x00, 0x00, 0x00, 0x00,  0x01,  OPERAND_KIND_PROG_ADDRESS, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00,  0x00, 0x00, 0x00, 0x00,  0x00, 0x00, 0x00, 0x00,  0xff, 0xff, 0xff, 0xff,
+
+            0x00, 0x00, 0x00, 0x00,  0x00, 0x00,  0x00,  0x02,  0xff, 0xcf, 0x00, 0x00,  0x01,  OPERAND_KIND_RELATIVE_ADDRESS, 0x00, 0x00,
+            0xfe, 0xff, 0xff, 0xff,  0x00, 0x00, 0x00, 0x00,  0x00, 0x00, 0x00, 0x00,  0x00, 0x00, 0x00, 0x00,
+
+            0x02, 0x00, 0x00, 0x00,  0x00, 0x00,  0x00,  0x04,  0x0e, 0x94, 0x02, 0x00,  0x01,  OPERAND_KIND_PROG_ADDRESS, 0x00, 0x00,
+            0x04, 0x00, 0x00, 0x00,  0x00, 0x00, 0x00, 0x00,  0x00, 0x00, 0x00, 0x00,  0x04, 0x00, 0x00, 0x00,
+        };
+        unsigned int i;
+
+        /* Fill in the instruction set table entries */
+        for (i = 0; avr_isa_mnemonic(i) != NULL; i++) {
+            if (strcmp(avr_isa_mnemonic(i), "rjmp") == 0) expected[32+4] = i;
+            if (strcmp(avr_isa_mnemonic(i), "call") == 0) expected[64+4] = i;
+        }
+
+        if (test_binary("AVR8 Binary Records", 0, avr_d, avr_a, 6, expected, sizeof(expected)) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        /* .org 0x0000; rjmp .-2; call 0x0004; .org 0x0014; rjmp .-2 */
+        uint8_t avr_gap_d[] = {0xff, 0xcf, 0x0e, 0x94, 0x02, 0x00, 0xff, 0xcf};
+        uint32_t avr_gap_a[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x14, 0x15};
+        uint8_t expected[] = {
+            BINARY_FLAG_DIRECTIVE | BINARY_FLAG_ADDRESS, 0x00, 0x00,
+            BINARY_FLAG_TARGET | 2, 0x00, 0xff, 0xcf, 0x00,
+            BINARY_FLAG_TARGET | 4, 0x00, 0x0e, 0x94, 0x02, 0x00, 0x04,
+            BINARY_FLAG_DIRECTIVE | BINARY_FLAG_ADDRESS, 0x00, 0x14,
+            BINARY_FLAG_TARGET | 2, 0x00, 0xff, 0xcf, 0x00,
+        };
+        unsigned int i;
+
+        /* Fill in the instruction set table entries, each a one byte varint */
+        for (i = 0; avr_isa_mnemonic(i) != NULL && i < 0x80; i++) {
+            if (strcmp(avr_isa_mnemonic(i), "rjmp") == 0) expected[4] = expected[19] = i;
+            if (strcmp(avr_isa_mnemonic(i), "call") == 0) expected[9] = i;
+        }
+
+        if (test_binary("AVR8 Compact Records", 1, avr_gap_d, avr_gap_a, sizeof(avr_gap_d), expected, sizeof(expected)) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        char *expected[] = {
+            "{\"architecture\":\"avr\",\"instructions\":5,\"directives\":2,\"bytes\":14,",
+            "\"widths\":{\"2\":3,\"4\":2},",
+            "\"mnemonic\":\"lds\",\"count\":1}",
+            "\"flow\":{\"branch\":0,\"skip\":0,\"jump\":1,\"call\":1,\"indirect_jump\":0,\"indirect_call\":0,\"return\":0},",
+            "\"io_registers\":{\"accesses\":0,\"addresses\":{}},",
+            "\"data_addresses\":{\"accesses\":1,\"addresses\":{\"256\":1}},",
+            "\"raw\":0,\"raw_fraction\":0.000000}\n",
+            NULL
+        };
+
+        if (test_stats("AVR8 Statistics", avr_d, avr_a, sizeof(avr_d), expected) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        /* sbrc R16, 0; call 0x0; dec R16; brne .-4; ret */
+        uint8_t cycles_d[] = {0x00, 0xfd, 0x0e, 0x94, 0x00, 0x00, 0x0a, 0x95, 0xf1, 0xf7, 0x08, 0x95};
+        uint32_t cycles_a[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b};
+        char *expected_avre =
+            "   0:\t1/2\tsbrc\tR16, 0\n"
+            "   2:\t4\tcall\t0x0000\n"
+            "   6:\t1\tdec\tR16\n"
+            "   8:\t1/2\tbrne\t.-4\t; 0x6\n"
+            "   a:\t4\tret\t\n"
+            "; block 0x0000-0x0002: 1 instruction, 1-3 cycles\n"
+            "; block 0x0002-0x0006: 1 instruction, 4 cycles\n"
+            "; block 0x0006-0x000a: 2 instructions, 2-3 cycles\n"
+            "; block 0x000a-0x000c: 1 instruction, 4 cycles\n";
+        char *expected_avrrc =
+            "   0:\t1/2\tsbrc\tR16, 0\n"
+            "   2:\t-\tcall\t0x0000\n"
+            "   6:\t1\tdec\tR16\n"
+            "   8:\t1/2\tbrne\t.-4\t; 0x6\n"
+            "   a:\t6\tret\t\n"
+            "; block 0x0000-0x0002: 1 instruction, 1-3 cycles\n"
+            "; block 0x0002-0x0006: 1 instruction, unknown cycles\n"
+            "; block 0x0006-0x000a: 2 instructions, 2-3 cycles\n"
+            "; block 0x000a-0x000c: 1 instruction, 6 cycles\n";
+
+        if (test_blocks("AVR8 Cycle Counts", TEST_BLOCKS_CYCLES, PRINT_FLAG_ADDRESSES | PRINT_FLAG_DESTINATION_COMMENT | PRINT_FLAG_DATA_HEX, cycles_d, cycles_a, sizeof(cycles_d), expected_avre) == 0)
+            passedTests++;
+        numTests++;
+        if (test_blocks("AVR8 Reduced Core Cycle Counts", TEST_BLOCKS_CYCLES, PRINT_FLAG_ADDRESSES | PRINT_FLAG_DESTINATION_COMMENT | PRINT_FLAG_DATA_HEX | PRINT_FLAG_CYCLES_VARIANT(CYCLES_VARIANT_AVRRC), cycles_d, cycles_a, sizeof(cycles_d), expected_avrrc) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        /* sbrs R16, 0; jmp 0x0; rjmp .-2 */
+        uint8_t cfg_d[] = {0x00, 0xff, 0x0c, 0x94, 0x00, 0x00, 0xff, 0xcf};
+        uint32_t cfg_a[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+        char *expected_json =
+            "{\"architecture\":\"avr\",\"blocks\":["
+            "{\"start\":0,\"end\":2,\"instructions\":1,\"cycles\":{\"min\":1,\"max\":3},\"edges\":[{\"kind\":\"skip\",\"to\":6,\"block\":2},{\"kind\":\"next\",\"to\":2,\"block\":1}]},"
+            "{\"start\":2,\"end\":6,\"instructions\":1,\"cycles\":{\"min\":3,\"max\":3},\"edges\":[{\"kind\":\"jump\",\"to\":0,\"block\":0}]},"
+            "{\"start\":6,\"end\":8,\"instructions\":1,\"cycles\":{\"min\":2,\"max\":2},\"edges\":[{\"kind\":\"jump\",\"to\":6,\"block\":2}]}]}\n";
+        char *expected_dot =
+            "digraph cfg {\n"
+            "    node [shape=box, fontname=\"monospace\"];\n"
+            "    b0 [label=\"0x0000-0x0002\\n1 instruction\\n1-3 cycles\"];\n"
+            "    b1 [label=\"0x0002-0x0006\\n1 instruction\\n3 cycles\"];\n"
+            "    b2 [label=\"0x0006-0x0008\\n1 instruction\\n2 cycles\"];\n"
+            "    b0 -> b2 [label=\"skip\"];\n"
+            "    b0 -> b1 [label=\"next\"];\n"
+            "    b1 -> b0 [label=\"jump\"];\n"
+            "    b2 -> b2 [label=\"jump\"];\n"
+            "}\n";
+
+        if (test_blocks("AVR8 Control Flow Graph JSON", TEST_BLOCKS_CFG_JSON, 0, cfg_d, cfg_a, sizeof(cfg_d), expected_json) == 0)
+            passedTests++;
+        numTests++;
+        if (test_blocks("AVR8 Control Flow Graph DOT", TEST_BLOCKS_CFG_DOT, 0, cfg_d, cfg_a, sizeof(cfg_d), expected_dot) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    {
+        /* Vectors rjmp main, rjmp isr, reti; main: rcall f, rjmp main;
+         * f: push R16, rcall g, pop R16, ret; g: push R28, push R29, pop R29,
+         * pop R28, ret; isr: push R0, rcall g, pop R0, reti */
+        uint8_t stack_d[] = {0x02, 0xc0, 0x0c, 0xc0, 0x18, 0x95, 0x01, 0xd0, 0xfe, 0xcf, 0x0f, 0x93, 0x02, 0xd0, 0x0f, 0x91, 0x08, 0x95, 0xcf, 0x93, 0xdf, 0x93, 0xdf, 0x91, 0xcf, 0x91, 0x08, 0x95, 0x0f, 0x92, 0xf9, 0xdf, 0x0f, 0x90, 0x18, 0x95};
+        uint32_t stack_a[sizeof(stack_d)];
+        /* rcall .+0, falling through into f: push R16, rcall f, pop R16,
+         * ret */
+        uint8_t recursive_d[] = {0x00, 0xd0, 0x0f, 0x93, 0xfe, 0xdf, 0x0f, 0x91, 0x08, 0x95};
+        uint32_t recursive_a[sizeof(recursive_d)];
+        char *expected_stack =
+            "function  vector  frame   depth  calls  notes\n"
+            "0x0000         0      0       7      1\n"
+            "0x0002         1      1       5      1\n"
+            "0x0004         2      0       0      0\n"
+            "0x000a         -      1       5      1\n"
+            "0x0012         -      2       2      0\n"
+            "vector 0 at 0x0000: 7 bytes\n"
+            "vector 1 at 0x0002: 7 bytes\n"
+            "vector 2 at 0x0004: 2 bytes\n"
+            "worst case: 14 bytes, vector 0 and vector 1\n";
+        char *expected_recursive =
+            "function  vector  frame   depth  calls  notes\n"
+            "0x0000         0      2      3+      1\n"
+            "0x0002         -      1      1+      1  recursive\n"
+            "vector 0 at 0x0000: 3+ bytes\n"
+            "worst case: 3+ bytes, vector 0\n";
+        unsigned int i;
+
+        for (i = 0; i < sizeof(stack_d); i++)
+            stack_a[i] = i;
+        for (i = 0; i < sizeof(recursive_d); i++)
+            recursive_a[i] = i;
+
+        if (test_blocks("AVR8 Stack Depth", TEST_BLOCKS_STACK, 0, stack_d, stack_a, sizeof(stack_d), expected_stack) == 0)
+            passedTests++;
+        numTests++;
+        if (test_blocks("AVR8 Recursive Stack Depth", TEST_BLOCKS_STACK, 0, recursive_d, recursive_a, sizeof(recursive_d), expected_recursive) == 0)
+            passedTests++;
+        numTests++;
+    }
+
+    /* Check template compile errors */
+    {
+        struct PrintStream ps;
+        char *bad[] = {"{addr", "addr}", "{bogus}", "{mnem:08s}", "{addr:s}", "{addr:4q}"};
+        int i, failed = 0;
+
+        printf("Running test \"Template Compile Errors\"\n");
+        for (i = 0; i < sizeof(bad)/sizeof(bad[0]); i++) {
+            if (printstream_template_setup(&ps, bad[i]) == 0) {
+                printf("\tFAILURE template \"%s\" compiled\n", bad[i]);
+                failed = 1;
+            } else {
+                printf("\t\"%s\": %s\n", bad[i], ps.error);
+            }
+        }
+        if (!failed) {
+            printf("\tSUCCESS all templates rejected\n\n");
+            passedTests++;
+        }
+        numTests++;
+    }
+
+    printf("%d / %d tests passed.\n\n", passedTests, numTests);
+
+    if (passedTests == numTests)
+        return 0;
+
+    return -1;
+}
+
@@ -0,0 +1,8 @@
+#ifndef TEST_RECORD_H
+#define TEST_RECORD_H
+
+/* Test JSON Lines, CSV and Template Print Streams */
+int test_record_unit_tests(void);
+
+#endif
+
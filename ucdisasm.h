@@ -0,0 +1,92 @@
+#ifndef UCDISASM_H
+#define UCDISASM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <printstream_file.h>
+
+/* ucdisasm Library
+ *
+ * Disassembles a program image held in memory, without files, so
+ * independent calls may run concurrently on different threads. Link with
+ * libucdisasm.a or libucdisasm.so.
+ *
+ * The one global state, on purpose, is the memory budget (budget.h), shared
+ * by the whole process so that one --max-memory limit bounds every stage.
+ * The library charges the xref index of its assembly labels to it. Its
+ * counters are atomic, so concurrent calls charge it without locking. It is
+ * unlimited unless the program sets a limit, which then applies to all calls
+ * together.
+ *
+ * All stream implementations keep their state in the stream's state pointer,
+ * errors are reported with string literals, and the instruction set tables
+ * are const, so separate stream objects may be used on separate threads
+ * without locking. A single stream object is not safe to share.
+ */
+
+/* Supported architectures */
+enum {
+    UCDISASM_ARCH_AVR8,
+    UCDISASM_ARCH_PIC_BASELINE,
+    UCDISASM_ARCH_PIC_MIDRANGE,
+    UCDISASM_ARCH_PIC_MIDRANGE_ENHANCED,
+    UCDISASM_ARCH_PIC_PIC18,
+    UCDISASM_ARCH_8051,
+};
+
+/* Look up an architecture by its command line name (avr, pic-baseline,
+ * pic-midrange, pic-enhanced, pic-18, 8051), returns -1 if unknown */
+int ucdisasm_arch_lookup(const char *name);
+
+/* Look up a core variant with its own instruction timing, for
+ * get_cycles(), by its command line name (avre, avrxm, avrxt, avrrc for
+ * avr, or default). Returns -1 if unknown for the architecture. */
+int ucdisasm_cycles_variant_lookup(int arch, const char *name);
+
+/* Setup a Disasm Stream for an architecture, returns its instruction set
+ * mnemonic lookup, or NULL for an unknown architecture */
+isa_mnemonic_func ucdisasm_disasmstream_setup(struct DisasmStream *ds, int arch);
+
+/* Look up the instruction alignment and the longest instruction width of an
+ * architecture, in bytes. Returns 0, or -1 for an unknown architecture. */
+int ucdisasm_arch_widths(int arch, unsigned int *align, unsigned int *max_width);
+
+/* Width in bytes of the instruction that starts with the opcode bytes at
+ * opcode, which must hold at least the alignment's worth of bytes */
+unsigned int ucdisasm_instruction_width(int arch, const uint8_t *opcode);
+
+/* Make a raw data "instruction" (.dw or .db) of the first bytes of the len
+ * bytes at data, loaded at address, as the Disasm Stream does for bytes that
+ * do not form an instruction, for streams that decode bytes out of input
+ * order. Returns the number of bytes used, or a negative STREAM_ERROR_*
+ * code. instr is freed with instr->free(). */
+int ucdisasm_raw_instruction(int arch, const uint8_t *data, unsigned int len, uint32_t address, struct instruction *instr);
+
+/* Make an origin directive for address. Returns 0, or a negative
+ * STREAM_ERROR_* code. */
+int ucdisasm_origin_directive(int arch, uint32_t address, struct instruction *instr);
+
+/* Called for each disassembled instruction or directive, which is only valid
+ * for the duration of the call. A nonzero return stops the disassembly. */
+typedef int (*ucdisasm_callback)(struct instruction *instr, void *arg);
+
+/* Disassemble len bytes of data loaded at address into callback. Returns 0,
+ * or a negative STREAM_ERROR_* code. */
+int ucdisasm_disassemble(int arch, const uint8_t *data, uint32_t len, uint32_t address, ucdisasm_callback callback, void *arg);
+
+/* As ucdisasm_disassemble(), for a listing formatted with PRINT_FLAG_* flags:
+ * with PRINT_FLAG_ASSEMBLY and without PRINT_FLAG_ALL_LABELS, a first pass
+ * collects the addresses that operands refer to, and the address labels of
+ * the other instructions are removed, as by ucdisasm --assembly. */
+int ucdisasm_disassemble_listing(int arch, const uint8_t *data, uint32_t len, uint32_t address, int flags, ucdisasm_callback callback, void *arg);
+
+/* Disassemble into a text listing in dest, formatted as by ucdisasm with
+ * PRINT_FLAG_* flags. Like snprintf(), returns the length of the complete
+ * listing, which is truncated if it is size or longer, or a negative
+ * STREAM_ERROR_* code. dest may be NULL if size is 0. */
+long ucdisasm_disassemble_text(int arch, const uint8_t *data, uint32_t len, uint32_t address, int flags, char *dest, size_t size);
+
+#endif
+
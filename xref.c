@@ -0,0 +1,353 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+#include <budget.h>
+#include <ucdisasm.h>
+#include <discover.h>
+#include <xref.h>
+
+/******************************************************************************/
+/* Cross-Reference Index */
+/******************************************************************************/
+
+void xref_index_init(struct xref_index *index) {
+    index->slots = NULL;
+    index->capacity = 0;
+    index->count = 0;
+    index->has_empty = 0;
+}
+
+void xref_index_free(struct xref_index *index) {
+    if (index->slots != NULL)
+        budget_release(index->capacity * sizeof(uint32_t));
+    free(index->slots);
+    xref_index_init(index);
+}
+
+/* Hash of an address into a table of capacity slots, mixing the high bits
+ * into the low bits, which are often all even for word aligned targets */
+static size_t util_hash(uint32_t address, size_t capacity) {
+    address ^= address >> 16;
+    address *= 0x45d9f3b;
+    address ^= address >> 16;
+    return address & (capacity - 1);
+}
+
+/* Slot of address, or the empty slot it would go in */
+static size_t util_slot(const uint32_t *slots, size_t capacity, uint32_t address) {
+    size_t i;
+
+    for (i = util_hash(address, capacity); slots[i] != XREF_EMPTY && slots[i] != address; i = (i + 1) & (capacity - 1))
+        ;
+
+    return i;
+}
+
+/* Rehash into twice the slots */
+static int util_grow(struct xref_index *index) {
+    size_t capacity, i;
+    uint32_t *slots;
+
+    capacity = (index->capacity == 0) ? XREF_INITIAL_CAPACITY : index->capacity*2;
+    if (budget_charge(capacity * sizeof(uint32_t)) < 0)
+        return -1;
+    if ((slots = malloc(capacity * sizeof(uint32_t))) == NULL) {
+        budget_release(capacity * sizeof(uint32_t));
+        return -1;
+    }
+    memset(slots, 0xff, capacity * sizeof(uint32_t));
+
+    for (i = 0; i < index->capacity; i++) {
+        if (index->slots[i] != XREF_EMPTY)
+            slots[util_slot(slots, capacity, index->slots[i])] = index->slots[i];
+    }
+
+    if (index->slots != NULL)
+        budget_release(index->capacity * sizeof(uint32_t));
+    free(index->slots);
+    index->slots = slots;
+    index->capacity = capacity;
+
+    return 0;
+}
+
+int xref_index_add(struct xref_index *index, uint32_t address) {
+    size_t i;
+
+    if (address == XREF_EMPTY) {
+        index->has_empty = 1;
+        return 0;
+    }
+
+    /* Keep the table at most half full */
+    if (2*(index->count + 1) > index->capacity && util_grow(index) < 0)
+        return -1;
+
+    i = util_slot(index->slots, index->capacity, address);
+    if (index->slots[i] == XREF_EMPTY) {
+        index->slots[i] = address;
+        index->count++;
+    }
+
+    return 0;
+}
+
+int xref_index_contains(const struct xref_index *index, uint32_t address) {
+    if (address == XREF_EMPTY)
+        return index->has_empty;
+    if (index->capacity == 0)
+        return 0;
+
+    return index->slots[util_slot(index->slots, index->capacity, address)] == address;
+}
+
+int xref_index_add_targets(struct xref_index *index, struct instruction *instr) {
+    unsigned int i, num_operands;
+    uint32_t target;
+
+    if (instr->type != DISASM_TYPE_INSTRUCTION)
+        return 0;
+
+    num_operands = instr->get_num_operands(instr);
+    for (i = 0; i < num_operands; i++) {
+        if (instr->get_label_target(instr, i, &target) && xref_index_add(index, target) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int xref_index_scan(struct xref_index *index, struct DisasmStream *source) {
+    struct instruction instr;
+    int ret;
+
+    if ((ret = source->stream_init(source)) < 0)
+        return ret;
+
+    while ((ret = source->stream_read(source, &instr)) == 0) {
+        if (xref_index_add_targets(index, &instr) < 0) {
+            source->error = "Error allocating cross-reference index!";
+            ret = STREAM_ERROR_ALLOC;
+        }
+        instr.free(&instr);
+        if (ret < 0)
+            break;
+    }
+
+    if (source->stream_close(source) < 0 && ret == STREAM_EOF)
+        ret = STREAM_ERROR_INPUT;
+
+    return (ret == STREAM_EOF) ? 0 : ret;
+}
+
+/* Address label of an instruction nothing refers to */
+static int util_no_label(struct instruction *instr, char *dest, int size, int flags) {
+    if (size > 0)
+        dest[0] = '\0';
+    return 0;
+}
+
+/* Window onto the input of the first pass, which leaves the input open */
+struct xref_view {
+    FILE *in;
+    off_t start;
+};
+
+static ssize_t util_view_read(void *cookie, char *buf, size_t size) {
+    struct xref_view *view = (struct xref_view *)cookie;
+    size_t len;
+
+    len = fread(buf, 1, size, view->in);
+    return (len == 0 && ferror(view->in)) ? -1 : (ssize_t)len;
+}
+
+static int util_view_seek(void *cookie, off64_t *offset, int whence) {
+    struct xref_view *view = (struct xref_view *)cookie;
+    off_t position;
+
+    if (fseeko(view->in, (whence == SEEK_SET) ? view->start + *offset : *offset, whence) < 0 || (position = ftello(view->in)) < 0)
+        return -1;
+    *offset = position - view->start;
+
+    return 0;
+}
+
+static int util_view_close(void *cookie) {
+    free(cookie);
+    return 0;
+}
+
+/* Make in readable twice from its current position, copying an input that
+ * cannot seek to a temporary file. Returns in or the copy, with in closed,
+ * or NULL on failure. */
+static FILE *util_rereadable(FILE *in, off_t *start) {
+    char buf[4096];
+    size_t len;
+    FILE *fp;
+
+    if ((*start = ftello(in)) >= 0 && fseeko(in, *start, SEEK_SET) == 0)
+        return in;
+
+    if ((fp = tmpfile()) == NULL)
+        return NULL;
+    while ((len = fread(buf, 1, sizeof(buf), in)) > 0) {
+        if (fwrite(buf, 1, len, fp) != len) {
+            fclose(fp);
+            return NULL;
+        }
+    }
+    if (ferror(in)) {
+        fclose(fp);
+        return NULL;
+    }
+    fclose(in);
+    rewind(fp);
+    *start = 0;
+
+    return fp;
+}
+
+int xref_index_scan_input(struct xref_index *index, struct ByteStream *bs, int arch, const struct discover_spec *discover, const char **error) {
+    cookie_io_functions_t functions = {util_view_read, NULL, util_view_seek, util_view_close};
+    struct ByteStream bs_scan;
+    struct DisasmStream ds, ds_discover, *source = &ds;
+    struct xref_view *view;
+    FILE *in;
+    off_t start;
+    int ret;
+
+    if ((in = util_rereadable(bs->in, &start)) == NULL) {
+        *error = "Error copying program file for a second pass!";
+        return STREAM_ERROR_INPUT;
+    }
+    bs->in = in;
+
+    if ((view = malloc(sizeof(struct xref_view))) == NULL) {
+        *error = "Error allocating cross-reference pass!";
+        return STREAM_ERROR_ALLOC;
+    }
+    view->in = in;
+    view->start = start;
+
+    /* The first pass reads through the view, with the same ByteStream */
+    bs_scan = *bs;
+    bs_scan.error = NULL;
+    if ((bs_scan.in = fopencookie(view, "r", functions)) == NULL) {
+        free(view);
+        *error = "Error allocating cross-reference pass!";
+        return STREAM_ERROR_ALLOC;
+    }
+    ds.in = &bs_scan;
+    ds.error = NULL;
+    ucdisasm_disasmstream_setup(&ds, arch);
+
+    if (discover != NULL) {
+        if ((ret = discover_disasmstream_setup(&ds_discover, &ds, discover)) < 0) {
+            fclose(bs_scan.in);
+            *error = ds_discover.error;
+            return ret;
+        }
+        source = &ds_discover;
+    }
+
+    if ((ret = xref_index_scan(index, source)) < 0) {
+        *error = (bs_scan.error != NULL) ? bs_scan.error : (ds.error != NULL) ? ds.error : (source->error != NULL) ? source->error : "Unknown error";
+        return ret;
+    }
+
+    /* Rewind the input for the second pass */
+    if (fseeko(in, start, SEEK_SET) < 0) {
+        *error = "Error rewinding program file!";
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+void xref_filter_label(const struct xref_index *index, struct instruction *instr) {
+    if (instr->type == DISASM_TYPE_INSTRUCTION && !xref_index_contains(index, instr->get_address(instr)))
+        instr->get_str_address_label = util_no_label;
+}
+
+/******************************************************************************/
+/* Xref Disasm Stream Support */
+/******************************************************************************/
+
+struct xref_state {
+    struct DisasmStream *source;
+    struct xref_index *index;
+};
+
+int xref_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, struct xref_index *index) {
+    struct xref_state *state;
+
+    /* Allocate stream state */
+    state = malloc(sizeof(struct xref_state));
+    if (state == NULL) {
+        self->error = "Error allocating xref stream state!";
+        return STREAM_ERROR_ALLOC;
+    }
+    state->source = source;
+    state->index = index;
+
+    self->in = source->in;
+    self->state = state;
+    self->error = NULL;
+    self->stream_init = xref_disasmstream_init;
+    self->stream_close = xref_disasmstream_close;
+    self->stream_read = xref_disasmstream_read;
+
+    return 0;
+}
+
+int xref_disasmstream_init(struct DisasmStream *self) {
+    struct xref_state *state = (struct xref_state *)self->state;
+
+    /* Reset the error to NULL */
+    self->error = NULL;
+
+    /* Initialize the source stream */
+    if (state->source->stream_init(state->source) < 0) {
+        self->error = state->source->error;
+        return STREAM_ERROR_INPUT;
+    }
+
+    return 0;
+}
+
+int xref_disasmstream_close(struct DisasmStream *self) {
+    struct xref_state *state = (struct xref_state *)self->state;
+    int ret = 0;
+
+    /* Close the source stream */
+    if (state->source->stream_close(state->source) < 0) {
+        self->error = state->source->error;
+        ret = STREAM_ERROR_INPUT;
+    }
+
+    /* Free the stream state memory */
+    free(state);
+
+    return ret;
+}
+
+int xref_disasmstream_read(struct DisasmStream *self, struct instruction *instr) {
+    struct xref_state *state = (struct xref_state *)self->state;
+    int ret;
+
+    if ((ret = state->source->stream_read(state->source, instr)) < 0) {
+        if (ret != STREAM_EOF)
+            self->error = state->source->error;
+        return ret;
+    }
+
+    xref_filter_label(state->index, instr);
+
+    return 0;
+}
+
@@ -0,0 +1,83 @@
+#ifndef XREF_H
+#define XREF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <bytestream.h>
+#include <disasmstream.h>
+#include <instruction.h>
+
+struct discover_spec;
+
+/* Cross-Reference Support
+ *
+ * In assembly output, an instruction needs an address label only if an
+ * operand refers to its address. A first pass over the program collects
+ * every address that an operand is printed as a label of (get_label_target())
+ * into an xref index, an open addressing hash set of addresses charged to the
+ * memory budget. On the second pass, the xref stream passes the instructions
+ * of a source DisasmStream through, and removes the address label of each
+ * instruction whose address is not in the index.
+ *
+ * The first pass reads the same input as the second: an input that cannot
+ * seek, e.g. standard input or a gzip file, is first copied to a temporary
+ * file. The library and the Python module make both passes over the data in
+ * memory, so every front end labels the same instructions.
+ */
+
+struct xref_index {
+    /* Addresses, XREF_EMPTY for an empty slot */
+    uint32_t *slots;
+    /* Number of slots, a power of two, and of addresses in them */
+    size_t capacity, count;
+    /* XREF_EMPTY itself is in the index */
+    int has_empty;
+};
+
+/* Empty hash set slot */
+#define XREF_EMPTY              UINT32_MAX
+/* Initial number of slots */
+#define XREF_INITIAL_CAPACITY   1024
+
+/* Initialize an empty index */
+void xref_index_init(struct xref_index *index);
+/* Free the index's slots */
+void xref_index_free(struct xref_index *index);
+
+/* Add an address, returns 0, or -1 on allocation failure */
+int xref_index_add(struct xref_index *index, uint32_t address);
+/* Returns 1 if the address is in the index */
+int xref_index_contains(const struct xref_index *index, uint32_t address);
+
+/* Add the label targets of an instruction's operands, returns 0, or -1 on
+ * allocation failure */
+int xref_index_add_targets(struct xref_index *index, struct instruction *instr);
+
+/* Add the label targets of all instructions read from source, which is
+ * initialized and closed. Returns 0, or a STREAM_ERROR_* code with the error
+ * in source->error. */
+int xref_index_scan(struct xref_index *index, struct DisasmStream *source);
+
+/* Add the label targets of the program read by bs, a ByteStream set up but
+ * not initialized, with a first pass of its own through the DisasmStream of
+ * arch (UCDISASM_ARCH_*) and, if discover is not NULL, the same discovery as
+ * the output. The input is then rewound for the second pass, and bs->in is
+ * replaced with a temporary copy if it cannot seek. Returns 0, or a
+ * STREAM_ERROR_* code with *error set. */
+int xref_index_scan_input(struct xref_index *index, struct ByteStream *bs, int arch, const struct discover_spec *discover, const char **error);
+
+/* Remove the address label of an instruction not in index */
+void xref_filter_label(const struct xref_index *index, struct instruction *instr);
+
+/* Setup self to pass through the source stream, removing the address labels
+ * not in index. The index is not freed with the stream, so that one index can
+ * serve several streams, e.g. the branches of a fan-out. */
+int xref_disasmstream_setup(struct DisasmStream *self, struct DisasmStream *source, struct xref_index *index);
+
+/* Xref Disasm Stream Support */
+int xref_disasmstream_init(struct DisasmStream *self);
+int xref_disasmstream_close(struct DisasmStream *self);
+int xref_disasmstream_read(struct DisasmStream *self, struct instruction *instr);
+
+#endif
+